@@ -0,0 +1,341 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Binary capture format.
+
+	Stream starts with 'CaptureHeader' and contains sequence of records,
+	each record is 'CaptureRecord' followed by 'size' bytes of payload.
+	'Execute' record contains all commands of the command buffer as nested records.
+
+	Resource IDs are stored as is and remapped during replay,
+	task dependencies are stored as task index in the command buffer.
+	POD structures are stored in native layout, so capture can be replayed only
+	on the same platform and with the same 'FG_OPTIMIZE_IDS' value.
+*/
+
+#pragma once
+
+#include "framegraph/FG.h"
+
+namespace FG
+{
+
+	//
+	// Capture Command
+	//
+
+	enum class ECaptureCmd : uint
+	{
+		Unknown		= 0,
+
+		// frame graph
+		CreateImage,
+		CreateBuffer,
+		CreateSampler,
+		CreateGraphicsPipeline,
+		CreateComputePipeline,
+		ReleaseImage,
+		ReleaseBuffer,
+		ReleaseSampler,
+		ReleaseGraphicsPipeline,
+		ReleaseComputePipeline,
+		UpdateHostBuffer,
+		Begin,
+		Execute,
+		Wait,
+		Flush,
+		WaitIdle,
+		Unsupported,
+
+		// command buffer
+		AddDependency,
+		AllocBuffer,
+		AcquireImage,
+		AcquireBuffer,
+		CreateTransientImage,
+		CreateTransientBuffer,
+		DefragmentMemory,
+		CreateRenderPass,
+		SubmitRenderPass,
+		DispatchCompute,
+		DispatchComputeIndirect,
+		CopyBuffer,
+		CopyImage,
+		CopyBufferToImage,
+		CopyImageToBuffer,
+		BlitImage,
+		ResolveImage,
+		GenerateMipmaps,
+		FillBuffer,
+		ClearColorImage,
+		ClearDepthStencilImage,
+		UpdateBuffer,
+		UpdateImage,
+		ReadBuffer,
+		ReadImage,
+		DrawVertices,
+		DrawIndexed,
+		DrawVerticesIndirect,
+		DrawIndexedIndirect,
+		UnsupportedTask,
+
+		_Count
+	};
+
+
+
+	//
+	// Capture Header
+	//
+
+	struct CaptureHeader
+	{
+		static constexpr uint	Magic	= 0x50414346;	// 'FCAP'
+		static constexpr uint	Version	= 1;
+
+		uint		magic			= Magic;
+		uint		version			= Version;
+		uint		optimizedIDs	= uint(FG_OPTIMIZE_IDS);
+		uint		pointerSize		= uint(sizeof(void*));
+		uint16_t	podSizes [8]	= { uint16_t(sizeof(ImageDesc)), uint16_t(sizeof(BufferDesc)), uint16_t(sizeof(SamplerDesc)),
+										uint16_t(sizeof(MemoryDesc)), uint16_t(sizeof(ImageViewDesc)), uint16_t(sizeof(BufferViewDesc)),
+										uint16_t(sizeof(RenderState::ColorBuffersState)), uint16_t(sizeof(RenderState::RasterizationState)) };
+
+		ND_ bool  IsCompatible (const CaptureHeader &rhs) const
+		{
+			return	magic			== rhs.magic			and
+					version			== rhs.version			and
+					optimizedIDs	== rhs.optimizedIDs		and
+					pointerSize		== rhs.pointerSize		and
+					std::memcmp( podSizes, rhs.podSizes, sizeof(podSizes) ) == 0;
+		}
+	};
+
+
+	struct CaptureRecord
+	{
+		ECaptureCmd		cmd		= Default;
+		uint			size	= 0;
+	};
+
+
+
+	//
+	// Capture Writer
+	//
+
+	class CaptureWriter
+	{
+	// types
+	public:
+		static constexpr bool	IsReader = false;
+
+	// variables
+	private:
+		Array<uint8_t>			_data;
+		HashMap< Task, uint >	_taskIndices;
+		uint					_taskCount		= 0;
+
+	// methods
+	public:
+		CaptureWriter () {}
+
+		void  Bytes (const void *ptr, size_t size)
+		{
+			_data.insert( _data.end(), Cast<uint8_t>(ptr), Cast<uint8_t>(ptr) + size );
+		}
+
+		template <typename T>
+		void  POD (const T &value)
+		{
+			STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+			Bytes( &value, sizeof(value) );
+		}
+
+		ND_ size_t  BeginRecord (ECaptureCmd cmd)
+		{
+			const size_t	pos = _data.size();
+			POD( CaptureRecord{ cmd, 0 });
+			return pos;
+		}
+
+		void  EndRecord (size_t pos)
+		{
+			ASSERT( pos + sizeof(CaptureRecord) <= _data.size() );
+			Cast<CaptureRecord>( _data.data() + pos )->size = uint(_data.size() - pos - sizeof(CaptureRecord));
+		}
+
+		// task dependencies
+		void  AddTask (Task task)
+		{
+			if ( task )
+				_taskIndices.insert_or_assign( task, _taskCount );
+			++_taskCount;
+		}
+
+		ND_ uint  TaskIndex (Task task) const
+		{
+			auto	iter = _taskIndices.find( task );
+			return iter != _taskIndices.end() ? iter->second : UMax;
+		}
+
+		void  Clear ()
+		{
+			_data.clear();
+			_taskIndices.clear();
+			_taskCount = 0;
+		}
+
+		ND_ ArrayView<uint8_t>	GetData ()	const	{ return _data; }
+		ND_ bool				Empty ()	const	{ return _data.empty(); }
+	};
+
+
+
+	//
+	// Capture Reader
+	//
+
+	class CaptureReader
+	{
+	// types
+	public:
+		static constexpr bool	IsReader = true;
+
+		using ResourceMap_t		= HashMap< uint64_t, uint >;		// (UID << 32 | captured ID) -> replayed ID
+		using Resources_t		= Array< UniquePtr< PipelineResources >>;
+
+	// variables
+	private:
+		ArrayView<uint8_t>		_data;
+		size_t					_pos			= 0;
+		bool					_isValid		= true;
+		bool					_missingRes		= false;
+
+		ResourceMap_t *			_resMap			= null;
+		ArrayView< Task >		_tasks;
+		IFrameGraph *			_frameGraph		= null;
+		Resources_t *			_resources		= null;
+
+	// methods
+	public:
+		CaptureReader () {}
+		explicit CaptureReader (ArrayView<uint8_t> data) : _data{data} {}
+
+		void  SetContext (ResourceMap_t *resMap, IFrameGraph *fg, Resources_t *resources, ArrayView<Task> tasks = Default)
+		{
+			_resMap		= resMap;
+			_frameGraph	= fg;
+			_resources	= resources;
+			_tasks		= tasks;
+		}
+
+		void  Bytes (OUT void *ptr, size_t size)
+		{
+			if ( not _isValid or _pos + size > _data.size() )
+			{
+				_isValid = false;
+				std::memset( ptr, 0, size );
+				return;
+			}
+			std::memcpy( ptr, _data.data() + _pos, size );
+			_pos += size;
+		}
+
+		template <typename T>
+		void  POD (OUT T &value)
+		{
+			STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+			Bytes( OUT &value, sizeof(value) );
+		}
+
+		template <typename T>
+		ND_ T  POD ()
+		{
+			T	value;
+			POD( OUT value );
+			return value;
+		}
+
+		// returns view to the captured data without copying
+		ND_ ArrayView<uint8_t>  View (size_t size)
+		{
+			if ( not _isValid or _pos + size > _data.size() )
+			{
+				_isValid = false;
+				return {};
+			}
+			ArrayView<uint8_t>	result{ _data.data() + _pos, size };
+			_pos += size;
+			return result;
+		}
+
+		ND_ bool  ReadRecord (OUT ECaptureCmd &cmd, OUT CaptureReader &payload)
+		{
+			CaptureRecord	rec;
+			POD( OUT rec );
+			cmd		= rec.cmd;
+			payload	= CaptureReader{ View( rec.size )};
+			payload.SetContext( _resMap, _frameGraph, _resources, _tasks );
+			return _isValid;
+		}
+
+		// resource remapping
+		template <uint UID>
+		void  AddResource (_fg_hidden_::ResourceID<UID> captured, _fg_hidden_::ResourceID<UID> replayed)
+		{
+			if ( captured and _resMap )
+				_resMap->insert_or_assign( (uint64_t(UID) << 32) | captured.Data(), replayed.Data() );
+		}
+
+		template <uint UID>
+		ND_ _fg_hidden_::ResourceID<UID>  Remap (_fg_hidden_::ResourceID<UID> captured)
+		{
+			using ID = _fg_hidden_::ResourceID<UID>;
+
+			if ( not captured or not _resMap )
+				return ID{};
+
+			auto	iter = _resMap->find( (uint64_t(UID) << 32) | captured.Data() );
+			if ( iter == _resMap->end() )
+			{
+				_missingRes = true;
+				return ID{};
+			}
+			return ID{ iter->second };
+		}
+
+		template <uint UID>
+		void  RemoveResource (_fg_hidden_::ResourceID<UID> captured)
+		{
+			if ( _resMap )
+				_resMap->erase( (uint64_t(UID) << 32) | captured.Data() );
+		}
+
+		// task dependencies
+		ND_ Task  GetTask (uint index) const
+		{
+			return index < _tasks.size() ? _tasks[index] : null;
+		}
+
+		// pipeline resources are owned by replayer until command buffer is executed
+		template <typename PplnID>
+		ND_ PipelineResources*  CreateResources (PplnID ppln, const DescriptorSetID &id)
+		{
+			if ( not ppln or not _frameGraph or not _resources )
+				return null;
+
+			auto	res = MakeUnique<PipelineResources>();
+			if ( not _frameGraph->InitPipelineResources( ppln, id, OUT *res ))
+				return null;
+
+			return _resources->emplace_back( std::move(res) ).get();
+		}
+
+		ND_ bool	IsValid ()				const	{ return _isValid; }
+		ND_ bool	IsEnd ()				const	{ return _pos >= _data.size(); }
+		ND_ bool	HasMissingResources ()	const	{ return _missingRes; }
+		void		ResetMissingResources ()		{ _missingRes = false; }
+	};
+
+
+}	// FG
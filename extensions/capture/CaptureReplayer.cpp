@@ -0,0 +1,714 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "extensions/capture/CaptureReplayer.h"
+#include "extensions/capture/CaptureSerializer.h"
+#include "stl/Stream/FileStream.h"
+#include <chrono>
+
+namespace FG
+{
+namespace
+{
+	using TimePoint_t	= std::chrono::high_resolution_clock::time_point;
+
+	ND_ inline Nanoseconds  TimeSince (const TimePoint_t &start)
+	{
+		return std::chrono::duration_cast<Nanoseconds>( TimePoint_t::clock::now() - start );
+	}
+}
+
+	//
+	// Replay State
+	//
+
+	struct CaptureReplayer::ReplayState
+	{
+		template <typename ID>
+		using IDMap_t	= HashMap< uint, ID >;		// captured ID -> owned replayed ID
+
+		FrameGraph						fg;
+		Statistics &					stats;
+		CaptureReader::ResourceMap_t	resMap;
+		HashMap< uint, CommandBuffer >	cmdBuffers;	// capture index -> command buffer
+
+		// each command buffer holds its batch until released, so it is released after the last record that refers to it
+		Array<Pair< size_t, uint >>		lastUsage;	// (record index, capture index), sorted by record index
+		size_t							lastUsagePos	= 0;
+
+		IDMap_t< ImageID >				images;
+		IDMap_t< BufferID >				buffers;
+		IDMap_t< SamplerID >			samplers;
+		IDMap_t< GPipelineID >			gpipelines;
+		IDMap_t< CPipelineID >			cpipelines;
+
+		// current command buffer
+		CommandBuffer					cmd;
+		Array< Task >					tasks;
+		CaptureReader::Resources_t		resources;
+
+		ReplayState (const FrameGraph &fg, Statistics &stats) : fg{fg}, stats{stats} {}
+	};
+//-----------------------------------------------------------------------------
+
+
+namespace
+{
+	using ReplayState = CaptureReplayer::ReplayState;
+
+/*
+=================================================
+	CreateResource
+=================================================
+*/
+	template <typename ID, typename RawID>
+	static void  AddOwnedResource (INOUT HashMap<uint, ID> &map, CaptureReader &payload, RawID captured, ID &&id)
+	{
+		if ( not id )
+			return;
+
+		payload.AddResource( captured, id.Get() );
+		map.insert_or_assign( captured.Data(), std::move(id) );
+	}
+
+/*
+=================================================
+	ReleaseResource
+=================================================
+*/
+	template <typename ID, typename RawID>
+	static void  ReleaseOwnedResource (IFrameGraph &fg, INOUT HashMap<uint, ID> &map, CaptureReader &payload, RawID captured)
+	{
+		auto	iter = map.find( captured.Data() );
+		if ( iter == map.end() )
+			return;
+
+		fg.ReleaseResource( INOUT iter->second );
+		map.erase( iter );
+		payload.RemoveResource( captured );
+	}
+
+	template <typename ID>
+	static void  ReleaseAll (IFrameGraph &fg, INOUT HashMap<uint, ID> &map)
+	{
+		for (auto& item : map) {
+			fg.ReleaseResource( INOUT item.second );
+		}
+		map.clear();
+	}
+
+/*
+=================================================
+	FindLastUsage
+----
+	returns index of the last top-level record that refers to each command buffer:
+	'Begin' and its dependencies, 'Execute' and nested 'AddDependency', 'Wait'.
+=================================================
+*/
+	static bool  FindLastUsage (ArrayView<uint8_t> data, OUT Array<Pair< size_t, uint >> &result)
+	{
+		HashMap< uint, size_t >	last_usage;
+		CaptureReader			reader{ data };
+
+		for (size_t rec_index = 0; not reader.IsEnd(); ++rec_index)
+		{
+			ECaptureCmd		cmd;
+			CaptureReader	payload;
+			CHECK_ERR( reader.ReadRecord( OUT cmd, OUT payload ));
+
+			switch ( cmd )
+			{
+				case ECaptureCmd::Begin :
+				{
+					const uint		index	= payload.POD<uint>();
+					CommandBufferDesc	desc;
+					String			name;
+					Array<uint>		deps;
+					CaptureSerializer::All( payload, desc.queueType, desc.debugFlags, desc.compilationFlags, name, deps );
+					CHECK_ERR( payload.IsValid() );
+
+					last_usage.insert_or_assign( index, rec_index );
+					for (uint dep : deps) {
+						last_usage.insert_or_assign( dep, rec_index );
+					}
+					break;
+				}
+				case ECaptureCmd::Execute :
+				{
+					last_usage.insert_or_assign( payload.POD<uint>(), rec_index );
+
+					for (; payload.IsValid() and not payload.IsEnd();)
+					{
+						ECaptureCmd		task_cmd;
+						CaptureReader	rec;
+						CHECK_ERR( payload.ReadRecord( OUT task_cmd, OUT rec ));
+
+						if ( task_cmd == ECaptureCmd::AddDependency )
+							last_usage.insert_or_assign( rec.POD<uint>(), rec_index );
+					}
+					CHECK_ERR( payload.IsValid() );
+					break;
+				}
+				case ECaptureCmd::Wait :
+				{
+					Array<uint>		indices;
+					Nanoseconds		timeout;
+					CaptureSerializer::All( payload, indices, timeout );
+					CHECK_ERR( payload.IsValid() );
+
+					for (uint idx : indices) {
+						last_usage.insert_or_assign( idx, rec_index );
+					}
+					break;
+				}
+				default :
+					break;
+			}
+		}
+
+		result.clear();
+		result.reserve( last_usage.size() );
+
+		for (auto& item : last_usage) {
+			result.emplace_back( item.second, item.first );
+		}
+		std::sort( result.begin(), result.end() );
+		return true;
+	}
+
+/*
+=================================================
+	ReleaseCommandBuffers
+=================================================
+*/
+	static void  ReleaseCommandBuffers (ReplayState &st, size_t recIndex)
+	{
+		for (; st.lastUsagePos < st.lastUsage.size(); ++st.lastUsagePos)
+		{
+			auto&	item = st.lastUsage[ st.lastUsagePos ];
+			if ( item.first > recIndex )
+				break;
+
+			st.cmdBuffers.erase( item.second );
+		}
+	}
+
+/*
+=================================================
+	AddTask
+----
+	task index must be incremented even if task is skipped,
+	otherwise dependencies will point to the wrong tasks
+=================================================
+*/
+	template <typename T>
+	static bool  AddTask (ReplayState &st, CaptureReader &payload, T &&task)
+	{
+		CaptureSerializer::Serialize( payload, task );
+		CHECK_ERR( payload.IsValid() );
+
+		if ( payload.HasMissingResources() )
+		{
+			st.tasks.push_back( null );
+			++st.stats.skipped;
+			return true;
+		}
+
+		st.tasks.push_back( st.cmd->AddTask( task ));
+		++st.stats.tasks;
+		return true;
+	}
+
+	template <typename T>
+	static bool  AddDrawTask (ReplayState &st, CaptureReader &payload, T &&task)
+	{
+		LogicalPassID	pass;
+		CaptureSerializer::All( payload, pass, task );
+		CHECK_ERR( payload.IsValid() );
+
+		if ( payload.HasMissingResources() )
+		{
+			++st.stats.skipped;
+			return true;
+		}
+
+		st.cmd->AddTask( pass, task );
+		++st.stats.drawTasks;
+		return true;
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	Load
+=================================================
+*/
+	bool  CaptureReplayer::Load (RStream &stream)
+	{
+		_data.clear();
+		CHECK_ERR( stream.IsOpen() );
+
+		CaptureHeader	header;
+		CHECK_ERR( stream.Read( OUT &header, BytesU::SizeOf(header) ));
+		CHECK_ERR( header.IsCompatible( CaptureHeader{} ));
+
+		CHECK_ERR( stream.Read( size_t(stream.RemainingSize()), OUT _data ));
+		return true;
+	}
+
+	bool  CaptureReplayer::Load (NtStringView filename)
+	{
+		FileRStream		file{ filename };
+		return Load( file );
+	}
+
+/*
+=================================================
+	Replay
+=================================================
+*/
+	bool  CaptureReplayer::Replay (const FrameGraph &fg, OUT Statistics &stats) const
+	{
+		CHECK_ERR( fg and IsLoaded() );
+
+		stats = Default;
+
+		ReplayState		st{ fg, stats };
+		CaptureReader	reader{ _data };
+		reader.SetContext( &st.resMap, fg.get(), null );
+		CHECK_ERR( FindLastUsage( _data, OUT st.lastUsage ));
+
+		bool	result = true;
+		for (size_t rec_index = 0; result and not reader.IsEnd(); ++rec_index)
+		{
+			ECaptureCmd		cmd;
+			CaptureReader	payload;
+			CHECK_ERR( reader.ReadRecord( OUT cmd, OUT payload ));
+
+			result = _ReplayCommand( st, cmd, payload );
+			ReleaseCommandBuffers( st, rec_index );
+		}
+
+		const auto	start = TimePoint_t::clock::now();
+		result &= fg->WaitIdle();
+		stats.wait += TimeSince( start );
+
+		ReleaseAll( *fg, st.images );
+		ReleaseAll( *fg, st.buffers );
+		ReleaseAll( *fg, st.samplers );
+		ReleaseAll( *fg, st.gpipelines );
+		ReleaseAll( *fg, st.cpipelines );
+		st.cmdBuffers.clear();
+
+		IFrameGraph::Statistics		fg_stats;
+		if ( fg->GetStatistics( OUT fg_stats ))
+			stats.renderer = fg_stats.renderer;
+
+		return result;
+	}
+
+/*
+=================================================
+	_ReplayCommand
+=================================================
+*/
+	bool  CaptureReplayer::_ReplayCommand (ReplayState &st, ECaptureCmd cmd, CaptureReader &payload)
+	{
+		IFrameGraph&	fg		= *st.fg;
+		const auto		start	= TimePoint_t::clock::now();
+
+		BEGIN_ENUM_CHECKS();
+		switch ( cmd )
+		{
+			case ECaptureCmd::CreateImage :
+			{
+				RawImageID		captured	{ payload.POD<uint>() };
+				ImageDesc		desc;
+				MemoryDesc		mem;
+				EResourceState	state;
+				String			name;
+				CaptureSerializer::All( payload, desc, mem, state, name );
+				CHECK_ERR( payload.IsValid() );
+
+				AddOwnedResource( INOUT st.images, payload, captured, fg.CreateImage( desc, mem, state, name ));
+				st.stats.createResources += TimeSince( start );
+				return true;
+			}
+			case ECaptureCmd::CreateBuffer :
+			{
+				RawBufferID		captured	{ payload.POD<uint>() };
+				BufferDesc		desc;
+				MemoryDesc		mem;
+				String			name;
+				CaptureSerializer::All( payload, desc, mem, name );
+				CHECK_ERR( payload.IsValid() );
+
+				AddOwnedResource( INOUT st.buffers, payload, captured, fg.CreateBuffer( desc, mem, name ));
+				st.stats.createResources += TimeSince( start );
+				return true;
+			}
+			case ECaptureCmd::CreateSampler :
+			{
+				RawSamplerID	captured	{ payload.POD<uint>() };
+				SamplerDesc		desc;
+				String			name;
+				CaptureSerializer::All( payload, desc, name );
+				CHECK_ERR( payload.IsValid() );
+
+				AddOwnedResource( INOUT st.samplers, payload, captured, fg.CreateSampler( desc, name ));
+				st.stats.createResources += TimeSince( start );
+				return true;
+			}
+			case ECaptureCmd::CreateGraphicsPipeline :
+			{
+				RawGPipelineID			captured	{ payload.POD<uint>() };
+				GraphicsPipelineDesc	desc;
+				String					name;
+				CaptureSerializer::All( payload, desc, name );
+				CHECK_ERR( payload.IsValid() );
+
+				AddOwnedResource( INOUT st.gpipelines, payload, captured, fg.CreatePipeline( INOUT desc, name ));
+				st.stats.createPipelines += TimeSince( start );
+				return true;
+			}
+			case ECaptureCmd::CreateComputePipeline :
+			{
+				RawCPipelineID			captured	{ payload.POD<uint>() };
+				ComputePipelineDesc		desc;
+				String					name;
+				CaptureSerializer::All( payload, desc, name );
+				CHECK_ERR( payload.IsValid() );
+
+				AddOwnedResource( INOUT st.cpipelines, payload, captured, fg.CreatePipeline( INOUT desc, name ));
+				st.stats.createPipelines += TimeSince( start );
+				return true;
+			}
+
+			case ECaptureCmd::ReleaseImage :			ReleaseOwnedResource( fg, INOUT st.images, payload, RawImageID{ payload.POD<uint>() });		return true;
+			case ECaptureCmd::ReleaseBuffer :			ReleaseOwnedResource( fg, INOUT st.buffers, payload, RawBufferID{ payload.POD<uint>() });		return true;
+			case ECaptureCmd::ReleaseSampler :			ReleaseOwnedResource( fg, INOUT st.samplers, payload, RawSamplerID{ payload.POD<uint>() });	return true;
+			case ECaptureCmd::ReleaseGraphicsPipeline :	ReleaseOwnedResource( fg, INOUT st.gpipelines, payload, RawGPipelineID{ payload.POD<uint>() });	return true;
+			case ECaptureCmd::ReleaseComputePipeline :	ReleaseOwnedResource( fg, INOUT st.cpipelines, payload, RawCPipelineID{ payload.POD<uint>() });	return true;
+
+			case ECaptureCmd::UpdateHostBuffer :
+			{
+				RawBufferID			id;
+				BytesU				offset;
+				ArrayView<uint8_t>	data;
+				CaptureSerializer::All( payload, id, offset, data );
+				CHECK_ERR( payload.IsValid() );
+
+				if ( payload.HasMissingResources() )
+					++st.stats.skipped;
+				else
+					fg.UpdateHostBuffer( id, offset, ArraySizeOf(data), data.data() );
+				return true;
+			}
+
+			case ECaptureCmd::Begin :
+			{
+				const uint		index	= payload.POD<uint>();
+				CommandBufferDesc	desc;
+				String			name;
+				Array<uint>		deps;
+				CaptureSerializer::All( payload, desc.queueType, desc.debugFlags, desc.compilationFlags, name, deps );
+				CHECK_ERR( payload.IsValid() );
+				desc.name = name;
+
+				FixedArray< CommandBuffer, 16 >	depends_on;
+				for (uint dep : deps)
+				{
+					auto	iter = st.cmdBuffers.find( dep );
+					if ( iter != st.cmdBuffers.end() and depends_on.size() < depends_on.capacity() )
+						depends_on.push_back( iter->second );
+				}
+
+				CommandBuffer	cb = fg.Begin( desc, depends_on );
+				CHECK_ERR( cb );
+				st.cmdBuffers.insert_or_assign( index, std::move(cb) );
+				++st.stats.commandBuffers;
+				return true;
+			}
+
+			case ECaptureCmd::Execute :
+				return _ReplayCommandBuffer( st, payload );
+
+			case ECaptureCmd::Wait :
+			{
+				Array<uint>		indices;
+				Nanoseconds		timeout;
+				CaptureSerializer::All( payload, indices, timeout );
+				CHECK_ERR( payload.IsValid() );
+
+				Array<CommandBuffer>	cmdbufs;
+				for (uint idx : indices)
+				{
+					auto	iter = st.cmdBuffers.find( idx );
+					if ( iter != st.cmdBuffers.end() )
+						cmdbufs.push_back( iter->second );
+				}
+
+				fg.Wait( cmdbufs, timeout );
+				st.stats.wait += TimeSince( start );
+				return true;
+			}
+
+			case ECaptureCmd::Flush :
+			{
+				EQueueUsage	queues = payload.POD<EQueueUsage>();
+				CHECK_ERR( payload.IsValid() );
+
+				fg.Flush( queues );
+				st.stats.wait += TimeSince( start );
+				return true;
+			}
+
+			case ECaptureCmd::WaitIdle :
+				fg.WaitIdle();
+				st.stats.wait += TimeSince( start );
+				return true;
+
+			case ECaptureCmd::Unsupported :
+				++st.stats.skipped;
+				return true;
+
+			case ECaptureCmd::AddDependency :
+			case ECaptureCmd::AllocBuffer :
+			case ECaptureCmd::AcquireImage :
+			case ECaptureCmd::AcquireBuffer :
+			case ECaptureCmd::CreateTransientImage :
+			case ECaptureCmd::CreateTransientBuffer :
+			case ECaptureCmd::DefragmentMemory :
+			case ECaptureCmd::CreateRenderPass :
+			case ECaptureCmd::SubmitRenderPass :
+			case ECaptureCmd::DispatchCompute :
+			case ECaptureCmd::DispatchComputeIndirect :
+			case ECaptureCmd::CopyBuffer :
+			case ECaptureCmd::CopyImage :
+			case ECaptureCmd::CopyBufferToImage :
+			case ECaptureCmd::CopyImageToBuffer :
+			case ECaptureCmd::BlitImage :
+			case ECaptureCmd::ResolveImage :
+			case ECaptureCmd::GenerateMipmaps :
+			case ECaptureCmd::FillBuffer :
+			case ECaptureCmd::ClearColorImage :
+			case ECaptureCmd::ClearDepthStencilImage :
+			case ECaptureCmd::UpdateBuffer :
+			case ECaptureCmd::UpdateImage :
+			case ECaptureCmd::ReadBuffer :
+			case ECaptureCmd::ReadImage :
+			case ECaptureCmd::DrawVertices :
+			case ECaptureCmd::DrawIndexed :
+			case ECaptureCmd::DrawVerticesIndirect :
+			case ECaptureCmd::DrawIndexedIndirect :
+			case ECaptureCmd::UnsupportedTask :
+			case ECaptureCmd::Unknown :
+			case ECaptureCmd::_Count :
+				break;
+		}
+		END_ENUM_CHECKS();
+		RETURN_ERR( "unknown or misplaced capture command" );
+	}
+
+/*
+=================================================
+	_ReplayCommandBuffer
+=================================================
+*/
+	bool  CaptureReplayer::_ReplayCommandBuffer (ReplayState &st, CaptureReader &payload)
+	{
+		const uint	index	= payload.POD<uint>();
+		auto		iter	= st.cmdBuffers.find( index );
+		CHECK_ERR( payload.IsValid() and iter != st.cmdBuffers.end() );
+
+		st.cmd = iter->second;
+		st.tasks.clear();
+		st.resources.clear();
+
+		auto	start = TimePoint_t::clock::now();
+
+		for (; not payload.IsEnd();)
+		{
+			// tasks array may be reallocated, so update view before each record
+			payload.SetContext( &st.resMap, st.fg.get(), &st.resources, st.tasks );
+
+			ECaptureCmd		cmd;
+			CaptureReader	rec;
+			CHECK_ERR( payload.ReadRecord( OUT cmd, OUT rec ));
+			CHECK_ERR( _ReplayTask( st, cmd, rec ));
+		}
+
+		st.stats.recordTasks += TimeSince( start );
+		start = TimePoint_t::clock::now();
+
+		bool	result = st.fg->Execute( INOUT st.cmd );
+		iter->second = st.cmd;
+
+		st.stats.execute += TimeSince( start );
+
+		st.cmd = CommandBuffer{};
+		st.tasks.clear();
+		st.resources.clear();
+		return result;
+	}
+
+/*
+=================================================
+	_ReplayTask
+=================================================
+*/
+	bool  CaptureReplayer::_ReplayTask (ReplayState &st, ECaptureCmd cmd, CaptureReader &payload)
+	{
+		BEGIN_ENUM_CHECKS();
+		switch ( cmd )
+		{
+			case ECaptureCmd::AddDependency :
+			{
+				auto	iter = st.cmdBuffers.find( payload.POD<uint>() );
+				if ( iter != st.cmdBuffers.end() )
+					st.cmd->AddDependency( iter->second );
+				return payload.IsValid();
+			}
+			case ECaptureCmd::AllocBuffer :
+			{
+				BytesU			size, align;
+				RawBufferID		captured;
+				CaptureSerializer::All( payload, size, align );
+				captured = RawBufferID{ payload.POD<uint>() };
+				CHECK_ERR( payload.IsValid() );
+
+				// content of the mapped memory is not captured
+				RawBufferID		id;
+				BytesU			offset;
+				void *			mapped = null;
+				if ( st.cmd->AllocBuffer( size, align, OUT id, OUT offset, OUT mapped ))
+					payload.AddResource( captured, id );
+				return true;
+			}
+			case ECaptureCmd::AcquireImage :
+			{
+				RawImageID	id;
+				bool		make_mutable, invalidate;
+				CaptureSerializer::All( payload, id, make_mutable, invalidate );
+				CHECK_ERR( payload.IsValid() );
+
+				if ( not payload.HasMissingResources() )
+					st.cmd->AcquireImage( id, make_mutable, invalidate );
+				return true;
+			}
+			case ECaptureCmd::AcquireBuffer :
+			{
+				RawBufferID	id;
+				bool		make_mutable;
+				CaptureSerializer::All( payload, id, make_mutable );
+				CHECK_ERR( payload.IsValid() );
+
+				if ( not payload.HasMissingResources() )
+					st.cmd->AcquireBuffer( id, make_mutable );
+				return true;
+			}
+			case ECaptureCmd::CreateTransientImage :
+			{
+				RawImageID	captured	{ payload.POD<uint>() };
+				ImageDesc	desc;
+				String		name;
+				CaptureSerializer::All( payload, desc, name );
+				CHECK_ERR( payload.IsValid() );
+
+				payload.AddResource( captured, st.cmd->CreateTransientImage( desc, name ));
+				return true;
+			}
+			case ECaptureCmd::CreateTransientBuffer :
+			{
+				RawBufferID	captured	{ payload.POD<uint>() };
+				BufferDesc	desc;
+				String		name;
+				CaptureSerializer::All( payload, desc, name );
+				CHECK_ERR( payload.IsValid() );
+
+				payload.AddResource( captured, st.cmd->CreateTransientBuffer( desc, name ));
+				return true;
+			}
+			case ECaptureCmd::DefragmentMemory :
+			{
+				BytesU	max_bytes = payload.POD<BytesU>();
+				CHECK_ERR( payload.IsValid() );
+
+				st.cmd->DefragmentMemory( max_bytes );
+				return true;
+			}
+			case ECaptureCmd::CreateRenderPass :
+			{
+				LogicalPassID	captured	{ payload.POD<uint>() };
+				RenderPassDesc	desc		{ uint2{} };
+				CaptureSerializer::Serialize( payload, desc );
+				CHECK_ERR( payload.IsValid() );
+
+				if ( payload.HasMissingResources() )
+					++st.stats.skipped;
+				else
+					payload.AddResource( captured, st.cmd->CreateRenderPass( desc ));
+				return true;
+			}
+
+			case ECaptureCmd::SubmitRenderPass :		return AddTask( st, payload, SubmitRenderPass{ LogicalPassID{} });
+			case ECaptureCmd::DispatchCompute :			return AddTask( st, payload, DispatchCompute{} );
+			case ECaptureCmd::DispatchComputeIndirect :	return AddTask( st, payload, DispatchComputeIndirect{} );
+			case ECaptureCmd::CopyBuffer :				return AddTask( st, payload, CopyBuffer{} );
+			case ECaptureCmd::CopyImage :				return AddTask( st, payload, CopyImage{} );
+			case ECaptureCmd::CopyBufferToImage :		return AddTask( st, payload, CopyBufferToImage{} );
+			case ECaptureCmd::CopyImageToBuffer :		return AddTask( st, payload, CopyImageToBuffer{} );
+			case ECaptureCmd::BlitImage :				return AddTask( st, payload, BlitImage{} );
+			case ECaptureCmd::ResolveImage :			return AddTask( st, payload, ResolveImage{} );
+			case ECaptureCmd::GenerateMipmaps :			return AddTask( st, payload, GenerateMipmaps{} );
+			case ECaptureCmd::FillBuffer :				return AddTask( st, payload, FillBuffer{} );
+			case ECaptureCmd::ClearColorImage :			return AddTask( st, payload, ClearColorImage{} );
+			case ECaptureCmd::ClearDepthStencilImage :	return AddTask( st, payload, ClearDepthStencilImage{} );
+			case ECaptureCmd::UpdateBuffer :			return AddTask( st, payload, UpdateBuffer{} );
+			case ECaptureCmd::UpdateImage :				return AddTask( st, payload, UpdateImage{} );
+			case ECaptureCmd::ReadBuffer :				return AddTask( st, payload, ReadBuffer{}.SetCallback( [] (const BufferView &) {} ));
+			case ECaptureCmd::ReadImage :				return AddTask( st, payload, ReadImage{}.SetCallback( [] (const ImageView &) {} ));
+
+			case ECaptureCmd::DrawVertices :			return AddDrawTask( st, payload, DrawVertices{} );
+			case ECaptureCmd::DrawIndexed :				return AddDrawTask( st, payload, DrawIndexed{} );
+			case ECaptureCmd::DrawVerticesIndirect :	return AddDrawTask( st, payload, DrawVerticesIndirect{} );
+			case ECaptureCmd::DrawIndexedIndirect :		return AddDrawTask( st, payload, DrawIndexedIndirect{} );
+
+			case ECaptureCmd::UnsupportedTask :
+				st.tasks.push_back( null );
+				++st.stats.skipped;
+				return true;
+
+			case ECaptureCmd::Unsupported :
+				++st.stats.skipped;
+				return true;
+
+			case ECaptureCmd::CreateImage :
+			case ECaptureCmd::CreateBuffer :
+			case ECaptureCmd::CreateSampler :
+			case ECaptureCmd::CreateGraphicsPipeline :
+			case ECaptureCmd::CreateComputePipeline :
+			case ECaptureCmd::ReleaseImage :
+			case ECaptureCmd::ReleaseBuffer :
+			case ECaptureCmd::ReleaseSampler :
+			case ECaptureCmd::ReleaseGraphicsPipeline :
+			case ECaptureCmd::ReleaseComputePipeline :
+			case ECaptureCmd::UpdateHostBuffer :
+			case ECaptureCmd::Begin :
+			case ECaptureCmd::Execute :
+			case ECaptureCmd::Wait :
+			case ECaptureCmd::Flush :
+			case ECaptureCmd::WaitIdle :
+			case ECaptureCmd::Unknown :
+			case ECaptureCmd::_Count :
+				break;
+		}
+		END_ENUM_CHECKS();
+		RETURN_ERR( "unknown or misplaced command buffer command" );
+	}
+
+
+}	// FG
@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Replays stream that was written by 'FrameGraphCapture'.
+	Commands that reference unsupported or missing resources are skipped.
+*/
+
+#pragma once
+
+#include "extensions/capture/CaptureFormat.h"
+#include "stl/Stream/Stream.h"
+
+namespace FG
+{
+
+	//
+	// Capture Replayer
+	//
+
+	class CaptureReplayer final
+	{
+	// types
+	public:
+		struct Statistics
+		{
+			// CPU time
+			Nanoseconds		createResources		{0};
+			Nanoseconds		createPipelines		{0};
+			Nanoseconds		recordTasks			{0};
+			Nanoseconds		execute				{0};
+			Nanoseconds		wait				{0};	// Wait, Flush and WaitIdle
+
+			uint			commandBuffers		= 0;
+			uint			tasks				= 0;
+			uint			drawTasks			= 0;
+			uint			skipped				= 0;	// unsupported commands and commands with missing resources
+
+			IFrameGraph::RenderingStatistics	renderer;
+		};
+
+		struct ReplayState;
+
+
+	// variables
+	private:
+		Array<uint8_t>		_data;
+
+
+	// methods
+	public:
+		CaptureReplayer () {}
+
+		bool  Load (RStream &stream);
+		bool  Load (NtStringView filename);
+
+		bool  Replay (const FrameGraph &fg, OUT Statistics &stats) const;
+
+		ND_ bool  IsLoaded () const		{ return not _data.empty(); }
+
+	private:
+		static bool  _ReplayCommand (ReplayState &, ECaptureCmd cmd, CaptureReader &payload);
+		static bool  _ReplayCommandBuffer (ReplayState &, CaptureReader &payload);
+		static bool  _ReplayTask (ReplayState &, ECaptureCmd cmd, CaptureReader &payload);
+	};
+
+
+}	// FG
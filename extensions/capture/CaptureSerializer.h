@@ -0,0 +1,802 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Serialization of frame graph structures,
+	same code is used for writing and reading, direction is defined by archive type.
+	Writer never modifies the values, 'const_cast' is used to share code with the reader.
+*/
+
+#pragma once
+
+#include "extensions/capture/CaptureFormat.h"
+#include "framegraph/Shared/PipelineResourcesHelper.h"
+
+namespace FG
+{
+
+	//
+	// Capture Serializer
+	//
+
+	struct CaptureSerializer final
+	{
+	// types
+		using Uniform_t			= PipelineDescription::Uniform;
+		using UniformMap_t		= PipelineDescription::UniformMap_t;
+		using EDescriptorType	= PipelineResources::EDescriptorType;
+
+
+	// methods
+		template <typename Ar, typename ...Args>
+		static void  All (Ar &ar, Args& ...args)
+		{
+			(Serialize( ar, args ), ...);
+		}
+
+		template <typename Ar, typename T>
+		static void  Serialize (Ar &ar, T &value)
+		{
+			STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+			ar.POD( INOUT value );
+		}
+
+		template <typename Ar, uint UID>
+		static void  Serialize (Ar &ar, _fg_hidden_::ResourceID<UID> &id)
+		{
+			if constexpr( Ar::IsReader )
+				id = ar.Remap( _fg_hidden_::ResourceID<UID>{ ar.template POD<uint>() });
+			else
+				ar.POD( id.Data() );
+		}
+
+		template <typename Ar, size_t Size, uint UID, bool Optimize, uint Seed>
+		static void  Serialize (Ar &ar, _fg_hidden_::IDWithString<Size, UID, Optimize, Seed> &id)
+		{
+			using ID = _fg_hidden_::IDWithString<Size, UID, Optimize, Seed>;
+
+			if constexpr( Optimize )
+			{
+				if constexpr( Ar::IsReader )
+					id = ID{ ar.template POD<uint>() };
+				else
+					ar.POD( uint(size_t(id.GetHash())) );
+			}
+			else
+			{
+				StaticString<Size>	name{ id.GetName() };
+				Serialize( ar, name );
+				if constexpr( Ar::IsReader )
+					id = ID{ StringView{name} };
+			}
+		}
+
+		template <typename Ar, size_t Size>
+		static void  Serialize (Ar &ar, StaticString<Size> &str)
+		{
+			uint	len = uint(str.length());
+			ar.POD( INOUT len );
+
+			if constexpr( Ar::IsReader )
+			{
+				ArrayView<uint8_t>	data = ar.View( len );
+				str = StringView{ Cast<char>(data.data()), Min( data.size(), Size-1 )};
+			}
+			else
+				ar.Bytes( str.data(), len );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, String &str)
+		{
+			uint	len = uint(str.length());
+			ar.POD( INOUT len );
+
+			if constexpr( Ar::IsReader )
+			{
+				ArrayView<uint8_t>	data = ar.View( len );
+				str.assign( Cast<char>(data.data()), data.size() );
+			}
+			else
+				ar.Bytes( str.data(), len );
+		}
+
+		// data is not copied by the reader, view points to the captured data
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ArrayView<uint8_t> &data)
+		{
+			uint64_t	size = data.size();
+			ar.POD( INOUT size );
+
+			if constexpr( Ar::IsReader )
+				data = ar.View( size_t(size) );
+			else
+				ar.Bytes( data.data(), size_t(size) );
+		}
+
+		template <typename Ar, typename T>
+		static void  Serialize (Ar &ar, Array<T> &arr)
+		{
+			uint	count = uint(arr.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				if ( not ar.IsValid() )
+					return;
+				arr.resize( count );
+			}
+
+			if constexpr( std::is_arithmetic_v<T> )
+				ar.Bytes( INOUT arr.data(), arr.size() * sizeof(T) );
+			else
+				for (auto& item : arr) {
+					Serialize( ar, item );
+				}
+		}
+
+		template <typename Ar, typename T, size_t ArraySize>
+		static void  Serialize (Ar &ar, FixedArray<T, ArraySize> &arr)
+		{
+			uint	count = uint(arr.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+				arr.resize( Min( count, uint(ArraySize) ));
+
+			for (auto& item : arr) {
+				Serialize( ar, item );
+			}
+		}
+
+		template <typename Ar, typename T, size_t ArraySize>
+		static void  Serialize (Ar &ar, StaticArray<T, ArraySize> &arr)
+		{
+			for (auto& item : arr) {
+				Serialize( ar, item );
+			}
+		}
+
+		template <typename Ar, typename K, typename V, size_t ArraySize>
+		static void  Serialize (Ar &ar, FixedMap<K, V, ArraySize> &map)
+		{
+			uint	count = uint(map.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				for (uint i = 0; i < count and ar.IsValid(); ++i)
+				{
+					K	key;
+					V	value;
+					All( ar, key, value );
+					map.insert_or_assign( key, value );
+				}
+			}
+			else
+			{
+				for (auto& [key, value] : map) {
+					All( ar, const_cast<K &>(key), const_cast<V &>(value) );
+				}
+			}
+		}
+
+		template <typename Ar, typename T>
+		static void  Serialize (Ar &ar, Rectangle<T> &rect)
+		{
+			All( ar, rect.left, rect.top, rect.right, rect.bottom );
+		}
+
+		template <typename Ar, typename A, typename B>
+		static void  Serialize (Ar &ar, Pair<A, B> &value)
+		{
+			All( ar, value.first, value.second );
+		}
+
+		template <typename Ar, typename T>
+		static void  Serialize (Ar &ar, Optional<T> &value)
+		{
+			bool	has_value = value.has_value();
+			ar.POD( INOUT has_value );
+
+			if ( not has_value )
+				return;
+
+			if constexpr( Ar::IsReader )
+				value.emplace();
+
+			Serialize( ar, *value );
+		}
+
+		template <typename Ar, typename ...Types>
+		static void  Serialize (Ar &ar, Union<Types...> &value)
+		{
+			uint	index = uint(value.index());
+			ar.POD( INOUT index );
+
+			if constexpr( Ar::IsReader )
+				_EmplaceUnion<0>( index, INOUT value );
+
+			Visit( value, [&ar] (auto &alt) { Serialize( ar, alt ); });
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &, NullUnion &)
+		{}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, Task &task)
+		{
+			if constexpr( Ar::IsReader )
+				task = ar.GetTask( ar.template POD<uint>() );
+			else
+				ar.POD( ar.TaskIndex( task ));
+		}
+
+
+	// descriptions
+		template <typename Ar>
+		static void  Serialize (Ar &ar, RenderPassDesc &desc)
+		{
+			All( ar, desc.colorState, desc.depthState, desc.stencilState, desc.rasterizationState, desc.multisampleState,
+				 desc.shadingRate.image, desc.shadingRate.layer, desc.shadingRate.mipmap,
+				 desc.renderTargets, desc.viewports, desc.area );
+
+			// pipeline is unknown, resources are skipped during replay
+			SerializeResources( ar, RawGPipelineID{}, desc.perPassResources );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, RenderPassDesc::RT &rt)
+		{
+			All( ar, rt.image, rt.desc, rt.clearValue, rt.loadOp, rt.storeOp );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, RenderPassDesc::Viewport &vp)
+		{
+			All( ar, vp.rect, vp.minDepth, vp.maxDepth, vp.palette );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, VertexInputState &state)
+		{
+			using Vertices_t	= VertexInputState::Vertices_t;
+			using Bindings_t	= VertexInputState::Bindings_t;
+
+			Bindings_t	bindings	= state.BufferBindings();
+			Vertices_t	vertices	= state.Vertices();
+
+			uint	count = uint(bindings.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				state.Clear();
+				bindings.clear();
+
+				for (uint i = 0; i < count and ar.IsValid(); ++i)
+				{
+					VertexBufferID					id;
+					VertexInputState::BufferBinding	bb;
+					All( ar, id, bb.index, bb.stride, bb.rate );
+
+					state.Bind( id, bb.stride, bb.index, bb.rate );
+					bindings.insert_or_assign( id, bb );
+				}
+			}
+			else
+			{
+				for (auto& [id, bb] : bindings) {
+					All( ar, const_cast<VertexBufferID &>(id), bb.index, bb.stride, bb.rate );
+				}
+			}
+
+			count = uint(vertices.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				for (uint i = 0; i < count and ar.IsValid(); ++i)
+				{
+					VertexID						id;
+					VertexInputState::VertexInput	vi;
+					All( ar, id, vi.type, vi.offset, vi.bufferBinding );
+
+					VertexBufferID	buffer_id;
+					for (auto& [bid, bb] : bindings) {
+						if ( bb.index == vi.bufferBinding )
+							buffer_id = bid;
+					}
+					state.Add( id, vi.type, BytesU{vi.offset}, buffer_id );
+				}
+			}
+			else
+			{
+				for (auto& [id, vi] : vertices) {
+					All( ar, const_cast<VertexID &>(id), vi.type, vi.offset, vi.bufferBinding );
+				}
+			}
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, _fg_hidden_::PushConstantData &pc)
+		{
+			All( ar, pc.id, pc.size );
+
+			const size_t	size = Min( size_t(pc.size), sizeof(pc.data) );
+			if constexpr( Ar::IsReader )
+				ar.Bytes( OUT pc.data, size );
+			else
+				ar.Bytes( pc.data, size );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, _fg_hidden_::VertexBuffer &vb)
+		{
+			All( ar, vb.buffer, vb.offset );
+		}
+
+
+	// pipeline resources
+		template <typename Ar, typename PplnID>
+		static void  SerializeResources (Ar &ar, PplnID ppln, PipelineResourceSet &resources)
+		{
+			uint	count = uint(resources.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				resources.clear();
+
+				for (uint i = 0; i < count and ar.IsValid(); ++i)
+				{
+					DescriptorSetID		id;
+					Serialize( ar, id );
+
+					PipelineResources*	res = ar.CreateResources( ppln, id );
+					_ReadUniforms( ar, res );
+
+					if ( res )
+						resources.insert_or_assign( id, Ptr<const PipelineResources>{ res });
+				}
+			}
+			else
+			{
+				for (auto& [id, res] : resources)
+				{
+					Serialize( ar, const_cast<DescriptorSetID &>(id) );
+					_WriteUniforms( ar, *res );
+				}
+			}
+		}
+
+
+	// pipelines
+		template <typename Ar>
+		static void  Serialize (Ar &ar, GraphicsPipelineDesc &desc)
+		{
+			uint64_t	topology = desc._supportedTopology.to_ullong();
+
+			All( ar, desc._pipelineLayout, desc._shaders, topology, desc._fragmentOutput, desc._vertexAttribs,
+				 desc._patchControlPoints, desc._earlyFragmentTests );
+
+			if constexpr( Ar::IsReader )
+				desc._supportedTopology = GraphicsPipelineDesc::TopologyBits_t{ topology };
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ComputePipelineDesc &desc)
+		{
+			All( ar, desc._pipelineLayout, desc._shader, desc._defaultLocalGroupSize, desc._localSizeSpec );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, PipelineDescription::PipelineLayout &layout)
+		{
+			All( ar, layout.descriptorSets, layout.pushConstants );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, PipelineDescription::DescriptorSet &ds)
+		{
+			All( ar, ds.id, ds.bindingIndex );
+
+			UniformMap_t	uniforms;
+			if constexpr( not Ar::IsReader ) {
+				if ( ds.uniforms )
+					uniforms = *ds.uniforms;
+			}
+
+			uint	count = uint(uniforms.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				for (uint i = 0; i < count and ar.IsValid(); ++i)
+				{
+					UniformID	id;
+					Uniform_t	un;
+					All( ar, id, un.data, un.index, un.arraySize, un.stageFlags );
+					uniforms.insert_or_assign( id, un );
+				}
+				ds.uniforms = MakeShared<const UniformMap_t>( std::move(uniforms) );
+			}
+			else
+			{
+				for (auto& [id, un] : uniforms) {
+					All( ar, const_cast<UniformID &>(id), un.data, un.index, un.arraySize, un.stageFlags );
+				}
+			}
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, GraphicsPipelineDesc::VertexAttrib &attr)
+		{
+			All( ar, attr.id, attr.index, attr.type );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, PipelineDescription::Shader &shader)
+		{
+			Serialize( ar, shader.specConstants );
+
+			// only shader sources and binaries are supported, vulkan shader modules are skipped
+			uint	count = 0;
+			if constexpr( not Ar::IsReader ) {
+				for (auto& [fmt, data] : shader.data) {
+					count += uint(data.index() >= 1 and data.index() <= 3);
+				}
+			}
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				for (uint i = 0; i < count and ar.IsValid(); ++i)
+				{
+					EShaderLangFormat	fmt;
+					uint				index;
+					String				entry, dbg_name;
+					All( ar, fmt, index, entry, dbg_name );
+
+					switch ( index )
+					{
+						case 1 : { String			src;	Serialize( ar, src );	shader.AddShaderData( fmt, entry, std::move(src), dbg_name );  break; }
+						case 2 : { Array<uint8_t>	bin;	Serialize( ar, bin );	shader.AddShaderData( fmt, entry, std::move(bin), dbg_name );  break; }
+						case 3 : { Array<uint>		bin;	Serialize( ar, bin );	shader.AddShaderData( fmt, entry, std::move(bin), dbg_name );  break; }
+					}
+				}
+			}
+			else
+			{
+				for (auto& [fmt, data] : shader.data)
+				{
+					uint	index = uint(data.index());
+					Visit( data,
+						[&] (const auto &sh)
+						{
+							using T = std::remove_cv_t< std::remove_reference_t< decltype(*sh) >>;
+
+							if constexpr( not IsSameTypes< T, PipelineDescription::IShaderData<ShaderModuleVk_t> >)
+							{
+								String	entry	 { sh->GetEntry() };
+								String	dbg_name { sh->GetDebugName() };
+								auto	bin		 = sh->GetData();
+								All( ar, const_cast<EShaderLangFormat &>(fmt), index, entry, dbg_name, bin );
+							}
+						},
+						[] (const NullUnion &) {}
+					);
+				}
+			}
+		}
+
+
+	// tasks
+		template <typename Ar, typename T>
+		static void  SerializeBase (Ar &ar, _fg_hidden_::BaseTask<T> &task)
+		{
+			uint	count = uint(task.depends.size());
+			ar.POD( INOUT count );
+
+			if constexpr( Ar::IsReader )
+			{
+				task.depends.clear();
+				for (uint i = 0; i < count; ++i)
+				{
+					Task	dep;
+					Serialize( ar, dep );
+					if ( dep )
+						task.depends.push_back( dep );
+				}
+			}
+			else
+			{
+				for (auto& dep : task.depends) {
+					Serialize( ar, dep );
+				}
+			}
+			All( ar, task.taskName, task.debugColor );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, SubmitRenderPass &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.renderPassId, task.images, task.buffers );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, DispatchCompute &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.pipeline );
+			SerializeResources( ar, task.pipeline, task.resources );
+			All( ar, task.commands, task.localGroupSize, task.pushConstants, task.debugMode );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, DispatchComputeIndirect &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.pipeline );
+			SerializeResources( ar, task.pipeline, task.resources );
+			All( ar, task.commands, task.indirectBuffer, task.localGroupSize, task.pushConstants, task.debugMode );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, CopyBuffer &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcBuffer, task.dstBuffer, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, CopyImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcImage, task.dstImage, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, CopyBufferToImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcBuffer, task.dstImage, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, CopyImageToBuffer &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcImage, task.dstBuffer, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, BlitImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcImage, task.dstImage, task.filter, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ResolveImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcImage, task.dstImage, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, GenerateMipmaps &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.image, task.baseLevel, task.levelCount );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, FillBuffer &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.dstBuffer, task.dstOffset, task.size, task.pattern );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ClearColorImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.dstImage, task.ranges, task.clearValue );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ClearDepthStencilImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.dstImage, task.ranges, task.clearValue );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, UpdateBuffer &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.dstBuffer, task.regions );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, UpdateBuffer::Region &reg)
+		{
+			All( ar, reg.offset, reg.data );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, UpdateImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.dstImage, task.imageOffset, task.imageSize, task.arrayLayer, task.mipmapLevel,
+				 task.dataRowPitch, task.dataSlicePitch, task.aspectMask, task.data );
+		}
+
+		// callback is not serialized
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ReadBuffer &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcBuffer, task.offset, task.size, task.contiguous );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, ReadImage &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.srcImage, task.imageOffset, task.imageSize, task.arrayLayer, task.mipmapLevel,
+				 task.aspectMask, task.contiguous );
+		}
+
+
+	// draw tasks
+		template <typename Ar, typename T>
+		static void  SerializeBase (Ar &ar, _fg_hidden_::BaseDrawVertices<T> &task)
+		{
+			All( ar, task.taskName, task.debugColor, task.pipeline );
+			SerializeResources( ar, task.pipeline, task.resources );
+			All( ar, task.pushConstants, task.scissors, task.colorBuffers, task.dynamicStates, task.debugMode,
+				 task.vertexInput, task.vertexBuffers, task.topology, task.primitiveRestart );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, DrawVertices &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.commands );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, DrawIndexed &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.indexBuffer, task.indexBufferOffset, task.indexType, task.commands );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, DrawVerticesIndirect &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.commands, task.indirectBuffer );
+		}
+
+		template <typename Ar>
+		static void  Serialize (Ar &ar, DrawIndexedIndirect &task)
+		{
+			SerializeBase( ar, task );
+			All( ar, task.indexBuffer, task.indexBufferOffset, task.indexType, task.commands, task.indirectBuffer );
+		}
+
+
+	private:
+		template <size_t I, typename ...Types>
+		static void  _EmplaceUnion (uint index, INOUT Union<Types...> &value)
+		{
+			if constexpr( I < sizeof...(Types) )
+			{
+				if ( index == I )
+					value.template emplace<I>();
+				else
+					_EmplaceUnion<I+1>( index, INOUT value );
+			}
+		}
+
+		template <typename Ar>
+		static void  _WriteUniforms (Ar &ar, const PipelineResources &res)
+		{
+			using PR = PipelineResources;
+
+			auto*	data	= PipelineResourcesHelper::GetData( res );
+			uint	count	= data ? data->uniformCount : 0;
+			ar.POD( count );
+
+			if ( not data )
+				return;
+
+			data->ForEachUniform( [&ar] (const UniformID &id, const auto &un)
+				{
+					using T = std::remove_cv_t< std::remove_reference_t< decltype(un) >>;
+
+					EDescriptorType	type	= T::TypeId;
+					uint			elems	= un.elementCount;
+					All( ar, const_cast<UniformID &>(id), type, elems );
+
+					for (uint i = 0; i < elems; ++i)
+					{
+						auto&	elem = const_cast<typename T::Element &>( un.elements[i] );
+
+						if constexpr( IsSameTypes< T, PR::Buffer >)			All( ar, elem.bufferId, elem.offset, elem.size );		else
+						if constexpr( IsSameTypes< T, PR::TexelBuffer >)	All( ar, elem.bufferId, elem.desc );					else
+						if constexpr( IsSameTypes< T, PR::Image >)			All( ar, elem.imageId, elem.desc, elem.hasDesc );		else
+						if constexpr( IsSameTypes< T, PR::Texture >)		All( ar, elem.imageId, elem.samplerId, elem.desc, elem.hasDesc );	else
+						if constexpr( IsSameTypes< T, PR::Sampler >)		All( ar, elem.samplerId );								else
+						if constexpr( IsSameTypes< T, PR::RayTracingScene >)All( ar, elem.sceneId );
+					}
+				});
+		}
+
+		// if 'res' is null then uniforms are skipped
+		template <typename Ar>
+		static void  _ReadUniforms (Ar &ar, PipelineResources *res)
+		{
+			const uint	count = ar.template POD<uint>();
+
+			for (uint u = 0; u < count and ar.IsValid(); ++u)
+			{
+				UniformID		id;
+				EDescriptorType	type;
+				uint			elems;
+				All( ar, id, type, elems );
+
+				for (uint i = 0; i < elems and ar.IsValid(); ++i)
+				{
+					switch ( type )
+					{
+						case EDescriptorType::Buffer : {
+							RawBufferID	buf;  BytesU  offset, size;
+							All( ar, buf, offset, size );
+							if ( res and buf )	res->BindBuffer( id, buf, offset, size, i );
+							break;
+						}
+						case EDescriptorType::TexelBuffer : {
+							RawBufferID	buf;  BufferViewDesc  desc;
+							All( ar, buf, desc );
+							if ( res and buf )	res->BindTexelBuffer( id, buf, desc, i );
+							break;
+						}
+						case EDescriptorType::SubpassInput :
+						case EDescriptorType::Image : {
+							RawImageID	img;  ImageViewDesc  desc;  bool  has_desc;
+							All( ar, img, desc, has_desc );
+							if ( res and img )	has_desc ? res->BindImage( id, img, desc, i ) : res->BindImage( id, img, i );
+							break;
+						}
+						case EDescriptorType::Texture : {
+							RawImageID	img;  RawSamplerID  samp;  ImageViewDesc  desc;  bool  has_desc;
+							All( ar, img, samp, desc, has_desc );
+							if ( res and img )	has_desc ? res->BindTexture( id, img, samp, desc, i ) : res->BindTexture( id, img, samp, i );
+							break;
+						}
+						case EDescriptorType::Sampler : {
+							RawSamplerID	samp;
+							All( ar, samp );
+							if ( res and samp )	res->BindSampler( id, samp, i );
+							break;
+						}
+						case EDescriptorType::RayTracingScene : {
+							RawRTSceneID	scene;
+							All( ar, scene );	// ray tracing is not supported
+							break;
+						}
+						case EDescriptorType::Unknown :
+						default :
+							return;
+					}
+				}
+			}
+		}
+	};
+
+
+}	// FG
@@ -0,0 +1,899 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "extensions/capture/FrameGraphCapture.h"
+#include "extensions/capture/CaptureSerializer.h"
+
+namespace FG
+{
+
+	//
+	// Capture Command Buffer
+	//
+
+	class FrameGraphCapture::CaptureCommandBuffer final : public ICommandBuffer
+	{
+	// variables
+	private:
+		FrameGraphCapture &		_capture;
+		ICommandBuffer *		_cmdBuf;
+		uint					_index		= UMax;
+		CaptureWriter			_writer;
+
+
+	// methods
+	public:
+		CaptureCommandBuffer (FrameGraphCapture &capture, ICommandBuffer *cmdBuf) : _capture{capture}, _cmdBuf{cmdBuf} {}
+
+		void  Begin (uint index)
+		{
+			_index = index;
+			_writer.Clear();
+		}
+
+		ND_ ICommandBuffer*		GetOriginal ()	const	{ return _cmdBuf; }
+		ND_ uint				GetIndex ()		const	{ return _index; }
+		ND_ ArrayView<uint8_t>	GetData ()		const	{ return _writer.GetData(); }
+
+
+		// ICommandBuffer //
+		FrameGraph	GetFrameGraph () override
+		{
+			return _capture.shared_from_this();
+		}
+
+		RawImageID	GetSwapchainImage (RawSwapchainID swapchain, ESwapchainImage type) override
+		{
+			_WriteUnsupported( "GetSwapchainImage" );
+			return _cmdBuf->GetSwapchainImage( swapchain, type );
+		}
+
+		bool  AddExternalCommands (const ExternalCmdBatch_t &batch) override
+		{
+			_WriteUnsupported( "AddExternalCommands" );
+			return _cmdBuf->AddExternalCommands( batch );
+		}
+
+		bool  AddDependency (const CommandBuffer &cmd) override
+		{
+			if ( cmd.GetCommandBuffer() == this )
+				return true;
+
+			uint	index = _capture._GetCmdIndex( cmd );
+			_Write( ECaptureCmd::AddDependency, index );
+			return _cmdBuf->AddDependency( cmd );
+		}
+
+		bool  AllocBuffer (BytesU size, BytesU align, OUT RawBufferID &id, OUT BytesU &offset, OUT void* &mapped) override
+		{
+			bool	res = _cmdBuf->AllocBuffer( size, align, OUT id, OUT offset, OUT mapped );
+			if ( res )
+				_Write( ECaptureCmd::AllocBuffer, size, align, id );
+			return res;
+		}
+
+		void  AcquireImage (RawImageID id, bool makeMutable, bool invalidate) override
+		{
+			_Write( ECaptureCmd::AcquireImage, id, makeMutable, invalidate );
+			_cmdBuf->AcquireImage( id, makeMutable, invalidate );
+		}
+
+		void  AcquireBuffer (RawBufferID id, bool makeMutable) override
+		{
+			_Write( ECaptureCmd::AcquireBuffer, id, makeMutable );
+			_cmdBuf->AcquireBuffer( id, makeMutable );
+		}
+
+		RawImageID  CreateTransientImage (const ImageDesc &desc, StringView dbgName) override
+		{
+			RawImageID	id = _cmdBuf->CreateTransientImage( desc, dbgName );
+			if ( id )
+				_Write( ECaptureCmd::CreateTransientImage, id, desc, String{dbgName} );
+			return id;
+		}
+
+		RawBufferID  CreateTransientBuffer (const BufferDesc &desc, StringView dbgName) override
+		{
+			RawBufferID	id = _cmdBuf->CreateTransientBuffer( desc, dbgName );
+			if ( id )
+				_Write( ECaptureCmd::CreateTransientBuffer, id, desc, String{dbgName} );
+			return id;
+		}
+
+		BytesU  DefragmentMemory (BytesU maxBytesToMove) override
+		{
+			_Write( ECaptureCmd::DefragmentMemory, maxBytesToMove );
+			return _cmdBuf->DefragmentMemory( maxBytesToMove );
+		}
+
+		Task  AddTask (const SubmitRenderPass &task)			override	{ return _AddTask( ECaptureCmd::SubmitRenderPass, task ); }
+		Task  AddTask (const DispatchCompute &task)				override	{ return _AddTask( ECaptureCmd::DispatchCompute, task ); }
+		Task  AddTask (const DispatchComputeIndirect &task)		override	{ return _AddTask( ECaptureCmd::DispatchComputeIndirect, task ); }
+		Task  AddTask (const CopyBuffer &task)					override	{ return _AddTask( ECaptureCmd::CopyBuffer, task ); }
+		Task  AddTask (const CopyImage &task)					override	{ return _AddTask( ECaptureCmd::CopyImage, task ); }
+		Task  AddTask (const CopyBufferToImage &task)			override	{ return _AddTask( ECaptureCmd::CopyBufferToImage, task ); }
+		Task  AddTask (const CopyImageToBuffer &task)			override	{ return _AddTask( ECaptureCmd::CopyImageToBuffer, task ); }
+		Task  AddTask (const BlitImage &task)					override	{ return _AddTask( ECaptureCmd::BlitImage, task ); }
+		Task  AddTask (const ResolveImage &task)				override	{ return _AddTask( ECaptureCmd::ResolveImage, task ); }
+		Task  AddTask (const GenerateMipmaps &task)				override	{ return _AddTask( ECaptureCmd::GenerateMipmaps, task ); }
+		Task  AddTask (const FillBuffer &task)					override	{ return _AddTask( ECaptureCmd::FillBuffer, task ); }
+		Task  AddTask (const ClearColorImage &task)				override	{ return _AddTask( ECaptureCmd::ClearColorImage, task ); }
+		Task  AddTask (const ClearDepthStencilImage &task)		override	{ return _AddTask( ECaptureCmd::ClearDepthStencilImage, task ); }
+		Task  AddTask (const UpdateBuffer &task)				override	{ return _AddTask( ECaptureCmd::UpdateBuffer, task ); }
+		Task  AddTask (const UpdateImage &task)					override	{ return _AddTask( ECaptureCmd::UpdateImage, task ); }
+		Task  AddTask (const ReadBuffer &task)					override	{ return _AddTask( ECaptureCmd::ReadBuffer, task ); }
+		Task  AddTask (const ReadImage &task)					override	{ return _AddTask( ECaptureCmd::ReadImage, task ); }
+		Task  AddTask (const Present &task)						override	{ return _AddUnsupportedTask( task ); }
+		Task  AddTask (const UpdateRayTracingShaderTable &task)	override	{ return _AddUnsupportedTask( task ); }
+		Task  AddTask (const BuildRayTracingGeometry &task)		override	{ return _AddUnsupportedTask( task ); }
+		Task  AddTask (const BuildRayTracingScene &task)		override	{ return _AddUnsupportedTask( task ); }
+		Task  AddTask (const TraceRays &task)					override	{ return _AddUnsupportedTask( task ); }
+		Task  AddTask (const CustomTask &task)					override	{ return _AddUnsupportedTask( task ); }
+
+		bool  BeginShaderTimeMap (const uint2 &dim, EShaderStages stages) override
+		{
+			_WriteUnsupported( "BeginShaderTimeMap" );
+			return _cmdBuf->BeginShaderTimeMap( dim, stages );
+		}
+
+		Task  EndShaderTimeMap (RawImageID dstImage, ImageLayer layer, MipmapLevel level, ArrayView<Task> dependsOn) override
+		{
+			Task	task = _cmdBuf->EndShaderTimeMap( dstImage, layer, level, dependsOn );
+			_Write( ECaptureCmd::UnsupportedTask, String{"EndShaderTimeMap"} );
+			_writer.AddTask( task );
+			return task;
+		}
+
+		LogicalPassID  CreateRenderPass (const RenderPassDesc &desc) override
+		{
+			LogicalPassID	id = _cmdBuf->CreateRenderPass( desc );
+			if ( id )
+				_Write( ECaptureCmd::CreateRenderPass, id, desc );
+			return id;
+		}
+
+		void  AddTask (LogicalPassID pass, const DrawVertices &task)			override	{ _AddDrawTask( ECaptureCmd::DrawVertices, pass, task ); }
+		void  AddTask (LogicalPassID pass, const DrawIndexed &task)				override	{ _AddDrawTask( ECaptureCmd::DrawIndexed, pass, task ); }
+		void  AddTask (LogicalPassID pass, const DrawVerticesIndirect &task)	override	{ _AddDrawTask( ECaptureCmd::DrawVerticesIndirect, pass, task ); }
+		void  AddTask (LogicalPassID pass, const DrawIndexedIndirect &task)		override	{ _AddDrawTask( ECaptureCmd::DrawIndexedIndirect, pass, task ); }
+
+		void  AddTask (LogicalPassID pass, const DrawMeshes &task) override
+		{
+			_WriteUnsupported( task.taskName );
+			_cmdBuf->AddTask( pass, task );
+		}
+
+		void  AddTask (LogicalPassID pass, const DrawMeshesIndirect &task) override
+		{
+			_WriteUnsupported( task.taskName );
+			_cmdBuf->AddTask( pass, task );
+		}
+
+		void  AddTask (LogicalPassID pass, const CustomDraw &task) override
+		{
+			_WriteUnsupported( task.taskName );
+			_cmdBuf->AddTask( pass, task );
+		}
+
+
+	private:
+		template <typename ...Args>
+		void  _Write (ECaptureCmd cmd, const Args& ...args)
+		{
+			const size_t	pos = _writer.BeginRecord( cmd );
+			CaptureSerializer::All( _writer, const_cast<Args &>(args)... );
+			_writer.EndRecord( pos );
+		}
+
+		void  _WriteUnsupported (StringView name)
+		{
+			_Write( ECaptureCmd::Unsupported, String{name} );
+		}
+
+		template <typename T>
+		Task  _AddTask (ECaptureCmd cmd, const T &task)
+		{
+			// dependencies are serialized before the new task is registered
+			Task	result = _cmdBuf->AddTask( task );
+			_Write( cmd, task );
+			_writer.AddTask( result );
+			return result;
+		}
+
+		template <typename T>
+		Task  _AddUnsupportedTask (const T &task)
+		{
+			Task	result = _cmdBuf->AddTask( task );
+			_Write( ECaptureCmd::UnsupportedTask, String{task.taskName} );
+			_writer.AddTask( result );
+			return result;
+		}
+
+		template <typename T>
+		void  _AddDrawTask (ECaptureCmd cmd, LogicalPassID pass, const T &task)
+		{
+			_Write( cmd, pass, task );
+			_cmdBuf->AddTask( pass, task );
+		}
+	};
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	FrameGraphCapture::FrameGraphCapture (const FrameGraph &fg, const SharedPtr<WStream> &stream) :
+		_frameGraph{ fg }, _stream{ stream }
+	{}
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	FrameGraphCapture::~FrameGraphCapture ()
+	{
+		if ( _stream )
+			_stream->Flush();
+	}
+
+/*
+=================================================
+	Create
+=================================================
+*/
+	FrameGraph  FrameGraphCapture::Create (const FrameGraph &fg, const SharedPtr<WStream> &stream)
+	{
+		CHECK_ERR( fg and stream and stream->IsOpen() );
+		const CaptureHeader	header;
+		CHECK_ERR( stream->Write( &header, BytesU::SizeOf(header) ));
+
+		return MakeShared<FrameGraphCapture>( fg, stream );
+	}
+
+/*
+=================================================
+	_Write
+----
+	'_guard' must be locked
+=================================================
+*/
+	void  FrameGraphCapture::_Write (const CaptureWriter &writer)
+	{
+		CHECK( _stream->Write( writer.GetData() ));
+	}
+
+	void  FrameGraphCapture::_WriteCmd (ECaptureCmd cmd)
+	{
+		CaptureWriter	writer;
+		writer.EndRecord( writer.BeginRecord( cmd ));
+
+		EXLOCK( _guard );
+		_Write( writer );
+	}
+
+	template <typename ID>
+	void  FrameGraphCapture::_WriteRelease (ECaptureCmd cmd, const ID &id)
+	{
+		if ( not id )
+			return;
+
+		CaptureWriter	writer;
+		const size_t	pos = writer.BeginRecord( cmd );
+		writer.POD( id.Get().Data() );
+		writer.EndRecord( pos );
+
+		EXLOCK( _guard );
+		_Write( writer );
+	}
+
+/*
+=================================================
+	_GetCmdIndex
+=================================================
+*/
+	uint  FrameGraphCapture::_GetCmdIndex (const CommandBuffer &cmd) const
+	{
+		EXLOCK( _guard );
+		auto	iter = _batchIndices.find( cmd.GetBatch() );
+		return iter != _batchIndices.end() ? iter->second : UMax;
+	}
+
+/*
+=================================================
+	Deinitialize
+=================================================
+*/
+	void  FrameGraphCapture::Deinitialize ()
+	{
+		{
+			EXLOCK( _guard );
+			_stream->Flush();
+			_cmdBuffers.clear();
+			_batchIndices.clear();
+		}
+		_frameGraph->Deinitialize();
+	}
+
+/*
+=================================================
+	forward
+=================================================
+*/
+	bool  FrameGraphCapture::AddPipelineCompiler (const PipelineCompiler &comp)
+	{
+		return _frameGraph->AddPipelineCompiler( comp );
+	}
+
+	bool  FrameGraphCapture::LoadPipelineCache (NtStringView filename)
+	{
+		return _frameGraph->LoadPipelineCache( filename );
+	}
+
+	bool  FrameGraphCapture::SavePipelineCache (NtStringView filename)
+	{
+		return _frameGraph->SavePipelineCache( filename );
+	}
+
+	bool  FrameGraphCapture::SetShaderDebugCallback (ShaderDebugCallback_t &&cb)
+	{
+		return _frameGraph->SetShaderDebugCallback( std::move(cb) );
+	}
+
+	bool  FrameGraphCapture::SetReadbackExecutor (ReadbackExecutor_t &&executor)
+	{
+		return _frameGraph->SetReadbackExecutor( std::move(executor) );
+	}
+
+	bool  FrameGraphCapture::SetMemoryBudgetCallback (float softBudget, MemoryBudgetCallback_t &&cb)
+	{
+		return _frameGraph->SetMemoryBudgetCallback( softBudget, std::move(cb) );
+	}
+
+	IFrameGraph::DeviceInfo_t  FrameGraphCapture::GetDeviceInfo () const
+	{
+		return _frameGraph->GetDeviceInfo();
+	}
+
+	EQueueUsage  FrameGraphCapture::GetAvilableQueues () const
+	{
+		return _frameGraph->GetAvilableQueues();
+	}
+
+/*
+=================================================
+	CreatePipeline
+----
+	description is serialized before compilation
+=================================================
+*/
+	MPipelineID  FrameGraphCapture::CreatePipeline (INOUT MeshPipelineDesc &desc, StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreatePipeline( INOUT desc, dbgName );
+	}
+
+	RTPipelineID  FrameGraphCapture::CreatePipeline (INOUT RayTracingPipelineDesc &desc)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreatePipeline( INOUT desc );
+	}
+
+	GPipelineID  FrameGraphCapture::CreatePipeline (INOUT GraphicsPipelineDesc &desc, StringView dbgName)
+	{
+		CaptureWriter	desc_data;
+		CaptureSerializer::Serialize( desc_data, desc );
+
+		GPipelineID		id = _frameGraph->CreatePipeline( INOUT desc, dbgName );
+		if ( id )
+		{
+			CaptureWriter	writer;
+			String			name{ dbgName };
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::CreateGraphicsPipeline );
+			writer.POD( id.Get().Data() );
+			writer.Bytes( desc_data.GetData().data(), desc_data.GetData().size() );
+			CaptureSerializer::Serialize( writer, name );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return id;
+	}
+
+	CPipelineID  FrameGraphCapture::CreatePipeline (INOUT ComputePipelineDesc &desc, StringView dbgName)
+	{
+		CaptureWriter	desc_data;
+		CaptureSerializer::Serialize( desc_data, desc );
+
+		CPipelineID		id = _frameGraph->CreatePipeline( INOUT desc, dbgName );
+		if ( id )
+		{
+			CaptureWriter	writer;
+			String			name{ dbgName };
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::CreateComputePipeline );
+			writer.POD( id.Get().Data() );
+			writer.Bytes( desc_data.GetData().data(), desc_data.GetData().size() );
+			CaptureSerializer::Serialize( writer, name );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return id;
+	}
+
+/*
+=================================================
+	CreateImage
+=================================================
+*/
+	ImageID  FrameGraphCapture::CreateImage (const ImageDesc &desc, const MemoryDesc &mem, StringView dbgName)
+	{
+		return CreateImage( desc, mem, Default, dbgName );
+	}
+
+	ImageID  FrameGraphCapture::CreateImage (const ImageDesc &desc, const MemoryDesc &mem, EResourceState defaultState, StringView dbgName)
+	{
+		ImageID		id = _frameGraph->CreateImage( desc, mem, defaultState, dbgName );
+		if ( id )
+		{
+			CaptureWriter	writer;
+			ImageDesc		img_desc	= desc;
+			MemoryDesc		mem_desc	= mem;
+			String			name		{ dbgName };
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::CreateImage );
+			writer.POD( id.Get().Data() );
+			CaptureSerializer::All( writer, img_desc, mem_desc, defaultState, name );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return id;
+	}
+
+	ImageID  FrameGraphCapture::CreateImage (const ExternalImageDesc_t &desc, OnExternalImageReleased_t &&onRelease, StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreateImage( desc, std::move(onRelease), dbgName );
+	}
+
+/*
+=================================================
+	CreateBuffer
+=================================================
+*/
+	BufferID  FrameGraphCapture::CreateBuffer (const BufferDesc &desc, const MemoryDesc &mem, StringView dbgName)
+	{
+		BufferID	id = _frameGraph->CreateBuffer( desc, mem, dbgName );
+		if ( id )
+		{
+			CaptureWriter	writer;
+			BufferDesc		buf_desc	= desc;
+			MemoryDesc		mem_desc	= mem;
+			String			name		{ dbgName };
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::CreateBuffer );
+			writer.POD( id.Get().Data() );
+			CaptureSerializer::All( writer, buf_desc, mem_desc, name );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return id;
+	}
+
+	BufferID  FrameGraphCapture::CreateBuffer (const ExternalBufferDesc_t &desc, OnExternalBufferReleased_t &&onRelease, StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreateBuffer( desc, std::move(onRelease), dbgName );
+	}
+
+/*
+=================================================
+	CreateSampler
+=================================================
+*/
+	SamplerID  FrameGraphCapture::CreateSampler (const SamplerDesc &desc, StringView dbgName)
+	{
+		SamplerID	id = _frameGraph->CreateSampler( desc, dbgName );
+		if ( id )
+		{
+			CaptureWriter	writer;
+			SamplerDesc		samp_desc	= desc;
+			String			name		{ dbgName };
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::CreateSampler );
+			writer.POD( id.Get().Data() );
+			CaptureSerializer::All( writer, samp_desc, name );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return id;
+	}
+
+/*
+=================================================
+	not captured
+=================================================
+*/
+	SwapchainID  FrameGraphCapture::CreateSwapchain (const SwapchainCreateInfo_t &info, RawSwapchainID oldSwapchain, StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreateSwapchain( info, oldSwapchain, dbgName );
+	}
+
+	RTGeometryID  FrameGraphCapture::CreateRayTracingGeometry (const RayTracingGeometryDesc &desc, const MemoryDesc &mem, StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreateRayTracingGeometry( desc, mem, dbgName );
+	}
+
+	RTSceneID  FrameGraphCapture::CreateRayTracingScene (const RayTracingSceneDesc &desc, const MemoryDesc &mem, StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreateRayTracingScene( desc, mem, dbgName );
+	}
+
+	RTShaderTableID  FrameGraphCapture::CreateRayTracingShaderTable (StringView dbgName)
+	{
+		_WriteCmd( ECaptureCmd::Unsupported );
+		return _frameGraph->CreateRayTracingShaderTable( dbgName );
+	}
+
+/*
+=================================================
+	InitPipelineResources
+----
+	pipeline resources are captured as part of the task
+=================================================
+*/
+	bool  FrameGraphCapture::InitPipelineResources (RawGPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const
+	{
+		return _frameGraph->InitPipelineResources( pplnId, id, OUT resources );
+	}
+
+	bool  FrameGraphCapture::InitPipelineResources (RawCPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const
+	{
+		return _frameGraph->InitPipelineResources( pplnId, id, OUT resources );
+	}
+
+	bool  FrameGraphCapture::InitPipelineResources (RawMPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const
+	{
+		return _frameGraph->InitPipelineResources( pplnId, id, OUT resources );
+	}
+
+	bool  FrameGraphCapture::InitPipelineResources (RawRTPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const
+	{
+		return _frameGraph->InitPipelineResources( pplnId, id, OUT resources );
+	}
+
+	bool  FrameGraphCapture::CachePipelineResources (INOUT PipelineResources &resources)
+	{
+		return _frameGraph->CachePipelineResources( INOUT resources );
+	}
+
+/*
+=================================================
+	ReleaseResource
+=================================================
+*/
+	void  FrameGraphCapture::ReleaseResource (INOUT PipelineResources &resources)
+	{
+		_frameGraph->ReleaseResource( INOUT resources );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT GPipelineID &id)
+	{
+		_WriteRelease( ECaptureCmd::ReleaseGraphicsPipeline, id );
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT CPipelineID &id)
+	{
+		_WriteRelease( ECaptureCmd::ReleaseComputePipeline, id );
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT MPipelineID &id)
+	{
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT RTPipelineID &id)
+	{
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT ImageID &id)
+	{
+		_WriteRelease( ECaptureCmd::ReleaseImage, id );
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT BufferID &id)
+	{
+		_WriteRelease( ECaptureCmd::ReleaseBuffer, id );
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT SamplerID &id)
+	{
+		_WriteRelease( ECaptureCmd::ReleaseSampler, id );
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT SwapchainID &id)
+	{
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT RTGeometryID &id)
+	{
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT RTSceneID &id)
+	{
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+	void  FrameGraphCapture::ReleaseResource (INOUT RTShaderTableID &id)
+	{
+		_frameGraph->ReleaseResource( INOUT id );
+	}
+
+/*
+=================================================
+	IsSupported
+=================================================
+*/
+	bool  FrameGraphCapture::IsSupported (RawImageID image, const ImageViewDesc &desc) const
+	{
+		return _frameGraph->IsSupported( image, desc );
+	}
+
+	bool  FrameGraphCapture::IsSupported (RawBufferID buffer, const BufferViewDesc &desc) const
+	{
+		return _frameGraph->IsSupported( buffer, desc );
+	}
+
+	bool  FrameGraphCapture::IsSupported (const ImageDesc &desc, EMemoryType memType) const
+	{
+		return _frameGraph->IsSupported( desc, memType );
+	}
+
+	bool  FrameGraphCapture::IsSupported (const BufferDesc &desc, EMemoryType memType) const
+	{
+		return _frameGraph->IsSupported( desc, memType );
+	}
+
+/*
+=================================================
+	GetDescription
+=================================================
+*/
+	BufferDesc const&  FrameGraphCapture::GetDescription (RawBufferID id) const
+	{
+		return _frameGraph->GetDescription( id );
+	}
+
+	ImageDesc const&  FrameGraphCapture::GetDescription (RawImageID id) const
+	{
+		return _frameGraph->GetDescription( id );
+	}
+
+	IFrameGraph::ExternalBufferDesc_t  FrameGraphCapture::GetApiSpecificDescription (RawBufferID id) const
+	{
+		return _frameGraph->GetApiSpecificDescription( id );
+	}
+
+	IFrameGraph::ExternalImageDesc_t  FrameGraphCapture::GetApiSpecificDescription (RawImageID id) const
+	{
+		return _frameGraph->GetApiSpecificDescription( id );
+	}
+
+/*
+=================================================
+	UpdateHostBuffer
+=================================================
+*/
+	bool  FrameGraphCapture::UpdateHostBuffer (RawBufferID id, BytesU offset, BytesU size, const void *data)
+	{
+		bool	res = _frameGraph->UpdateHostBuffer( id, offset, size, data );
+		if ( res )
+		{
+			CaptureWriter		writer;
+			ArrayView<uint8_t>	content{ Cast<uint8_t>(data), size_t(size) };
+			const size_t		pos = writer.BeginRecord( ECaptureCmd::UpdateHostBuffer );
+			CaptureSerializer::All( writer, id, offset, content );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return res;
+	}
+
+/*
+=================================================
+	MapBufferRange
+----
+	memory content is not captured
+=================================================
+*/
+	bool  FrameGraphCapture::MapBufferRange (RawBufferID id, BytesU offset, INOUT BytesU &size, OUT void* &data)
+	{
+		return _frameGraph->MapBufferRange( id, offset, INOUT size, OUT data );
+	}
+
+/*
+=================================================
+	Begin
+=================================================
+*/
+	CommandBuffer  FrameGraphCapture::Begin (const CommandBufferDesc &desc, ArrayView<CommandBuffer> dependsOn)
+	{
+		CommandBuffer	cmd = _frameGraph->Begin( desc, dependsOn );
+		CHECK_ERR( cmd );
+
+		EXLOCK( _guard );
+
+		auto&	proxy = _cmdBuffers[ cmd.GetCommandBuffer() ];
+		if ( not proxy )
+			proxy.reset( new CaptureCommandBuffer{ *this, cmd.GetCommandBuffer() });
+
+		const uint	index = _cmdBufferCounter++;
+		proxy->Begin( index );
+		_batchIndices.insert_or_assign( cmd.GetBatch(), index );
+
+		Array<uint>		deps;
+		for (auto& dep : dependsOn)
+		{
+			auto	iter = _batchIndices.find( dep.GetBatch() );
+			if ( iter != _batchIndices.end() )
+				deps.push_back( iter->second );
+		}
+
+		CaptureWriter	writer;
+		String			name		{ desc.name };
+		EQueueType		queue		= desc.queueType;
+		EDebugFlags		dbg_flags	= desc.debugFlags;
+		ECompilationFlags comp_flags= desc.compilationFlags;
+		const size_t	pos = writer.BeginRecord( ECaptureCmd::Begin );
+		writer.POD( index );
+		CaptureSerializer::All( writer, queue, dbg_flags, comp_flags, name, deps );
+		writer.EndRecord( pos );
+		_Write( writer );
+
+		return CommandBuffer{ proxy.get(), cmd.GetBatch() };
+	}
+
+/*
+=================================================
+	Execute
+----
+	command buffer content is written as nested records
+=================================================
+*/
+	bool  FrameGraphCapture::Execute (INOUT CommandBuffer &cmd)
+	{
+		CHECK_ERR( cmd and cmd.GetCommandBuffer() );
+
+		auto*	proxy = Cast<CaptureCommandBuffer>( cmd.GetCommandBuffer() );
+		{
+			CaptureWriter	writer;
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::Execute );
+			writer.POD( proxy->GetIndex() );
+			writer.Bytes( proxy->GetData().data(), proxy->GetData().size() );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+
+		CommandBuffer	orig{ proxy->GetOriginal(), cmd.GetBatch() };
+		proxy->Begin( UMax );
+
+		bool	res = _frameGraph->Execute( INOUT orig );
+		cmd = std::move(orig);
+		return res;
+	}
+
+/*
+=================================================
+	Wait
+=================================================
+*/
+	bool  FrameGraphCapture::Wait (ArrayView<CommandBuffer> commands, Nanoseconds timeout)
+	{
+		{
+			Array<uint>		indices;
+			CaptureWriter	writer;
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::Wait );
+
+			EXLOCK( _guard );
+			for (auto& cmd : commands)
+			{
+				auto	iter = _batchIndices.find( cmd.GetBatch() );
+				if ( iter != _batchIndices.end() )
+					indices.push_back( iter->second );
+			}
+			CaptureSerializer::All( writer, indices, timeout );
+			writer.EndRecord( pos );
+			_Write( writer );
+		}
+
+		if ( not _frameGraph->Wait( commands, timeout ))
+			return false;
+
+		// batches are complete and may be recycled, dependencies on them are not needed anymore
+		EXLOCK( _guard );
+		for (auto& cmd : commands) {
+			_batchIndices.erase( cmd.GetBatch() );
+		}
+		return true;
+	}
+
+/*
+=================================================
+	Flush
+=================================================
+*/
+	bool  FrameGraphCapture::Flush (EQueueUsage queues)
+	{
+		{
+			CaptureWriter	writer;
+			const size_t	pos = writer.BeginRecord( ECaptureCmd::Flush );
+			writer.POD( queues );
+			writer.EndRecord( pos );
+
+			EXLOCK( _guard );
+			_Write( writer );
+		}
+		return _frameGraph->Flush( queues );
+	}
+
+/*
+=================================================
+	WaitIdle
+=================================================
+*/
+	bool  FrameGraphCapture::WaitIdle ()
+	{
+		_WriteCmd( ECaptureCmd::WaitIdle );
+
+		if ( not _frameGraph->WaitIdle() )
+			return false;
+
+		EXLOCK( _guard );
+		_batchIndices.clear();
+		return true;
+	}
+
+/*
+=================================================
+	debugging
+=================================================
+*/
+	bool  FrameGraphCapture::GetStatistics (OUT Statistics &result) const
+	{
+		return _frameGraph->GetStatistics( OUT result );
+	}
+
+	bool  FrameGraphCapture::DumpToString (OUT String &result) const
+	{
+		return _frameGraph->DumpToString( OUT result );
+	}
+
+	bool  FrameGraphCapture::DumpToGraphViz (OUT String &result) const
+	{
+		return _frameGraph->DumpToGraphViz( OUT result );
+	}
+
+
+}	// FG
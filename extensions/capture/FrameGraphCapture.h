@@ -0,0 +1,135 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Frame graph wrapper that writes resource descriptions, pipelines and command buffers into the binary stream
+	and forwards all calls to the wrapped frame graph.
+	Use 'CaptureReplayer' or 'FGReplay' tool to replay the stream.
+
+	Not captured:
+		ray tracing, mesh shading, swapchain, external resources and external commands,
+		custom tasks and custom draw calls, content of the mapped memory.
+*/
+
+#pragma once
+
+#include "extensions/capture/CaptureFormat.h"
+#include "stl/Stream/Stream.h"
+
+namespace FG
+{
+
+	//
+	// Frame Graph Capture
+	//
+
+	class FrameGraphCapture final : public IFrameGraph
+	{
+	// types
+	private:
+		class CaptureCommandBuffer;
+
+		using CmdBuffers_t		= HashMap< const ICommandBuffer *, UniquePtr< CaptureCommandBuffer >>;
+		using BatchIndices_t	= HashMap< const CommandBuffer::Batch *, uint >;
+
+
+	// variables
+	private:
+		FrameGraph				_frameGraph;
+		SharedPtr<WStream>		_stream;
+
+		mutable Mutex			_guard;
+		CmdBuffers_t			_cmdBuffers;		// key is original command buffer
+		BatchIndices_t			_batchIndices;		// batch -> capture index, entries are removed after 'Wait' and 'WaitIdle',
+													// recycled batch overrides the previous entry in 'Begin', so size is limited by the batch pool
+		uint					_cmdBufferCounter	= 0;
+
+
+	// methods
+	public:
+		FrameGraphCapture (const FrameGraph &fg, const SharedPtr<WStream> &stream);
+		~FrameGraphCapture ();
+
+		// writes header and returns wrapper
+		ND_ static FrameGraph  Create (const FrameGraph &fg, const SharedPtr<WStream> &stream);
+
+		ND_ FrameGraph const&  GetWrapped () const	{ return _frameGraph; }
+
+
+		// IFrameGraph //
+		void			Deinitialize () override;
+		bool			AddPipelineCompiler (const PipelineCompiler &comp) override;
+		bool			LoadPipelineCache (NtStringView filename) override;
+		bool			SavePipelineCache (NtStringView filename) override;
+		bool			SetShaderDebugCallback (ShaderDebugCallback_t &&) override;
+		bool			SetReadbackExecutor (ReadbackExecutor_t &&) override;
+		bool			SetMemoryBudgetCallback (float softBudget, MemoryBudgetCallback_t &&) override;
+		DeviceInfo_t	GetDeviceInfo () const override;
+		EQueueUsage		GetAvilableQueues () const override;
+
+		MPipelineID		CreatePipeline (INOUT MeshPipelineDesc &desc, StringView dbgName) override;
+		RTPipelineID	CreatePipeline (INOUT RayTracingPipelineDesc &desc) override;
+		GPipelineID		CreatePipeline (INOUT GraphicsPipelineDesc &desc, StringView dbgName) override;
+		CPipelineID		CreatePipeline (INOUT ComputePipelineDesc &desc, StringView dbgName) override;
+		ImageID			CreateImage (const ImageDesc &desc, const MemoryDesc &mem, StringView dbgName) override;
+		ImageID			CreateImage (const ImageDesc &desc, const MemoryDesc &mem, EResourceState defaultState, StringView dbgName) override;
+		BufferID		CreateBuffer (const BufferDesc &desc, const MemoryDesc &mem, StringView dbgName) override;
+		ImageID			CreateImage (const ExternalImageDesc_t &desc, OnExternalImageReleased_t &&, StringView dbgName) override;
+		BufferID		CreateBuffer (const ExternalBufferDesc_t &desc, OnExternalBufferReleased_t &&, StringView dbgName) override;
+		SamplerID		CreateSampler (const SamplerDesc &desc, StringView dbgName) override;
+		SwapchainID		CreateSwapchain (const SwapchainCreateInfo_t &, RawSwapchainID oldSwapchain, StringView dbgName) override;
+		RTGeometryID	CreateRayTracingGeometry (const RayTracingGeometryDesc &desc, const MemoryDesc &mem, StringView dbgName) override;
+		RTSceneID		CreateRayTracingScene (const RayTracingSceneDesc &desc, const MemoryDesc &mem, StringView dbgName) override;
+		RTShaderTableID	CreateRayTracingShaderTable (StringView dbgName) override;
+		bool			InitPipelineResources (RawGPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const override;
+		bool			InitPipelineResources (RawCPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const override;
+		bool			InitPipelineResources (RawMPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const override;
+		bool			InitPipelineResources (RawRTPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) const override;
+		bool			CachePipelineResources (INOUT PipelineResources &resources) override;
+		void			ReleaseResource (INOUT PipelineResources &resources) override;
+		void			ReleaseResource (INOUT GPipelineID &id) override;
+		void			ReleaseResource (INOUT CPipelineID &id) override;
+		void			ReleaseResource (INOUT MPipelineID &id) override;
+		void			ReleaseResource (INOUT RTPipelineID &id) override;
+		void			ReleaseResource (INOUT ImageID &id) override;
+		void			ReleaseResource (INOUT BufferID &id) override;
+		void			ReleaseResource (INOUT SamplerID &id) override;
+		void			ReleaseResource (INOUT SwapchainID &id) override;
+		void			ReleaseResource (INOUT RTGeometryID &id) override;
+		void			ReleaseResource (INOUT RTSceneID &id) override;
+		void			ReleaseResource (INOUT RTShaderTableID &id) override;
+
+		bool			IsSupported (RawImageID image, const ImageViewDesc &desc) const override;
+		bool			IsSupported (RawBufferID buffer, const BufferViewDesc &desc) const override;
+		bool			IsSupported (const ImageDesc &desc, EMemoryType memType) const override;
+		bool			IsSupported (const BufferDesc &desc, EMemoryType memType) const override;
+
+		BufferDesc const&	GetDescription (RawBufferID id) const override;
+		ImageDesc const&	GetDescription (RawImageID id) const override;
+		ExternalBufferDesc_t GetApiSpecificDescription (RawBufferID id) const override;
+		ExternalImageDesc_t  GetApiSpecificDescription (RawImageID id) const override;
+
+		bool			UpdateHostBuffer (RawBufferID id, BytesU offset, BytesU size, const void *data) override;
+		bool			MapBufferRange (RawBufferID id, BytesU offset, INOUT BytesU &size, OUT void* &data) override;
+
+		CommandBuffer	Begin (const CommandBufferDesc &, ArrayView<CommandBuffer> dependsOn) override;
+		bool			Execute (INOUT CommandBuffer &) override;
+		bool			Wait (ArrayView<CommandBuffer> commands, Nanoseconds timeout) override;
+		bool			Flush (EQueueUsage queues) override;
+		bool			WaitIdle () override;
+
+		bool			GetStatistics (OUT Statistics &result) const override;
+		bool			DumpToString (OUT String &result) const override;
+		bool			DumpToGraphViz (OUT String &result) const override;
+
+
+	private:
+		void  _Write (const CaptureWriter &);
+		void  _WriteCmd (ECaptureCmd cmd);
+
+		template <typename ID>
+		void  _WriteRelease (ECaptureCmd cmd, const ID &id);
+
+		ND_ uint  _GetCmdIndex (const CommandBuffer &) const;
+	};
+
+
+}	// FG
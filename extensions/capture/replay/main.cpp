@@ -0,0 +1,125 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Headless capture replay.
+
+	FGReplay <capture file> [--device <name>] [--repeat <count>]
+
+	'--device' selects physical device by name, use it to replay on
+	software implementation like 'llvmpipe' or 'SwiftShader'.
+*/
+
+#include "extensions/capture/CaptureReplayer.h"
+#include "pipeline_compiler/VPipelineCompiler.h"
+#include "framework/Vulkan/VulkanDeviceExt.h"
+#include "stl/Algorithms/StringUtils.h"
+using namespace FG;
+
+
+/*
+=================================================
+	PrintStatistics
+=================================================
+*/
+static void  PrintStatistics (uint pass, const CaptureReplayer::Statistics &stats)
+{
+	FG_LOGI( "pass "s << ToString( pass ) << ":"
+		<< "\n  command buffers:  " << ToString( stats.commandBuffers )
+		<< "\n  tasks:            " << ToString( stats.tasks )
+		<< "\n  draw tasks:       " << ToString( stats.drawTasks )
+		<< "\n  skipped:          " << ToString( stats.skipped )
+		<< "\n  create resources: " << ToString( stats.createResources )
+		<< "\n  create pipelines: " << ToString( stats.createPipelines )
+		<< "\n  record tasks:     " << ToString( stats.recordTasks )
+		<< "\n  execute:          " << ToString( stats.execute )
+		<< "\n  wait:             " << ToString( stats.wait )
+		<< "\n  submit (fg):      " << ToString( stats.renderer.submitingTime )
+		<< "\n  wait (fg):        " << ToString( stats.renderer.waitingTime )
+		<< "\n  gpu time (fg):    " << ToString( stats.renderer.gpuTime ));
+}
+
+/*
+=================================================
+	main
+=================================================
+*/
+int main (int argc, char** argv)
+{
+	CHECK_ERR( argc > 1, 1 );
+
+	StringView	filename	= argv[1];
+	StringView	device_name;
+	uint		repeat		= 1;
+
+	for (int i = 2; i < argc; ++i)
+	{
+		StringView	key = argv[i];
+		StringView	value;
+
+		if ( ++i < argc )
+			value = argv[i];
+
+		if ( key == "--device" )
+			device_name = value;
+		else
+		if ( key == "--repeat" )
+			repeat = Max( 1u, uint(std::strtoul( value.data(), null, 10 )));
+		else
+			RETURN_ERR( "unsupported command arg: "s << key, 2 );
+	}
+
+	CaptureReplayer		replayer;
+	CHECK_ERR( replayer.Load( NtStringView{filename} ), 3 );
+
+	// create vulkan device without surface
+	VulkanDeviceExt		vulkan;
+	CHECK_ERR( vulkan.Create( "FGReplay", "FrameGraph", VK_API_VERSION_1_2,
+							  device_name,
+							  {{ VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0.0f },
+							   { VK_QUEUE_COMPUTE_BIT,  0.0f },
+							   { VK_QUEUE_TRANSFER_BIT, 0.0f }},
+							  VulkanDevice::GetRecomendedInstanceLayers(),
+							  VulkanDevice::GetRecomendedInstanceExtensions(),
+							  VulkanDevice::GetAllDeviceExtensions_v110()
+							), 4 );
+
+	VulkanDeviceInfo	vulkan_info;
+	vulkan_info.instance		= BitCast<InstanceVk_t>( vulkan.GetVkInstance() );
+	vulkan_info.physicalDevice	= BitCast<PhysicalDeviceVk_t>( vulkan.GetVkPhysicalDevice() );
+	vulkan_info.device			= BitCast<DeviceVk_t>( vulkan.GetVkDevice() );
+
+	for (auto& q : vulkan.GetVkQueues())
+	{
+		VulkanDeviceInfo::QueueInfo	qi;
+		qi.handle		= BitCast<QueueVk_t>( q.handle );
+		qi.familyFlags	= BitCast<QueueFlagsVk_t>( q.flags );
+		qi.familyIndex	= q.familyIndex;
+		qi.priority		= q.priority;
+		qi.debugName	= "";
+
+		vulkan_info.queues.push_back( qi );
+	}
+
+	bool	result = true;
+	{
+		FrameGraph	fg = IFrameGraph::CreateFrameGraph( vulkan_info );
+		CHECK_ERR( fg, 5 );
+
+		auto	compiler = MakeShared<VPipelineCompiler>( vulkan_info.instance, vulkan_info.physicalDevice, vulkan_info.device );
+		compiler->SetCompilationFlags( EShaderCompilationFlags::Quiet				|
+									   EShaderCompilationFlags::ParseAnnotations	|
+									   EShaderCompilationFlags::UseCurrentDeviceLimits );
+		fg->AddPipelineCompiler( compiler );
+
+		for (uint i = 0; result and i < repeat; ++i)
+		{
+			CaptureReplayer::Statistics	stats;
+			result = replayer.Replay( fg, OUT stats );
+			PrintStatistics( i, stats );
+		}
+
+		fg->Deinitialize();
+	}
+
+	vulkan.Destroy();
+	return result ? 0 : 6;
+}
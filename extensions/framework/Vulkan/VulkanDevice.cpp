@@ -213,6 +213,9 @@ namespace FGC
 			#ifdef VK_KHR_spirv_1_4
 				VK_KHR_SPIRV_1_4_EXTENSION_NAME,
 			#endif
+			#ifdef VK_EXT_pipeline_creation_feedback
+				VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME,
+			#endif
 
 			// Vendor specific extensions
 			#ifdef VK_NV_mesh_shader
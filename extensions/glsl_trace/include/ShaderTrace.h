@@ -56,10 +56,26 @@ public:
 		std::vector<LineRange>	lines;		// offset in bytes for each line in 'code'
 	};
 
+	// trace of single shader invocation without conversion to string
+	struct InvocationTrace
+	{
+		struct Record
+		{
+			uint32_t	exprID;			// index in 'GetExprInfos()'
+			uint32_t	type;			// bits 0..7 - glslang::TBasicType or 'TBasicType_Clock', 8..11 - rows, 12..15 - columns
+			uint32_t	valueOffset;	// index in 'values'
+			uint32_t	valueCount;
+		};
+
+		std::vector<Record>		records;
+		std::vector<uint32_t>	values;		// raw data, 64 bit value and clock use 2 components
+	};
+
 	using VarNames_t	= std::unordered_map< VariableID, std::string >;
 	using ExprInfos_t	= std::vector< ExprInfo >;
 	using Sources_t		= std::vector< SourceInfo >;
 	using FileMap_t		= std::unordered_map< std::string, uint32_t >;	// index in '_sources'
+	using InvocationTraces_t	= std::vector< InvocationTrace >;
 
 	static constexpr int	TBasicType_Clock = 0xcc;	// 4x uint64
 
@@ -87,7 +103,17 @@ public:
 	//bool InsertDebugAsserts (glslang::TIntermediate &, uint32_t descSetIndex);
 	//bool InsertInstructionCounter (glslang::TIntermediate &, uint32_t descSetIndex);
 	
-	bool ParseShaderTrace (const void *ptr, uint64_t maxSize, std::vector<std::string> &result) const;
+	// 'threadCount' - number of threads to parse invocations in parallel, 0 - use all hardware threads
+	bool ParseShaderTrace (const void *ptr, uint64_t maxSize, std::vector<std::string> &result, uint32_t threadCount = 1) const;
+	bool ParseShaderTrace (const void *ptr, uint64_t maxSize, InvocationTraces_t &result, uint32_t threadCount = 1) const;
+
+	ExprInfos_t const&	GetExprInfos ()			const	{ return _exprLocations; }
+	VarNames_t const&	GetVarNames ()			const	{ return _varNames; }
+
+	// debug storage buffer layout
+	uint64_t			GetPositionOffset ()	const	{ return _posOffset; }
+	uint64_t			GetDataOffset ()		const	{ return _dataOffset; }
+	uint32_t			GetInitialPosition ()	const	{ return _initialPosition; }
 
 	void SetSource (const char* const* sources, const size_t *lengths, size_t count);
 	void SetSource (const char* source, size_t length);
@@ -3,6 +3,8 @@
 #include "Common.h"
 
 #include <array>
+#include <atomic>
+#include <thread>
 #include <assert.h>
 
 #include "glslang/Include/BaseTypes.h"
@@ -64,8 +66,6 @@ public:
 	using Profiling_t	= std::unordered_map< ExprInfo const*, FnExecutionDuration >;
 
 
-public:
-	uint32_t			lastPosition	= ~0u;
 private:
 	VarStates_t			_states;
 	Pending_t			_pending;
@@ -499,81 +499,261 @@ inline uint32_t  GetTypeSizeOf (TBasicType type)
 	}
 	RETURN_ERR( "not supported" );
 }
-}	// namespace
-//-----------------------------------------------------------------------------
 
+/*
+=================================================
+	RecordInfo
+=================================================
+*/
+struct RecordInfo
+{
+	uint32_t			prevPos		= 0;
+	uint32_t			exprID		= 0;
+	uint32_t			type		= 0;
+	TBasicType			basicType	= TBasicType::EbtVoid;
+	uint32_t			rows		= 0;	// for scalar, vector and matrix
+	uint32_t			cols		= 0;	// only for matrix
+	uint32_t			size		= 0;	// number of 32 bit values
+	uint32_t const*		data		= nullptr;
+};
 
+inline bool  ReadRecord (uint32_t const* ptr, OUT RecordInfo &info)
+{
+	info.prevPos	= ptr[0];
+	info.exprID		= ptr[1];
+	info.type		= ptr[2];
+	info.basicType	= TBasicType(info.type & 0xFF);
+	info.rows		= (info.type >> 8) & 0xF;
+	info.cols		= std::max(1u, (info.type >> 12) & 0xF );
+	info.data		= ptr + 3;
+
+	CHECK_ERR( (info.basicType == TBasicType::EbtVoid and info.rows == 0) or (info.rows > 0 and info.rows <= 4) );
+	CHECK_ERR( info.cols > 0 and info.cols <= 4 );
+
+	info.size = (info.rows * info.cols) * GetTypeSizeOf( info.basicType );
+	return true;
+}
 
 /*
 =================================================
-	ParseShaderTrace
+	InvocationChains
+----
+	positions of records grouped by shader invocation
 =================================================
 */
-bool  ShaderTrace::ParseShaderTrace (const void *ptr, uint64_t maxSize, OUT std::vector<std::string> &result) const
+struct InvocationChains
 {
-	result.clear();
+	std::vector<uint32_t>	records;
+	std::vector<uint32_t>	offsets;	// range in 'records' for each invocation, size = invocation count + 1
 
-	const uint64_t		count		= *(static_cast<uint32_t const*>(ptr) + _posOffset / sizeof(uint32_t));
-	uint32_t const*		start_ptr	= static_cast<uint32_t const*>(ptr) + _dataOffset / sizeof(uint32_t);
-	uint32_t const*		end_ptr		= start_ptr + std::min( count, (maxSize - _dataOffset) / sizeof(uint32_t) );
-	std::vector<Trace>	shaders;
-	
-	for (auto data_ptr = start_ptr; data_ptr < end_ptr;)
+	size_t  Count () const	{ return offsets.empty() ? 0 : offsets.size()-1; }
+};
+
+/*
+=================================================
+	SplitByInvocation
+----
+	each record contains position of the previous record from the same invocation,
+	hash map is used to find invocation by position of the last record.
+=================================================
+*/
+bool  SplitByInvocation (uint32_t const* startPtr, uint32_t const* endPtr, uint32_t initialPosition, OUT InvocationChains &chains)
+{
+	std::unordered_map< uint32_t, uint32_t >		last_pos;		// position of last record -> invocation index
+	std::vector< std::pair< uint32_t, uint32_t >>	entries;		// record position, invocation index
+	std::vector< uint32_t >							counts;
+
+	for (auto data_ptr = startPtr; data_ptr < endPtr;)
 	{
-		uint32_t		pos			= uint32_t(std::distance( start_ptr, data_ptr ));
-		uint32_t		prev_pos	= *(data_ptr++);
-		uint32_t		expr_id		= *(data_ptr++);
-		uint32_t		type		= *(data_ptr++);
-		TBasicType		t_basic		= TBasicType(type & 0xFF);
-		uint32_t		row_size	= (type >> 8) & 0xF;					// for scalar, vector and matrix
-		uint32_t		col_size	= std::max(1u, (type >> 12) & 0xF );	// only for matrix
-		uint32_t const*	data		= data_ptr;
-		Trace*			trace		= nullptr;
-
-		CHECK_ERR( (t_basic == TBasicType::EbtVoid and row_size == 0) or (row_size > 0 and row_size <= 4) );
-		CHECK_ERR( col_size > 0 and col_size <= 4 );
-
-		data_ptr += (row_size * col_size) * GetTypeSizeOf( t_basic );
-		ASSERT( data_ptr <= end_ptr );
-
-		for (auto& sh : shaders) {
-			if ( sh.lastPosition == prev_pos ) {
-				trace = &sh;
-				break;
-			}
+		const uint32_t	pos	= uint32_t(std::distance( startPtr, data_ptr ));
+		RecordInfo		rec;
+		CHECK_ERR( ReadRecord( data_ptr, OUT rec ));
+
+		data_ptr = rec.data + rec.size;
+		ASSERT( data_ptr <= endPtr );
+
+		uint32_t	inv;
+		auto		iter = last_pos.find( rec.prevPos );
+
+		if ( iter != last_pos.end() )
+		{
+			inv = iter->second;
+			last_pos.erase( iter );
 		}
-		
-		if ( not trace )
+		else
+		if ( rec.prevPos == initialPosition )
 		{
-			if ( prev_pos == _initialPosition )
-			{
-				shaders.push_back( Trace{} );
-				result.resize( shaders.size() );
-				trace = &shaders.back();
-			}
-			else
-			{
-				// this entry from another shader, skip it
-				continue;
-			}
+			inv = uint32_t(counts.size());
+			counts.push_back( 0 );
+		}
+		else
+		{
+			// this entry from another shader, skip it
+			continue;
 		}
-		
-		CHECK_ERR( expr_id < _exprLocations.size() );
 
-		auto&	expr = _exprLocations[ expr_id ];
-		auto&	str  = result[ std::distance( shaders.data(), trace )];
+		last_pos.emplace( pos, inv );
+		entries.emplace_back( pos, inv );
+		++counts[inv];
+	}
 
-		if ( t_basic == ShaderTrace::TBasicType_Clock )
-			CHECK_ERR( trace->AddTime( expr, row_size, col_size, data ))
-		else
-			CHECK_ERR( trace->AddState( expr, t_basic, row_size, col_size, data, _varNames, _sources, INOUT str ));
+	chains.offsets.resize( counts.size() + 1 );
+	chains.offsets[0] = 0;
+	for (size_t i = 0; i < counts.size(); ++i) {
+		chains.offsets[i+1] = chains.offsets[i] + counts[i];
+	}
 
-		trace->lastPosition = pos;
+	// reuse 'counts' as write cursor
+	std::copy( chains.offsets.begin(), chains.offsets.end()-1, counts.begin() );
+
+	chains.records.resize( entries.size() );
+	for (auto& e : entries) {
+		chains.records[ counts[e.second]++ ] = e.first;
 	}
+	return true;
+}
+
+/*
+=================================================
+	ForEachInvocation
+----
+	invocations are independent and can be processed in parallel
+=================================================
+*/
+template <typename Fn>
+bool  ForEachInvocation (size_t count, uint32_t threadCount, const Fn &fn)
+{
+	if ( threadCount == 0 )
+		threadCount = std::max( 1u, std::thread::hardware_concurrency() );
 
-	for (size_t i = 0; i < shaders.size(); ++i)
+	threadCount = uint32_t(std::min( size_t(threadCount), count ));
+
+	if ( threadCount <= 1 )
 	{
-		CHECK_ERR( shaders[i].Flush( _varNames, _sources, INOUT result[i] ));
+		for (size_t i = 0; i < count; ++i) {
+			CHECK_ERR( fn( i ));
+		}
+		return true;
 	}
-	return true;
+
+	static constexpr size_t		BatchSize = 16;
+
+	std::atomic<size_t>		next	{0};
+	std::atomic<bool>		result	{true};
+
+	const auto	Worker = [&] ()
+	{
+		for (;;)
+		{
+			const size_t	first = next.fetch_add( BatchSize, std::memory_order_relaxed );
+			if ( first >= count )
+				break;
+
+			for (size_t i = first, end = std::min( first + BatchSize, count ); i < end; ++i)
+			{
+				if ( not fn( i ))
+					result.store( false, std::memory_order_relaxed );
+			}
+		}
+	};
+
+	std::vector<std::thread>	threads;
+	threads.reserve( threadCount-1 );
+
+	for (uint32_t i = 1; i < threadCount; ++i) {
+		threads.emplace_back( Worker );
+	}
+	Worker();
+
+	for (auto& t : threads) {
+		t.join();
+	}
+	return result.load();
+}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	ParseShaderTrace
+=================================================
+*/
+bool  ShaderTrace::ParseShaderTrace (const void *ptr, uint64_t maxSize, OUT std::vector<std::string> &result, uint32_t threadCount) const
+{
+	result.clear();
+
+	const uint64_t		count		= *(static_cast<uint32_t const*>(ptr) + _posOffset / sizeof(uint32_t));
+	uint32_t const*		start_ptr	= static_cast<uint32_t const*>(ptr) + _dataOffset / sizeof(uint32_t);
+	uint32_t const*		end_ptr		= start_ptr + std::min( count, (maxSize - _dataOffset) / sizeof(uint32_t) );
+	InvocationChains	chains;
+
+	CHECK_ERR( SplitByInvocation( start_ptr, end_ptr, _initialPosition, OUT chains ));
+
+	result.resize( chains.Count() );
+
+	return ForEachInvocation( chains.Count(), threadCount,
+				[&] (size_t i) -> bool
+				{
+					Trace			trace;
+					std::string&	str = result[i];
+
+					for (uint32_t j = chains.offsets[i]; j < chains.offsets[i+1]; ++j)
+					{
+						RecordInfo	rec;
+						CHECK_ERR( ReadRecord( start_ptr + chains.records[j], OUT rec ));
+						CHECK_ERR( rec.exprID < _exprLocations.size() );
+
+						auto&	expr = _exprLocations[ rec.exprID ];
+
+						if ( rec.basicType == ShaderTrace::TBasicType_Clock )
+							CHECK_ERR( trace.AddTime( expr, rec.rows, rec.cols, rec.data ))
+						else
+							CHECK_ERR( trace.AddState( expr, rec.basicType, rec.rows, rec.cols, rec.data, _varNames, _sources, INOUT str ));
+					}
+
+					CHECK_ERR( trace.Flush( _varNames, _sources, INOUT str ));
+					return true;
+				});
+}
+
+/*
+=================================================
+	ParseShaderTrace
+----
+	returns records without conversion to string
+=================================================
+*/
+bool  ShaderTrace::ParseShaderTrace (const void *ptr, uint64_t maxSize, OUT InvocationTraces_t &result, uint32_t threadCount) const
+{
+	result.clear();
+
+	const uint64_t		count		= *(static_cast<uint32_t const*>(ptr) + _posOffset / sizeof(uint32_t));
+	uint32_t const*		start_ptr	= static_cast<uint32_t const*>(ptr) + _dataOffset / sizeof(uint32_t);
+	uint32_t const*		end_ptr		= start_ptr + std::min( count, (maxSize - _dataOffset) / sizeof(uint32_t) );
+	InvocationChains	chains;
+
+	CHECK_ERR( SplitByInvocation( start_ptr, end_ptr, _initialPosition, OUT chains ));
+
+	result.resize( chains.Count() );
+
+	return ForEachInvocation( chains.Count(), threadCount,
+				[&] (size_t i) -> bool
+				{
+					auto&	inv = result[i];
+					inv.records.reserve( chains.offsets[i+1] - chains.offsets[i] );
+
+					for (uint32_t j = chains.offsets[i]; j < chains.offsets[i+1]; ++j)
+					{
+						RecordInfo	rec;
+						CHECK_ERR( ReadRecord( start_ptr + chains.records[j], OUT rec ));
+						CHECK_ERR( rec.exprID < _exprLocations.size() );
+
+						inv.records.push_back({ rec.exprID, rec.type, uint32_t(inv.values.size()), rec.size });
+						inv.values.insert( inv.values.end(), rec.data, rec.data + rec.size );
+					}
+					return true;
+				});
 }
@@ -1,10 +1,11 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "SpirvCompiler.h"
+#include "SpirvDiskCache.h"
 #include "PrivateDefines.h"
 #include "stl/Algorithms/StringUtils.h"
 #include "stl/Algorithms/StringParser.h"
-#include "stl/Stream/FileStream.h"
+#include "stl/Stream/MappedFileStream.h"
 #include "framegraph/Shared/EnumUtils.h"
 #include "VCachedDebuggableShaderData.h"
 
@@ -40,7 +41,8 @@ namespace FG
 	private:
 		struct IncludeResultImpl final : IncludeResult
 		{
-			const String	_data;
+			const String						_data;
+			const UniquePtr<MappedFileRStream>	_file;		// keeps mapped memory for 'headerData'
 
 			IncludeResultImpl (String &&data, const String& headerName, void* userData = null) :
 				IncludeResult{headerName, null, 0, userData}, _data{std::move(data)}
@@ -49,7 +51,15 @@ namespace FG
 				const_cast<size_t&>(headerLength)    = _data.length();
 			}
 
-			ND_ StringView	GetSource () const	{ return _data; }
+			IncludeResultImpl (UniquePtr<MappedFileRStream> &&file, const String& headerName, void* userData = null) :
+				IncludeResult{headerName, null, 0, userData}, _file{std::move(file)}
+			{
+				auto	view = _file->GetView( 0_b, _file->Size() );
+				const_cast<const char*&>(headerData) = Cast<char>( view.data() );
+				const_cast<size_t&>(headerLength)    = view.size();
+			}
+
+			ND_ StringView	GetSource () const	{ return StringView{ headerData, headerLength }; }
 		};
 
 		using IncludeResultPtr_t	= UniquePtr< IncludeResultImpl >;
@@ -133,13 +143,10 @@ namespace FG
 			if ( _includedFiles.count( filename ))
 				return _results.emplace_back(new IncludeResultImpl{ "// skip header\n", headerName }).get();
 			
-			FileRStream  file{ filename };
-			CHECK_ERR( file.IsOpen() );
+			UniquePtr<MappedFileRStream>	file{ new MappedFileRStream{ filename }};
+			CHECK_ERR( file->IsOpen() );
 
-			String	data;
-			CHECK_ERR( file.Read( size_t(file.Size()), OUT data ));
-
-			auto*	result = _results.emplace_back(new IncludeResultImpl{ std::move(data), headerName }).get();
+			auto*	result = _results.emplace_back(new IncludeResultImpl{ std::move(file), headerName }).get();
 
 			_includedFiles.insert_or_assign( filename, result );
 			return result;
@@ -155,18 +162,15 @@ namespace FG
 
 			fpath += headerName;
 			
-			FileRStream  file{ fpath };
+			UniquePtr<MappedFileRStream>	file{ new MappedFileRStream{ fpath }};
 
-			if ( not file.IsOpen() )
+			if ( not file->IsOpen() )
 				continue;
 
 			if ( _includedFiles.count( fpath ) )
 				return _results.emplace_back(new IncludeResultImpl{ " ", headerName }).get();
 
-			String	data;
-			CHECK_ERR( file.Read( size_t(file.Size()), OUT data ));
-
-			auto*	result = _results.emplace_back(new IncludeResultImpl{ std::move(data), headerName }).get();
+			auto*	result = _results.emplace_back(new IncludeResultImpl{ std::move(file), headerName }).get();
 
 			_includedFiles.insert_or_assign( fpath, result );
 			return result;
@@ -252,6 +256,34 @@ namespace FG
 		_features.fragmentStoresAndAtomics		 = fragmentStoresAndAtomics;
 	}
 	
+/*
+=================================================
+	SetDiskCache
+=================================================
+*/
+	void  SpirvCompiler::SetDiskCache (SpirvDiskCache *cache)
+	{
+		_diskCache = cache;
+	}
+
+/*
+=================================================
+	CopySettings
+----
+	used to create compiler for another thread
+=================================================
+*/
+	void  SpirvCompiler::CopySettings (const SpirvCompiler &other)
+	{
+		ASSERT( &_directories == &other._directories );
+
+		_compilerFlags		= other._compilerFlags;
+		_features			= other._features;
+		_debugFlags			= other._debugFlags;
+		_builtinResource	= other._builtinResource;
+		_diskCache			= other._diskCache;
+	}
+
 /*
 =================================================
 	_CheckShaderFeatures
@@ -313,6 +345,25 @@ namespace FG
 		_currentStage = EShaderStages_FromShader( shaderType );
 		
 
+		// load from cache, shaders with debug info are not cached because they depend on glslang intermediate
+	#ifdef FG_STD_FILESYSTEM
+		const bool		use_cache	= _diskCache and _diskCache->IsEnabled() and
+									  ((srcShaderFmt & EShaderLangFormat::_DebugModeMask) | _debugFlags) == EShaderLangFormat::Unknown;
+		const uint64_t	cache_key	= use_cache ? _CalcCacheKey( shaderType, srcShaderFmt, dstShaderFmt, StringView{entry}, StringView{source} ) : 0;
+
+		if ( use_cache )
+		{
+			Array<uint>		spirv;
+			if ( _diskCache->Load( cache_key, OUT spirv, OUT outReflection ))
+			{
+				outShader.specConstants	= outReflection.specConstants;
+				outShader.AddShaderData( dstShaderFmt, StringView{entry}, std::move(spirv), debugName );
+				return true;
+			}
+		}
+	#endif
+
+
 		// compile shader without debug info
 		{
 			ShaderIncluder	includer	{_directories};
@@ -334,6 +385,17 @@ namespace FG
 				}
 			}
 
+		#ifdef FG_STD_FILESYSTEM
+			if ( use_cache )
+			{
+				SpirvDiskCache::Dependencies_t	deps;
+				for (auto& file : includer.GetIncludedFiles()) {
+					deps.emplace_back( file.first, StableHashOf( file.second->GetSource().data(), file.second->GetSource().length() ));
+				}
+				_diskCache->Store( cache_key, deps, spirv, outReflection );
+			}
+		#endif
+
 			outShader.specConstants	= outReflection.specConstants;
 			outShader.AddShaderData( dstShaderFmt, StringView{entry}, std::move(spirv), debugName );
 		}
@@ -403,6 +465,50 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	_CalcCacheKey
+----
+	key must depend on everything that affects compilation result,
+	SPIRV target is derived from shader formats,
+	content of included files is checked by disk cache
+=================================================
+*/
+	uint64_t  SpirvCompiler::_CalcCacheKey (EShader shaderType, EShaderLangFormat srcShaderFmt, EShaderLangFormat dstShaderFmt,
+											StringView entry, StringView source) const
+	{
+		const uint	version		= 1;
+		const uint	glslang_ver	= GLSLANG_PATCH_LEVEL;
+		const bool	opt_ids		= UniformID::IsOptimized();
+		const uint	stage		= uint(shaderType);
+		uint64_t	key			= StableHashOf( &version, sizeof(version) );
+
+		// hash fields separately, structure may contain padding
+		const uint	features	= (uint(_features.shaderSubgroupClock)				<< 0) |
+								  (uint(_features.shaderDeviceClock)				<< 1) |
+								  (uint(_features.vertexPipelineStoresAndAtomics)	<< 2) |
+								  (uint(_features.fragmentStoresAndAtomics)			<< 3);
+
+		key = StableHashOf( &glslang_ver, sizeof(glslang_ver), key );
+		key = StableHashOf( source.data(), source.length(), key );
+		key = StableHashOf( entry.data(), entry.length(), key );
+		key = StableHashOf( &stage, sizeof(stage), key );
+		key = StableHashOf( &srcShaderFmt, sizeof(srcShaderFmt), key );
+		key = StableHashOf( &dstShaderFmt, sizeof(dstShaderFmt), key );
+		key = StableHashOf( &_compilerFlags, sizeof(_compilerFlags), key );
+		key = StableHashOf( &features, sizeof(features), key );
+		key = StableHashOf( &opt_ids, sizeof(opt_ids), key );
+
+		// skip padding at the end of structure
+		key = StableHashOf( &_builtinResource, offsetof( TBuiltInResource, limits ) + sizeof(TLimits), key );
+
+		// include directories affects which files will be included
+		for (auto& dir : _directories) {
+			key = StableHashOf( dir.data(), dir.length()+1, key );
+		}
+		return key;
+	}
+
 /*
 =================================================
 	ConvertShaderType
@@ -22,6 +22,8 @@ namespace glslang
 
 namespace FG
 {
+	class SpirvDiskCache;
+
 
 	//
 	// SPIRV Compiler
@@ -110,6 +112,8 @@ namespace FG
 		EShaderLangFormat			_debugFlags		= Default;
 		TBuiltInResource			_builtinResource;
 
+		SpirvDiskCache *			_diskCache		= null;
+
 
 	// methods
 	public:
@@ -120,6 +124,8 @@ namespace FG
 		void  SetDebugFlags (EShaderLangFormat flags);
 		void  SetShaderClockFeatures (bool shaderSubgroupClock, bool shaderDeviceClock);
 		void  SetShaderFeatures (bool vertexPipelineStoresAndAtomics, bool fragmentStoresAndAtomics);
+		void  SetDiskCache (SpirvDiskCache *cache);
+		void  CopySettings (const SpirvCompiler &other);
 
 		bool  SetDefaultResourceLimits ();
 		bool  SetCurrentResourceLimits (PhysicalDeviceVk_t physicalDevice);
@@ -145,6 +151,9 @@ namespace FG
 
 		bool  _CheckShaderFeatures (EShader shaderType) const;
 
+		ND_ uint64_t  _CalcCacheKey (EShader shaderType, EShaderLangFormat srcShaderFmt, EShaderLangFormat dstShaderFmt,
+									 StringView entry, StringView source) const;
+
 		static void  _GenerateResources (OUT TBuiltInResource& res);
 
 
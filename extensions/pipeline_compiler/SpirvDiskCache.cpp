@@ -0,0 +1,712 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "SpirvDiskCache.h"
+
+#ifdef FG_STD_FILESYSTEM
+
+#include "PrivateDefines.h"
+#include "stl/Algorithms/ArrayUtils.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "stl/Stream/FileStream.h"
+#include "stl/Stream/MemStream.h"
+
+namespace FG
+{
+namespace
+{
+	using PipelineLayout	= PipelineDescription::PipelineLayout;
+	using UniformData_t		= PipelineDescription::UniformData_t;
+	using UniformMap_t		= PipelineDescription::UniformMap_t;
+
+	static constexpr char	EntryExtension[] = ".spvc";
+
+	struct EntryHeader
+	{
+		static constexpr uint	Magic	= 0x43565053;	// 'SPVC'
+		static constexpr uint	Version	= 1;
+
+		uint		magic;
+		uint		version;
+		uint64_t	key;
+		uint64_t	payloadSize;
+		uint64_t	payloadHash;
+	};
+	STATIC_ASSERT( sizeof(EntryHeader) == 32 );
+
+/*
+=================================================
+	WriteRaw / ReadRaw
+=================================================
+*/
+	template <typename T>
+	ND_ bool  WriteRaw (WStream &stream, const T &value)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		return stream.Write( &value, BytesU::SizeOf(value) );
+	}
+
+	template <typename T>
+	ND_ bool  ReadRaw (RStream &stream, OUT T &value)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		return stream.Read( OUT &value, BytesU::SizeOf(value) );
+	}
+
+/*
+=================================================
+	WriteString / ReadString
+=================================================
+*/
+	ND_ bool  WriteString (WStream &stream, StringView str)
+	{
+		return WriteRaw( stream, uint(str.length()) ) and stream.Write( str );
+	}
+
+	ND_ bool  ReadString (RStream &stream, OUT String &str)
+	{
+		uint	len = 0;
+		return ReadRaw( stream, OUT len ) and BytesU(len) <= stream.RemainingSize() and stream.Read( len, OUT str );
+	}
+
+/*
+=================================================
+	WriteID / ReadID
+----
+	optimized ID contains only hash, otherwise name is stored
+=================================================
+*/
+	template <size_t S, uint U, bool O, uint Seed>
+	ND_ bool  WriteID (WStream &stream, const _fg_hidden_::IDWithString<S,U,O,Seed> &id)
+	{
+		if constexpr( O )
+			return WriteRaw( stream, uint(size_t(id.GetHash())) );
+		else
+			return WriteString( stream, id.GetName() );
+	}
+
+	template <size_t S, uint U, bool O, uint Seed>
+	ND_ bool  ReadID (RStream &stream, OUT _fg_hidden_::IDWithString<S,U,O,Seed> &id)
+	{
+		using ID = _fg_hidden_::IDWithString<S,U,O,Seed>;
+
+		if constexpr( O )
+		{
+			uint	hash = 0;
+			CHECK_ERR( ReadRaw( stream, OUT hash ));
+			id = ID{ hash };
+		}
+		else
+		{
+			String	name;
+			CHECK_ERR( ReadString( stream, OUT name ));
+			CHECK_ERR( name.length() < S );
+			id = ID{ StringView{name} };
+		}
+		return true;
+	}
+
+/*
+=================================================
+	ReadUniformData
+=================================================
+*/
+	template <size_t I = 0>
+	ND_ bool  ReadUniformData (RStream &stream, size_t index, OUT UniformData_t &data)
+	{
+		if constexpr( I < TypeList<UniformData_t>::Count )
+		{
+			if ( index != I )
+				return ReadUniformData< I+1 >( stream, index, OUT data );
+
+			typename TypeList<UniformData_t>::template Get<I>	value;
+			CHECK_ERR( ReadRaw( stream, OUT value ));
+
+			data = value;
+			return true;
+		}
+		else
+		{
+			FG_UNUSED( stream );
+			FG_UNUSED( index );
+			FG_UNUSED( data );
+			return false;
+		}
+	}
+
+/*
+=================================================
+	SerializeLayout
+=================================================
+*/
+	ND_ bool  SerializeLayout (WStream &stream, const PipelineLayout &layout)
+	{
+		CHECK_ERR( WriteRaw( stream, uint(layout.descriptorSets.size()) ));
+
+		for (auto& ds : layout.descriptorSets)
+		{
+			CHECK_ERR( WriteID( stream, ds.id ));
+			CHECK_ERR( WriteRaw( stream, ds.bindingIndex ));
+			CHECK_ERR( WriteRaw( stream, uint(ds.uniforms ? ds.uniforms->size() : 0) ));
+
+			if ( not ds.uniforms )
+				continue;
+
+			for (auto& un : *ds.uniforms)
+			{
+				bool	written = false;
+
+				CHECK_ERR( WriteID( stream, un.first ));
+				CHECK_ERR( WriteRaw( stream, uint(un.second.data.index()) ));
+
+				Visit( un.second.data, [&] (auto& value) { written = WriteRaw( stream, value ); });
+				CHECK_ERR( written );
+				CHECK_ERR( WriteRaw( stream, un.second.index ));
+				CHECK_ERR( WriteRaw( stream, un.second.arraySize ));
+				CHECK_ERR( WriteRaw( stream, un.second.stageFlags ));
+			}
+		}
+
+		CHECK_ERR( WriteRaw( stream, uint(layout.pushConstants.size()) ));
+
+		for (auto& pc : layout.pushConstants)
+		{
+			CHECK_ERR( WriteID( stream, pc.first ));
+			CHECK_ERR( WriteRaw( stream, pc.second ));
+		}
+		return true;
+	}
+
+/*
+=================================================
+	DeserializeLayout
+=================================================
+*/
+	ND_ bool  DeserializeLayout (RStream &stream, OUT PipelineLayout &layout)
+	{
+		uint	ds_count = 0;
+		CHECK_ERR( ReadRaw( stream, OUT ds_count ));
+		CHECK_ERR( ds_count <= layout.descriptorSets.capacity() );
+
+		for (uint i = 0; i < ds_count; ++i)
+		{
+			auto&	ds			= layout.descriptorSets.emplace_back();
+			auto	uniforms	= MakeShared<UniformMap_t>();
+			uint	un_count	= 0;
+
+			CHECK_ERR( ReadID( stream, OUT ds.id ));
+			CHECK_ERR( ReadRaw( stream, OUT ds.bindingIndex ));
+			CHECK_ERR( ReadRaw( stream, OUT un_count ));
+
+			uniforms->reserve( un_count );
+
+			for (uint j = 0; j < un_count; ++j)
+			{
+				UniformID						id;
+				PipelineDescription::Uniform	un;
+				uint							data_index = 0;
+
+				CHECK_ERR( ReadID( stream, OUT id ));
+				CHECK_ERR( ReadRaw( stream, OUT data_index ));
+				CHECK_ERR( ReadUniformData( stream, data_index, OUT un.data ));
+				CHECK_ERR( ReadRaw( stream, OUT un.index ));
+				CHECK_ERR( ReadRaw( stream, OUT un.arraySize ));
+				CHECK_ERR( ReadRaw( stream, OUT un.stageFlags ));
+
+				uniforms->insert_or_assign( id, std::move(un) );
+			}
+			ds.uniforms = std::move(uniforms);
+		}
+
+		uint	pc_count = 0;
+		CHECK_ERR( ReadRaw( stream, OUT pc_count ));
+		CHECK_ERR( pc_count <= layout.pushConstants.capacity() );
+
+		for (uint i = 0; i < pc_count; ++i)
+		{
+			PushConstantID						id;
+			PipelineDescription::PushConstant	pc;
+
+			CHECK_ERR( ReadID( stream, OUT id ));
+			CHECK_ERR( ReadRaw( stream, OUT pc ));
+
+			layout.pushConstants.insert_or_assign( id, pc );
+		}
+		return true;
+	}
+
+/*
+=================================================
+	SerializeReflection
+=================================================
+*/
+	ND_ bool  SerializeReflection (WStream &stream, const SpirvDiskCache::ShaderReflection &refl)
+	{
+		CHECK_ERR( SerializeLayout( stream, refl.layout ));
+
+		CHECK_ERR( WriteRaw( stream, uint(refl.specConstants.size()) ));
+		for (auto& sc : refl.specConstants)
+		{
+			CHECK_ERR( WriteID( stream, sc.first ));
+			CHECK_ERR( WriteRaw( stream, sc.second ));
+		}
+
+		CHECK_ERR( WriteRaw( stream, uint64_t(refl.vertex.supportedTopology.to_ullong()) ));
+		CHECK_ERR( WriteRaw( stream, uint(refl.vertex.vertexAttribs.size()) ));
+		for (auto& attr : refl.vertex.vertexAttribs)
+		{
+			CHECK_ERR( WriteID( stream, attr.id ));
+			CHECK_ERR( WriteRaw( stream, attr.index ));
+			CHECK_ERR( WriteRaw( stream, attr.type ));
+		}
+
+		CHECK_ERR( WriteRaw( stream, uint(refl.fragment.fragmentOutput.size()) ));
+		for (auto& frag : refl.fragment.fragmentOutput)
+		{
+			CHECK_ERR( WriteRaw( stream, frag.id ));
+			CHECK_ERR( WriteRaw( stream, frag.index ));
+			CHECK_ERR( WriteRaw( stream, frag.type ));
+		}
+		CHECK_ERR( WriteRaw( stream, refl.fragment.earlyFragmentTests ));
+
+		CHECK_ERR( WriteRaw( stream, refl.tessellation ));
+		CHECK_ERR( WriteRaw( stream, refl.compute ));
+		CHECK_ERR( WriteRaw( stream, refl.mesh ));
+		return true;
+	}
+
+/*
+=================================================
+	DeserializeReflection
+=================================================
+*/
+	ND_ bool  DeserializeReflection (RStream &stream, OUT SpirvDiskCache::ShaderReflection &refl)
+	{
+		CHECK_ERR( DeserializeLayout( stream, OUT refl.layout ));
+
+		uint	sc_count = 0;
+		CHECK_ERR( ReadRaw( stream, OUT sc_count ));
+		CHECK_ERR( sc_count <= refl.specConstants.capacity() );
+
+		for (uint i = 0; i < sc_count; ++i)
+		{
+			SpecializationID	id;
+			uint				index = 0;
+			CHECK_ERR( ReadID( stream, OUT id ));
+			CHECK_ERR( ReadRaw( stream, OUT index ));
+			refl.specConstants.insert_or_assign( id, index );
+		}
+
+		uint64_t	topology = 0;
+		CHECK_ERR( ReadRaw( stream, OUT topology ));
+		refl.vertex.supportedTopology = SpirvDiskCache::ShaderReflection::TopologyBits_t{ topology };
+
+		uint	attr_count = 0;
+		CHECK_ERR( ReadRaw( stream, OUT attr_count ));
+		CHECK_ERR( attr_count <= refl.vertex.vertexAttribs.capacity() );
+
+		for (uint i = 0; i < attr_count; ++i)
+		{
+			auto&	attr = refl.vertex.vertexAttribs.emplace_back();
+			CHECK_ERR( ReadID( stream, OUT attr.id ));
+			CHECK_ERR( ReadRaw( stream, OUT attr.index ));
+			CHECK_ERR( ReadRaw( stream, OUT attr.type ));
+		}
+
+		uint	frag_count = 0;
+		CHECK_ERR( ReadRaw( stream, OUT frag_count ));
+		CHECK_ERR( frag_count <= refl.fragment.fragmentOutput.capacity() );
+
+		for (uint i = 0; i < frag_count; ++i)
+		{
+			auto&	frag = refl.fragment.fragmentOutput.emplace_back();
+			CHECK_ERR( ReadRaw( stream, OUT frag.id ));
+			CHECK_ERR( ReadRaw( stream, OUT frag.index ));
+			CHECK_ERR( ReadRaw( stream, OUT frag.type ));
+		}
+		CHECK_ERR( ReadRaw( stream, OUT refl.fragment.earlyFragmentTests ));
+
+		CHECK_ERR( ReadRaw( stream, OUT refl.tessellation ));
+		CHECK_ERR( ReadRaw( stream, OUT refl.compute ));
+		CHECK_ERR( ReadRaw( stream, OUT refl.mesh ));
+		return true;
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	SetDirectory
+----
+	creates directory if not exists and calculates current cache size
+=================================================
+*/
+	bool  SpirvDiskCache::SetDirectory (const FS::path &dir, BytesU maxSize)
+	{
+		EXLOCK( _guard );
+		std::error_code	ec;
+
+		_directory.clear();
+		_totalSize	= 0_b;
+		_maxSize	= maxSize;
+
+		if ( not FS::exists( dir, ec ))
+			CHECK_ERR( FS::create_directories( dir, ec ));
+
+		CHECK_ERR( FS::is_directory( dir, ec ));
+
+		for (auto& file : FS::directory_iterator{ dir, ec })
+		{
+			if ( file.is_regular_file( ec ) and file.path().extension() == EntryExtension )
+				_totalSize += BytesU{file.file_size( ec )};
+		}
+
+		_directory	= dir;
+		_enabled	= true;
+		_Evict();
+		return true;
+	}
+
+/*
+=================================================
+	Prewarm
+----
+	loads all entries from directory to memory,
+	entries will be validated only when requested
+=================================================
+*/
+	bool  SpirvDiskCache::Prewarm (const FS::path &dir)
+	{
+		std::error_code	ec;
+		CHECK_ERR( FS::is_directory( dir, ec ));
+
+		MemCache_t	entries;
+
+		for (auto& file : FS::directory_iterator{ dir, ec })
+		{
+			if ( not file.is_regular_file( ec ) or file.path().extension() != EntryExtension )
+				continue;
+
+			FileRStream		stream{ file.path() };
+			Array<uint8_t>	blob;
+			EntryHeader		header;
+
+			if ( not stream.IsOpen() or not stream.Read( size_t(stream.Size()), OUT blob ) or blob.size() < sizeof(header) )
+				continue;
+
+			std::memcpy( OUT &header, blob.data(), sizeof(header) );
+
+			if ( header.magic == EntryHeader::Magic and header.version == EntryHeader::Version )
+				entries.insert_or_assign( header.key, std::move(blob) );
+		}
+
+		// files are read without lock, only memory cache is updated under lock
+		EXLOCK( _guard );
+		for (auto& entry : entries) {
+			_prewarmed.insert_or_assign( entry.first, std::move(entry.second) );
+		}
+		_enabled = true;
+		return true;
+	}
+
+/*
+=================================================
+	HashOfFile
+=================================================
+*/
+	uint64_t  SpirvDiskCache::HashOfFile (const String &filename)
+	{
+		std::error_code	ec;
+		if ( not FS::exists( FS::path{filename}, ec ))
+			return 0;
+
+		FileRStream		file{ filename };
+		String			data;
+
+		if ( not file.IsOpen() or not file.Read( size_t(file.Size()), OUT data ))
+			return 0;
+
+		return StableHashOf( data.data(), data.length() );
+	}
+
+/*
+=================================================
+	_EntryPath
+=================================================
+*/
+	FS::path  SpirvDiskCache::_EntryPath (const FS::path &dir, uint64_t key)
+	{
+		return dir / (ToString<16>( key ) + EntryExtension);
+	}
+
+/*
+=================================================
+	Load
+=================================================
+*/
+	bool  SpirvDiskCache::Load (uint64_t key, OUT Array<uint> &spirv, OUT ShaderReflection &reflection)
+	{
+		// search in memory, lock is held only to copy the entry
+		{
+			Array<uint8_t>	blob;
+			{
+				EXLOCK( _guard );
+
+				auto	iter = _prewarmed.find( key );
+				if ( iter != _prewarmed.end() )
+					blob = iter->second;
+			}
+
+			if ( blob.size() )
+			{
+				const bool	ok = _Deserialize( key, blob, OUT spirv, OUT reflection );
+
+				EXLOCK( _guard );
+				if ( ok )
+				{
+					++_stat.hits;
+					return true;
+				}
+				_prewarmed.erase( key );
+			}
+		}
+
+		// search on disk
+		if ( not _directory.empty() )
+		{
+			const FS::path	path = _EntryPath( _directory, key );
+			std::error_code	ec;
+
+			Array<uint8_t>	blob;
+			if ( FS::exists( path, ec ))
+			{
+				FileRStream		file{ path };
+
+				if ( file.IsOpen() and not file.Read( size_t(file.Size()), OUT blob ))
+					blob.clear();
+			}
+
+			if ( blob.size() )
+			{
+				if ( _Deserialize( key, blob, OUT spirv, OUT reflection ))
+				{
+					// mark as recently used
+					FS::last_write_time( path, FS::file_time_type::clock::now(), ec );
+
+					EXLOCK( _guard );
+					++_stat.hits;
+					return true;
+				}
+
+				// remove outdated entry
+				if ( FS::remove( path, ec ))
+				{
+					EXLOCK( _guard );
+					_totalSize -= Min( _totalSize, BytesU{blob.size()} );
+				}
+			}
+		}
+
+		EXLOCK( _guard );
+		++_stat.misses;
+		return false;
+	}
+
+/*
+=================================================
+	Store
+----
+	entry is written to temporary file and then renamed,
+	so other threads and processes never read partially written entry
+=================================================
+*/
+	bool  SpirvDiskCache::Store (uint64_t key, const Dependencies_t &deps, ArrayView<uint> spirv, const ShaderReflection &reflection)
+	{
+		if ( _directory.empty() )
+			return false;
+
+		Array<uint8_t>	blob;
+		CHECK_ERR( _Serialize( key, deps, spirv, reflection, OUT blob ));
+
+		const FS::path	path	 = _EntryPath( _directory, key );
+		FS::path		tmp_path = path;
+		std::error_code	ec;
+
+		tmp_path += "."s << ToString( _tempIndex.fetch_add( 1, memory_order_relaxed )) << ".tmp";
+		{
+			FileWStream		file{ tmp_path };
+			CHECK_ERR( file.IsOpen() );
+			CHECK_ERR( file.Write( ArrayView<uint8_t>{ blob }));
+		}
+
+		EXLOCK( _guard );
+
+		// entry may be overwritten, its size is already counted
+		const uintmax_t	old_size = FS::file_size( path, OUT ec );
+		const BytesU	replaced = ec ? 0_b : BytesU{old_size};
+
+		FS::rename( tmp_path, path, OUT ec );
+
+		if ( ec )
+		{
+			FS::remove( tmp_path, ec );
+			return false;
+		}
+
+		_totalSize -= Min( _totalSize, replaced );
+		_totalSize += BytesU{blob.size()};
+
+		if ( _totalSize > _maxSize )
+			_Evict();
+
+		return true;
+	}
+
+/*
+=================================================
+	_Evict
+----
+	removes least recently used entries,
+	cache is shrinked to 3/4 of max size to avoid scanning directory on each store
+=================================================
+*/
+	void  SpirvDiskCache::_Evict ()
+	{
+		if ( _totalSize <= _maxSize )
+			return;
+
+		struct FileInfo
+		{
+			FS::path			path;
+			FS::file_time_type	time;
+			BytesU				size;
+		};
+
+		std::error_code		ec;
+		Array<FileInfo>		files;
+		BytesU				total_size;
+
+		for (auto& file : FS::directory_iterator{ _directory, ec })
+		{
+			if ( not file.is_regular_file( ec ) or file.path().extension() != EntryExtension )
+				continue;
+
+			auto&	info = files.emplace_back();
+			info.path	= file.path();
+			info.time	= file.last_write_time( ec );
+			info.size	= BytesU{file.file_size( ec )};
+			total_size	+= info.size;
+		}
+
+		std::sort( files.begin(), files.end(), [] (auto& lhs, auto& rhs) { return lhs.time < rhs.time; });
+
+		const BytesU	target_size = _maxSize * 3 / 4;
+
+		for (auto& file : files)
+		{
+			if ( total_size <= target_size )
+				break;
+
+			if ( FS::remove( file.path, ec ))
+			{
+				total_size -= file.size;
+				++_stat.evicted;
+			}
+		}
+
+		_totalSize = total_size;
+	}
+
+/*
+=================================================
+	_Serialize
+=================================================
+*/
+	bool  SpirvDiskCache::_Serialize (uint64_t key, const Dependencies_t &deps, ArrayView<uint> spirv, const ShaderReflection &reflection, OUT Array<uint8_t> &blob)
+	{
+		MemWStream	stream;
+		EntryHeader	header	= {};
+
+		CHECK_ERR( WriteRaw( stream, header ));	// will be overwritten
+
+		CHECK_ERR( WriteRaw( stream, uint(deps.size()) ));
+		for (auto& dep : deps)
+		{
+			CHECK_ERR( WriteString( stream, dep.first ));
+			CHECK_ERR( WriteRaw( stream, dep.second ));
+		}
+
+		CHECK_ERR( WriteRaw( stream, uint(spirv.size()) ));
+		CHECK_ERR( stream.Write( spirv.data(), ArraySizeOf(spirv) ));
+
+		CHECK_ERR( SerializeReflection( stream, reflection ));
+
+		auto	data = stream.GetData();
+		blob.assign( data.begin(), data.end() );
+
+		header.magic		= EntryHeader::Magic;
+		header.version		= EntryHeader::Version;
+		header.key			= key;
+		header.payloadSize	= blob.size() - sizeof(header);
+		header.payloadHash	= StableHashOf( blob.data() + sizeof(header), size_t(header.payloadSize) );
+
+		std::memcpy( OUT blob.data(), &header, sizeof(header) );
+		return true;
+	}
+
+/*
+=================================================
+	_Deserialize
+----
+	returns 'false' if entry is corrupted or one of included files was changed
+=================================================
+*/
+	bool  SpirvDiskCache::_Deserialize (uint64_t key, ArrayView<uint8_t> blob, OUT Array<uint> &spirv, OUT ShaderReflection &reflection)
+	{
+		EntryHeader	header;
+
+		if ( blob.size() < sizeof(header) )
+			return false;
+
+		std::memcpy( OUT &header, blob.data(), sizeof(header) );
+
+		if ( header.magic		!= EntryHeader::Magic	or
+			 header.version		!= EntryHeader::Version	or
+			 header.key			!= key					or
+			 header.payloadSize	!= blob.size() - sizeof(header) or
+			 header.payloadHash	!= StableHashOf( blob.data() + sizeof(header), size_t(header.payloadSize) ))
+			return false;
+
+		MemRStream	stream{ blob.section( sizeof(header), size_t(header.payloadSize) )};
+
+		uint	dep_count = 0;
+		CHECK_ERR( ReadRaw( stream, OUT dep_count ));
+
+		for (uint i = 0; i < dep_count; ++i)
+		{
+			String		filename;
+			uint64_t	hash = 0;
+			CHECK_ERR( ReadString( stream, OUT filename ));
+			CHECK_ERR( ReadRaw( stream, OUT hash ));
+
+			if ( HashOfFile( filename ) != hash )
+				return false;
+		}
+
+		uint	spirv_size = 0;
+		CHECK_ERR( ReadRaw( stream, OUT spirv_size ));
+		CHECK_ERR( SizeOf<uint> * spirv_size <= stream.RemainingSize() );
+		CHECK_ERR( stream.Read( spirv_size, OUT spirv ));
+
+		reflection = ShaderReflection{};
+		CHECK_ERR( DeserializeReflection( stream, OUT reflection ));
+		CHECK_ERR( stream.RemainingSize() == 0 );
+		return true;
+	}
+
+
+}	// FG
+
+#endif	// FG_STD_FILESYSTEM
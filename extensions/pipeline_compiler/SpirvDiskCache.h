@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Persistent cache for compiled SPIRV and shader reflection.
+
+	Each entry is stored in separate file '<key>.spvc', key is a hash of shader source and all compiler settings.
+	Entry contains paths and content hashes of included files, entry is discarded if any of them was changed.
+	When total size of cache exceeds the limit, least recently used entries are removed.
+
+	'Load' and 'Store' can be used from multiple threads,
+	'SetDirectory' and 'Prewarm' must not be called concurrently with them.
+*/
+
+#pragma once
+
+#include "SpirvCompiler.h"
+
+#ifdef FG_STD_FILESYSTEM
+
+namespace FG
+{
+
+	//
+	// SPIRV Disk Cache
+	//
+
+	class SpirvDiskCache final
+	{
+	// types
+	public:
+		using ShaderReflection	= SpirvCompiler::ShaderReflection;
+		using Dependencies_t	= Array< Pair< String, uint64_t >>;		// included file path and hash of content
+
+		struct Statistics
+		{
+			uint		hits		= 0;
+			uint		misses		= 0;
+			uint		evicted		= 0;
+		};
+
+	private:
+		using MemCache_t	= HashMap< uint64_t, Array<uint8_t> >;
+
+
+	// variables
+	private:
+		FS::path		_directory;
+		BytesU			_maxSize;
+		BytesU			_totalSize;
+		MemCache_t		_prewarmed;		// entries loaded by 'Prewarm'
+		Statistics		_stat;
+		Atomic<uint>	_tempIndex		{0};
+		Mutex			_guard;			// protects size, statistics and memory cache
+		bool			_enabled		= false;
+
+
+	// methods
+	public:
+		SpirvDiskCache () {}
+
+		bool  SetDirectory (const FS::path &dir, BytesU maxSize);
+		bool  Prewarm (const FS::path &dir);
+
+		bool  Load (uint64_t key, OUT Array<uint> &spirv, OUT ShaderReflection &reflection);
+		bool  Store (uint64_t key, const Dependencies_t &deps, ArrayView<uint> spirv, const ShaderReflection &reflection);
+
+		ND_ bool				IsEnabled ()		const	{ return _enabled; }
+		ND_ Statistics			GetStatistics ()			{ EXLOCK( _guard );  return _stat; }
+
+		ND_ static uint64_t		HashOfFile (const String &filename);
+
+	private:
+		void  _Evict ();
+
+		ND_ static FS::path	_EntryPath (const FS::path &dir, uint64_t key);
+
+		ND_ static bool  _Serialize (uint64_t key, const Dependencies_t &deps, ArrayView<uint> spirv, const ShaderReflection &reflection, OUT Array<uint8_t> &blob);
+		ND_ static bool  _Deserialize (uint64_t key, ArrayView<uint8_t> blob, OUT Array<uint> &spirv, OUT ShaderReflection &reflection);
+	};
+
+
+}	// FG
+
+#endif	// FG_STD_FILESYSTEM
@@ -2,12 +2,14 @@
 
 #include "VPipelineCompiler.h"
 #include "SpirvCompiler.h"
+#include "SpirvDiskCache.h"
 #include "PrivateDefines.h"
 #include "extensions/vulkan_loader/VulkanLoader.h"
 #include "extensions/vulkan_loader/VulkanCheckError.h"
 #include "framegraph/Shared/EnumUtils.h"
 #include "stl/Algorithms/StringUtils.h"
 #include "VCachedDebuggableShaderData.h"
+#include <thread>
 
 namespace FG
 {
@@ -154,6 +156,75 @@ namespace FG
 		_directories.push_back( std::move(file_path) );
 	}
 
+/*
+=================================================
+	SetCacheDirectory
+=================================================
+*/
+	bool VPipelineCompiler::SetCacheDirectory (StringView path, BytesU maxSize)
+	{
+		EXLOCK( _lock );
+
+#	ifdef FG_STD_FILESYSTEM
+		if ( not _diskCache )
+			_diskCache.reset( new SpirvDiskCache{} );
+
+		CHECK_ERR( _diskCache->SetDirectory( FS::path{path}.make_preferred(), maxSize ));
+
+		_spirvCompiler->SetDiskCache( _diskCache.get() );
+		return true;
+#	else
+		FG_UNUSED( path );
+		FG_UNUSED( maxSize );
+		RETURN_ERR( "shader cache requires std::filesystem" );
+#	endif
+	}
+	
+/*
+=================================================
+	PrewarmCache
+=================================================
+*/
+	bool VPipelineCompiler::PrewarmCache (StringView path)
+	{
+		EXLOCK( _lock );
+
+#	ifdef FG_STD_FILESYSTEM
+		if ( not _diskCache )
+			_diskCache.reset( new SpirvDiskCache{} );
+
+		CHECK_ERR( _diskCache->Prewarm( FS::path{path}.make_preferred() ));
+
+		_spirvCompiler->SetDiskCache( _diskCache.get() );
+		return true;
+#	else
+		FG_UNUSED( path );
+		RETURN_ERR( "shader cache requires std::filesystem" );
+#	endif
+	}
+	
+/*
+=================================================
+	GetCacheStatistics
+=================================================
+*/
+	VPipelineCompiler::CacheStatistics  VPipelineCompiler::GetCacheStatistics ()
+	{
+		EXLOCK( _lock );
+
+		CacheStatistics		result;
+#	ifdef FG_STD_FILESYSTEM
+		if ( _diskCache )
+		{
+			const auto	stat = _diskCache->GetStatistics();
+			result.hits		= stat.hits;
+			result.misses	= stat.misses;
+			result.evicted	= stat.evicted;
+		}
+#	endif
+		return result;
+	}
+
 /*
 =================================================
 	ReleaseUnusedShaders
@@ -772,6 +843,21 @@ namespace FG
 	bool VPipelineCompiler::Compile (INOUT MeshPipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
 		EXLOCK( _lock );
+
+		if ( not _Compile( *_spirvCompiler, INOUT ppln, dstFormat ))
+			return false;
+
+		_CheckHashCollision( ppln );
+		return true;
+	}
+	
+/*
+=================================================
+	_Compile
+=================================================
+*/
+	bool VPipelineCompiler::_Compile (SpirvCompiler &spirvCompiler, INOUT MeshPipelineDesc &ppln, EShaderLangFormat dstFormat)
+	{
 		ASSERT( IsSupported( ppln, dstFormat ) );
 
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -797,9 +883,9 @@ namespace FG
 				String							log;
 				PipelineDescription::Shader		new_shader;
 
-				if ( not _spirvCompiler->Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
-												  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
-												  OUT new_shader, OUT reflection, OUT log ))
+				if ( not spirvCompiler.Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
+												(*shader_data)->GetData(), (*shader_data)->GetDebugName(),
+												OUT new_shader, OUT reflection, OUT log ))
 				{
 					COMP_RETURN_ERR( log );
 				}
@@ -844,7 +930,6 @@ namespace FG
 		UpdateBufferDynamicOffsets( new_ppln._pipelineLayout.descriptorSets );
 
 		std::swap( ppln, new_ppln );
-		_CheckHashCollision( ppln );
 		
 		ASSERT( _CheckDescriptorBindings( ppln ));
 		return true;
@@ -858,6 +943,21 @@ namespace FG
 	bool VPipelineCompiler::Compile (INOUT RayTracingPipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
 		EXLOCK( _lock );
+
+		if ( not _Compile( *_spirvCompiler, INOUT ppln, dstFormat ))
+			return false;
+
+		_CheckHashCollision( ppln );
+		return true;
+	}
+	
+/*
+=================================================
+	_Compile
+=================================================
+*/
+	bool VPipelineCompiler::_Compile (SpirvCompiler &spirvCompiler, INOUT RayTracingPipelineDesc &ppln, EShaderLangFormat dstFormat)
+	{
 		ASSERT( IsSupported( ppln, dstFormat ) );
 		
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -883,9 +983,9 @@ namespace FG
 				String								log;
 				RayTracingPipelineDesc::RTShader	new_shader;
 
-				if ( not _spirvCompiler->Compile( shader.second.shaderType, iter->first, spirv_format, (*shader_data)->GetEntry(),
-												  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
-												  OUT new_shader, OUT reflection, OUT log ))
+				if ( not spirvCompiler.Compile( shader.second.shaderType, iter->first, spirv_format, (*shader_data)->GetEntry(),
+												(*shader_data)->GetData(), (*shader_data)->GetDebugName(),
+												OUT new_shader, OUT reflection, OUT log ))
 				{
 					COMP_RETURN_ERR( log );
 				}
@@ -921,7 +1021,6 @@ namespace FG
 		UpdateBufferDynamicOffsets( new_ppln._pipelineLayout.descriptorSets );
 
 		std::swap( ppln, new_ppln );
-		_CheckHashCollision( ppln );
 		
 		ASSERT( _CheckDescriptorBindings( ppln ));
 		return true;
@@ -935,6 +1034,21 @@ namespace FG
 	bool VPipelineCompiler::Compile (INOUT GraphicsPipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
 		EXLOCK( _lock );
+
+		if ( not _Compile( *_spirvCompiler, INOUT ppln, dstFormat ))
+			return false;
+
+		_CheckHashCollision( ppln );
+		return true;
+	}
+	
+/*
+=================================================
+	_Compile
+=================================================
+*/
+	bool VPipelineCompiler::_Compile (SpirvCompiler &spirvCompiler, INOUT GraphicsPipelineDesc &ppln, EShaderLangFormat dstFormat)
+	{
 		ASSERT( IsSupported( ppln, dstFormat ) );
 		
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -960,9 +1074,9 @@ namespace FG
 				String							log;
 				PipelineDescription::Shader		new_shader;
 
-				if ( not _spirvCompiler->Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
-												  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
-												  OUT new_shader, OUT reflection, OUT log ))
+				if ( not spirvCompiler.Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
+												(*shader_data)->GetData(), (*shader_data)->GetDebugName(),
+												OUT new_shader, OUT reflection, OUT log ))
 				{
 					COMP_RETURN_ERR( log );
 				}
@@ -1011,7 +1125,6 @@ namespace FG
 		UpdateBufferDynamicOffsets( new_ppln._pipelineLayout.descriptorSets );
 
 		std::swap( ppln, new_ppln );
-		_CheckHashCollision( ppln );
 
 		ASSERT( _CheckDescriptorBindings( ppln ));
 		return true;
@@ -1025,6 +1138,21 @@ namespace FG
 	bool VPipelineCompiler::Compile (INOUT ComputePipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
 		EXLOCK( _lock );
+
+		if ( not _Compile( *_spirvCompiler, INOUT ppln, dstFormat ))
+			return false;
+
+		_CheckHashCollision( ppln );
+		return true;
+	}
+	
+/*
+=================================================
+	_Compile
+=================================================
+*/
+	bool VPipelineCompiler::_Compile (SpirvCompiler &spirvCompiler, INOUT ComputePipelineDesc &ppln, EShaderLangFormat dstFormat)
+	{
 		ASSERT( IsSupported( ppln, dstFormat ) );
 		
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -1044,9 +1172,9 @@ namespace FG
 			String							log;
 			ComputePipelineDesc				new_ppln;
 
-			if ( not _spirvCompiler->Compile( EShader::Compute, iter->first, spirv_format, (*shader_data)->GetEntry(),
-											  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
-											  OUT new_ppln._shader, OUT reflection, OUT log ))
+			if ( not spirvCompiler.Compile( EShader::Compute, iter->first, spirv_format, (*shader_data)->GetEntry(),
+											(*shader_data)->GetData(), (*shader_data)->GetDebugName(),
+											OUT new_ppln._shader, OUT reflection, OUT log ))
 			{
 				COMP_RETURN_ERR( log );
 			}
@@ -1061,7 +1189,6 @@ namespace FG
 			UpdateBufferDynamicOffsets( new_ppln._pipelineLayout.descriptorSets );
 
 			std::swap( ppln, new_ppln );
-			_CheckHashCollision( ppln );
 
 			ASSERT( _CheckDescriptorBindings( ppln ));
 			return true;
@@ -1070,6 +1197,88 @@ namespace FG
 		RETURN_ERR( "invalid shader data type!" );
 	}
 	
+/*
+=================================================
+	CompileBatch
+----
+	each pipeline is compiled by single thread, shader stages are merged
+	in the same order as in 'Compile', so result doesn't depend on thread count.
+=================================================
+*/
+	bool VPipelineCompiler::CompileBatch (const PipelineBatch &batch, EShaderLangFormat dstFormat, uint threadCount)
+	{
+		using Pipeline_t = Union< NullUnion, GraphicsPipelineDesc*, ComputePipelineDesc*, MeshPipelineDesc*, RayTracingPipelineDesc* >;
+
+		EXLOCK( _lock );
+
+		Array< Pipeline_t >		pipelines;
+		pipelines.reserve( batch.graphics.size() + batch.compute.size() + batch.mesh.size() + batch.rayTracing.size() );
+		
+		for (auto* ppln : batch.graphics)	{ CHECK_ERR( ppln );  pipelines.emplace_back( ppln ); }
+		for (auto* ppln : batch.compute)	{ CHECK_ERR( ppln );  pipelines.emplace_back( ppln ); }
+		for (auto* ppln : batch.mesh)		{ CHECK_ERR( ppln );  pipelines.emplace_back( ppln ); }
+		for (auto* ppln : batch.rayTracing)	{ CHECK_ERR( ppln );  pipelines.emplace_back( ppln ); }
+
+		if ( pipelines.empty() )
+			return true;
+
+		if ( threadCount == 0 )
+			threadCount = Max( 1u, std::thread::hardware_concurrency() );
+
+		threadCount = Min( threadCount, uint(pipelines.size()) );
+
+		// glslang and reflection state can't be shared between threads
+		for (size_t i = _workerCompilers.size(); i < threadCount; ++i) {
+			_workerCompilers.emplace_back( new SpirvCompiler{ _directories });
+		}
+		for (uint i = 0; i < threadCount; ++i) {
+			_workerCompilers[i]->CopySettings( *_spirvCompiler );
+		}
+
+		Array<uint8_t>		compiled;	compiled.resize( pipelines.size() );
+		Atomic<size_t>		counter		{0};
+
+		const auto	Process = [&] (uint index)
+		{
+			SpirvCompiler&	compiler = *_workerCompilers[index];
+
+			for (size_t i = counter.fetch_add( 1, memory_order_relaxed ); i < pipelines.size();
+				 i = counter.fetch_add( 1, memory_order_relaxed ))
+			{
+				compiled[i] = Visit( pipelines[i],
+									 [] (NullUnion) { return false; },
+									 [&] (auto* ppln) { return _Compile( compiler, INOUT *ppln, dstFormat ); });
+			}
+		};
+
+		Array< std::thread >	threads;
+
+		for (uint i = 1; i < threadCount; ++i) {
+			threads.emplace_back( Process, i );
+		}
+
+		Process( 0 );
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		bool	result = true;
+
+		for (size_t i = 0; i < pipelines.size(); ++i)
+		{
+			if ( not compiled[i] )
+			{
+				result = false;
+				continue;
+			}
+			Visit( pipelines[i],
+				   [] (NullUnion) {},
+				   [this] (auto* ppln) { _CheckHashCollision( *ppln ); });
+		}
+		return result;
+	}
+
 /*
 =================================================
 	_CreateVulkanShader
@@ -1078,6 +1287,7 @@ namespace FG
 	bool VPipelineCompiler::_CreateVulkanShader (INOUT PipelineDescription::Shader &shader)
 	{
 		CHECK_ERR( _fpCreateShaderModule and _fpDestroyShaderModule );
+		EXLOCK( _shaderCacheGuard );
 
 		auto CreateShaderModule = BitCast<PFN_vkCreateShaderModule>(_fpCreateShaderModule);
 		uint count = 0;
@@ -16,6 +16,22 @@ namespace FG
 	class VPipelineCompiler final : public IPipelineCompiler
 	{
 	// types
+	public:
+		struct CacheStatistics
+		{
+			uint	hits		= 0;
+			uint	misses		= 0;
+			uint	evicted		= 0;
+		};
+
+		struct PipelineBatch
+		{
+			Array< GraphicsPipelineDesc *>		graphics;
+			Array< ComputePipelineDesc *>		compute;
+			Array< MeshPipelineDesc *>			mesh;
+			Array< RayTracingPipelineDesc *>	rayTracing;
+		};
+
 	private:
 		using StringShaderData	= PipelineDescription::SharedShaderPtr< String >;
 		using BinaryShaderData	= PipelineDescription::SharedShaderPtr< Array<uint> >;
@@ -36,7 +52,10 @@ namespace FG
 		Mutex								_lock;
 		Array< String >						_directories;
 		UniquePtr< class SpirvCompiler >	_spirvCompiler;
+		UniquePtr< class SpirvDiskCache >	_diskCache;
 		ShaderCache_t						_shaderCache;
+		Mutex								_shaderCacheGuard;
+		Array< UniquePtr< SpirvCompiler >>	_workerCompilers;		// for batch compilation
 		EShaderCompilationFlags				_compilerFlags			= Default;
 
 		DEBUG_ONLY(
@@ -65,6 +84,15 @@ namespace FG
 
 		ND_ EShaderCompilationFlags  GetCompilationFlags ()		{ EXLOCK( _lock );  return _compilerFlags; }
 
+		// enable persistent cache for compiled SPIRV and reflection,
+		// least recently used entries will be removed when cache size exceeds 'maxSize'.
+		bool SetCacheDirectory (StringView path, BytesU maxSize = 256_Mb);
+
+		// load all cache entries from directory to memory.
+		bool PrewarmCache (StringView path);
+
+		ND_ CacheStatistics  GetCacheStatistics ();
+
 		void ReleaseUnusedShaders ();
 		void ReleaseShaderCache ();
 
@@ -78,8 +106,17 @@ namespace FG
 		bool Compile (INOUT GraphicsPipelineDesc &ppln, EShaderLangFormat dstFormat) override;
 		bool Compile (INOUT ComputePipelineDesc &ppln, EShaderLangFormat dstFormat) override;
 
+		// compile pipelines on 'threadCount' threads (0 - number of hardware threads),
+		// result for each pipeline is the same as for 'Compile' call.
+		bool CompileBatch (const PipelineBatch &batch, EShaderLangFormat dstFormat, uint threadCount = 0);
+
 
 	private:
+		bool _Compile (SpirvCompiler &, INOUT MeshPipelineDesc &ppln, EShaderLangFormat dstFormat);
+		bool _Compile (SpirvCompiler &, INOUT RayTracingPipelineDesc &ppln, EShaderLangFormat dstFormat);
+		bool _Compile (SpirvCompiler &, INOUT GraphicsPipelineDesc &ppln, EShaderLangFormat dstFormat);
+		bool _Compile (SpirvCompiler &, INOUT ComputePipelineDesc &ppln, EShaderLangFormat dstFormat);
+
 		bool _MergePipelineResources (const PipelineDescription::PipelineLayout &srcLayout,
 									  INOUT PipelineDescription::PipelineLayout &dstLayout) const;
 
@@ -10,7 +10,7 @@
 #include "scene/Loader/DDS/DDSUtils.h"
 
 #include "framegraph/Shared/EnumUtils.h"
-#include "stl/Stream/FileStream.h"
+#include "stl/Stream/MappedFileStream.h"
 
 namespace FG
 {
@@ -22,7 +22,7 @@ namespace
 	LoadDX10Image
 =================================================
 */
-	static bool  LoadDX10Image (IntermImagePtr &image, const DDS_HEADER &header, const DDS_HEADER_DXT10 &headerDX10, FileRStream &file)
+	static bool  LoadDX10Image (IntermImagePtr &image, const DDS_HEADER &header, const DDS_HEADER_DXT10 &headerDX10, const SharedPtr<MappedFileRStream> &file)
 	{
 		CHECK_ERR( EnumEq( header.dwFlags, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT ));
 
@@ -92,15 +92,29 @@ namespace
 
 		IntermImage::Mipmaps_t	image_data;
 		const uint3				block_dim	{ (dim.x + info.blockSize.x-1) / info.blockSize.x, (dim.y + info.blockSize.y-1) / info.blockSize.y, dim.z };
+		const BytesU			level_size	{ block_dim.y * pitch * block_dim.z };
 		
+		// pixels will be read sequentially, start loading pages in background
+		file->WillNeed( file->Position(), level_size * array_layers * mipmap_count );
+
 		for (uint layer = 0; layer < array_layers; ++layer)
 		{
 			for (uint mm = 0; mm < mipmap_count; ++mm)
 			{
 				IntermImage::Level	image_level;
-				image_level.pixels.resize( block_dim.y * pitch * block_dim.z );
 
-				CHECK_ERR( file.Read( image_level.pixels.data(), ArraySizeOf(image_level.pixels) ));
+				if ( file->IsMapped() )
+				{
+					// zero-copy, memory is kept alive by image
+					image_level.mappedPixels = file->GetView( file->Position(), level_size );
+					CHECK_ERR( image_level.mappedPixels.size() == size_t(level_size) );
+					CHECK_ERR( file->SeekSet( file->Position() + level_size ));
+				}
+				else
+				{
+					image_level.pixels.resize( size_t(level_size) );
+					CHECK_ERR( file->Read( image_level.pixels.data(), level_size ));
+				}
 
 				image_level.format		= format;
 				image_level.dimension	= dim;
@@ -117,13 +131,13 @@ namespace
 			
 				auto&	curr_mm = image_data[mm][layer];
 
-				CHECK( curr_mm.pixels.empty() );	// warning: previous data will be discarded
+				CHECK( curr_mm.Pixels().empty() );	// warning: previous data will be discarded
 
 				curr_mm = std::move(image_level);
 			}
 		}
 
-		image->SetData( std::move(image_data), img_type );
+		image->SetData( std::move(image_data), img_type, file );
 		return true;
 	}
 	
@@ -132,7 +146,7 @@ namespace
 	LoadDDSImage
 =================================================
 */
-	static bool  LoadDDSImage (IntermImagePtr &image, const DDS_HEADER &header, FileRStream &file)
+	static bool  LoadDDSImage (IntermImagePtr &image, const DDS_HEADER &header, const SharedPtr<MappedFileRStream> &file)
 	{
 		// TODO
 		return false;
@@ -160,14 +174,14 @@ namespace
 			return true;
 		
 		// load DDS header
-		FileRStream		file{ filename };
-		CHECK_ERR( file.IsOpen() );
+		auto	file = MakeShared<MappedFileRStream>( filename );
+		CHECK_ERR( file->IsOpen() );
 
 		DDS_HEADER					header		= {};
 		Optional<DDS_HEADER_DXT10>	header_10;
 		bool						result		= true;
 
-		result &= file.Read( OUT header );
+		result &= file->Read( OUT header );
 		CHECK_ERR( result );
 		CHECK_ERR( header.dwMagic == MakeFourCC('D','D','S',' '));
 		CHECK_ERR( header.dwSize == sizeof(header) - sizeof(header.dwMagic) );
@@ -176,7 +190,7 @@ namespace
 		if ( EnumEq( header.ddspf.dwFlags, DDPF_FOURCC ) and header.ddspf.dwFourCC == MakeFourCC('D','X','1','0') )
 		{
 			header_10  = DDS_HEADER_DXT10{};
-			result    &= file.Read( OUT *header_10 );
+			result    &= file->Read( OUT *header_10 );
 
 			CHECK_ERR( result and LoadDX10Image( image, header, *header_10, file ));
 		}
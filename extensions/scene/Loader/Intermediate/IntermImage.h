@@ -3,6 +3,7 @@
 #pragma once
 
 #include "scene/Common.h"
+#include "stl/Stream/Stream.h"
 
 namespace FG
 {
@@ -17,13 +18,16 @@ namespace FG
 	public:
 		struct Level
 		{
-			uint3			dimension;
-			EPixelFormat	format		= Default;
-			ImageLayer		layer		= 0_layer;
-			MipmapLevel		mipmap		= 0_mipmap;
-			BytesU			rowPitch;
-			BytesU			slicePitch;
-			Array<uint8_t>	pixels;
+			uint3				dimension;
+			EPixelFormat		format		= Default;
+			ImageLayer			layer		= 0_layer;
+			MipmapLevel			mipmap		= 0_mipmap;
+			BytesU				rowPitch;
+			BytesU				slicePitch;
+			Array<uint8_t>		pixels;
+			ArrayView<uint8_t>	mappedPixels;		// points to memory owned by 'IntermImage::_storage', used instead of 'pixels'
+
+			ND_ ArrayView<uint8_t>  Pixels () const		{ return mappedPixels.empty() ? ArrayView<uint8_t>{pixels} : mappedPixels; }
 		};
 
 		using ArrayLayers_t		= Array< Level >;			// size == 1 for non-array images
@@ -32,12 +36,13 @@ namespace FG
 
 	// variables
 	private:
-		String		_srcPath;
+		String				_srcPath;
 
-		Mipmaps_t	_data;					// mipmaps[] { layers[] { level } }
-		EImage		_imageType	= Default;
+		Mipmaps_t			_data;					// mipmaps[] { layers[] { level } }
+		SharedPtr<RStream>	_storage;				// keeps memory for 'Level::mappedPixels'
+		EImage				_imageType	= Default;
 
-		bool		_immutable	= false;
+		bool				_immutable	= false;
 
 
 	// methods
@@ -47,8 +52,9 @@ namespace FG
 		explicit IntermImage (Mipmaps_t &&data, EImage type, StringView path = Default) : _srcPath{path}, _data{std::move(data)}, _imageType{type} {}
 
 		void  MakeImmutable ()							{ _immutable = true; }
-		void  SetData (Mipmaps_t &&data, EImage type)	{ ASSERT( not _immutable );  _data = std::move(data);  _imageType = type; }
-		void  ReleaseData ()							{ Mipmaps_t temp;  std::swap( temp, _data ); }
+		void  SetData (Mipmaps_t &&data, EImage type)	{ ASSERT( not _immutable );  _data = std::move(data);  _imageType = type;  _storage.reset(); }
+		void  SetData (Mipmaps_t &&data, EImage type, const SharedPtr<RStream> &storage)	{ SetData( std::move(data), type );  _storage = storage; }
+		void  ReleaseData ()							{ Mipmaps_t temp;  std::swap( temp, _data );  _storage.reset(); }
 
 		ND_ StringView			GetPath ()		const	{ return _srcPath; }
 		ND_ bool				IsImmutable ()	const	{ return _immutable; }
@@ -110,7 +110,7 @@ namespace
 
 				auto&	lvl = image.GetData()[mm][layer];
 
-				CHECK_ERR( file.Write( lvl.pixels.data(), ArraySizeOf(lvl.pixels) ));
+				CHECK_ERR( file.Write( lvl.Pixels() ));
 			}
 		}
 
@@ -155,7 +155,7 @@ namespace FG
 			task.mipmapLevel	= MipmapLevel{ uint(i) };
 			task.aspectMask		= EImageAspect::Color;
 			task.imageSize		= img.dimension;
-			task.data			= img.pixels;
+			task.data			= img.Pixels();
 			task.dataRowPitch	= img.rowPitch;
 			task.dataSlicePitch	= img.slicePitch;
 
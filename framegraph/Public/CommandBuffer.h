@@ -21,15 +21,17 @@ namespace FG
 	
 	struct CommandBufferDesc
 	{
-		EQueueType		queueType	= EQueueType::Graphics;
-		EDebugFlags		debugFlags	= Default;
-		StringView		name;
+		EQueueType			queueType			= EQueueType::Graphics;
+		EDebugFlags			debugFlags			= Default;
+		ECompilationFlags	compilationFlags	= Default;
+		StringView			name;
 		
 				 CommandBufferDesc () {}
 		explicit CommandBufferDesc (EQueueType type) : queueType{type} {}
 
 		CommandBufferDesc&  SetDebugFlags (EDebugFlags value)	{ debugFlags = value;  return *this; }
 		CommandBufferDesc&  SetDebugName (StringView value)		{ name = value;  return *this; }
+		CommandBufferDesc&  SetCompilationFlags (ECompilationFlags value)	{ compilationFlags = value;  return *this; }
 	};
 
 
@@ -74,6 +76,22 @@ namespace FG
 		// Buffer may be in immutable or mutable state, immutable state disables barrier placement that increases CPU performance.
 		virtual void		AcquireBuffer (RawBufferID id, bool makeMutable) = 0;
 
+		// Create image that can be used only in current command buffer, image will be released after execution.
+		// Memory is bound on compilation and may be shared with other transient resources that are not used at the same time,
+		// so image content is undefined before first use. Image must be used directly in tasks or in task descriptor sets.
+		ND_ virtual RawImageID	CreateTransientImage (const ImageDesc &desc, StringView dbgName = Default) = 0;
+
+		// Create buffer that can be used only in current command buffer, same as 'CreateTransientImage'.
+		ND_ virtual RawBufferID	CreateTransientBuffer (const BufferDesc &desc, StringView dbgName = Default) = 0;
+
+		// Move images and buffers from sparsely used memory blocks to more used blocks, copy tasks will be added to current command buffer.
+		// Resource IDs are not changed, only resources with transfer usage that are not used by other command buffers are moved.
+		// Resources that are referenced by cached pipeline resources (descriptor sets) or framebuffers are skipped,
+		// so sampled images and attachments are moved only after these caches are released.
+		// Current command buffer must be the only one that is recording, and the call must not run concurrently with
+		// 'IFrameGraph::Flush', 'IFrameGraph::Wait', resource creation or destruction. Returns size of moved resources.
+		virtual BytesU		DefragmentMemory (BytesU maxBytesToMove) = 0;
+
 	// tasks //
 		virtual Task		AddTask (const SubmitRenderPass &) = 0;
 		virtual Task		AddTask (const DispatchCompute &) = 0;
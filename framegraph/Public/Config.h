@@ -57,6 +57,8 @@ namespace FG
 
 	// render pass
 	static constexpr unsigned	FG_MaxRenderPassSubpasses	= 8;
+	static constexpr unsigned	FG_MaxRecordingThreads		= 8;	// for 'ECompilationFlags::ParallelRenderPass'
+	static constexpr unsigned	FG_MinDrawTasksPerThread	= 256;
 
 	// pipeline
 	static constexpr unsigned	FG_MaxPushConstants			= 8;
@@ -22,6 +22,7 @@ namespace FG
 		LogTasks						= 1 << 0,	// 
 		LogBarriers						= 1 << 1,	//
 		LogResourceUsage				= 1 << 2,	// 
+		LogBarrierBatching				= 1 << 3,	// add number of pipeline barriers that was saved by 'ECompilationFlags::BatchBarriers'
 
 		VisTasks						= 1 << 10,
 		VisDrawTasks					= 1 << 11,
@@ -52,4 +53,13 @@ namespace FG
 	FG_BIT_OPERATORS( EDebugFlags );
 
 
+	enum class ECompilationFlags : uint
+	{
+		BatchBarriers					= 1 << 0,	// merge pipeline barriers of independent transfer and compute tasks
+		ParallelRenderPass				= 1 << 1,	// record draw tasks of large render passes into secondary command buffers on multiple threads
+		Unknown							= 0,
+	};
+	FG_BIT_OPERATORS( ECompilationFlags );
+
+
 }	// FG
@@ -35,6 +35,8 @@ namespace FG
 		using OnExternalImageReleased_t		= std::function< void (const ExternalImage_t &) >;
 		using OnExternalBufferReleased_t	= std::function< void (const ExternalBuffer_t &) >;
 		using ShaderDebugCallback_t			= std::function< void (StringView taskName, StringView shaderName, EShaderStages, ArrayView<String> output) >;
+		using ReadbackExecutor_t			= std::function< void (std::function<void ()> &&task) >;
+		using MemoryBudgetCallback_t		= std::function< void (uint heapIndex, BytesU usage, BytesU budget) >;
 
 		struct RenderingStatistics
 		{
@@ -64,11 +66,51 @@ namespace FG
 			Nanoseconds waitingTime					{0};
 		};
 
+		struct MemoryHeapStatistics
+		{
+			BytesU		size;								// total heap size
+			BytesU		allocated;							// size of memory blocks that was allocated by frame graph
+			BytesU		used;								// sum of allocation sizes
+			uint		allocationCount				= 0;
+			BytesU		highWaterMark;						// max used size since last 'GetStatistics' call
+			BytesU		budget;								// requires 'VK_EXT_memory_budget', otherwise zero
+			BytesU		usage;								// memory usage of the process, requires 'VK_EXT_memory_budget', otherwise zero
+			bool		isDeviceLocal				= false;
+		};
+
 		struct ResourceStatistics
 		{
 			uint		newGraphicsPipelineCount	= 0;
 			uint		newComputePipelineCount		= 0;
 			uint		newRayTracingPipelineCount	= 0;
+
+			// requires 'VK_EXT_pipeline_creation_feedback'
+			uint		pipelineCacheHits			= 0;
+			uint		pipelineCacheMisses			= 0;
+
+			uint		descriptorSetCacheHits		= 0;	// unchanged 'PipelineResources', used cached descriptor set without hashing
+			uint		descriptorSetDedupHits		= 0;	// found descriptor set with the same content
+			uint		descriptorSetCacheMisses	= 0;	// new descriptor set created
+
+			// host-to-device staging rings, sum for all queues
+			BytesU		stagingBufferSize;					// total size of ring buffers
+			BytesU		stagingHighWaterMark;				// max size of staging memory used by batches in flight since last 'GetStatistics' call
+			BytesU		stagingBufferUsed;					// size of staging memory that is used by batches in flight
+			uint		stagingRingGrowCount		= 0;	// number of times when ring was replaced by larger one
+
+			// transient resources, see 'ICommandBuffer::CreateTransientImage'
+			BytesU		transientMemorySize;				// sum of transient resource sizes
+			BytesU		transientMemorySaved;				// memory that is shared between transient resources with non-overlapping lifetime
+
+			// device memory fragmentation, see 'ICommandBuffer::DefragmentMemory'
+			uint		memoryBlockCount			= 0;	// number of allocated device memory blocks
+			BytesU		memoryUsed;							// sum of allocation sizes
+			BytesU		memoryUnused;						// free space in allocated blocks
+			BytesU		memoryLargestFreeRange;				// if much less than 'memoryUnused' then memory is fragmented
+			uint		defragmentedResources		= 0;	// number of resources that was moved to another memory block
+			BytesU		defragmentedBytes;
+
+			FixedArray< MemoryHeapStatistics, 16 >	memoryHeaps;	// same indices as in 'VkPhysicalDeviceMemoryProperties::memoryHeaps'
 		};
 
 		struct Statistics
@@ -97,11 +139,30 @@ namespace FG
 			
 			// Add pipeline compiler.
 			virtual bool			AddPipelineCompiler (const PipelineCompiler &comp) = 0;
+
+			// Load pipeline cache that was saved by 'SavePipelineCache'.
+			// Returns 'false' if file is not found or was created on another device or driver, in this case cache stays empty.
+			// Must be called before first 'Begin' call, otherwise cache is used only by new command buffers.
+			virtual bool			LoadPipelineCache (NtStringView filename) = 0;
+
+			// Save pipeline cache that contains all pipelines from executed command buffers.
+			virtual bool			SavePipelineCache (NtStringView filename) = 0;
 			
 			// Callback will be called at end of the frame if debugging enabled by
 			// calling 'Task::EnableDebugTrace' and shader compiled with 'EShaderLangFormat::EnableDebugTrace' flag.
 			virtual bool			SetShaderDebugCallback (ShaderDebugCallback_t &&) = 0;
 
+			// By default 'ReadBuffer' and 'ReadImage' callbacks are called in thread that calls 'Wait' or 'Flush'.
+			// If executor is set then callbacks are passed to it and may be called in any thread,
+			// staging memory is kept alive until callback returns. Executor must not depend on the thread that calls 'Deinitialize'.
+			// Pass empty function to restore default behaviour.
+			virtual bool			SetReadbackExecutor (ReadbackExecutor_t &&) = 0;
+
+			// Callback will be called in 'Flush' for each memory heap where usage exceeds 'softBudget' part of the heap budget,
+			// or part of the heap size if 'VK_EXT_memory_budget' is not supported.
+			// Application may release streamed resources to avoid out of memory error. Pass empty function to disable.
+			virtual bool			SetMemoryBudgetCallback (float softBudget, MemoryBudgetCallback_t &&) = 0;
+
 			// Returns device info with which framegraph has been crated.
 		ND_ virtual DeviceInfo_t	GetDeviceInfo () const = 0;
 
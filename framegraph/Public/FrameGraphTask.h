@@ -728,6 +728,7 @@ namespace FG
 		BytesU			offset;
 		BytesU			size;
 		Callback_t		callback;
+		bool			contiguous	= false;	// if 'true' and size is not greater than staging page then data will be in single part
 
 	// methods
 		ReadBuffer () :
@@ -748,6 +749,12 @@ namespace FG
 			callback = std::move(value);
 			return *this;
 		}
+
+		ReadBuffer&  SetContiguous (bool value = true)
+		{
+			contiguous = value;
+			return *this;
+		}
 	};
 
 
@@ -850,6 +857,7 @@ namespace FG
 		MipmapLevel		mipmapLevel;
 		EImageAspect	aspectMask	= EImageAspect::Color;	// must only have a single bit set
 		Callback_t		callback;
+		bool			contiguous	= false;	// if 'true' and size is not greater than staging page then data will be in single part
 
 		
 	// methods
@@ -893,6 +901,12 @@ namespace FG
 			callback = std::move(value);
 			return *this;
 		}
+
+		ReadImage&  SetContiguous (bool value = true)
+		{
+			contiguous = value;
+			return *this;
+		}
 	};
 
 
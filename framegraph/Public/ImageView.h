@@ -27,6 +27,9 @@ namespace FG
 		using LoadRGBA32uFun_t	= void (*) (ArrayView<T>, OUT RGBA32u &);
 		using LoadRGBA32iFun_t	= void (*) (ArrayView<T>, OUT RGBA32i &);
 
+		using LoadRowFun_t		= void (*) (const T *src, size_t count, OUT RGBA32f *dst);
+		using StoreRowFun_t		= void (*) (const RGBA32f *src, size_t count, OUT T *dst);
+
 
 	// variables
 	private:
@@ -39,6 +42,7 @@ namespace FG
 		LoadRGBA32fFun_t	_loadF4			= null;
 		LoadRGBA32uFun_t	_loadU4			= null;
 		LoadRGBA32iFun_t	_loadI4			= null;
+		LoadRowFun_t		_loadRow		= null;
 
 
 	// methods
@@ -115,6 +119,22 @@ namespace FG
 			return _loadI4( GetPixel( point ), OUT col );
 		}
 
+
+		// converts region to RGBA32f, result is tightly packed: 'dst[x + y * size.x]'.
+		// uses bulk conversion for common formats and per-pixel 'Load' for others.
+		bool  LoadRows (const uint2 &offset, const uint2 &size, OUT Array<RGBA32f> &dst, uint z = 0) const;
+
+		bool  LoadRows (uint firstRow, uint rowCount, OUT Array<RGBA32f> &dst, uint z = 0) const
+		{
+			return LoadRows( uint2{0, firstRow}, uint2{_dimension.x, rowCount}, OUT dst, z );
+		}
+
+		// converts tightly packed 'src' to 'format' and writes 'size.y' rows to 'dst' with 'dstRowPitch'.
+		// supports only formats with bulk conversion.
+		static bool  StoreRows (EPixelFormat format, EImageAspect aspect, const uint2 &size, ArrayView<RGBA32f> src,
+								BytesU dstRowPitch, OUT T *dst, BytesU dstSize);
+
+
 		/*void Load (const uint3 &point, OUT RGBA32f &col) const
 		{
 			ASSERT( _isFloatFormat );
@@ -139,6 +139,7 @@ namespace FG
 		};
 
 		using CachedID			= Atomic< RawPipelineResourcesID::Value_t >;
+		using CachedHash		= Atomic< size_t >;
 		using DeallocatorFn_t	= void (*) (void*, void*, BytesU);
 
 		struct Uniform
@@ -192,6 +193,7 @@ namespace FG
 		DynamicDataPtr			_dataPtr;
 		bool					_allowEmptyResources	= false;
 		mutable CachedID		_cachedId;
+		mutable CachedHash		_cachedHash;		// hash of content, calculated on demand and reset on any changes
 		RWDataRaceCheck			_drCheck;
 
 
@@ -211,6 +213,7 @@ namespace FG
 			_allowEmptyResources{ other._allowEmptyResources }
 		{
 			_SetCachedID( other._GetCachedID() );
+			_cachedHash.store( other._cachedHash.load( memory_order_relaxed ), memory_order_relaxed );
 		}
 
 		Self&  BindImage (const UniformID &id, RawImageID image, uint elementIndex = 0);
@@ -257,7 +260,7 @@ namespace FG
 
 	private:
 		void _SetCachedID (RawPipelineResourcesID id)		const	{ _cachedId.store( BitCast<uint>(id.Data()), memory_order_relaxed ); }
-		void _ResetCachedID ()								const	{ _cachedId.store( UMax, memory_order_relaxed ); }
+		void _ResetCachedID ()								const	{ _cachedId.store( UMax, memory_order_relaxed );  _cachedHash.store( 0, memory_order_relaxed ); }
 		
 		ND_ RawPipelineResourcesID	_GetCachedID ()			const	{ return RawPipelineResourcesID( _cachedId.load( memory_order_acquire )); }
 
@@ -49,7 +49,7 @@ namespace FG
 		HostRead		= 1 << 0,
 		HostWrite		= 1 << 1,
 		Dedicated		= 1 << 2,		// force to use dedicated allocation
-		//AllowAliasing	= 1 << 3,		// 
+		Transient		= 1 << 3,		// memory is bound on command buffer compilation and may be aliased, see 'ICommandBuffer::CreateTransientImage'
 		//Sparse		= 1 << 4,
 		_Last,
 	};
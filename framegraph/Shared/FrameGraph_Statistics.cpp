@@ -44,6 +44,41 @@ namespace FG
 		dst.newComputePipelineCount		+= src.newComputePipelineCount;
 		dst.newGraphicsPipelineCount	+= src.newGraphicsPipelineCount;
 		dst.newRayTracingPipelineCount	+= src.newRayTracingPipelineCount;
+		dst.pipelineCacheHits			+= src.pipelineCacheHits;
+		dst.pipelineCacheMisses			+= src.pipelineCacheMisses;
+		dst.descriptorSetCacheHits		+= src.descriptorSetCacheHits;
+		dst.descriptorSetDedupHits		+= src.descriptorSetDedupHits;
+		dst.descriptorSetCacheMisses	+= src.descriptorSetCacheMisses;
+		dst.stagingBufferSize			 = Max( dst.stagingBufferSize, src.stagingBufferSize );
+		dst.stagingHighWaterMark		 = Max( dst.stagingHighWaterMark, src.stagingHighWaterMark );
+		dst.stagingRingGrowCount		+= src.stagingRingGrowCount;
+		dst.transientMemorySize			+= src.transientMemorySize;
+		dst.transientMemorySaved		+= src.transientMemorySaved;
+		dst.memoryBlockCount			 = Max( dst.memoryBlockCount, src.memoryBlockCount );
+		dst.memoryUsed					 = Max( dst.memoryUsed, src.memoryUsed );
+		dst.memoryUnused				 = Max( dst.memoryUnused, src.memoryUnused );
+		dst.memoryLargestFreeRange		 = Max( dst.memoryLargestFreeRange, src.memoryLargestFreeRange );
+		dst.defragmentedResources		+= src.defragmentedResources;
+		dst.defragmentedBytes			+= src.defragmentedBytes;
+		dst.stagingBufferUsed			 = Max( dst.stagingBufferUsed, src.stagingBufferUsed );
+
+		if ( dst.memoryHeaps.size() < src.memoryHeaps.size() )
+			dst.memoryHeaps.resize( src.memoryHeaps.size() );
+
+		for (size_t i = 0; i < src.memoryHeaps.size(); ++i)
+		{
+			auto&	s = src.memoryHeaps[i];
+			auto&	d = dst.memoryHeaps[i];
+
+			d.size				= Max( d.size, s.size );
+			d.allocated			= Max( d.allocated, s.allocated );
+			d.used				= Max( d.used, s.used );
+			d.allocationCount	= Max( d.allocationCount, s.allocationCount );
+			d.highWaterMark		= Max( d.highWaterMark, s.highWaterMark );
+			d.budget			= Max( d.budget, s.budget );
+			d.usage				= Max( d.usage, s.usage );
+			d.isDeviceLocal		|= s.isDeviceLocal;
+		}
 	}
 
 /*
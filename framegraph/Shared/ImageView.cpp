@@ -1,6 +1,7 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "Public/ImageView.h"
+#include "Shared/ImageViewKernels.h"
 
 namespace FG
 {
@@ -13,35 +14,6 @@ namespace {
 
 		FloatBits () : m{0}, e{0}, s{0} {}
 	};
-
-
-	struct HalfBits
-	{
-		uint16_t	m	: 10;	// mantissa bits
-		uint16_t	e	: 5;	// exponent bits
-		uint16_t	s	: 1;	// sign bit
-
-		HalfBits () : m{0}, e{0}, s{0} {}
-
-		ND_ float  ToFloat () const;
-	};
-	
-/*
-=================================================
-	ToFloat
-=================================================
-*/
-	inline float  HalfBits::ToFloat () const
-	{
-		FloatBits	f;
-		f.s = s;
-		f.e = e + (127 - 15);
-		f.m = m << (23-10);
-
-		float	result;
-		std::memcpy( OUT &result, &f, sizeof(result) );
-		return result;
-	}
 }
 //-----------------------------------------------------------------------------
 
@@ -57,10 +29,13 @@ namespace {
 	{
 		STATIC_ASSERT( Bits <= 32 );
 
-		FloatBits	f;
-		f.e	= 127 + Bits;
-
-		return float(value) / BitCast<float>(f);
+		if constexpr ( Bits == 0 )
+		{
+			(void)(value);
+			return 0.0f;
+		}
+		else
+			return float(value) / float((uint64_t(1) << Bits) - 1);
 	}
 
 /*
@@ -202,12 +177,12 @@ namespace {
 	{
 		if constexpr ( R == 16 )
 		{
-			StaticArray< HalfBits, 4 >	src = {};
+			StaticArray< uint16_t, 4 >	src = {};
 			std::memcpy( src.data(), pixel.data(), Min( (R+G+B+A+7)/8, size_t(ArraySizeOf(pixel)) ));
 
 			for (size_t i = 0; i < src.size(); ++i)
 			{
-				result[i] = src[i].ToFloat();
+				result[i] = HalfToFloat( src[i] );
 			}
 		}
 		else
@@ -229,40 +204,26 @@ namespace {
 */
 	static void ReadFloat_11_11_10 (ArrayView<ImageView::T> pixel, OUT RGBA32f &result)
 	{
-		struct RGBBits
-		{
-			// Blue //
-			uint	b_m	: 5;
-			uint	b_e	: 5;
-			// Green //
-			uint	g_m	: 6;
-			uint	g_e	: 5;
-			// Red //
-			uint	r_m	: 6;
-			uint	r_e	: 5;
-		};
-		STATIC_ASSERT( sizeof(RGBBits)*8 == (11+11+10) );
-
-		RGBBits	bits;
-		std::memcpy( &bits, pixel.data(), sizeof(bits) );
-
-		FloatBits	f;
-		
-		f.m = bits.r_m << (23-6);
-		f.e = bits.r_e + (127 - 15);
-		result.r = BitCast<float>(f);
-
-		f.m = bits.g_m << (23-6);
-		f.e = bits.g_e + (127 - 15);
-		result.g = BitCast<float>(f);
-
-		f.m = bits.b_m << (23-5);
-		f.e = bits.b_e + (127 - 15);
-		result.b = BitCast<float>(f);
+		uint	bits = 0;
+		std::memcpy( &bits, pixel.data(), Min( sizeof(bits), size_t(ArraySizeOf(pixel)) ));
 
+		result.r = UFloatToFloat<6>( bits & 0x7FF );
+		result.g = UFloatToFloat<6>( (bits >> 11) & 0x7FF );
+		result.b = UFloatToFloat<5>( bits >> 22 );
 		result.a = 1.0f;
 	}
 
+/*
+=================================================
+	ReadUNorm_BGRA8
+=================================================
+*/
+	static void ReadUNorm_BGRA8 (ArrayView<ImageView::T> pixel, OUT RGBA32f &result)
+	{
+		ReadUNorm<8,8,8,8>( pixel, OUT result );
+		std::swap( result.r, result.b );
+	}
+
 /*
 =================================================
 	constructor
@@ -491,18 +452,46 @@ namespace {
 				_loadF4			= &ReadFloat<32,32,32,32>;
 				break;
 
+			// depth aspect is copied as 16 bit unorm, 24 bit unorm in 32 bit word or 32 bit float
 			case EPixelFormat::Depth16 :
+				ASSERT( aspect == EImageAspect::Depth );
+				_bitsPerPixel	= 16;
+				_loadF4			= &ReadUNorm<16,0,0,0>;
+				break;
+
 			case EPixelFormat::Depth24 :
+				ASSERT( aspect == EImageAspect::Depth );
+				_bitsPerPixel	= 32;
+				_loadF4			= &ReadUNorm<24,0,0,0>;
+				break;
+
 			case EPixelFormat::Depth32F :
 				ASSERT( aspect == EImageAspect::Depth );
-				ASSERT(false);
+				_bitsPerPixel	= 32;
+				_loadF4			= &ReadFloat<32,0,0,0>;
 				break;
 
 			case EPixelFormat::Depth16_Stencil8	:
 			case EPixelFormat::Depth24_Stencil8 :
 			case EPixelFormat::Depth32F_Stencil8 :
 				ASSERT( aspect == EImageAspect::Depth or aspect == EImageAspect::Stencil );
-				ASSERT(false);
+				if ( aspect == EImageAspect::Stencil )
+				{
+					_bitsPerPixel	= 8;
+					_loadI4			= &ReadInt<8,0,0,0>;
+					_loadU4			= &ReadUInt<8,0,0,0>;
+				}
+				else
+				if ( _format == EPixelFormat::Depth16_Stencil8 )
+				{
+					_bitsPerPixel	= 16;
+					_loadF4			= &ReadUNorm<16,0,0,0>;
+				}
+				else
+				{
+					_bitsPerPixel	= 32;
+					_loadF4			= (_format == EPixelFormat::Depth24_Stencil8 ? &ReadUNorm<24,0,0,0> : &ReadFloat<32,0,0,0>);
+				}
 				break;
 
 			case EPixelFormat::sRGB8 :
@@ -522,9 +511,14 @@ namespace {
 				_loadI4			= &ReadInt<8,8,8,8>;
 				_loadU4			= &ReadUInt<8,8,8,8>;
 				break;
+
+			case EPixelFormat::BGRA8_UNorm :
+				ASSERT( aspect == EImageAspect::Color );
+				_bitsPerPixel	= 4*8;
+				_loadF4			= &ReadUNorm_BGRA8;
+				break;
 				
 			case EPixelFormat::BGR8_UNorm :
-			case EPixelFormat::BGRA8_UNorm :
 			case EPixelFormat::BC1_RGB8_UNorm :
 			case EPixelFormat::BC1_sRGB8 :
 			case EPixelFormat::BC1_RGB8_A1_UNorm :
@@ -588,6 +582,61 @@ namespace {
 				break;	// to shutup warnings
 		}
 		END_ENUM_CHECKS();
+
+		_loadRow = GetPixelRowKernels( _format, aspect ).load;
+	}
+
+/*
+=================================================
+	LoadRows
+=================================================
+*/
+	bool  ImageView::LoadRows (const uint2 &offset, const uint2 &size, OUT Array<RGBA32f> &dst, uint z) const
+	{
+		CHECK_ERR( All( offset + size <= _dimension.xy() ) and z < _dimension.z );
+		CHECK_ERR( _loadRow or _loadF4 );
+
+		dst.resize( size_t(size.x) * size.y );
+
+		for (uint y = 0; y < size.y; ++y)
+		{
+			RGBA32f*	row_dst = dst.data() + size_t(size.x) * y;
+
+			if ( _loadRow )
+			{
+				// all formats with bulk conversion have byte aligned pixels
+				auto	row = GetRow( offset.y + y, z );
+				_loadRow( row.data() + (size_t(offset.x) * _bitsPerPixel) / 8, size.x, OUT row_dst );
+			}
+			else
+			{
+				for (uint x = 0; x < size.x; ++x) {
+					_loadF4( GetPixel( uint3{ offset.x + x, offset.y + y, z }), OUT row_dst[x] );
+				}
+			}
+		}
+		return true;
+	}
+
+/*
+=================================================
+	StoreRows
+=================================================
+*/
+	bool  ImageView::StoreRows (EPixelFormat format, EImageAspect aspect, const uint2 &size, ArrayView<RGBA32f> src,
+								BytesU dstRowPitch, OUT T *dst, BytesU dstSize)
+	{
+		const auto	kernels	= GetPixelRowKernels( format, aspect );
+
+		CHECK_ERR( kernels.store and dst );
+		CHECK_ERR( src.size() >= size_t(size.x) * size.y );
+		CHECK_ERR( size.y == 0 or size_t(dstRowPitch) * (size.y - 1) + size_t(size.x) * kernels.bytesPerPixel <= size_t(dstSize) );
+
+		for (uint y = 0; y < size.y; ++y)
+		{
+			kernels.store( src.data() + size_t(size.x) * y, size.x, OUT dst + size_t(dstRowPitch) * y );
+		}
+		return true;
 	}
 
 }	// FG
@@ -0,0 +1,671 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Shared/ImageViewKernels.h"
+
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#	define FG_PIXEL_SSE2
+#	include <immintrin.h>
+
+#	ifdef __AVX2__
+#		define FG_PIXEL_AVX2
+#	endif
+#	if defined(__F16C__) or (defined(COMPILER_MSVC) and defined(__AVX2__))
+#		define FG_PIXEL_F16C
+#	endif
+
+#elif defined(__aarch64__) or defined(_M_ARM64)
+#	define FG_PIXEL_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace FG
+{
+namespace
+{
+	using T				= ImageView::T;
+	using LoadRowFun_t	= ImageView::LoadRowFun_t;
+	using StoreRowFun_t	= ImageView::StoreRowFun_t;
+
+	STATIC_ASSERT( sizeof(RGBA32f) == sizeof(float) * 4 );
+	STATIC_ASSERT( sizeof(T) == 1 );
+
+/*
+=================================================
+	FloatToUNorm
+=================================================
+*/
+	forceinline uint  FloatToUNorm (float value, float maxValue)
+	{
+		return uint( Min( Max( value, 0.0f ), 1.0f ) * maxValue + 0.5f );
+	}
+
+/*
+=================================================
+	LoadRGBA8 / StoreRGBA8
+----
+	'SwapRB' is used for BGRA format
+=================================================
+*/
+	template <bool SwapRB>
+	static void  LoadRGBA8_Scalar (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		const float	scale = 1.0f / 255.0f;
+
+		for (size_t i = 0; i < count; ++i, src += 4)
+		{
+			dst[i] = RGBA32f{ float(src[SwapRB ? 2 : 0]) * scale, float(src[1]) * scale,
+							  float(src[SwapRB ? 0 : 2]) * scale, float(src[3]) * scale };
+		}
+	}
+
+	template <bool SwapRB>
+	static void  StoreRGBA8_Scalar (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		for (size_t i = 0; i < count; ++i, dst += 4)
+		{
+			const RGBA32f&	c = src[i];
+			dst[SwapRB ? 2 : 0]	= T(FloatToUNorm( c.r, 255.0f ));
+			dst[1]				= T(FloatToUNorm( c.g, 255.0f ));
+			dst[SwapRB ? 0 : 2]	= T(FloatToUNorm( c.b, 255.0f ));
+			dst[3]				= T(FloatToUNorm( c.a, 255.0f ));
+		}
+	}
+
+	template <bool SwapRB>
+	static void  LoadRGBA8_SIMD (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_AVX2)
+		const __m256	scale = _mm256_set1_ps( 1.0f / 255.0f );
+
+		for (; i + 8 <= count; i += 8)
+		{
+			for (size_t j = 0; j < 8; j += 2)
+			{
+				const __m256i	c = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i *>(src + (i + j) * 4) ));
+				__m256			f = _mm256_mul_ps( _mm256_cvtepi32_ps( c ), scale );
+
+				if constexpr ( SwapRB )
+					f = _mm256_permute_ps( f, _MM_SHUFFLE(3,0,1,2) );
+
+				_mm256_storeu_ps( reinterpret_cast<float *>(dst + i + j), f );
+			}
+		}
+
+	#elif defined(FG_PIXEL_SSE2)
+		const __m128	scale	= _mm_set1_ps( 1.0f / 255.0f );
+		const __m128i	zero	= _mm_setzero_si128();
+
+		const auto	Store = [scale, dst] (size_t idx, __m128i c)
+		{
+			__m128	f = _mm_mul_ps( _mm_cvtepi32_ps( c ), scale );
+
+			if constexpr ( SwapRB )
+				f = _mm_shuffle_ps( f, f, _MM_SHUFFLE(3,0,1,2) );
+
+			_mm_storeu_ps( reinterpret_cast<float *>(dst + idx), f );
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	p	= _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + i * 4) );
+			const __m128i	lo	= _mm_unpacklo_epi8( p, zero );
+			const __m128i	hi	= _mm_unpackhi_epi8( p, zero );
+
+			Store( i+0, _mm_unpacklo_epi16( lo, zero ));
+			Store( i+1, _mm_unpackhi_epi16( lo, zero ));
+			Store( i+2, _mm_unpacklo_epi16( hi, zero ));
+			Store( i+3, _mm_unpackhi_epi16( hi, zero ));
+		}
+
+	#elif defined(FG_PIXEL_NEON)
+		const float32x4_t	scale		= vdupq_n_f32( 1.0f / 255.0f );
+		const uint8_t		swap_idx[]	= { 2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15 };
+		const uint8x16_t	swap		= vld1q_u8( swap_idx );
+		float *				d			= reinterpret_cast<float *>(dst);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			uint8x16_t	p = vld1q_u8( src + i * 4 );
+
+			if constexpr ( SwapRB )
+				p = vqtbl1q_u8( p, swap );
+
+			const uint16x8_t	lo = vmovl_u8( vget_low_u8( p ));
+			const uint16x8_t	hi = vmovl_u8( vget_high_u8( p ));
+
+			vst1q_f32( d + i*4 +  0, vmulq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ))), scale ));
+			vst1q_f32( d + i*4 +  4, vmulq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ))), scale ));
+			vst1q_f32( d + i*4 +  8, vmulq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ))), scale ));
+			vst1q_f32( d + i*4 + 12, vmulq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ))), scale ));
+		}
+	#endif
+
+		LoadRGBA8_Scalar<SwapRB>( src + i*4, count - i, OUT dst + i );
+	}
+
+	template <bool SwapRB>
+	static void  StoreRGBA8_SIMD (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_SSE2)
+		const __m128	zero	= _mm_setzero_ps();
+		const __m128	one		= _mm_set1_ps( 1.0f );
+		const __m128	scale	= _mm_set1_ps( 255.0f );
+		const __m128	half	= _mm_set1_ps( 0.5f );
+
+		const auto	ToUNorm = [&] (size_t idx)
+		{
+			__m128	f = _mm_loadu_ps( reinterpret_cast<const float *>(src + idx) );
+
+			if constexpr ( SwapRB )
+				f = _mm_shuffle_ps( f, f, _MM_SHUFFLE(3,0,1,2) );
+
+			f = _mm_min_ps( _mm_max_ps( f, zero ), one );
+			return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( f, scale ), half ));
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	lo = _mm_packs_epi32( ToUNorm( i+0 ), ToUNorm( i+1 ));
+			const __m128i	hi = _mm_packs_epi32( ToUNorm( i+2 ), ToUNorm( i+3 ));
+
+			_mm_storeu_si128( reinterpret_cast<__m128i *>(dst + i*4), _mm_packus_epi16( lo, hi ));
+		}
+
+	#elif defined(FG_PIXEL_NEON)
+		const float32x4_t	zero		= vdupq_n_f32( 0.0f );
+		const float32x4_t	one			= vdupq_n_f32( 1.0f );
+		const float32x4_t	scale		= vdupq_n_f32( 255.0f );
+		const float32x4_t	half		= vdupq_n_f32( 0.5f );
+		const uint8_t		swap_idx[]	= { 2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15 };
+		const uint8x16_t	swap		= vld1q_u8( swap_idx );
+		const float *		s			= reinterpret_cast<const float *>(src);
+
+		const auto	ToUNorm = [&] (size_t idx)
+		{
+			const float32x4_t	f = vminq_f32( vmaxq_f32( vld1q_f32( s + idx*4 ), zero ), one );
+			return vmovn_u32( vcvtq_u32_f32( vaddq_f32( vmulq_f32( f, scale ), half )));
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const uint16x8_t	lo	= vcombine_u16( ToUNorm( i+0 ), ToUNorm( i+1 ));
+			const uint16x8_t	hi	= vcombine_u16( ToUNorm( i+2 ), ToUNorm( i+3 ));
+			uint8x16_t			p	= vcombine_u8( vmovn_u16( lo ), vmovn_u16( hi ));
+
+			if constexpr ( SwapRB )
+				p = vqtbl1q_u8( p, swap );
+
+			vst1q_u8( dst + i*4, p );
+		}
+	#endif
+
+		StoreRGBA8_Scalar<SwapRB>( src + i, count - i, OUT dst + i*4 );
+	}
+
+/*
+=================================================
+	LoadRGBA16F / StoreRGBA16F
+=================================================
+*/
+	static void  LoadRGBA16F_Scalar (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		for (size_t i = 0; i < count; ++i, src += 8)
+		{
+			uint16_t	h[4];
+			std::memcpy( OUT h, src, sizeof(h) );
+
+			dst[i] = RGBA32f{ HalfToFloat( h[0] ), HalfToFloat( h[1] ), HalfToFloat( h[2] ), HalfToFloat( h[3] )};
+		}
+	}
+
+	static void  StoreRGBA16F_Scalar (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		for (size_t i = 0; i < count; ++i, dst += 8)
+		{
+			const uint16_t	h[4] = { FloatToHalf( src[i].r ), FloatToHalf( src[i].g ), FloatToHalf( src[i].b ), FloatToHalf( src[i].a )};
+			std::memcpy( OUT dst, h, sizeof(h) );
+		}
+	}
+
+#if defined(FG_PIXEL_SSE2) and not defined(FG_PIXEL_F16C)
+	// 'h' contains half float in low 16 bits
+	forceinline __m128  HalfToFloat_SSE2 (__m128i h)
+	{
+		const __m128i	sign	= _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x8000 )), 16 );
+		const __m128i	exp_m	= _mm_and_si128( h, _mm_set1_epi32( 0x7FFF ));
+		const __m128i	inf_nan	= _mm_cmpgt_epi32( exp_m, _mm_set1_epi32( 0x7BFF ));
+
+		// multiply by 2^112 to rebias exponent, denormals are normalized too
+		const __m128	f		= _mm_mul_ps( _mm_castsi128_ps( _mm_slli_epi32( exp_m, 13 )), _mm_castsi128_ps( _mm_set1_epi32( 0x77800000 )));
+		const __m128i	bits	= _mm_or_si128( _mm_castps_si128( f ), _mm_and_si128( inf_nan, _mm_set1_epi32( 0x7F800000 )));
+
+		return _mm_castsi128_ps( _mm_or_si128( bits, sign ));
+	}
+#endif
+
+	static void  LoadRGBA16F_SIMD (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_F16C)
+		for (; i < count; ++i)
+		{
+			const __m128i	h = _mm_loadl_epi64( reinterpret_cast<const __m128i *>(src + i*8) );
+			_mm_storeu_ps( reinterpret_cast<float *>(dst + i), _mm_cvtph_ps( h ));
+		}
+
+	#elif defined(FG_PIXEL_SSE2)
+		const __m128i	zero = _mm_setzero_si128();
+
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m128i	h = _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + i*8) );
+			_mm_storeu_ps( reinterpret_cast<float *>(dst + i + 0), HalfToFloat_SSE2( _mm_unpacklo_epi16( h, zero )));
+			_mm_storeu_ps( reinterpret_cast<float *>(dst + i + 1), HalfToFloat_SSE2( _mm_unpackhi_epi16( h, zero )));
+		}
+
+	#elif defined(FG_PIXEL_NEON)
+		for (; i < count; ++i)
+		{
+			const float16x4_t	h = vreinterpret_f16_u8( vld1_u8( src + i*8 ));
+			vst1q_f32( reinterpret_cast<float *>(dst + i), vcvt_f32_f16( h ));
+		}
+	#endif
+
+		LoadRGBA16F_Scalar( src + i*8, count - i, OUT dst + i );
+	}
+
+	static void  StoreRGBA16F_SIMD (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_F16C)
+		for (; i < count; ++i)
+		{
+			const __m128	f = _mm_loadu_ps( reinterpret_cast<const float *>(src + i) );
+			_mm_storel_epi64( reinterpret_cast<__m128i *>(dst + i*8), _mm_cvtps_ph( f, _MM_FROUND_TO_NEAREST_INT ));
+		}
+
+	#elif defined(FG_PIXEL_NEON)
+		for (; i < count; ++i)
+		{
+			const float32x4_t	f = vld1q_f32( reinterpret_cast<const float *>(src + i) );
+			vst1_u8( dst + i*8, vreinterpret_u8_f16( vcvt_f16_f32( f )));
+		}
+	#endif
+
+		StoreRGBA16F_Scalar( src + i, count - i, OUT dst + i*8 );
+	}
+
+/*
+=================================================
+	LoadRGBA32F / StoreRGBA32F
+=================================================
+*/
+	static void  LoadRGBA32F (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		std::memcpy( OUT dst, src, count * sizeof(*dst) );
+	}
+
+	static void  StoreRGBA32F (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		std::memcpy( OUT dst, src, count * sizeof(*src) );
+	}
+
+/*
+=================================================
+	LoadRGB10A2 / StoreRGB10A2
+=================================================
+*/
+	static void  LoadRGB10A2_Scalar (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		const float	scale10	= 1.0f / 1023.0f;
+		const float	scale2	= 1.0f / 3.0f;
+
+		for (size_t i = 0; i < count; ++i, src += 4)
+		{
+			uint	bits;
+			std::memcpy( OUT &bits, src, sizeof(bits) );
+
+			dst[i] = RGBA32f{ float(bits & 0x3FF) * scale10,		 float((bits >> 10) & 0x3FF) * scale10,
+							  float((bits >> 20) & 0x3FF) * scale10, float(bits >> 30) * scale2 };
+		}
+	}
+
+	static void  StoreRGB10A2_Scalar (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		for (size_t i = 0; i < count; ++i, dst += 4)
+		{
+			const uint	bits = FloatToUNorm( src[i].r, 1023.0f )		 | (FloatToUNorm( src[i].g, 1023.0f ) << 10) |
+							   (FloatToUNorm( src[i].b, 1023.0f ) << 20) | (FloatToUNorm( src[i].a, 3.0f ) << 30);
+			std::memcpy( OUT dst, &bits, sizeof(bits) );
+		}
+	}
+
+	static void  LoadRGB10A2_SIMD (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_SSE2)
+		const __m128i	mask10	= _mm_set1_epi32( 0x3FF );
+		const __m128	scale10	= _mm_set1_ps( 1.0f / 1023.0f );
+		const __m128	scale2	= _mm_set1_ps( 1.0f / 3.0f );
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	bits	= _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + i*4) );
+			__m128			r		= _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( bits, mask10 )), scale10 );
+			__m128			g		= _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( bits, 10 ), mask10 )), scale10 );
+			__m128			b		= _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( bits, 20 ), mask10 )), scale10 );
+			__m128			a		= _mm_mul_ps( _mm_cvtepi32_ps( _mm_srli_epi32( bits, 30 )), scale2 );
+
+			_MM_TRANSPOSE4_PS( r, g, b, a );
+
+			float*	d = reinterpret_cast<float *>(dst + i);
+			_mm_storeu_ps( d +  0, r );
+			_mm_storeu_ps( d +  4, g );
+			_mm_storeu_ps( d +  8, b );
+			_mm_storeu_ps( d + 12, a );
+		}
+	#endif
+
+		LoadRGB10A2_Scalar( src + i*4, count - i, OUT dst + i );
+	}
+
+	static void  StoreRGB10A2_SIMD (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_SSE2)
+		const __m128	zero	= _mm_setzero_ps();
+		const __m128	one		= _mm_set1_ps( 1.0f );
+		const __m128	half	= _mm_set1_ps( 0.5f );
+
+		const auto	ToUNorm = [&] (__m128 f, float maxValue)
+		{
+			f = _mm_min_ps( _mm_max_ps( f, zero ), one );
+			return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( f, _mm_set1_ps( maxValue )), half ));
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const float*	s	= reinterpret_cast<const float *>(src + i);
+			__m128			r	= _mm_loadu_ps( s +  0 );
+			__m128			g	= _mm_loadu_ps( s +  4 );
+			__m128			b	= _mm_loadu_ps( s +  8 );
+			__m128			a	= _mm_loadu_ps( s + 12 );
+
+			_MM_TRANSPOSE4_PS( r, g, b, a );
+
+			const __m128i	bits = _mm_or_si128( _mm_or_si128( ToUNorm( r, 1023.0f ), _mm_slli_epi32( ToUNorm( g, 1023.0f ), 10 )),
+												 _mm_or_si128( _mm_slli_epi32( ToUNorm( b, 1023.0f ), 20 ), _mm_slli_epi32( ToUNorm( a, 3.0f ), 30 )));
+
+			_mm_storeu_si128( reinterpret_cast<__m128i *>(dst + i*4), bits );
+		}
+	#endif
+
+		StoreRGB10A2_Scalar( src + i, count - i, OUT dst + i*4 );
+	}
+
+/*
+=================================================
+	LoadRG11B10F / StoreRG11B10F
+=================================================
+*/
+	static void  LoadRG11B10F_Scalar (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		for (size_t i = 0; i < count; ++i, src += 4)
+		{
+			uint	bits;
+			std::memcpy( OUT &bits, src, sizeof(bits) );
+
+			dst[i] = RGBA32f{ UFloatToFloat<6>( bits & 0x7FF ), UFloatToFloat<6>( (bits >> 11) & 0x7FF ), UFloatToFloat<5>( bits >> 22 ), 1.0f };
+		}
+	}
+
+	static void  StoreRG11B10F (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		for (size_t i = 0; i < count; ++i, dst += 4)
+		{
+			const uint	bits = FloatToUFloat<6>( src[i].r ) | (FloatToUFloat<6>( src[i].g ) << 11) | (FloatToUFloat<5>( src[i].b ) << 22);
+			std::memcpy( OUT dst, &bits, sizeof(bits) );
+		}
+	}
+
+#ifdef FG_PIXEL_SSE2
+	// 'v' contains 5 bit exponent and 'MantBits' mantissa in low bits
+	template <uint MantBits>
+	forceinline __m128  UFloatToFloat_SSE2 (__m128i v)
+	{
+		const __m128i	inf_nan	= _mm_cmpgt_epi32( v, _mm_set1_epi32( (0x1F << MantBits) - 1 ));
+		const __m128	f		= _mm_mul_ps( _mm_castsi128_ps( _mm_slli_epi32( v, 23 - MantBits )), _mm_castsi128_ps( _mm_set1_epi32( 0x77800000 )));
+
+		return _mm_castsi128_ps( _mm_or_si128( _mm_castps_si128( f ), _mm_and_si128( inf_nan, _mm_set1_epi32( 0x7F800000 ))));
+	}
+#endif
+
+	static void  LoadRG11B10F_SIMD (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_SSE2)
+		const __m128i	mask11	= _mm_set1_epi32( 0x7FF );
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	bits	= _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + i*4) );
+			__m128			r		= UFloatToFloat_SSE2<6>( _mm_and_si128( bits, mask11 ));
+			__m128			g		= UFloatToFloat_SSE2<6>( _mm_and_si128( _mm_srli_epi32( bits, 11 ), mask11 ));
+			__m128			b		= UFloatToFloat_SSE2<5>( _mm_srli_epi32( bits, 22 ));
+			__m128			a		= _mm_set1_ps( 1.0f );
+
+			_MM_TRANSPOSE4_PS( r, g, b, a );
+
+			float*	d = reinterpret_cast<float *>(dst + i);
+			_mm_storeu_ps( d +  0, r );
+			_mm_storeu_ps( d +  4, g );
+			_mm_storeu_ps( d +  8, b );
+			_mm_storeu_ps( d + 12, a );
+		}
+	#endif
+
+		LoadRG11B10F_Scalar( src + i*4, count - i, OUT dst + i );
+	}
+
+/*
+=================================================
+	LoadDepth / StoreDepth
+----
+	depth is stored in red channel, other channels are zero
+=================================================
+*/
+	template <uint Bits>
+	static void  LoadDepthUNorm_Scalar (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		using Word_t = std::conditional_t< (Bits > 16), uint, uint16_t >;
+
+		constexpr uint	mask	= (~0u >> (32 - Bits));
+		const float		scale	= 1.0f / float(mask);
+
+		for (size_t i = 0; i < count; ++i, src += sizeof(Word_t))
+		{
+			Word_t	w;
+			std::memcpy( OUT &w, src, sizeof(w) );
+
+			dst[i] = RGBA32f{ float(w & mask) * scale, 0.0f, 0.0f, 0.0f };
+		}
+	}
+
+	template <uint Bits>
+	static void  StoreDepthUNorm (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		using Word_t = std::conditional_t< (Bits > 16), uint, uint16_t >;
+
+		constexpr uint	mask = (~0u >> (32 - Bits));
+
+		for (size_t i = 0; i < count; ++i, dst += sizeof(Word_t))
+		{
+			// 24 bit value may be rounded up to 2^24 in float
+			const Word_t	w = Word_t(Min( FloatToUNorm( src[i].r, float(mask) ), mask ));
+			std::memcpy( OUT dst, &w, sizeof(w) );
+		}
+	}
+
+	static void  LoadDepth32F_Scalar (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		for (size_t i = 0; i < count; ++i, src += sizeof(float))
+		{
+			float	d;
+			std::memcpy( OUT &d, src, sizeof(d) );
+
+			dst[i] = RGBA32f{ d, 0.0f, 0.0f, 0.0f };
+		}
+	}
+
+	static void  StoreDepth32F (const RGBA32f *src, size_t count, OUT T *dst)
+	{
+		for (size_t i = 0; i < count; ++i, dst += sizeof(float))
+		{
+			std::memcpy( OUT dst, &src[i].r, sizeof(float) );
+		}
+	}
+
+#ifdef FG_PIXEL_SSE2
+	forceinline void  StoreDepth4_SSE2 (__m128 depth, OUT RGBA32f *dst)
+	{
+		const __m128	zero	= _mm_setzero_ps();
+		const __m128	lo		= _mm_unpacklo_ps( depth, zero );	// d0, 0, d1, 0
+		const __m128	hi		= _mm_unpackhi_ps( depth, zero );	// d2, 0, d3, 0
+		float*			d		= reinterpret_cast<float *>(dst);
+
+		_mm_storeu_ps( d +  0, _mm_movelh_ps( lo, zero ));
+		_mm_storeu_ps( d +  4, _mm_movehl_ps( zero, lo ));
+		_mm_storeu_ps( d +  8, _mm_movelh_ps( hi, zero ));
+		_mm_storeu_ps( d + 12, _mm_movehl_ps( zero, hi ));
+	}
+#endif
+
+	template <uint Bits>
+	static void  LoadDepthUNorm_SIMD (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_SSE2)
+		constexpr uint	mask	= (~0u >> (32 - Bits));
+		const __m128	scale	= _mm_set1_ps( 1.0f / float(mask) );
+
+		if constexpr ( Bits == 16 )
+		{
+			const __m128i	zero = _mm_setzero_si128();
+
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m128i	w = _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + i*2) );
+				StoreDepth4_SSE2( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( w, zero )), scale ), OUT dst + i );
+				StoreDepth4_SSE2( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( w, zero )), scale ), OUT dst + i + 4 );
+			}
+		}
+		else
+		{
+			const __m128i	vmask = _mm_set1_epi32( int(mask) );
+
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128i	w = _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + i*4) );
+				StoreDepth4_SSE2( _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( w, vmask )), scale ), OUT dst + i );
+			}
+		}
+	#endif
+
+		LoadDepthUNorm_Scalar<Bits>( src + i * (Bits > 16 ? 4 : 2), count - i, OUT dst + i );
+	}
+
+	static void  LoadDepth32F_SIMD (const T *src, size_t count, OUT RGBA32f *dst)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_PIXEL_SSE2)
+		for (; i + 4 <= count; i += 4)
+		{
+			StoreDepth4_SSE2( _mm_loadu_ps( reinterpret_cast<const float *>(src + i*4) ), OUT dst + i );
+		}
+	#endif
+
+		LoadDepth32F_Scalar( src + i*4, count - i, OUT dst + i );
+	}
+
+/*
+=================================================
+	MakeKernels
+=================================================
+*/
+	ND_ forceinline PixelRowKernels  MakeKernels (bool allowSIMD, uint bytesPerPixel,
+												  LoadRowFun_t scalarLoad, LoadRowFun_t simdLoad,
+												  StoreRowFun_t scalarStore, StoreRowFun_t simdStore)
+	{
+		PixelRowKernels	result;
+		result.load				= allowSIMD ? simdLoad : scalarLoad;
+		result.store			= allowSIMD ? simdStore : scalarStore;
+		result.bytesPerPixel	= bytesPerPixel;
+		return result;
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	GetPixelRowKernels
+=================================================
+*/
+	PixelRowKernels  GetPixelRowKernels (EPixelFormat format, EImageAspect aspect, bool allowSIMD)
+	{
+		if ( aspect == EImageAspect::Stencil )
+			return {};
+
+		switch ( format )
+		{
+			case EPixelFormat::RGBA8_UNorm :
+			case EPixelFormat::sRGB8_A8 :
+				return MakeKernels( allowSIMD, 4, &LoadRGBA8_Scalar<false>, &LoadRGBA8_SIMD<false>, &StoreRGBA8_Scalar<false>, &StoreRGBA8_SIMD<false> );
+
+			case EPixelFormat::BGRA8_UNorm :
+				return MakeKernels( allowSIMD, 4, &LoadRGBA8_Scalar<true>, &LoadRGBA8_SIMD<true>, &StoreRGBA8_Scalar<true>, &StoreRGBA8_SIMD<true> );
+
+			case EPixelFormat::RGBA16F :
+				return MakeKernels( allowSIMD, 8, &LoadRGBA16F_Scalar, &LoadRGBA16F_SIMD, &StoreRGBA16F_Scalar, &StoreRGBA16F_SIMD );
+
+			case EPixelFormat::RGBA32F :
+				return MakeKernels( allowSIMD, 16, &LoadRGBA32F, &LoadRGBA32F, &StoreRGBA32F, &StoreRGBA32F );
+
+			case EPixelFormat::RGB10_A2_UNorm :
+				return MakeKernels( allowSIMD, 4, &LoadRGB10A2_Scalar, &LoadRGB10A2_SIMD, &StoreRGB10A2_Scalar, &StoreRGB10A2_SIMD );
+
+			case EPixelFormat::RGB_11_11_10F :
+				return MakeKernels( allowSIMD, 4, &LoadRG11B10F_Scalar, &LoadRG11B10F_SIMD, &StoreRG11B10F, &StoreRG11B10F );
+
+			case EPixelFormat::Depth16 :
+			case EPixelFormat::Depth16_Stencil8 :
+				return MakeKernels( allowSIMD, 2, &LoadDepthUNorm_Scalar<16>, &LoadDepthUNorm_SIMD<16>, &StoreDepthUNorm<16>, &StoreDepthUNorm<16> );
+
+			case EPixelFormat::Depth24 :
+			case EPixelFormat::Depth24_Stencil8 :
+				return MakeKernels( allowSIMD, 4, &LoadDepthUNorm_Scalar<24>, &LoadDepthUNorm_SIMD<24>, &StoreDepthUNorm<24>, &StoreDepthUNorm<24> );
+
+			case EPixelFormat::Depth32F :
+			case EPixelFormat::Depth32F_Stencil8 :
+				return MakeKernels( allowSIMD, 4, &LoadDepth32F_Scalar, &LoadDepth32F_SIMD, &StoreDepth32F, &StoreDepth32F );
+
+			default :
+				break;
+		}
+		return {};
+	}
+
+}	// FG
@@ -0,0 +1,160 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Bulk pixel conversion kernels for 'ImageView::LoadRows' and 'ImageView::StoreRows'.
+	SIMD paths are selected at compile time (SSE2 / F16C / AVX2 on x64, NEON on AArch64),
+	scalar path is used for other platforms and for remaining pixels in the row.
+*/
+
+#pragma once
+
+#include "framegraph/Public/ImageView.h"
+
+namespace FG
+{
+
+	//
+	// Pixel Row Kernels
+	//
+
+	struct PixelRowKernels
+	{
+		ImageView::LoadRowFun_t		load			= null;
+		ImageView::StoreRowFun_t	store			= null;
+		uint						bytesPerPixel	= 0;
+	};
+
+
+	// returns empty kernels if format is not supported, in this case use per-pixel 'ImageView::Load'
+	ND_ PixelRowKernels  GetPixelRowKernels (EPixelFormat format, EImageAspect aspect, bool allowSIMD = true);
+
+
+/*
+=================================================
+	HalfToFloat
+----
+	supports zero, denormals, inf and nan
+=================================================
+*/
+	ND_ inline float  HalfToFloat (uint16_t value)
+	{
+		const uint	sign	= uint(value & 0x8000) << 16;
+		const uint	exp		= (value >> 10) & 0x1F;
+		uint		mant	= value & 0x3FF;
+		uint		bits	= sign;
+
+		if ( exp == 0 )
+		{
+			if ( mant != 0 )
+			{
+				// normalize denormal
+				uint	e = 0;
+				for (; (mant & 0x400) == 0; ++e) { mant <<= 1; }
+				bits |= ((113 - e) << 23) | ((mant & 0x3FF) << 13);
+			}
+		}
+		else
+		if ( exp == 31 )
+			bits |= 0x7F800000 | (mant << 13);
+		else
+			bits |= ((exp + 112) << 23) | (mant << 13);
+
+		return BitCast<float>( bits );
+	}
+
+/*
+=================================================
+	FloatToHalf
+----
+	round to nearest even, based on
+	https://gist.github.com/rygorous/2156668
+=================================================
+*/
+	ND_ inline uint16_t  FloatToHalf (float value)
+	{
+		uint		bits	= BitCast<uint>( value );
+		const uint	sign	= bits & 0x80000000u;
+		uint		result;
+
+		bits ^= sign;
+
+		if ( bits >= (143u << 23) )
+		{
+			// inf or nan
+			result = (bits > 0x7F800000u ? 0x7E00 : 0x7C00);
+		}
+		else
+		if ( bits < (113u << 23) )
+		{
+			// denormal or zero, float addition rounds mantissa
+			const uint	magic = 126u << 23;
+			result = BitCast<uint>( BitCast<float>( bits ) + BitCast<float>( magic )) - magic;
+		}
+		else
+		{
+			const uint	mant_odd = (bits >> 13) & 1;
+			bits  += (uint(15 - 127) << 23) + 0xFFF;
+			bits  += mant_odd;
+			result = bits >> 13;
+		}
+		return uint16_t( result | (sign >> 16) );
+	}
+
+/*
+=================================================
+	UFloatToFloat
+----
+	unsigned 11 or 10 bit float with 5 bits exponent
+=================================================
+*/
+	template <uint MantBits>
+	ND_ inline float  UFloatToFloat (uint value)
+	{
+		const uint	exp		= (value >> MantBits) & 0x1F;
+		const uint	mant	= value & ((1u << MantBits) - 1);
+
+		if ( exp == 0 )
+			return float(mant) * BitCast<float>( (127u - 14 - MantBits) << 23 );
+
+		if ( exp == 31 )
+			return BitCast<float>( 0x7F800000u | (mant << (23 - MantBits)) );
+
+		return BitCast<float>( ((exp + 112) << 23) | (mant << (23 - MantBits)) );
+	}
+
+/*
+=================================================
+	FloatToUFloat
+----
+	negative values are clamped to zero
+=================================================
+*/
+	template <uint MantBits>
+	ND_ inline uint  FloatToUFloat (float value)
+	{
+		constexpr uint	shift	= 23 - MantBits;
+		constexpr uint	inf		= 0x1Fu << MantBits;
+		uint			bits	= BitCast<uint>( value );
+
+		if ( (bits & 0x7FFFFFFFu) > 0x7F800000u )
+			return inf | (1u << (MantBits - 1));	// nan
+
+		if ( bits & 0x80000000u )
+			return 0;
+
+		if ( bits >= (143u << 23) )
+			return inf;
+
+		if ( bits < (113u << 23) )
+		{
+			const uint	magic = (136u - MantBits) << 23;
+			return BitCast<uint>( BitCast<float>( bits ) + BitCast<float>( magic )) - magic;
+		}
+
+		const uint	mant_odd = (bits >> shift) & 1;
+		bits += (uint(15 - 127) << 23) + ((1u << (shift - 1)) - 1);
+		bits += mant_odd;
+		return bits >> shift;
+	}
+
+
+}	// FG
@@ -20,17 +20,15 @@ namespace {
 	HashOf (Buffer)
 =================================================
 */
-	inline HashVal  HashOf (const FG::PipelineResources::Buffer &buf)
+	inline void  HashOf (INOUT HashStream64 &hash, const FG::PipelineResources::Buffer &buf)
 	{
-		HashVal	result = FGC::HashOf( buf.index ) + FGC::HashOf( buf.state ) +
-						 FGC::HashOf( buf.dynamicOffsetIndex ) + FGC::HashOf( buf.elementCount );
+		hash.Update( FGC::HashOf( buf.index )).Update( uint64_t(buf.state) ).Update( buf.dynamicOffsetIndex ).Update( buf.elementCount );
 
 		for (uint16_t i = 0; i < buf.elementCount; ++i)
 		{
 			auto&	elem = buf.elements[i];
-			result << (FGC::HashOf( elem.bufferId ) + FGC::HashOf( elem.offset ) + FGC::HashOf( elem.size ));
+			hash.Update( FGC::HashOf( elem.bufferId )).Update( uint64_t(elem.offset) ).Update( uint64_t(elem.size) );
 		}
-		return result;
 	}
 
 /*
@@ -38,16 +36,15 @@ namespace {
 	HashOf (TexelBuffer)
 =================================================
 */
-	inline HashVal  HashOf (const FG::PipelineResources::TexelBuffer &buf)
+	inline void  HashOf (INOUT HashStream64 &hash, const FG::PipelineResources::TexelBuffer &buf)
 	{
-		HashVal	result = FGC::HashOf( buf.index ) + FGC::HashOf( buf.state );
+		hash.Update( FGC::HashOf( buf.index )).Update( uint64_t(buf.state) ).Update( buf.elementCount );
 
 		for (uint16_t i = 0; i < buf.elementCount; ++i)
 		{
 			auto&	elem = buf.elements[i];
-			result << (FGC::HashOf( elem.bufferId ) + FGC::HashOf( elem.desc ));
+			hash.Update( FGC::HashOf( elem.bufferId )).Update( FGC::HashOf( elem.desc ));
 		}
-		return result;
 	}
 	
 /*
@@ -55,16 +52,15 @@ namespace {
 	HashOf (Image)
 =================================================
 */
-	inline HashVal  HashOf (const FG::PipelineResources::Image &img)
+	inline void  HashOf (INOUT HashStream64 &hash, const FG::PipelineResources::Image &img)
 	{
-		HashVal	result = FGC::HashOf( img.index ) + FGC::HashOf( img.state ) + FGC::HashOf( img.elementCount );
+		hash.Update( FGC::HashOf( img.index )).Update( uint64_t(img.state) ).Update( img.elementCount );
 
 		for (uint16_t i = 0; i < img.elementCount; ++i)
 		{
 			auto&	elem = img.elements[i];
-			result << (FGC::HashOf( elem.imageId ) + (elem.hasDesc ? FGC::HashOf( elem.desc ) : HashVal{}));
+			hash.Update( FGC::HashOf( elem.imageId )).Update( elem.hasDesc ? FGC::HashOf( elem.desc ) : HashVal{} );
 		}
-		return result;
 	}
 	
 /*
@@ -72,17 +68,16 @@ namespace {
 	HashOf (Texture)
 =================================================
 */
-	inline HashVal  HashOf (const FG::PipelineResources::Texture &tex)
+	inline void  HashOf (INOUT HashStream64 &hash, const FG::PipelineResources::Texture &tex)
 	{
-		HashVal	result = FGC::HashOf( tex.index ) + FGC::HashOf( tex.state ) + FGC::HashOf( tex.elementCount );
+		hash.Update( FGC::HashOf( tex.index )).Update( uint64_t(tex.state) ).Update( tex.elementCount );
 
 		for (uint16_t i = 0; i < tex.elementCount; ++i)
 		{
 			auto&	elem = tex.elements[i];
-			result << (FGC::HashOf( elem.imageId ) + FGC::HashOf( elem.samplerId ) +
-					   (elem.hasDesc ? FGC::HashOf( elem.desc ) : HashVal{}));
+			hash.Update( FGC::HashOf( elem.imageId )).Update( FGC::HashOf( elem.samplerId ))
+				.Update( elem.hasDesc ? FGC::HashOf( elem.desc ) : HashVal{} );
 		}
-		return result;
 	}
 	
 /*
@@ -90,15 +85,14 @@ namespace {
 	HashOf (Sampler)
 =================================================
 */
-	inline HashVal  HashOf (const FG::PipelineResources::Sampler &samp)
+	inline void  HashOf (INOUT HashStream64 &hash, const FG::PipelineResources::Sampler &samp)
 	{
-		HashVal	result = FGC::HashOf( samp.index ) + FGC::HashOf( samp.elementCount );
+		hash.Update( FGC::HashOf( samp.index )).Update( samp.elementCount );
 
 		for (uint16_t i = 0; i < samp.elementCount; ++i)
 		{
-			result << FGC::HashOf( samp.elements[i].samplerId );
+			hash.Update( FGC::HashOf( samp.elements[i].samplerId ));
 		}
-		return result;
 	}
 
 /*
@@ -106,15 +100,14 @@ namespace {
 	HashOf (RayTracingScene)
 =================================================
 */
-	inline HashVal  HashOf (const FG::PipelineResources::RayTracingScene &rts)
+	inline void  HashOf (INOUT HashStream64 &hash, const FG::PipelineResources::RayTracingScene &rts)
 	{
-		HashVal	result = FGC::HashOf( rts.index ) + FGC::HashOf( rts.elementCount );
+		hash.Update( FGC::HashOf( rts.index )).Update( rts.elementCount );
 
 		for (uint16_t i = 0; i < rts.elementCount; ++i)
 		{
-			result << FGC::HashOf( rts.elements[i].sceneId );
+			hash.Update( FGC::HashOf( rts.elements[i].sceneId ));
 		}
-		return result;
 	}
 
 }	// namespace
@@ -137,6 +130,7 @@ namespace FG
 		//STATIC_ASSERT( sizeof(CachedID::value_type) == sizeof(RawPipelineResourcesID) );
 
 		_SetCachedID(other._GetCachedID());
+		_cachedHash.store( other._cachedHash.load( memory_order_relaxed ), memory_order_relaxed );
 	}
 
 /*
@@ -827,9 +821,11 @@ namespace {
 */
 	HashVal  PipelineResources::DynamicData::CalcHash () const
 	{
-		HashVal	result;
-		ForEachUniform( [&result] (const UniformID &id, auto& res) { result << HashOf(id) << HashOf(res); });
-		return result;
+		HashStream64	hash;
+		hash.Update( HashOf( layoutId ));
+
+		ForEachUniform( [&hash] (const UniformID &id, auto& res) { hash.Update( HashOf( id ));  HashOf( INOUT hash, res ); });
+		return hash.GetHash();
 	}
 
 /*
@@ -841,7 +837,7 @@ namespace {
 	{
 		auto&	lhs = *this;
 
-		if ( lhs.layoutId		!= rhs.layoutId		and
+		if ( lhs.layoutId		!= rhs.layoutId		or
 			 lhs.uniformCount	!= rhs.uniformCount	)
 			return false;
 
@@ -880,6 +876,27 @@ namespace {
 
 
 
+/*
+=================================================
+	GetContentHash
+=================================================
+*/
+	HashVal  PipelineResourcesHelper::GetContentHash (const PipelineResources &res)
+	{
+		SHAREDLOCK( res._drCheck );
+		CHECK_ERR( res._dataPtr );
+
+		size_t	hash = res._cachedHash.load( memory_order_relaxed );
+
+		if ( hash == 0 )
+		{
+			// may be calculated by multiple threads at the same time, result is the same
+			hash = size_t(res._dataPtr->CalcHash());
+			res._cachedHash.store( hash, memory_order_relaxed );
+		}
+		return HashVal{hash};
+	}
+
 /*
 =================================================
 	Initialize
@@ -36,6 +36,14 @@ namespace FG
 		{
 			res._SetCachedID( id );
 		}
+
+		ND_ static DynamicData const*  GetData (const PipelineResources &res)
+		{
+			return res._dataPtr.get();
+		}
+
+		// returns hash of layout and all bound resources, hash is cached until resources are changed
+		ND_ static HashVal  GetContentHash (const PipelineResources &res);
 	};
 
 
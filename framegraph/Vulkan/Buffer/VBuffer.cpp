@@ -113,7 +113,17 @@ namespace FG
 
 		VK_CHECK( dev.vkCreateBuffer( dev.GetVkDevice(), &info, null, OUT &_buffer ));
 
-		CHECK_ERR( memObj.AllocateForBuffer( resMngr.GetMemoryManager(), _buffer ));
+		// memory for relocated buffer is allocated before, see 'VResourceManager::DefragmentMemory'
+		if ( EnumEq( memObj.MemoryType(), EMemoryTypeExt::Relocation ))
+		{
+			VMemoryObj::MemoryInfo	mem_info;
+			CHECK_ERR( memObj.GetInfo( resMngr.GetMemoryManager(), OUT mem_info ));
+			VK_CHECK( dev.vkBindBufferMemory( dev.GetVkDevice(), _buffer, mem_info.mem, VkDeviceSize(mem_info.offset) ));
+		}
+		else
+		// memory for transient buffer will be bound by command buffer
+		if ( not EnumEq( memObj.MemoryType(), EMemoryTypeExt::Transient ))
+			CHECK_ERR( memObj.AllocateForBuffer( resMngr.GetMemoryManager(), _buffer ));
 
 		if ( not dbgName.empty() )
 		{
@@ -204,6 +214,33 @@ namespace FG
 		_debugName.clear();
 	}
 	
+/*
+=================================================
+	SwapMemory
+----
+	exchange vulkan objects between buffers with same description,
+	used to move buffer to another memory without changing buffer ID.
+=================================================
+*/
+	void VBuffer::SwapMemory (VBuffer &other)
+	{
+		EXLOCK( _drCheck );
+		EXLOCK( other._drCheck );
+		ASSERT( _desc.size == other._desc.size and _desc.usage == other._desc.usage );
+		ASSERT( not _desc.isExternal and not other._desc.isExternal );
+
+		std::swap( _buffer, other._buffer );
+		{
+			EXLOCK( _viewMapLock );
+			EXLOCK( other._viewMapLock );
+			std::swap( _viewMap, other._viewMap );
+		}
+
+		RawMemoryID	mem_id	= _memoryId.Release();
+		_memoryId			= MemoryID{ other._memoryId.Release() };
+		other._memoryId		= MemoryID{ mem_id };
+	}
+
 /*
 =================================================
 	GetView
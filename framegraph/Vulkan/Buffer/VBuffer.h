@@ -55,6 +55,8 @@ namespace FG
 
 		void Destroy (VResourceManager &);
 
+		void SwapMemory (VBuffer &other);
+
 		//void Merge (BufferViewMap_t &, OUT AppendableVkResources_t) const;
 
 		ND_ VkBufferView		GetView (const VDevice &, const BufferViewDesc &) const;
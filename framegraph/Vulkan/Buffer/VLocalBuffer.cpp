@@ -24,7 +24,7 @@ namespace FG
 	Create
 =================================================
 */
-	bool VLocalBuffer::Create (const VBuffer *bufferData)
+	bool VLocalBuffer::Create (const VBuffer *bufferData, LinearAllocator<> &allocator)
 	{
 		CHECK_ERR( _bufferData == null );
 		CHECK_ERR( bufferData );
@@ -32,6 +32,10 @@ namespace FG
 		_bufferData		= bufferData;
 		_isImmutable	= _bufferData->IsReadOnly();
 
+		_pendingAccesses.SetAllocator( allocator );
+		_accessForWrite.SetAllocator( allocator );
+		_accessForRead.SetAllocator( allocator );
+
 		return true;
 	}
 	
@@ -49,9 +53,9 @@ namespace FG
 		ASSERT( _accessForWrite.empty() );
 		ASSERT( _accessForRead.empty() );
 
-		_pendingAccesses.clear();
-		_accessForWrite.clear();
-		_accessForRead.clear();
+		_pendingAccesses.Release();
+		_accessForWrite.Release();
+		_accessForRead.Release();
 	}
 
 /*
@@ -86,10 +90,17 @@ namespace FG
 	_ReplaceAccessRecords
 =================================================
 */
-	inline void VLocalBuffer::_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const BufferAccess &barrier)
+	inline bool VLocalBuffer::_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const BufferAccess &barrier)
 	{
 		ASSERT( iter >= arr.begin() and iter <= arr.end() );
 
+		// fast path: barrier overlaps all records
+		if ( arr.empty() or (barrier.range.begin <= arr.front().range.begin and barrier.range.end >= arr.back().range.end) )
+		{
+			arr.Assign( barrier );
+			return true;
+		}
+
 		bool replaced = false;
 
 		for (; iter != arr.end();)
@@ -117,9 +128,11 @@ namespace FG
 				iter->range.end = barrier.range.begin;
 
 				iter = arr.insert( iter+1, barrier );
+				CHECK_ERR( iter != arr.end() );
 				replaced = true;
 
 				iter = arr.insert( iter+1, src );
+				CHECK_ERR( iter != arr.end() );
 
 				iter->range.begin = barrier.range.end;
 				break;
@@ -137,7 +150,7 @@ namespace FG
 
 					if ( not replaced )
 					{
-						arr.insert( iter, barrier );
+						CHECK_ERR( arr.insert( iter, barrier ) != arr.end() );
 						replaced = true;
 					}
 					break;
@@ -164,8 +177,9 @@ namespace FG
 			
 		if ( not replaced )
 		{
-			arr.insert( iter, barrier );
+			CHECK_ERR( arr.insert( iter, barrier ) != arr.end() );
 		}
+		return true;
 	}
 	
 /*
@@ -181,6 +195,13 @@ namespace FG
 
 		ASSERT( iter >= arr.begin() and iter <= arr.end() );
 
+		// fast path: range overlaps all records
+		if ( range.begin <= arr.front().range.begin and range.end >= arr.back().range.end )
+		{
+			arr.clear();
+			return arr.end();
+		}
+
 		for (; iter != arr.end();)
 		{
 			if ( iter->range.begin < range.begin and
@@ -190,6 +211,8 @@ namespace FG
 				iter->range.end = range.begin;
 
 				iter = arr.insert( iter+1, src );
+				CHECK_ERR( iter != arr.end(), iter );
+
 				iter->range.begin = range.end;
 				break;
 			}
@@ -262,6 +285,7 @@ namespace FG
 			pending.range = BufferRange{ range.begin, iter->range.begin };
 			
 			iter = _pendingAccesses.insert( iter, pending );
+			CHECK_ERR( iter != _pendingAccesses.end(), void() );
 			++iter;
 
 			range.begin = iter->range.begin;
@@ -283,7 +307,7 @@ namespace FG
 		if ( not range.IsEmpty() )
 		{
 			pending.range = range;
-			_pendingAccesses.insert( iter, pending );
+			CHECK( _pendingAccesses.insert( iter, pending ) != _pendingAccesses.end() );
 		}
 	}
 	
@@ -309,7 +333,7 @@ namespace FG
 			pending.isWritable	= false;
 			pending.index		= index;
 
-			_pendingAccesses.push_back( std::move(pending) );
+			CHECK( _pendingAccesses.push_back( std::move(pending) ));
 		}
 
 		CommitBarrier( barrierMngr, debugger );
@@ -386,7 +410,7 @@ namespace FG
 				}
 				
 				// store to '_accessForWrite'
-				_ReplaceAccessRecords( _accessForWrite, w_iter, pending );
+				CHECK( _ReplaceAccessRecords( _accessForWrite, w_iter, pending ));
 				_EraseAccessRecords( _accessForRead, r_iter, pending.range );
 			}
 			else
@@ -398,7 +422,7 @@ namespace FG
 				}
 
 				// store to '_accessForRead'
-				_ReplaceAccessRecords( _accessForRead, r_iter, pending );
+				CHECK( _ReplaceAccessRecords( _accessForRead, r_iter, pending ));
 			}
 		}
 
@@ -4,6 +4,7 @@
 
 #include "framegraph/Public/EResourceState.h"
 #include "framegraph/Shared/ResourceDataRange.h"
+#include "VAccessRecords.h"
 #include "VBuffer.h"
 
 namespace FG
@@ -50,7 +51,7 @@ namespace FG
 			BufferAccess () : isReadable{false}, isWritable{false} {}
 		};
 
-		using AccessRecords_t	= Array< BufferAccess >;	// TODO: fixed size array or custom allocator
+		using AccessRecords_t	= VAccessRecords< BufferAccess >;
 		using AccessIter_t		= AccessRecords_t::iterator;
 
 
@@ -70,7 +71,7 @@ namespace FG
 		VLocalBuffer (VLocalBuffer &&) = delete;
 		~VLocalBuffer ();
 
-		bool Create (const VBuffer *);
+		bool Create (const VBuffer *, LinearAllocator<> &);
 		void Destroy ();
 		
 		void SetInitialState (bool immutable) const;
@@ -90,7 +91,7 @@ namespace FG
 
 	private:
 		ND_ static AccessIter_t	_FindFirstAccess (AccessRecords_t &arr, const BufferRange &range);
-			static void			_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const BufferAccess &barrier);
+		ND_ static bool			_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const BufferAccess &barrier);
 			static AccessIter_t	_EraseAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const BufferRange &range);
 	};
 
@@ -43,7 +43,7 @@ namespace FG
 		}
 
 
-		void Commit (const VDevice &dev, VkCommandBuffer cmd)
+		bool Commit (const VDevice &dev, VkCommandBuffer cmd)
 		{
 			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 
@@ -54,11 +54,13 @@ namespace FG
 										  uint(_bufferBarriers.size()), _bufferBarriers.data(),
 										  uint(_imageBarriers.size()), _imageBarriers.data() );
 				ClearBarriers();
+				return true;
 			}
+			return false;
 		}
 		
 
-		void ForceCommit (const VDevice &dev, VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
+		bool ForceCommit (const VDevice &dev, VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
 		{
 			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 
@@ -72,7 +74,15 @@ namespace FG
 										  uint(_bufferBarriers.size()), _bufferBarriers.data(),
 										  uint(_imageBarriers.size()), _imageBarriers.data() );
 				ClearBarriers();
+				return true;
 			}
+			return false;
+		}
+
+
+		ND_ size_t  BarrierCount () const
+		{
+			return _imageBarriers.size() + _bufferBarriers.size() + !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 		}
 
 
@@ -5,6 +5,34 @@
 
 namespace FG
 {
+
+	//
+	// Readback Pages
+	//
+	struct VCmdBatch::ReadbackPages
+	{
+	// variables
+		VFrameGraph &						frameGraph;
+		FixedArray< StagingBufferIdx, 8 >	indices;
+
+	// methods
+		explicit ReadbackPages (VFrameGraph &fg) : frameGraph{fg}
+		{
+			frameGraph.BeginAsyncReadback();
+		}
+
+		~ReadbackPages ()
+		{
+			auto&	rm = frameGraph.GetResourceManager();
+
+			for (auto& idx : indices) {
+				rm.ReleaseStagingBuffer( idx );
+			}
+			frameGraph.EndAsyncReadback();
+		}
+	};
+//-----------------------------------------------------------------------------
+
 	
 /*
 =================================================
@@ -34,6 +62,7 @@ namespace FG
 	{
 		EXLOCK( _drCheck );
 		CHECK( _counter.load( memory_order_relaxed ) == 0 );
+		CHECK( _transientDescPools.empty() );
 	}
 	
 /*
@@ -47,6 +76,7 @@ namespace FG
 
 		ASSERT( _dependencies.empty() );
 		ASSERT( _batch.commands.empty() );
+		ASSERT( _batch.secondaries.empty() );
 		ASSERT( _batch.signalSemaphores.empty() );
 		ASSERT( _batch.waitSemaphores.empty() );
 		ASSERT( _staging.hostToDevice.empty() );
@@ -59,6 +89,7 @@ namespace FG
 		ASSERT( _shaderDebugger.modes.empty() );
 		ASSERT( _submitted == null );
 		ASSERT( _counter.load( memory_order_relaxed ) == 0 );
+		ASSERT( _dependents.empty() );
 
 		_queueType = type;
 
@@ -68,11 +99,12 @@ namespace FG
 		}
 
 		_state.store( EState::Initial, memory_order_relaxed );
+		_pendingDeps.store( 1, memory_order_relaxed );
 		
 		for (auto& dep : dependsOn)
 		{
 			if ( auto* batch = Cast<VCmdBatch>(dep.GetBatch()) )
-				_dependencies.push_back( batch );
+				AddDependency( batch );
 		}
 	}
 
@@ -141,6 +173,19 @@ namespace FG
 		_batch.commands.push_back( cmd, pool );
 	}
 	
+/*
+=================================================
+	AddSecondaryCommandBuffer
+=================================================
+*/
+	void  VCmdBatch::AddSecondaryCommandBuffer (VkCommandBuffer cmd, const VCommandPool *pool)
+	{
+		EXLOCK( _drCheck );
+		ASSERT( GetState() < EState::Submitted );
+
+		_batch.secondaries.emplace_back( cmd, pool );
+	}
+	
 /*
 =================================================
 	AddDependency
@@ -153,6 +198,42 @@ namespace FG
 		CHECK_ERR( _dependencies.size() < _dependencies.capacity(), void());
 
 		_dependencies.push_back( batch );
+		_pendingDeps.fetch_add( 1, memory_order_relaxed );
+
+		if ( not batch->_AddDependent( this, _queueType ))
+			_pendingDeps.fetch_sub( 1, memory_order_relaxed );
+	}
+
+/*
+=================================================
+	_AddDependent
+----
+	returns 'false' if this batch is already in required state
+=================================================
+*/
+	bool  VCmdBatch::_AddDependent (VCmdBatch *batch, EQueueType queue)
+	{
+		// batches in the same queue are submitted in order, for other queues semaphore is required
+		const EState	required = (queue == _queueType ? EState::Ready : EState::Submitted);
+
+		EXLOCK( _dependentsGuard );
+
+		if ( GetState() >= required )
+			return false;
+
+		_dependents.push_back({ batch, required });
+		return true;
+	}
+
+/*
+=================================================
+	_OnDependencyReady
+=================================================
+*/
+	void  VCmdBatch::_OnDependencyReady ()
+	{
+		if ( _pendingDeps.fetch_sub( 1, memory_order_acq_rel ) == 1 )
+			_frameGraph.EnqueueReadyBatch( this );
 	}
 	
 /*
@@ -168,6 +249,19 @@ namespace FG
 		_readyToDelete.push_back({ type, handle });
 	}
 
+/*
+=================================================
+	AllocTransientDescriptorSet
+=================================================
+*/
+	bool  VCmdBatch::AllocTransientDescriptorSet (VkDescriptorSetLayout layout, OUT VkDescriptorSet &ds)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( GetState() == EState::Recording );
+
+		return _frameGraph.GetResourceManager().GetDescriptorManager().AllocTransientDescriptorSet( layout, INOUT _transientDescPools, OUT ds );
+	}
+
 /*
 =================================================
 	_SetState
@@ -178,7 +272,28 @@ namespace FG
 		EXLOCK( _drCheck );
 		ASSERT( uint(newState) > uint(GetState()) );
 
-		_state.store( newState, memory_order_relaxed );
+		if ( newState != EState::Ready and newState != EState::Submitted )
+		{
+			_state.store( newState, memory_order_relaxed );
+			return;
+		}
+
+		// state must be changed under lock, otherwise new dependent may never be notified
+		EXLOCK( _dependentsGuard );
+		_state.store( newState, memory_order_release );
+
+		for (size_t i = 0; i < _dependents.size();)
+		{
+			auto&	dep = _dependents[i];
+
+			if ( dep.second > newState ) {
+				++i;
+				continue;
+			}
+
+			dep.first->_OnDependencyReady();
+			_dependents.erase( _dependents.begin() + i );
+		}
 	}
 	
 /*
@@ -193,6 +308,11 @@ namespace FG
 		
 		_dbgQueueSync	= EnumEq( desc.debugFlags, EDebugFlags::QueueSync );
 		_statistic		= Default;
+		
+	#ifdef FG_ENABLE_CPU_TRACE
+		_trace.name			= desc.name.empty() ? StringView{"CmdBatch"} : desc.name.substr( 0, _trace.name.capacity()-1 );
+		_trace.submitTime	= 0;
+	#endif
 
 		return true;
 	}
@@ -247,13 +367,34 @@ namespace FG
 */
 	bool  VCmdBatch::OnBaked (INOUT ResourceMap_t &resources)
 	{
+		FG_TRACE_SCOPE( "OnBaked", "CmdBatch" );
 		EXLOCK( _drCheck );
 		_SetState( EState::Backed );
 
-		std::swap( _resourcesToRelease, resources );
+		// map memory will be discarded by command buffer, so copy resources into persistent storage
+		_resourcesToRelease.reserve( resources.size() );
+
+		for (auto& [res, count] : resources) {
+			_resourcesToRelease.emplace_back( res, count );
+		}
+
+		resources.clear();
 		return true;
 	}
 	
+/*
+=================================================
+	OnExecuted
+----
+	batch will be added to the submission queue when all dependencies are ready
+=================================================
+*/
+	void  VCmdBatch::OnExecuted ()
+	{
+		ASSERT( GetState() == EState::Backed );
+		_OnDependencyReady();
+	}
+
 /*
 =================================================
 	OnReadyToSubmit
@@ -291,9 +432,9 @@ namespace FG
 		FixedArray<VkMappedMemoryRange, 32>		regions;
 		VDevice const&							dev = _frameGraph.GetDevice();
 		
-		for (auto& buf : _staging.hostToDevice)
+		for (auto& block : _staging.hostToDevice)
 		{
-			if ( buf.isCoherent )
+			if ( block.isCoherent )
 				continue;
 
 			if ( regions.size() == regions.capacity() )
@@ -302,12 +443,13 @@ namespace FG
 				regions.clear();
 			}
 
+			// block bounds are aligned to 'nonCoherentAtomSize'
 			auto&	reg = regions.emplace_back();
 			reg.sType	= VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
 			reg.pNext	= null;
-			reg.memory	= buf.mem;
-			reg.offset	= VkDeviceSize(buf.memOffset);
-			reg.size	= VkDeviceSize(buf.size);
+			reg.memory	= block.mem;
+			reg.offset	= VkDeviceSize(block.memOffset + block.begin);
+			reg.size	= VkDeviceSize(block.end - block.begin);
 		}
 		
 		if ( regions.size() )
@@ -333,6 +475,10 @@ namespace FG
 		_swapchains.clear();
 		_dependencies.clear();
 		_submitted = ptr;
+		
+	#ifdef FG_ENABLE_CPU_TRACE
+		_trace.submitTime = TraceRecorder::Now();
+	#endif
 
 		return true;
 	}
@@ -344,6 +490,7 @@ namespace FG
 */
 	bool  VCmdBatch::OnComplete (VDebugger &debugger, const ShaderDebugCallback_t &shaderDbgCallback, INOUT Statistic_t &outStatistic)
 	{
+		FG_TRACE_SCOPE( "OnComplete", "CmdBatch" );
 		EXLOCK( _drCheck );
 		ASSERT( _submitted );
 
@@ -351,6 +498,7 @@ namespace FG
 
 		_FinalizeCommands();
 		_ParseDebugOutput( shaderDbgCallback );
+		_frameGraph.GetResourceManager().GetDescriptorManager().ReleaseTransientPools( INOUT _transientDescPools );
 		_FinalizeStagingBuffers( _frameGraph.GetDevice() );
 		_ReleaseResources();
 		_ReleaseVkObjects();
@@ -373,6 +521,13 @@ namespace FG
 												sizeof(query_results[0]), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT ));
 
 			_statistic.renderer.gpuTime += Nanoseconds{query_results[1] - query_results[0]};
+			
+		#ifdef FG_ENABLE_CPU_TRACE
+			const double	period = double(dev.GetDeviceLimits().timestampPeriod);
+
+			_frameGraph.AddGpuTraceEvent( _queueType, _trace.name, uint64_t(double(query_results[0]) * period),
+										  uint64_t(double(query_results[1]) * period), _trace.submitTime );
+		#endif
 		}
 		outStatistic.Merge( _statistic );
 
@@ -393,7 +548,14 @@ namespace FG
 				pool->RecyclePrimary( _batch.commands.get<0>()[i] );
 		}
 
+		for (auto& [cmd, pool] : _batch.secondaries)
+		{
+			if ( pool )
+				pool->RecycleSecondary( cmd );
+		}
+
 		_batch.commands.clear();
+		_batch.secondaries.clear();
 		_batch.signalSemaphores.clear();
 		_batch.waitSemaphores.clear();
 	}
@@ -437,6 +599,23 @@ namespace FG
 			VK_CALL( dev.vkInvalidateMappedMemoryRanges( dev.GetVkDevice(), uint(regions.size()), regions.data() ));
 
 
+		// staging buffers will be released after all asynchronous callbacks
+		IFrameGraph::ReadbackExecutor_t	executor;
+		ReadbackPagesPtr				pages;
+
+		if ( _staging.onBufferLoadedEvents.size() or _staging.onImageLoadedEvents.size() )
+			executor = _frameGraph.GetReadbackExecutor();
+
+		if ( executor )
+		{
+			pages = std::make_shared<ReadbackPages>( _frameGraph );
+
+			for (auto& sb : _staging.deviceToHost) {
+				pages->indices.push_back( sb.index );
+			}
+		}
+
+
 		// trigger buffer events
 		for (auto& ev : _staging.onBufferLoadedEvents)
 		{
@@ -453,7 +632,10 @@ namespace FG
 
 			ASSERT( total_size == ev.totalSize );
 
-			ev.callback( BufferView{data_parts} );
+			if ( pages )
+				executor( [pages, cb = std::move(ev.callback), data_parts] () { cb( BufferView{data_parts} ); });
+			else
+				ev.callback( BufferView{data_parts} );
 		}
 		_staging.onBufferLoadedEvents.clear();
 		
@@ -474,18 +656,28 @@ namespace FG
 
 			ASSERT( total_size == ev.totalSize );
 
-			ev.callback( ImageView{ data_parts, ev.imageSize, ev.rowPitch, ev.slicePitch, ev.format, ev.aspect });
+			if ( pages )
+			{
+				executor( [pages, cb = std::move(ev.callback), data_parts, size = ev.imageSize, row_pitch = ev.rowPitch,
+						   slice_pitch = ev.slicePitch, fmt = ev.format, aspect = ev.aspect] ()
+						  {
+							  cb( ImageView{ data_parts, size, row_pitch, slice_pitch, fmt, aspect });
+						  });
+			}
+			else
+				ev.callback( ImageView{ data_parts, ev.imageSize, ev.rowPitch, ev.slicePitch, ev.format, ev.aspect });
 		}
 		_staging.onImageLoadedEvents.clear();
 
+		if ( pages )
+			_staging.deviceToHost.clear();
+
 
 		// release resources
 		{
 			auto&	rm = _frameGraph.GetResourceManager();
 
-			for (auto& sb : _staging.hostToDevice) {
-				rm.ReleaseStagingBuffer( sb.index );
-			}
+			_frameGraph.GetStagingRing( _queueType ).Release( rm, _staging.hostToDevice );
 			_staging.hostToDevice.clear();
 
 			for (auto& sb : _staging.deviceToHost) {
@@ -509,10 +701,7 @@ namespace FG
 
 		//VK_CHECK( dev.vkDeviceWaitIdle( dev.GetVkDevice() ), void());
 
-		// release descriptor sets
-		for (auto& ds : _shaderDebugger.descCache) {
-			rm.GetDescriptorManager().DeallocDescriptorSet( ds.second );
-		}
+		// descriptor sets are allocated from transient pools and will be released with them
 		_shaderDebugger.descCache.clear();
 
 		// process shader debug output
@@ -764,66 +953,10 @@ namespace FG
 		ASSERT( blockAlign > 0_b and offsetAlign > 0_b );
 		ASSERT( dstMinSize == AlignToSmaller( dstMinSize, blockAlign ));
 
-		auto&			staging_buffers = _staging.hostToDevice;
-		const BytesU	stagingbuf_size	= _frameGraph.GetResourceManager().GetHostWriteBufferSize();
-
-		// search in existing
-		StagingBuffer*	suitable		= null;
-		StagingBuffer*	max_available	= null;
-		BytesU			max_size;
-
-		for (auto& buf : staging_buffers)
-		{
-			const BytesU	off	= AlignToLarger( buf.size, offsetAlign );
-			const BytesU	av	= AlignToSmaller( buf.capacity - off, blockAlign );
-
-			if ( av >= srcRequiredSize )
-			{
-				suitable = &buf;
-				break;
-			}
-
-			if ( not max_available or av > max_size )
-			{
-				max_available	= &buf;
-				max_size		= av;
-			}
-		}
-
-		// no suitable space, try to use max available block
-		if ( not suitable and max_available and max_size >= dstMinSize )
-		{
-			suitable = max_available;
-		}
-
-		// allocate new buffer
-		if ( not suitable )
-		{
-			ASSERT( dstMinSize < stagingbuf_size );
-			CHECK_ERR( staging_buffers.size() < staging_buffers.capacity() );
-
-			VResourceManager&	rm = _frameGraph.GetResourceManager();
-			
-			RawBufferID			buf_id;
-			StagingBufferIdx	buf_idx;
-			CHECK_ERR( rm.CreateStagingBuffer( EBufferUsage::TransferSrc, OUT buf_id, OUT buf_idx ));
-
-			RawMemoryID		mem_id = rm.GetResource( buf_id )->GetMemoryID();
-			CHECK_ERR( mem_id );
-
-			staging_buffers.push_back({ buf_idx, buf_id, mem_id, stagingbuf_size });
-
-			suitable = &staging_buffers.back();
-			CHECK( _MapMemory( *suitable ));
-		}
-
-		// write data to buffer
-		dstOffset	= AlignToLarger( suitable->size, offsetAlign );
-		outSize		= Min( AlignToSmaller( suitable->capacity - dstOffset, blockAlign ), srcRequiredSize );
-		dstBuffer	= suitable->bufferId;
-		mappedPtr	= suitable->mappedPtr + dstOffset;
-
-		suitable->size = dstOffset + outSize;
+		// data is splitted into parts aligned to 'blockAlign' only if current ring has space for 'dstMinSize',
+		// otherwise ring grows and whole data is written into single block
+		CHECK_ERR( _frameGraph.GetStagingRing( _queueType ).Allocate( _frameGraph.GetResourceManager(), srcRequiredSize, dstMinSize, blockAlign, offsetAlign,
+																	   INOUT _staging.hostToDevice, OUT dstBuffer, OUT dstOffset, OUT outSize, OUT mappedPtr ));
 		return true;
 	}
 	
@@ -874,7 +1007,7 @@ namespace FG
 		// allocate new buffer
 		if ( not suitable )
 		{
-			ASSERT( dstMinSize < stagingbuf_size );
+			ASSERT( dstMinSize <= stagingbuf_size );
 			CHECK_ERR( staging_buffers.size() < staging_buffers.capacity() );
 			
 			VResourceManager&	rm = _frameGraph.GetResourceManager();
@@ -909,13 +1042,14 @@ namespace FG
 	AddPendingLoad
 =================================================
 */
-	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize,
+	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize, const bool contiguous,
 									 OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range)
 	{
 		EXLOCK( _drCheck );
 
-		// skip blocks less than 1/N of data size
-		const BytesU	min_size = (srcTotalSize + MaxBufferParts-1) / MaxBufferParts;
+		// skip blocks less than 1/N of data size, contiguous data that fits in single page must be in single block
+		const BytesU	min_size = (contiguous and srcTotalSize <= _frameGraph.GetResourceManager().GetHostReadBufferSize()) ?
+									(srcTotalSize - srcOffset) : (srcTotalSize + MaxBufferParts-1) / MaxBufferParts;
 
 		return _AddPendingLoad( srcTotalSize - srcOffset, 1_b, 16_b, min_size, OUT dstBuffer, OUT range );
 	}
@@ -939,13 +1073,14 @@ namespace FG
 	AddPendingLoad
 =================================================
 */
-	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize, const BytesU srcPitch,
+	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize, const BytesU srcPitch, const bool contiguous,
 									 OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range)
 	{
 		EXLOCK( _drCheck );
 
-		// skip blocks less than 1/N of total data size
-		const BytesU	min_size = Max( (srcTotalSize + MaxImageParts-1) / MaxImageParts, srcPitch );
+		// skip blocks less than 1/N of total data size, contiguous data that fits in single page must be in single block
+		const BytesU	min_size = (contiguous and srcTotalSize <= _frameGraph.GetResourceManager().GetHostReadBufferSize()) ?
+									(srcTotalSize - srcOffset) : Max( (srcTotalSize + MaxImageParts-1) / MaxImageParts, srcPitch );
 
 		return _AddPendingLoad( srcTotalSize - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT range );
 	}
@@ -1347,17 +1482,14 @@ namespace FG
 
 		if ( iter != _shaderDebugger.descCache.end() )
 		{
-			descSet = iter->second.first;
+			descSet = iter->second;
 			return true;
 		}
 
 		// allocate descriptor set
 		{
-			VDescriptorSetLayout::DescriptorSet	ds;
-			CHECK_ERR( rm.GetDescriptorManager().AllocDescriptorSet( layout->Handle(), OUT ds ));
-
-			descSet = ds.first;
-			_shaderDebugger.descCache.insert_or_assign( {storageBuffer, layout_id}, ds );
+			CHECK_ERR( AllocTransientDescriptorSet( layout->Handle(), OUT descSet ));
+			_shaderDebugger.descCache.insert_or_assign( {storageBuffer, layout_id}, descSet );
 		}
 
 		// update descriptor set
@@ -5,9 +5,13 @@
 #include "framegraph/Public/CommandBuffer.h"
 #include "framegraph/Public/FrameGraph.h"
 #include "VDescriptorSetLayout.h"
+#include "VDescriptorManager.h"
 #include "VLocalDebugger.h"
 #include "VCommandPool.h"
+#include "VStagingRing.h"
 #include "stl/Containers/FixedTupleArray.h"
+#include "stl/Containers/FlatHashMap.h"
+#include "stl/ThreadSafe/SpinLock.h"
 
 namespace FG
 {
@@ -98,13 +102,8 @@ namespace FG
 			ND_ uint			GetUID ()				const	{ return uint((value & IDMask) >> IDOffset); }
 		};
 
-		struct ResourceHash {
-			ND_ size_t  operator () (const Resource &x) const {
-				return std::hash<decltype(x.value)>{}( x.value );
-			}
-		};
-		
-		using ResourceMap_t		= std::unordered_map< Resource, uint, ResourceHash >;		// TODO: custom allocator
+		using ResourceMap_t		= FlatHashMap< Resource, uint, UntypedLinearAllocator<> >;	// allocated by command buffer
+		using ResourceArray_t	= Array< Pair< Resource, uint >>;
 
 
 		//---------------------------------------------------------------------------
@@ -162,6 +161,11 @@ namespace FG
 		};
 
 
+		// keeps device-to-host staging buffers alive until all asynchronous readback callbacks are finished
+		struct ReadbackPages;
+		using ReadbackPagesPtr	= SharedPtr< ReadbackPages >;
+
+
 		struct OnImageDataLoadedEvent
 		{
 		// types
@@ -220,7 +224,7 @@ namespace FG
 
 		using StorageBuffers_t		= Array< StorageBuffer >;
 		using DebugModes_t			= Array< DebugMode >;
-		using DescriptorCache_t		= HashMap< Pair<RawBufferID, RawDescriptorSetLayoutID>, VDescriptorSetLayout::DescriptorSet >;
+		using DescriptorCache_t		= HashMap< Pair<RawBufferID, RawDescriptorSetLayoutID>, VkDescriptorSet >;
 		using ShaderDebugCallback_t	= IFrameGraph::ShaderDebugCallback_t;
 		
 
@@ -236,6 +240,7 @@ namespace FG
 
 		static constexpr uint		MaxBatchItems = 8;
 		using CmdBuffers_t			= FixedTupleArray< MaxBatchItems, VkCommandBuffer, VCommandPool const* >;
+		using SecondaryCmdBuffers_t	= Array< Pair< VkCommandBuffer, VCommandPool const* >>;
 		using SignalSemaphores_t	= FixedArray< VkSemaphore, MaxBatchItems >;
 		using WaitSemaphores_t		= FixedTupleArray< MaxBatchItems, VkSemaphore, VkPipelineStageFlags >;
 		
@@ -255,6 +260,8 @@ namespace FG
 			Complete,		// commands complete execution on the GPU
 		};
 
+		using Dependents_t		= Array< Pair< VCmdBatchPtr, EState >>;
+
 
 	// variables
 	private:
@@ -265,6 +272,9 @@ namespace FG
 		EQueueType							_queueType			= Default;
 
 		Dependencies_t						_dependencies;
+		Atomic<uint>						_pendingDeps		{0};	// number of dependencies that are not in required state + 1 until executed
+		SpinLock							_dependentsGuard;
+		Dependents_t						_dependents;				// batches that wait until this batch will be in specified state
 		bool								_submitImmediately	= false;
 		bool								_supportsQuery		= false;
 		bool								_dbgQueueSync		= false;
@@ -272,23 +282,27 @@ namespace FG
 		// command batch data
 		struct {
 			CmdBuffers_t						commands;
+			SecondaryCmdBuffers_t				secondaries;	// executed inside 'commands', must be recycled with them
 			SignalSemaphores_t					signalSemaphores;
 			WaitSemaphores_t					waitSemaphores;
 		}									_batch;
 
 		// staging buffers
 		struct {
-			FixedArray< StagingBuffer, 8 >		hostToDevice;	// CPU write, GPU read
+			Array< VStagingRing::Block >		hostToDevice;	// CPU write, GPU read, allocated in queue staging ring
 			FixedArray< StagingBuffer, 8 >		deviceToHost;	// CPU read, GPU write
 			Array< OnBufferDataLoadedEvent >	onBufferLoadedEvents;
 			Array< OnImageDataLoadedEvent >		onImageLoadedEvents;
 		}									_staging;
 
 		// resources
-		ResourceMap_t						_resourcesToRelease;
+		ResourceArray_t						_resourcesToRelease;
 		Swapchains_t						_swapchains;
 		VkResourceArray_t					_readyToDelete;
 
+		// descriptor pools for transient descriptor sets, reset when batch is completed
+		VDescriptorManager::TransientPoolArray_t	_transientDescPools;
+
 		// shader debugger
 		struct {
 			StorageBuffers_t					buffers;
@@ -304,6 +318,14 @@ namespace FG
 		
 		Statistic_t							_statistic;
 
+	#ifdef FG_ENABLE_CPU_TRACE
+		// used to place GPU time on CPU timeline
+		struct {
+			TraceRecorder::Name_t				name;
+			uint64_t							submitTime	= 0;
+		}									_trace;
+	#endif
+
 		VSubmitted *						_submitted	= null;	// TODO: should be atomic
 		
 		RWDataRaceCheck						_drCheck;
@@ -321,6 +343,7 @@ namespace FG
 		void  OnBeginRecording (VkCommandBuffer cmd);
 		void  OnEndRecording (VkCommandBuffer cmd);
 		bool  OnBaked (INOUT ResourceMap_t &);
+		void  OnExecuted ();
 		bool  OnReadyToSubmit ();
 		bool  BeforeSubmit (OUT VkSubmitInfo &);
 		bool  AfterSubmit (OUT Appendable<VSwapchain const*>, VSubmitted *);
@@ -330,8 +353,10 @@ namespace FG
 		void  WaitSemaphore (VkSemaphore sem, VkPipelineStageFlags stage);
 		void  PushFrontCommandBuffer (VkCommandBuffer, const VCommandPool *);
 		void  PushBackCommandBuffer (VkCommandBuffer, const VCommandPool *);
+		void  AddSecondaryCommandBuffer (VkCommandBuffer, const VCommandPool *);
 		void  AddDependency (VCmdBatch *);
 		void  DestroyPostponed (VkObjectType type, uint64_t handle);
+		bool  AllocTransientDescriptorSet (VkDescriptorSetLayout layout, OUT VkDescriptorSet &ds);
 	
 
 		// shader debugger //
@@ -349,8 +374,8 @@ namespace FG
 		// staging buffer //
 		bool  GetWritable (const BytesU srcRequiredSize, const BytesU blockAlign, const BytesU offsetAlign, const BytesU dstMinSize,
 							OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &outSize, OUT void* &mappedPtr);
-		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range);
-		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, BytesU srcPitch, OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range);
+		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, bool contiguous, OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range);
+		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, BytesU srcPitch, bool contiguous, OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range);
 		bool  AddDataLoadedEvent (OnImageDataLoadedEvent &&);
 		bool  AddDataLoadedEvent (OnBufferDataLoadedEvent &&);
 
@@ -365,6 +390,8 @@ namespace FG
 
 	private:
 		void  _SetState (EState newState);
+		bool  _AddDependent (VCmdBatch *batch, EQueueType queue);
+		void  _OnDependencyReady ();
 		void  _ReleaseResources ();
 		void  _ReleaseVkObjects ();
 		void  _FinalizeCommands ();
@@ -2,6 +2,7 @@
 
 #include "VCommandBuffer.h"
 #include "VTaskGraph.hpp"
+#include "framegraph/Shared/PipelineResourcesHelper.h"
 
 namespace FG
 {
@@ -20,6 +21,7 @@ namespace {
 =================================================
 */
 	VCommandBuffer::VCommandBuffer (VFrameGraph &fg, uint index) :
+		_resourceMap{ _mainAllocator },
 		_state{ EState::Initial },
 		_queueIndex{ Default },
 		_instance{ fg },
@@ -44,6 +46,14 @@ namespace {
 			q.Destroy( GetDevice() );
 		}
 		_perQueue.clear();
+
+		for (auto& q : _secondaryPools)
+		for (auto& pool : q) {
+			pool.Destroy( GetDevice() );
+		}
+		_secondaryPools.clear();
+
+		_pipelineCache.Deinitialize( GetDevice() );
 	}
 
 /*
@@ -61,6 +71,7 @@ namespace {
 		_dbgName		= desc.name;
 		_dbgFullBarriers= EnumEq( desc.debugFlags, EDebugFlags::FullBarrier );
 		_dbgQueueSync	= EnumEq( desc.debugFlags, EDebugFlags::QueueSync );
+		_compilationFlags= desc.compilationFlags;
 		_state			= EState::Recording;
 		_queueIndex		= queue->familyIndex;
 		
@@ -77,7 +88,29 @@ namespace {
 				CHECK_ERR( pool.Create( GetDevice(), queue ));
 			}
 		}
+
+		// create command pools for parallel recording
+		if ( EnumEq( _compilationFlags, ECompilationFlags::ParallelRenderPass ))
+		{
+			const uint	index	= uint(_queueIndex);
+			const uint	count	= Min( FG_MaxRecordingThreads, Max( 1u, std::thread::hardware_concurrency() ));
+
+			_secondaryPools.resize( Max( _secondaryPools.size(), index+1 ));
+
+			auto&	pools = _secondaryPools[index];
+
+			for (; pools.size() < count;)
+			{
+				CHECK_ERR( pools.emplace_back().Create( GetDevice(), queue ));
+			}
+		}
 		
+		// create pipeline cache
+		if ( not _pipelineCache.IsCreated() )
+		{
+			CHECK_ERR( _instance.InitPipelineCache( INOUT _pipelineCache ));
+		}
+
 		_batch->OnBegin( desc );
 		
 		// setup local debugger
@@ -94,9 +127,34 @@ namespace {
 			_debugger.reset();
 
 		_taskGraph.OnStart( GetAllocator() );
+		_resourceMap.reserve( _lastResourceCount );
 		return true;
 	}
 	
+/*
+=================================================
+	GetSecondaryPoolCount
+=================================================
+*/
+	uint  VCommandBuffer::GetSecondaryPoolCount () const
+	{
+		EXLOCK( _drCheck );
+		const uint	index = uint(_queueIndex);
+
+		return index < _secondaryPools.size() ? uint(_secondaryPools[index].size()) : 0;
+	}
+	
+/*
+=================================================
+	GetSecondaryPool
+=================================================
+*/
+	VCommandPool&  VCommandBuffer::GetSecondaryPool (uint index)
+	{
+		EXLOCK( _drCheck );
+		return _secondaryPools[ uint(_queueIndex) ][ index ];
+	}
+
 /*
 =================================================
 	Execute
@@ -118,11 +176,20 @@ namespace {
 		if ( _debugger )
 			_debugger->End( GetName(), _indexInPool, OUT &_batch->_debugDump, OUT &_batch->_debugGraph );
 
-		CHECK_ERR( _batch->OnBaked( INOUT _rm.resourceMap ));
+		_lastResourceCount = uint(_resourceMap.size());
+		const bool	baked = _batch->OnBaked( INOUT _resourceMap );
 		
+		// map must not reference allocator memory even if baking failed
+		_resourceMap.release();	// memory will be discarded with allocator
+		CHECK_ERR( baked );
+
 		_taskGraph.OnDiscardMemory();
 		_AfterCompilation();
 		_mainAllocator.Discard();
+
+		// new pipelines will be merged into the main cache in background
+		if ( _pipelineCache.ResetModified() )
+			_instance.AddPipelineCacheToMerge( _pipelineCache );
 		
 		EditStatistic().renderer.cpuTime += TimePoint_t::clock::now() - start_time;
 		_batch = null;
@@ -156,6 +223,8 @@ namespace {
 			}
 		}
 		_rm.logicalRenderPassCount = 0;
+
+		_ResetTransientResources();
 	}
 
 /*
@@ -191,6 +260,8 @@ namespace {
 */
 	bool  VCommandBuffer::_BuildCommandBuffers ()
 	{
+		FG_TRACE_SCOPE( _dbgName, "BuildCommandBuffers" );
+
 		//if ( _taskGraph.Empty() )
 		//	return true;
 
@@ -222,7 +293,8 @@ namespace {
 		}
 
 		// commit image layout transition and other
-		_barrierMngr.Commit( dev, cmd );
+		if ( _barrierMngr.Commit( dev, cmd ))
+			EditStatistic().renderer.pipelineBarriers++;
 
 		CHECK( _ProcessTasks( cmd ));
 
@@ -236,7 +308,8 @@ namespace {
 			_barrierMngr.AddMemoryBarrier( VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, barrier );
 
 			_FlushLocalResourceStates( ExeOrderIndex::Final, _barrierMngr, GetDebugger() );
-			_barrierMngr.ForceCommit( dev, cmd, dev.GetAllWritableStages(), dev.GetAllReadableStages() );
+			if ( _barrierMngr.ForceCommit( dev, cmd, dev.GetAllWritableStages(), dev.GetAllReadableStages() ))
+				EditStatistic().renderer.pipelineBarriers++;
 		}
 
 		// end
@@ -260,64 +333,82 @@ namespace {
 		if ( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddTask( _currTask );
 
+		FG_TRACE_SCOPE( node->Name(), "Visit" );
 		node->Process( this );
 	}
 
 /*
 =================================================
-	_ProcessTasks
+	_SortTasks
+----
+	task graph can be traversed only once,
+	so tasks are sorted before processing to calculate lifetime of transient resources.
 =================================================
 */
-	bool  VCommandBuffer::_ProcessTasks (VkCommandBuffer cmd)
+	bool  VCommandBuffer::_SortTasks (OUT ArrayView<VTask> &result)
 	{
-		VTaskProcessor	processor{ *this, cmd };
-		uint			visitor_id		= 1;
+		const size_t	count			= _taskGraph.Count();
 		ExeOrderIndex	exe_order_index	= ExeOrderIndex::First;
+		size_t			pos				= 0;
+
+		if ( count == 0 )
+			return true;
 
-		TempTaskArray_t		pending{ GetAllocator() };
-		pending.reserve( 128 );
-		pending.assign( _taskGraph.Entries().begin(), _taskGraph.Entries().end() );
+		VTask*	tasks = GetAllocator().Alloc< VTask >( count );
+		CHECK_ERR( tasks );
 
-		for (uint k = 0; k < 10 and not pending.empty(); ++k)
+		const size_t	visited = _taskGraph.Traverse( GetAllocator(), [tasks, count, &exe_order_index, &pos] (VTask node)
 		{
-			for (size_t i = 0; i < pending.size();)
-			{
-				auto	node = pending[i];
-				
-				if ( node->VisitorID() == visitor_id ) {
-					++i;
-					continue;
-				}
+			CHECK_ERR( pos < count, void());
+			node->SetExecutionOrder( ++exe_order_index );
+			tasks[pos++] = node;
+		});
 
-				// wait for input
-				bool	input_processed = true;
+		// all tasks must be processed
+		CHECK_ERR( visited == count and pos == count );
 
-				for (auto in_node : node->Inputs())
-				{
-					if ( in_node->VisitorID() != visitor_id ) {
-						input_processed = false;
-						break;
-					}
-				}
+		result = ArrayView<VTask>{ tasks, count };
+		return true;
+	}
 
-				if ( not input_processed ) {
-					++i;
-					continue;
-				}
+/*
+=================================================
+	_ProcessTasks
+=================================================
+*/
+	bool  VCommandBuffer::_ProcessTasks (VkCommandBuffer cmd)
+	{
+		FG_TRACE_SCOPE( _dbgName, "ProcessTasks" );
 
-				node->SetVisitorID( visitor_id );
-				node->SetExecutionOrder( ++exe_order_index );
-				
-				processor.Run( node );
+		ArrayView<VTask>	tasks;
+		CHECK_ERR( _SortTasks( OUT tasks ));
+		CHECK_ERR( _BindTransientMemory() );
 
-				for (auto out_node : node->Outputs())
-				{
-					pending.push_back( out_node );
-				}
+		VTaskProcessor	processor{ *this, cmd };
+		
+		// global memory barrier after each task can not be merged
+		const bool		batch_barriers	= EnumEq( _compilationFlags, ECompilationFlags::BatchBarriers ) and not _dbgFullBarriers;
+		auto			aliasing		= _transient.aliasingBarriers.begin();
 
-				pending.erase( pending.begin()+i );
+		for (VTask node : tasks)
+		{
+			if ( aliasing != _transient.aliasingBarriers.end() and *aliasing == node->ExecutionOrder() )
+			{
+				processor.FlushBarrierGroup();
+				_AddAliasingBarrier();
+				++aliasing;
+			}
+
+			if ( batch_barriers and node->CanBatchBarriers() )
+				processor.RunBatched( node );
+			else
+			{
+				processor.FlushBarrierGroup();
+				processor.Run( node );
 			}
 		}
+		processor.FlushBarrierGroup();
+
 		return true;
 	}
 //-----------------------------------------------------------------------------
@@ -437,6 +528,116 @@ namespace {
 		}
 	}
 
+/*
+=================================================
+	CreateTransientImage
+=================================================
+*/
+	RawImageID  VCommandBuffer::CreateTransientImage (const ImageDesc &desc, StringView dbgName)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+
+		RawImageID	id = GetResourceManager().CreateImage( desc, MemoryDesc{ EMemoryType::Transient }, EQueueFamilyMask::Unknown, Default, dbgName );
+		CHECK_ERR( id );
+
+		// will be released after execution
+		ReleaseResource( id );
+
+		// previous content is undefined
+		auto*	image = _ToLocal( id, _rm.images, "failed when creating local image" );
+		CHECK_ERR( image );
+		image->SetInitialState( false, true );
+		
+		_transient.resources.push_back({ Resource_t{ id }});
+		return id;
+	}
+	
+/*
+=================================================
+	CreateTransientBuffer
+=================================================
+*/
+	RawBufferID  VCommandBuffer::CreateTransientBuffer (const BufferDesc &desc, StringView dbgName)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+
+		RawBufferID	id = GetResourceManager().CreateBuffer( desc, MemoryDesc{ EMemoryType::Transient }, EQueueFamilyMask::Unknown, dbgName );
+		CHECK_ERR( id );
+		
+		// will be released after execution
+		ReleaseResource( id );
+
+		_transient.resources.push_back({ Resource_t{ id }});
+		return id;
+	}
+
+/*
+=================================================
+	DefragmentMemory
+----
+	resource manager replaces memory of the resources,
+	previous memory is copied to the new and released after execution.
+	Reference counter of the resource is checked before relocation,
+	so other command buffers must not acquire resources at the same time.
+=================================================
+*/
+	BytesU  VCommandBuffer::DefragmentMemory (BytesU maxBytesToMove)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording(), 0_b );
+		CHECK_ERR( _instance.GetRecordingCommandBufferCount() == 1, 0_b );
+		ASSERT( EnumEq( TransferBit, _GetQueueUsage() ));
+
+		VResourceManager::RelocatedBuffers_t	buffers;
+		VResourceManager::RelocatedImages_t		images;
+		BytesU									moved_size;
+		CHECK_ERR( GetResourceManager().DefragmentMemory( maxBytesToMove, OUT buffers, OUT images, OUT moved_size ), 0_b );
+
+		for (auto& [buf_id, old_id] : buffers)
+		{
+			// will be released after execution
+			ReleaseResource( old_id );
+
+			AddTask( CopyBuffer{}.From( old_id ).To( buf_id ).AddRegion( 0_b, 0_b, GetResourceManager().GetDescription( buf_id ).size ));
+		}
+
+		for (auto& [img_id, old_id] : images)
+		{
+			// will be released after execution
+			ReleaseResource( old_id );
+
+			// new image content is undefined
+			auto*	image = _ToLocal( img_id, _rm.images, "failed when creating local image" );
+			CHECK_ERR( image, 0_b );
+			image->SetInitialState( false, true );
+
+			const ImageDesc&	desc = image->Description();
+			CopyImage			copy;
+			copy.From( old_id ).To( img_id );
+
+			for (uint mip = 0; mip < desc.maxLevel.Get(); ++mip)
+			{
+				if ( copy.regions.size() == copy.regions.capacity() )
+				{
+					AddTask( copy );
+					copy.regions.clear();
+				}
+
+				const ImageSubresourceRange	range{ MipmapLevel(mip), 0_layer, desc.arrayLayers.Get() };
+				copy.AddRegion( range, int3(), range, int3(), Max( desc.dimension >> mip, 1u ));
+			}
+			AddTask( copy );
+		}
+
+		auto&	stat = EditStatistic().resources;
+		stat.defragmentedResources	+= uint(buffers.size() + images.size());
+		stat.defragmentedBytes		+= moved_size;
+
+		return moved_size;
+	}
+
 /*
 =================================================
 	AddTask (SubmitRenderPass)
@@ -450,6 +651,18 @@ namespace {
 
 		// TODO: add scale to shader timemap
 
+		// transient resources that are used in render pass will be attached to the task
+		for (auto iter = _transient.passUsages.begin(); iter != _transient.passUsages.end();)
+		{
+			if ( iter->first == task.renderPassId.Index() )
+			{
+				_transient.pending.push_back( iter->second );
+				iter = _transient.passUsages.erase( iter );
+			}
+			else
+				++iter;
+		}
+
 		auto	rp_task = _taskGraph.Add( *this, task );
 		
 		if ( EnumEq( _shaderDbg.timemapStages, EShaderStages::Fragment ) and _shaderDbg.timemapIndex != Default )
@@ -765,7 +978,6 @@ namespace {
 
 		CHECK_ERR( total_size == ArraySizeOf(task.data) );
 
-		const BytesU		min_size	= _instance.GetResourceManager().GetHostWriteBufferSize() / 4;
 		const uint			row_length	= CheckCast<uint>((row_pitch * block_dim.x * 8) / block_size);
 		const uint			img_height	= CheckCast<uint>((slice_pitch * block_dim.y) / row_pitch);
 		CopyBufferToImage	copy;
@@ -778,77 +990,37 @@ namespace {
 		ASSERT( task.imageOffset.x % block_dim.x == 0 );
 		ASSERT( task.imageOffset.y % block_dim.y == 0 );
 
-		// copy to staging buffer slice by slice
-		if ( total_size < min_size )
+		// copy to staging buffer, staging ring allocates whole data in single block
+		uint	z_offset = 0;
+		for (BytesU readn; readn < total_size;)
 		{
-			uint	z_offset = 0;
-			for (BytesU readn; readn < total_size;)
-			{
-				RawBufferID		src_buffer;
-				BytesU			off, size;
-				CHECK_ERR( _StoreImageData( task.data, readn, slice_pitch, total_size, OUT src_buffer, OUT off, OUT size ));
+			RawBufferID		src_buffer;
+			BytesU			off, size;
+			CHECK_ERR( _StoreImageData( task.data, readn, slice_pitch, OUT src_buffer, OUT off, OUT size ));
 				
-				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
-				{
-					Task	last_task = AddTask( copy );
-					copy.regions.clear();
-					copy.depends.clear();
-					copy.depends.push_back( last_task );
-				}
-
-				const uint	z_size = CheckCast<uint>(size / slice_pitch);
-
-				ASSERT( image_size.x % block_dim.x == 0 );
-				ASSERT( image_size.y % block_dim.y == 0 );
-
-				copy.AddRegion( off, row_length, img_height,
-								ImageSubresourceRange{ task.mipmapLevel, task.arrayLayer, 1, task.aspectMask },
-								task.imageOffset + int3(0, 0, z_offset), uint3(image_size.x, image_size.y, z_size) );
-
-				readn		  += size;
-				z_offset	  += z_size;
-				copy.srcBuffer = src_buffer;
-			}
-			CHECK( z_offset == image_size.z );
-		}
-		else
-
-		// copy to staging buffer row by row
-		for (uint slice = 0; slice < image_size.z; ++slice)
-		{
-			uint				y_offset	= 0;
-			ArrayView<uint8_t>	data		= task.data.section( size_t(slice * slice_pitch), size_t(slice_pitch) );
-
-			for (BytesU readn; readn < ArraySizeOf(data);)
+			if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 			{
-				RawBufferID		src_buffer;
-				BytesU			off, size;
-				CHECK_ERR( _StoreImageData( data, readn, row_pitch * block_dim.y, total_size, OUT src_buffer, OUT off, OUT size ));
-				
-				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
-				{
-					Task	last_task = AddTask( copy );
-					copy.regions.clear();
-					copy.depends.clear();
-					copy.depends.push_back( last_task );
-				}
+				Task	last_task = AddTask( copy );
+				copy.regions.clear();
+				copy.depends.clear();
+				copy.depends.push_back( last_task );
+			}
 
-				const uint	y_size = CheckCast<uint>((size * block_dim.y) / row_pitch);
+			// last slice may be less than 'slice_pitch'
+			const uint	z_size = CheckCast<uint>((size + slice_pitch - min_slice_pitch) / slice_pitch);
 
-				ASSERT( (task.imageOffset.y + y_offset) % block_dim.y == 0 );
-				ASSERT( image_size.x % block_dim.x == 0 );
-				ASSERT( y_size % block_dim.y == 0 );
+			ASSERT( image_size.x % block_dim.x == 0 );
+			ASSERT( image_size.y % block_dim.y == 0 );
 
-				copy.AddRegion( off, row_length, y_size,
-								ImageSubresourceRange{ task.mipmapLevel, task.arrayLayer, 1, task.aspectMask },
-								task.imageOffset + int3(0, y_offset, slice), uint3(image_size.x, y_size, 1) );
+			copy.AddRegion( off, row_length, img_height,
+							ImageSubresourceRange{ task.mipmapLevel, task.arrayLayer, 1, task.aspectMask },
+							task.imageOffset + int3(0, 0, z_offset), uint3(image_size.x, image_size.y, z_size) );
 
-				readn		  += size;
-				y_offset	  += y_size;
-				copy.srcBuffer = src_buffer;
-			}
-			CHECK( y_offset == image_size.y );
+			readn		  += size;
+			z_offset	  += z_size;
+			copy.srcBuffer = src_buffer;
 		}
+		CHECK( z_offset == image_size.z );
 
 		return AddTask( copy );
 	}
@@ -894,7 +1066,7 @@ namespace {
 		{
 			RawBufferID					dst_buffer;
 			OnDataLoadedEvent::Range	range;
-			CHECK_ERR( _batch->AddPendingLoad( written, task.size, OUT dst_buffer, OUT range ));
+			CHECK_ERR( _batch->AddPendingLoad( written, task.size, task.contiguous, OUT dst_buffer, OUT range ));
 			
 			if ( copy.dstBuffer and dst_buffer != copy.dstBuffer )
 			{
@@ -950,7 +1122,8 @@ namespace {
 		ASSERT(Any( task.imageSize > Zero ));
 		
 		const uint3			image_size		= Max( task.imageSize, 1u );
-		const BytesU		min_size		= _instance.GetResourceManager().GetHostReadBufferSize() / 4;
+		const BytesU		page_size		= _instance.GetResourceManager().GetHostReadBufferSize();
+		const BytesU		min_size		= page_size / 4;
 		const auto&			fmt_info		= EPixelFormat_GetInfo( img_desc.format );
 		const auto&			block_dim		= fmt_info.blockSize;
 		const uint			block_size		= task.aspectMask != EImageAspect::Stencil ? fmt_info.bitsPerBlock : fmt_info.bitsPerBlock2;
@@ -969,14 +1142,14 @@ namespace {
 		copy.srcImage	= task.srcImage;
 		
 		// copy to staging buffer slice by slice
-		if ( total_size < min_size )
+		if ( total_size < min_size or (task.contiguous and total_size <= page_size) )
 		{
 			uint	z_offset = 0;
 			for (BytesU written; written < total_size;)
 			{
 				RawBufferID					dst_buffer;
 				OnDataLoadedEvent::Range	range;
-				CHECK_ERR( _batch->AddPendingLoad( written, total_size, slice_pitch, OUT dst_buffer, OUT range ));
+				CHECK_ERR( _batch->AddPendingLoad( written, total_size, slice_pitch, task.contiguous, OUT dst_buffer, OUT range ));
 			
 				if ( copy.dstBuffer and dst_buffer != copy.dstBuffer )
 				{
@@ -1011,7 +1184,7 @@ namespace {
 			{
 				RawBufferID					dst_buffer;
 				OnDataLoadedEvent::Range	range;
-				CHECK_ERR( _batch->AddPendingLoad( written, total_size, row_pitch * block_dim.y, OUT dst_buffer, OUT range ));
+				CHECK_ERR( _batch->AddPendingLoad( written, total_size, row_pitch * block_dim.y, false, OUT dst_buffer, OUT range ));
 				
 				if ( copy.dstBuffer and dst_buffer != copy.dstBuffer )
 				{
@@ -1430,6 +1603,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVertices,
 						VTaskProcessor::Visit2_DrawVertices );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1451,6 +1626,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexed,
 						VTaskProcessor::Visit2_DrawIndexed );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1472,6 +1649,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshes,
 						VTaskProcessor::Visit2_DrawMeshes );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1493,6 +1672,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVerticesIndirect,
 						VTaskProcessor::Visit2_DrawVerticesIndirect );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1514,6 +1695,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexedIndirect,
 						VTaskProcessor::Visit2_DrawIndexedIndirect );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1535,6 +1718,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshesIndirect,
 						VTaskProcessor::Visit2_DrawMeshesIndirect );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1555,6 +1740,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_CustomDraw,
 						VTaskProcessor::Visit2_CustomDraw );
+
+		_MoveTransientUsagesToPass( renderPass );
 	}
 	
 /*
@@ -1596,7 +1783,10 @@ namespace {
 
 		_rm.logicalRenderPassCount = Max( uint(index)+1, _rm.logicalRenderPassCount );
 
-		return LogicalPassID( index, 0 );
+		const LogicalPassID	result{ index, 0 };
+		_MoveTransientUsagesToPass( result );
+
+		return result;
 	}
 	
 /*
@@ -1724,7 +1914,10 @@ namespace {
 
 			if ( not image.IsDestroyed() )
 			{
-				image.Data().ResetState( index, barrierMngr, debugger );
+				// layout transition of the transient image may corrupt content of other transient resources in the same memory
+				if ( not image.Data().ToGlobal()->IsTransient() )
+					image.Data().ResetState( index, barrierMngr, debugger );
+
 				image.Destroy();
 				_rm.images.pool.Unassign( Index_t(i) );
 			}
@@ -1781,18 +1974,19 @@ namespace {
 	_ToLocal
 =================================================
 */
-	template <typename ID, typename Res, typename MainPool, size_t MC>
-	inline Res const*  VCommandBuffer::_ToLocal (ID id, INOUT LocalResPool<Res,MainPool,MC> &localRes, StringView msg)
+	template <typename ID, typename Res, typename MainPool, size_t CS>
+	inline Res const*  VCommandBuffer::_ToLocal (ID id, INOUT LocalResPool<Res,MainPool,CS> &localRes, StringView msg)
 	{
 		EXLOCK( _drCheck );
 		CHECK_ERR( _state == EState::Recording or _state == EState::Compiling );
 
-		if ( id.Index() >= localRes.toLocal.size() )
+		if ( id.Index() >= localRes.toLocal.capacity() )
 			return null;
 
-		Index_t&	local = localRes.toLocal[ id.Index() ];
+		bool		inserted;
+		Index_t&	local = localRes.toLocal.Emplace( id.Index(), Index_t(UMax), OUT inserted );
 
-		if ( local != UMax )
+		if ( local != Index_t(UMax) )
 		{
 			Res const*  result = &(localRes.pool[ local ].Data());
 			ASSERT( result->ToGlobal() );
@@ -1808,14 +2002,20 @@ namespace {
 		auto&	data = localRes.pool[ local ];
 		Replace( data );
 		
-		if ( not data.Create( res ) )
+		bool	created;
+		if constexpr( IsSameTypes< Res, VLocalImage > or IsSameTypes< Res, VLocalBuffer > )
+			created = data.Create( res, _mainAllocator );	// access records are allocated in '_mainAllocator'
+		else
+			created = data.Create( res );
+
+		if ( not created )
 		{
 			localRes.pool.Unassign( local );
+			local = Index_t(UMax);
 			RETURN_ERR( msg );
 		}
 
-		localRes.maxLocalIndex  = Max( uint(local)+1, localRes.maxLocalIndex );
-		localRes.maxGlobalIndex = Max( uint(id.Index())+1, localRes.maxGlobalIndex );
+		localRes.maxLocalIndex = Max( uint(local)+1, localRes.maxLocalIndex );
 
 		return &(data.Data());
 	}
@@ -1827,12 +2027,22 @@ namespace {
 */
 	VLocalBuffer const*  VCommandBuffer::ToLocal (RawBufferID id)
 	{
-		return _ToLocal( id, _rm.buffers, "failed when creating local buffer" );
+		auto*	result = _ToLocal( id, _rm.buffers, "failed when creating local buffer" );
+
+		if ( _transient.resources.size() and _IsRecording() )
+			_AddTransientUsage( id );
+
+		return result;
 	}
 
 	VLocalImage const*  VCommandBuffer::ToLocal (RawImageID id)
 	{
-		return _ToLocal( id, _rm.images, "failed when creating local image" );
+		auto*	result = _ToLocal( id, _rm.images, "failed when creating local image" );
+		
+		if ( _transient.resources.size() and _IsRecording() )
+			_AddTransientUsage( id );
+
+		return result;
 	}
 
 	VLocalRTGeometry const*  VCommandBuffer::ToLocal (RawRTGeometryID id)
@@ -1863,15 +2073,336 @@ namespace {
 */
 	void  VCommandBuffer::_ResetLocalRemaping ()
 	{
-		memset( _rm.images.toLocal.data(), ~0u, sizeof(Index_t)*_rm.images.maxGlobalIndex );
-		memset( _rm.buffers.toLocal.data(), ~0u, sizeof(Index_t)*_rm.buffers.maxGlobalIndex );
-		memset( _rm.rtScenes.toLocal.data(), ~0u, sizeof(Index_t)*_rm.rtScenes.maxGlobalIndex );
-		memset( _rm.rtGeometries.toLocal.data(), ~0u, sizeof(Index_t)*_rm.rtGeometries.maxGlobalIndex );
+		_rm.images.toLocal.Clear();
+		_rm.buffers.toLocal.Clear();
+		_rm.rtScenes.toLocal.Clear();
+		_rm.rtGeometries.toLocal.Clear();
+	}
+//-----------------------------------------------------------------------------
+
+
+/*
+=================================================
+	CreateDescriptorSet
+=================================================
+*/
+	VPipelineResources const*  VCommandBuffer::CreateDescriptorSet (const PipelineResources &desc)
+	{
+		// image view can not be created before memory binding
+		if ( _transient.resources.size() and _IsRecording() and _AddTransientUsages( desc ))
+			RETURN_ERR( "transient resources are supported only in task descriptor sets" );
+
+		return GetResourceManager().CreateDescriptorSet( desc, INOUT _resourceMap, INOUT EditStatistic().resources );
+	}
+	
+/*
+=================================================
+	CreateDescriptorSet
+----
+	descriptor set with transient resources will be created in '_BindTransientMemory'
+=================================================
+*/
+	void  VCommandBuffer::CreateDescriptorSet (const PipelineResources &desc, OUT VPipelineResources const* &result)
+	{
+		if ( _transient.resources.size() and _IsRecording() and _AddTransientUsages( desc ))
+		{
+			result = null;
+			_transient.descriptorSets.push_back({ PipelineResources{ desc }, &result });
+			return;
+		}
+
+		result = GetResourceManager().CreateDescriptorSet( desc, INOUT _resourceMap, INOUT EditStatistic().resources );
+	}
+
+/*
+=================================================
+	_AddTransientUsage
+=================================================
+*/
+	template <typename ID>
+	bool  VCommandBuffer::_AddTransientUsage (ID id)
+	{
+		const Resource_t	key{ id };
+
+		for (size_t i = 0; i < _transient.resources.size(); ++i)
+		{
+			if ( not (_transient.resources[i].id == key) )
+				continue;
+
+			auto&	pending = _transient.pending;
+
+			if ( std::find( pending.begin(), pending.end(), uint(i) ) == pending.end() )
+				pending.push_back( uint(i) );
+
+			return true;
+		}
+		return false;
+	}
+	
+/*
+=================================================
+	_AddTransientUsages
+=================================================
+*/
+	bool  VCommandBuffer::_AddTransientUsages (const PipelineResources &desc)
+	{
+		auto*	data	= PipelineResourcesHelper::GetData( desc );
+		bool	found	= false;
+
+		if ( not data )
+			return false;
+
+		data->ForEachUniform( [this, &found] (const UniformID &, const auto &un)
+		{
+			using T = std::remove_cv_t< std::remove_reference_t< decltype(un) >>;
+
+			if constexpr( IsSameTypes< T, PipelineResources::Buffer > or IsSameTypes< T, PipelineResources::TexelBuffer >)
+			{
+				for (uint i = 0; i < un.elementCount; ++i) {
+					found |= _AddTransientUsage( un.elements[i].bufferId );
+				}
+			}
+			else
+			if constexpr( IsSameTypes< T, PipelineResources::Image > or IsSameTypes< T, PipelineResources::Texture >)
+			{
+				for (uint i = 0; i < un.elementCount; ++i) {
+					found |= _AddTransientUsage( un.elements[i].imageId );
+				}
+			}
+		});
+		return found;
+	}
+	
+/*
+=================================================
+	_BindTransientMemory
+----
+	lifetime of transient resource is a range of execution order indices of tasks that use it,
+	resources with non-overlapping lifetime are placed into the same memory.
+=================================================
+*/
+	bool  VCommandBuffer::_BindTransientMemory ()
+	{
+		if ( _transient.resources.empty() )
+			return true;
+
+		struct Heap
+		{
+			uint			memTypeBits	= 0;
+			bool			forImage	= false;
+			BytesU			size;
+			BytesU			align;
+			VkDeviceMemory	mem			= VK_NULL_HANDLE;
+			BytesU			memOffset;
+		};
+
+		auto&			rm			= GetResourceManager();
+		VDevice const&	dev			= GetDevice();
+		auto&			res_arr		= _transient.resources;
+		Array<Heap>		heaps;
+		Array<uint>		order;
+		BytesU			total_size;
+		BytesU			heap_size;
+
+		const auto	IsImage = [] (const TransientResource &res) { return res.id.GetUID() == RawImageID::GetUID(); };
+
+		for (auto& usage : _transient.usages)
+		{
+			auto&				res	= res_arr[ usage.index ];
+			const ExeOrderIndex	idx	= usage.task->ExecutionOrder();
+
+			if ( idx < res.first )	res.first = idx;
+			if ( idx > res.last )	res.last  = idx;
+		}
+
+		// resource is used outside of tasks or in render pass that is not submitted,
+		// so it must be alive during whole command buffer execution
+		const auto	KeepAlive = [&res_arr] (uint index)
+		{
+			res_arr[index].first	= ExeOrderIndex::First;
+			res_arr[index].last		= ExeOrderIndex::Final;
+		};
+		for (uint index : _transient.pending)		{ KeepAlive( index ); }
+		for (auto& item : _transient.passUsages)	{ KeepAlive( item.second ); }
+
+		// group resources by memory type
+		for (size_t i = 0; i < res_arr.size(); ++i)
+		{
+			auto&	res = res_arr[i];
+
+			// unused resource has no memory
+			if ( res.first == ExeOrderIndex::Unknown )
+				continue;
+
+			VkMemoryRequirements	mem_req		= {};
+			const bool				is_image	= IsImage( res );
+
+			if ( is_image )
+				dev.vkGetImageMemoryRequirements( dev.GetVkDevice(), rm.GetResource( RawImageID{ res.id.Index(), res.id.InstanceID() })->Handle(), OUT &mem_req );
+			else
+				dev.vkGetBufferMemoryRequirements( dev.GetVkDevice(), rm.GetResource( RawBufferID{ res.id.Index(), res.id.InstanceID() })->Handle(), OUT &mem_req );
+
+			// images and buffers are placed in separate heaps to avoid 'bufferImageGranularity' conflicts
+			auto	iter = std::find_if( heaps.begin(), heaps.end(), [&] (auto& h) { return h.forImage == is_image and h.memTypeBits == mem_req.memoryTypeBits; });
+
+			if ( iter == heaps.end() )
+			{
+				iter = heaps.insert( heaps.end(), Heap{} );
+				iter->memTypeBits	= mem_req.memoryTypeBits;
+				iter->forImage		= is_image;
+			}
+
+			res.heap	= uint(std::distance( heaps.begin(), iter ));
+			res.align	= Max( BytesU{mem_req.alignment}, 1_b );
+			res.size	= AlignToLarger( BytesU{mem_req.size}, res.align );
+			iter->align	= Max( iter->align, res.align );
+			total_size += res.size;
+
+			order.push_back( uint(i) );
+		}
+
+		// place large resources first
+		std::sort( order.begin(), order.end(), [&res_arr] (uint lhs, uint rhs)
+		{
+			return res_arr[lhs].size != res_arr[rhs].size ? res_arr[lhs].size > res_arr[rhs].size : lhs < rhs;
+		});
+
+		const auto	IsAliased = [] (const TransientResource &lhs, const TransientResource &rhs)
+		{
+			return lhs.heap == rhs.heap and lhs.offset < rhs.offset + rhs.size and rhs.offset < lhs.offset + lhs.size;
+		};
+		const auto	IsAlive = [] (const TransientResource &lhs, const TransientResource &rhs)
+		{
+			return not (lhs.last < rhs.first or rhs.last < lhs.first);
+		};
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			auto&	res = res_arr[ order[i] ];
+
+			// move resource over all placed resources with overlapping lifetime
+			for (bool moved = true; moved;)
+			{
+				moved = false;
+				for (size_t j = 0; j < i; ++j)
+				{
+					auto&	other = res_arr[ order[j] ];
+
+					if ( IsAlive( res, other ) and IsAliased( res, other ))
+					{
+						res.offset	= AlignToLarger( other.offset + other.size, res.align );
+						moved		= true;
+					}
+				}
+			}
+
+			auto&	heap = heaps[ res.heap ];
+			heap.size = Max( heap.size, res.offset + res.size );
+		}
+
+		// allocate memory, heaps will be released after execution
+		for (auto& heap : heaps)
+		{
+			VkMemoryRequirements	mem_req = {};
+			mem_req.size			= VkDeviceSize( heap.size );
+			mem_req.alignment		= VkDeviceSize( heap.align );
+			mem_req.memoryTypeBits	= heap.memTypeBits;
+
+			RawMemoryID		mem_id = rm.CreateMemory( mem_req, MemoryDesc{}, "TransientHeap" );
+			CHECK_ERR( mem_id );
+			ReleaseResource( mem_id );
 
-		_rm.images.maxGlobalIndex		= 0;
-		_rm.buffers.maxGlobalIndex		= 0;
-		_rm.rtScenes.maxGlobalIndex		= 0;
-		_rm.rtGeometries.maxGlobalIndex	= 0;
+			VMemoryObj::MemoryInfo	info;
+			CHECK_ERR( rm.GetResource( mem_id )->GetInfo( rm.GetMemoryManager(), OUT info ));
+
+			heap.mem		= info.mem;
+			heap.memOffset	= info.offset;
+			heap_size	   += heap.size;
+		}
+
+		for (auto& res : res_arr)
+		{
+			if ( res.heap == UMax )
+				continue;
+
+			auto&				heap	= heaps[ res.heap ];
+			const VkDeviceSize	offset	= VkDeviceSize( heap.memOffset + res.offset );
+
+			if ( IsImage( res ))
+			{
+				VK_CHECK( dev.vkBindImageMemory( dev.GetVkDevice(), rm.GetResource( RawImageID{ res.id.Index(), res.id.InstanceID() })->Handle(), heap.mem, offset ));
+			}
+			else
+			{
+				VK_CHECK( dev.vkBindBufferMemory( dev.GetVkDevice(), rm.GetResource( RawBufferID{ res.id.Index(), res.id.InstanceID() })->Handle(), heap.mem, offset ));
+			}
+		}
+
+		// find tasks that use memory of previous resources
+		for (auto& res : res_arr)
+		{
+			if ( res.heap == UMax )
+				continue;
+
+			for (auto& other : res_arr)
+			{
+				if ( &other != &res and other.last < res.first and IsAliased( res, other ))
+				{
+					_transient.aliasingBarriers.push_back( res.first );
+					break;
+				}
+			}
+		}
+		std::sort( _transient.aliasingBarriers.begin(), _transient.aliasingBarriers.end() );
+		_transient.aliasingBarriers.erase( std::unique( _transient.aliasingBarriers.begin(), _transient.aliasingBarriers.end() ), _transient.aliasingBarriers.end() );
+
+		auto&	stat = EditStatistic().resources;
+		stat.transientMemorySize	+= total_size;
+		stat.transientMemorySaved	+= (total_size > heap_size ? total_size - heap_size : 0_b);
+
+		// image views can be created only after memory binding
+		for (auto& ds : _transient.descriptorSets)
+		{
+			*ds.result = rm.CreateDescriptorSet( ds.desc, INOUT _resourceMap, INOUT stat );
+			CHECK_ERR( *ds.result );
+		}
+		return true;
+	}
+	
+/*
+=================================================
+	_AddAliasingBarrier
+----
+	previous content of aliased memory is undefined,
+	but all previous accesses must be completed before memory reuse.
+=================================================
+*/
+	void  VCommandBuffer::_AddAliasingBarrier ()
+	{
+		VDevice const&				dev		= GetDevice();
+		const VkPipelineStageFlags	stages	= dev.GetAllWritableStages() | dev.GetAllReadableStages();
+		VkMemoryBarrier				barrier	= {};
+
+		barrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask	= VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask	= VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+		_barrierMngr.AddMemoryBarrier( stages, stages, barrier );
+	}
+	
+/*
+=================================================
+	_ResetTransientResources
+=================================================
+*/
+	void  VCommandBuffer::_ResetTransientResources ()
+	{
+		_transient.resources.clear();
+		_transient.pending.clear();
+		_transient.passUsages.clear();
+		_transient.usages.clear();
+		_transient.descriptorSets.clear();
+		_transient.aliasingBarriers.clear();
 	}
 //-----------------------------------------------------------------------------
 
@@ -1883,12 +2414,10 @@ namespace {
 */
 	bool  VCommandBuffer::_StorePartialData (ArrayView<uint8_t> srcData, const BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
 	{
-		// skip blocks less than 1/N of data size
-		const BytesU	src_size	= ArraySizeOf(srcData);
-		const BytesU	min_size	= Min( (src_size + MaxBufferParts-1) / MaxBufferParts, Min( src_size, MinBufferPart ));
+		const BytesU	src_size	= ArraySizeOf(srcData) - srcOffset;
 		void *			ptr			= null;
 
-		if ( _batch->GetWritable( src_size - srcOffset, 1_b, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
+		if ( _batch->GetWritable( src_size, 1_b, 16_b, src_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
 		{
 			MemCopy( ptr, size, srcData.data() + srcOffset, size );
 			return true;
@@ -1901,15 +2430,13 @@ namespace {
 	_StoreImageData
 =================================================
 */
-	bool  VCommandBuffer::_StoreImageData (ArrayView<uint8_t> srcData, const BytesU srcOffset, const BytesU srcPitch, const BytesU srcTotalSize,
+	bool  VCommandBuffer::_StoreImageData (ArrayView<uint8_t> srcData, const BytesU srcOffset, const BytesU srcPitch,
 										   OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
 	{
-		// skip blocks less than 1/N of total data size
-		const BytesU	src_size	= ArraySizeOf(srcData);
-		const BytesU	min_size	= Max( (srcTotalSize + MaxImageParts-1) / MaxImageParts, srcPitch );
+		const BytesU	src_size	= ArraySizeOf(srcData) - srcOffset;
 		void *			ptr			= null;
 
-		if ( _batch->GetWritable( src_size - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
+		if ( _batch->GetWritable( src_size, srcPitch, 16_b, AlignToSmaller( src_size, srcPitch ), OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
 		{
 			MemCopy( ptr, size, srcData.data() + srcOffset, size );
 			return true;
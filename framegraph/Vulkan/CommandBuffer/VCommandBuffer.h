@@ -3,6 +3,7 @@
 #pragma once
 
 #include "framegraph/Public/FrameGraph.h"
+#include "stl/Containers/SparseIndexMap.h"
 #include "VTaskGraph.h"
 #include "VBarrierManager.h"
 #include "VTaskProcessor.h"
@@ -29,7 +30,6 @@ namespace FG
 			Compiling,
 		};
 
-		using TempTaskArray_t	= std::vector< VTask, StdLinearAllocator<VTask> >;
 		using TaskGraph_t		= VTaskGraph< VTaskProcessor >;
 		using Allocator_t		= LinearAllocator<>;
 		using Statistic_t		= IFrameGraph::Statistics;
@@ -41,34 +41,58 @@ namespace FG
 		
 		static constexpr auto	MaxBufferParts	= VCmdBatch::MaxBufferParts;
 		static constexpr auto	MaxImageParts	= VCmdBatch::MaxImageParts;
-		static constexpr auto	MinBufferPart	= 4_Kb;
 
 		using PerQueueArray_t	= FixedArray< VCommandPool, 4 >;
+		using SecondaryPools_t	= FixedArray< FixedArray< VCommandPool, FG_MaxRecordingThreads >, 4 >;	// one pool per recording thread
 		
 		using Index_t			= VResourceManager::Index_t;
 		
 		template <typename T, size_t CS, size_t MC>
 		using PoolTmpl			= ChunkedIndexedPool< ResourceBase<T>, Index_t, CS, MC >;
 		
-		template <typename Res, typename MainPool, size_t MC>
+		template <typename Res, typename MainPool, size_t CS>
 		struct LocalResPool {
-			PoolTmpl< Res, MainPool::capacity()/MC, MC >		pool;
-			StaticArray< Index_t, MainPool::capacity() >		toLocal;
-			uint												maxLocalIndex	= 0;
-			uint												maxGlobalIndex	= uint(MainPool::capacity());
+			PoolTmpl< Res, CS, (MainPool::capacity() + CS-1) / CS >		pool;
+			SparseIndexMap< Index_t, Index_t, MainPool::capacity() >	toLocal;		// global index -> local index, cleared by generation
+			uint														maxLocalIndex	= 0;
 		};
 
-		using LocalImages_t			= LocalResPool< VLocalImage,		VResourceManager::ImagePool_t,		16 >;
-		using LocalBuffers_t		= LocalResPool< VLocalBuffer,		VResourceManager::BufferPool_t,		16 >;
-		using LocalRTScenes_t		= LocalResPool< VLocalRTScene,		VResourceManager::RTScenePool_t,	16 >;
-		using LocalRTGeometries_t	= LocalResPool< VLocalRTGeometry,	VResourceManager::RTGeometryPool_t,	16 >;
+		using LocalImages_t			= LocalResPool< VLocalImage,		VResourceManager::ImagePool_t,		1u<<9 >;
+		using LocalBuffers_t		= LocalResPool< VLocalBuffer,		VResourceManager::BufferPool_t,		1u<<9 >;
+		using LocalRTScenes_t		= LocalResPool< VLocalRTScene,		VResourceManager::RTScenePool_t,	1u<<6 >;
+		using LocalRTGeometries_t	= LocalResPool< VLocalRTGeometry,	VResourceManager::RTGeometryPool_t,	1u<<6 >;
 		using LogicalRenderPasses_t	= PoolTmpl< VLogicalRenderPass,		1u<<10,								16 >;
 		
+		struct TransientResource
+		{
+			Resource_t			id;
+			ExeOrderIndex		first		= ExeOrderIndex::Unknown;	// lifetime in tasks
+			ExeOrderIndex		last		= ExeOrderIndex::Initial;
+			uint				heap		= UMax;
+			BytesU				offset;									// in heap
+			BytesU				size;
+			BytesU				align;
+		};
+
+		struct TransientUsage
+		{
+			VTask				task;
+			uint				index;		// in 'resources'
+		};
+
+		struct DeferredDescriptorSet
+		{
+			PipelineResources				desc;
+			VPipelineResources const* *		result;
+		};
+
 
 
 	// variables
 	private:
 		Allocator_t				_mainAllocator;
+		ResourceMap_t			_resourceMap;			// allocated in '_mainAllocator'
+		uint					_lastResourceCount	= 0;	// used to reserve memory in '_resourceMap'
 		TaskGraph_t				_taskGraph;
 		EState					_state;
 		VCmdBatchPtr			_batch;
@@ -86,7 +110,6 @@ namespace FG
 		}						_shaderDbg;
 
 		struct {
-			ResourceMap_t			resourceMap;
 			LocalImages_t			images;
 			LocalBuffers_t			buffers;
 			LocalRTScenes_t			rtScenes;
@@ -95,10 +118,21 @@ namespace FG
 			uint					logicalRenderPassCount	= 0;
 		}						_rm;
 		
+		struct {
+			Array< TransientResource >		resources;
+			Array< uint >					pending;			// used by the task that is currently added
+			Array< Pair< Index_t, uint >>	passUsages;			// { logical pass, resource }, will be moved to the 'SubmitRenderPass' task
+			Array< TransientUsage >			usages;
+			Array< DeferredDescriptorSet >	descriptorSets;		// descriptor sets with transient resources are created after memory binding
+			Array< ExeOrderIndex >			aliasingBarriers;	// tasks that reuse memory of previous transient resources, sorted
+		}						_transient;
+
 		PerQueueArray_t			_perQueue;		// TODO: use global command pool manager to minimize memory usage
+		SecondaryPools_t		_secondaryPools;
 		DebugName_t				_dbgName;
 		bool					_dbgFullBarriers	= false;
 		bool					_dbgQueueSync		= false;
+		ECompilationFlags		_compilationFlags	= Default;
 
 		DataRaceCheck			_drCheck;
 
@@ -124,6 +158,11 @@ namespace FG
 		void		AcquireImage (RawImageID id, bool makeMutable, bool invalidate) override;
 		void		AcquireBuffer (RawBufferID id, bool makeMutable) override;
 
+		RawImageID	CreateTransientImage (const ImageDesc &desc, StringView dbgName) override;
+		RawBufferID	CreateTransientBuffer (const BufferDesc &desc, StringView dbgName) override;
+
+		BytesU		DefragmentMemory (BytesU maxBytesToMove) override;
+
 
 		// tasks //
 		Task		AddTask (const SubmitRenderPass &) override;
@@ -179,6 +218,9 @@ namespace FG
 		ND_ VLocalRTGeometry const*	ToLocal (RawRTGeometryID id);
 		ND_ VLocalRTScene const*	ToLocal (RawRTSceneID id);
 		ND_ VPipelineResources const* CreateDescriptorSet (const PipelineResources &desc);
+			void					CreateDescriptorSet (const PipelineResources &desc, OUT VPipelineResources const* &result);
+
+			void					OnTaskAdded (VTask task);
 
 		
 		ND_ StringView				GetName ()					const	{ EXLOCK( _drCheck );  return _dbgName; }
@@ -197,6 +239,9 @@ namespace FG
 		ND_ EQueueFamily			GetQueueFamily ()			const	{ EXLOCK( _drCheck );  return _queueIndex; }
 		ND_ bool					IsDebugFullBarriers ()		const	{ EXLOCK( _drCheck );  return _dbgFullBarriers; }
 		ND_ bool					IsDebugQueueSync ()			const	{ EXLOCK( _drCheck );  return _dbgQueueSync; }
+		ND_ ECompilationFlags		GetCompilationFlags ()		const	{ EXLOCK( _drCheck );  return _compilationFlags; }
+		ND_ uint					GetSecondaryPoolCount ()	const;
+		ND_ VCommandPool &			GetSecondaryPool (uint index);
 
 
 	private:
@@ -205,8 +250,7 @@ namespace FG
 		bool  _AllocStorage (size_t count, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset, OUT T* &ptr);
 		bool  _StoreData (const void *dataPtr, BytesU dataSize, BytesU offsetAlign, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset);
 		bool  _StorePartialData (ArrayView<uint8_t> srcData, BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
-		bool  _StoreImageData (ArrayView<uint8_t> srcData, BytesU srcOffset, BytesU srcPitch, BytesU srcTotalSize,
-							   OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
+		bool  _StoreImageData (ArrayView<uint8_t> srcData, BytesU srcOffset, BytesU srcPitch, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
 		
 		ND_ Task  _AddUpdateBufferTask (const UpdateBuffer &);
 		ND_ Task  _AddUpdateImageTask (const UpdateImage &);
@@ -216,18 +260,29 @@ namespace FG
 
 	// task processor //
 		bool  _BuildCommandBuffers ();
+		bool  _SortTasks (OUT ArrayView<VTask> &tasks);
 		bool  _ProcessTasks (VkCommandBuffer cmd);
 		void  _AfterCompilation ();
 		
 
 	// resource manager //
-		template <typename ID, typename Res, typename MainPool, size_t MC>
-		ND_ Res const*  _ToLocal (ID id, INOUT LocalResPool<Res,MainPool,MC> &, StringView msg);
+		template <typename ID, typename Res, typename MainPool, size_t CS>
+		ND_ Res const*  _ToLocal (ID id, INOUT LocalResPool<Res,MainPool,CS> &, StringView msg);
 
 		void  _FlushLocalResourceStates (ExeOrderIndex, VBarrierManager &, Ptr<VLocalDebugger>);
 		void  _ResetLocalRemaping ();
 
 
+	// transient resources //
+		template <typename ID>
+		bool  _AddTransientUsage (ID id);
+		bool  _AddTransientUsages (const PipelineResources &desc);
+		void  _MoveTransientUsagesToPass (LogicalPassID renderPass);
+		bool  _BindTransientMemory ();
+		void  _AddAliasingBarrier ();
+		void  _ResetTransientResources ();
+
+
 	// queue //
 		ND_ EQueueUsage	_GetQueueUsage ()	const	{ return EQueueUsage(0) | _batch->GetQueueType(); }
 		ND_ bool		_IsRecording ()		const	{ return _state == EState::Recording; }
@@ -242,7 +297,7 @@ namespace FG
 	template <uint UID>
 	inline auto const*  VCommandBuffer::AcquireTemporary (_fg_hidden_::ResourceID<UID> id)
 	{
-		auto[iter, inserted] = _rm.resourceMap.insert({ Resource_t{ id }, 1 });
+		auto[iter, inserted] = _resourceMap.insert({ Resource_t{ id }, 1 });
 
 		return _instance.GetResourceManager().GetResource( id, inserted );
 	}
@@ -255,17 +310,43 @@ namespace FG
 	template <uint UID>
 	inline void  VCommandBuffer::ReleaseResource (_fg_hidden_::ResourceID<UID> id)
 	{
-		_rm.resourceMap.insert({ Resource_t{ id }, 0 }).first->second++;
+		_resourceMap.insert({ Resource_t{ id }, 0 }).first->second++;
+	}
+	
+/*
+=================================================
+	OnTaskAdded
+----
+	attach transient resources that are used by the task
+=================================================
+*/
+	inline void  VCommandBuffer::OnTaskAdded (VTask task)
+	{
+		if ( _transient.pending.empty() )
+			return;
+
+		for (uint index : _transient.pending) {
+			_transient.usages.push_back({ task, index });
+		}
+		_transient.pending.clear();
 	}
 	
 /*
 =================================================
-	CreateDescriptorSet
+	_MoveTransientUsagesToPass
+----
+	draw tasks will be executed in 'SubmitRenderPass' task
 =================================================
 */
-	inline VPipelineResources const*  VCommandBuffer::CreateDescriptorSet (const PipelineResources &desc)
+	inline void  VCommandBuffer::_MoveTransientUsagesToPass (LogicalPassID renderPass)
 	{
-		return GetResourceManager().CreateDescriptorSet( desc, INOUT _rm.resourceMap );
+		if ( _transient.pending.empty() )
+			return;
+
+		for (uint index : _transient.pending) {
+			_transient.passUsages.emplace_back( renderPass.Index(), index );
+		}
+		_transient.pending.clear();
 	}
 
 
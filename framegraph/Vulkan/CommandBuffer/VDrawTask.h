@@ -86,6 +86,8 @@ namespace FG
 		const bool								primitiveRestart;
 
 		mutable VkDescriptorSets_t				descriptorSets;
+		mutable VkPipeline						pipelineHandle	= VK_NULL_HANDLE;	// resolved by 'VTaskProcessor' before recording
+		mutable VPipelineLayout const*			pipelineLayout	= null;
 		
 
 	// methods
@@ -195,6 +197,8 @@ namespace FG
 		const _fg_hidden_::DynamicStates		dynamicStates;
 
 		mutable VkDescriptorSets_t				descriptorSets;
+		mutable VkPipeline						pipelineHandle	= VK_NULL_HANDLE;	// resolved by 'VTaskProcessor' before recording
+		mutable VPipelineLayout const*			pipelineLayout	= null;
 
 
 	// methods
@@ -15,7 +15,8 @@ namespace FG
 	VSubmitted::VSubmitted (uint indexInPool) :
 		_indexInPool{ indexInPool },
 		_fence{ VK_NULL_HANDLE },
-		_queueType{ Default }
+		_queueType{ Default },
+		_refCount{ 0 }
 	{
 	}
 	
@@ -53,6 +54,44 @@ namespace FG
 		_batches	= batches;
 		_semaphores	= semaphores;
 		_queueType	= queue;
+		_refCount	= 1;
+	}
+
+/*
+=================================================
+	_AddSemaphore
+----
+	semaphore will be destroyed when batches complete
+=================================================
+*/
+	void  VSubmitted::_AddSemaphore (VkSemaphore sem)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _semaphores.size() < _semaphores.capacity(), void());
+
+		_semaphores.push_back( sem );
+	}
+
+/*
+=================================================
+	_AddRef / _ReleaseRef
+----
+	submitted batches are referenced by the queue and by 'Wait',
+	returns 'true' if object can be returned to the pool
+=================================================
+*/
+	void  VSubmitted::_AddRef ()
+	{
+		EXLOCK( _drCheck );
+		ASSERT( _refCount > 0 );
+		++_refCount;
+	}
+
+	bool  VSubmitted::_ReleaseRef ()
+	{
+		EXLOCK( _drCheck );
+		ASSERT( _refCount > 0 );
+		return --_refCount == 0;
 	}
 
 /*
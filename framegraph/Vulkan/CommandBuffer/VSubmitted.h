@@ -32,6 +32,7 @@ namespace FG
 		Semaphores_t		_semaphores;
 		VkFence				_fence;
 		EQueueType			_queueType;
+		uint				_refCount;		// protected by queue guard
 
 		DataRaceCheck		_drCheck;
 
@@ -48,6 +49,9 @@ namespace FG
 
 	private:
 		void  _Initialize (const VDevice &, EQueueType queue, ArrayView<VCmdBatchPtr>, ArrayView<VkSemaphore>);
+		void  _AddSemaphore (VkSemaphore);
+		void  _AddRef ();
+		ND_ bool  _ReleaseRef ();
 		void  _Release (const VDevice &, VDebugger &, const IFrameGraph::ShaderDebugCallback_t &, INOUT Statistic_t &);
 		void  _Destroy (const VDevice &);
 	};
@@ -30,11 +30,13 @@ namespace FG
 	// variables
 	protected:
 		ProcessFunc_t		_processFunc	= null;
+		ProcessFunc_t		_barriersFunc	= null;		// only for tasks that supports barrier batching
 		Dependencies_t		_inputs;
 		Dependencies_t		_outputs;
 		Name_t				_taskName;
 		RGBA8u				_debugColor;
 		uint				_visitorID		= 0;
+		uint				_pendingInputs	= 0;	// number of input tasks that are not processed yet
 		ExeOrderIndex		_exeOrderIdx	= ExeOrderIndex::Initial;
 
 
@@ -50,6 +52,7 @@ namespace FG
 			_debugColor{ task.debugColor }
 		{
 			_inputs.resize( task.depends.size() );
+			_pendingInputs = uint(_inputs.size());
 
 			for (size_t i = 0; i < task.depends.size(); ++i) {
 				_inputs[i] = Cast<VFrameGraphTask>( task.depends[i] );
@@ -68,7 +71,9 @@ namespace FG
 		ND_ StringView			Name ()				const	{ return _taskName; }
 		ND_ RGBA8u				DebugColor ()		const	{ return _debugColor; }
 		ND_ uint				VisitorID ()		const	{ return _visitorID; }
+		ND_ uint				PendingInputs ()	const	{ return _pendingInputs; }
 		ND_ ExeOrderIndex		ExecutionOrder ()	const	{ return _exeOrderIdx; }
+		ND_ bool				CanBatchBarriers ()	const	{ return _barriersFunc != null; }
 
 		ND_ ArrayView< VTask >	Inputs ()			const	{ return _inputs; }
 		ND_ ArrayView< VTask >	Outputs ()			const	{ return _outputs; }
@@ -76,8 +81,11 @@ namespace FG
 			void Attach (VTask output)						{ _outputs.push_back( output ); }
 			void SetVisitorID (uint id)						{ _visitorID = id; }
 			void SetExecutionOrder (ExeOrderIndex idx)		{ _exeOrderIdx = idx; }
+			void OnInputProcessed ()						{ ASSERT( _pendingInputs > 0 );  --_pendingInputs; }
+			void SetBarriersFunc (ProcessFunc_t fn)			{ _barriersFunc = fn; }
 
 			void Process (void *visitor)			const	{ ASSERT( _processFunc );  _processFunc( visitor, this ); }
+			void ProcessBarriers (void *visitor)	const	{ ASSERT( _barriersFunc );  _barriersFunc( visitor, this ); }
 	};
 
 
@@ -715,6 +723,7 @@ namespace FG
 	private:
 		InPlace<SearchableNodes_t>	_nodes;
 		InPlace<Entries_t>			_entries;
+		size_t						_edgeCount	= 0;
 
 
 	// methods
@@ -728,8 +737,15 @@ namespace FG
 		void OnStart (LinearAllocator<> &);
 		void OnDiscardMemory ();
 
+		template <typename FN>
+		ND_ size_t  Traverse (LinearAllocator<> &alloc, FN &&fn) const;
+
+		template <typename FN>
+		ND_ static size_t  Traverse (ArrayView<VTask> entries, size_t edgeCount, LinearAllocator<> &alloc, FN &&fn);
+
 		ND_ ArrayView<VTask>	Entries ()		const	{ return *_entries; }
 		ND_ size_t				Count ()		const	{ return _nodes->size(); }
+		ND_ size_t				EdgeCount ()	const	{ return _edgeCount; }
 		ND_ bool				Empty ()		const	{ return _nodes->empty(); }
 
 
@@ -739,6 +755,12 @@ namespace FG
 		{
 			static_cast< VisitorT *>(p)->Visit( *static_cast< VFgTask<T> const *>(task) );
 		}
+
+		template <typename T>
+		static void _BarriersVisitor (void *p, const void *task)
+		{
+			static_cast< VisitorT *>(p)->VisitBarriers( *static_cast< VFgTask<T> const *>(task) );
+		}
 	};
 
 
@@ -772,6 +794,7 @@ namespace FG
 		_nodes.Create( alloc );
 		_entries.Create( alloc );
 		_entries->reserve( 64 );
+		_edgeCount = 0;
 	}
 	
 /*
@@ -784,6 +807,69 @@ namespace FG
 	{
 		_nodes.Destroy();
 		_entries.Destroy();
+		_edgeCount = 0;
+	}
+	
+/*
+=================================================
+	Traverse
+=================================================
+*/
+	template <typename VisitorT>
+	template <typename FN>
+	inline size_t  VTaskGraph<VisitorT>::Traverse (LinearAllocator<> &alloc, FN &&fn) const
+	{
+		return Traverse( *_entries, _edgeCount, alloc, std::forward<FN>(fn) );
+	}
+	
+/*
+=================================================
+	Traverse
+----
+	Visits each task exactly once, after all of its inputs.
+	Every processed task pushes its outputs to the queue, so a task may be queued
+	several times, but it is visited only when all inputs are processed.
+	Tasks are visited in discovery order, complexity is O(tasks + dependencies).
+	Returns number of visited tasks.
+=================================================
+*/
+	template <typename VisitorT>
+	template <typename FN>
+	inline size_t  VTaskGraph<VisitorT>::Traverse (ArrayView<VTask> entries, size_t edgeCount, LinearAllocator<> &alloc, FN &&fn)
+	{
+		static constexpr uint	visitor_id	= 1;
+
+		const size_t	capacity	= entries.size() + edgeCount;
+		VTask *			queue		= alloc.Alloc<VTask>( capacity );
+		size_t			count		= 0;
+		size_t			visited		= 0;
+
+		for (auto node : entries) {
+			PlacementNew<VTask>( OUT queue + (count++), node );
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			VTask	node = queue[i];
+			
+			// skip already processed task or task that waits for input
+			if ( node->VisitorID() == visitor_id or node->PendingInputs() > 0 )
+				continue;
+
+			node->SetVisitorID( visitor_id );
+			++visited;
+
+			fn( node );
+
+			for (auto out_node : node->Outputs())
+			{
+				out_node->OnInputProcessed();
+
+				ASSERT( count < capacity );
+				PlacementNew<VTask>( OUT queue + (count++), out_node );
+			}
+		}
+		return visited;
 	}
 
 
@@ -17,12 +17,18 @@ namespace FG
 	template <typename T>
 	inline VFgTask<T>*  VTaskGraph<VisitorT>::Add (VCommandBuffer &cb, const T &task)
 	{
+		FG_TRACE_SCOPE( task.taskName, "AddTask" );
+
 		auto*	ptr  = cb.GetAllocator().Alloc< VFgTask<T> >();
 
 		PlacementNew< VFgTask<T> >( OUT ptr, cb, task, &_Visitor<T> );
 		CHECK_ERR( ptr->IsValid() );
 
+		if constexpr ( VisitorT::BatchableTasks_t::template HasType<T> )
+			ptr->SetBarriersFunc( &_BarriersVisitor<T> );
+
 		_nodes->insert( ptr );
+		cb.OnTaskAdded( ptr );
 
 		if ( ptr->Inputs().empty() )
 			_entries->push_back( ptr );
@@ -33,6 +39,8 @@ namespace FG
 
 			in_node->Attach( ptr );
 		}
+		_edgeCount += ptr->Inputs().size();
+
 		return ptr;
 	}
 //-----------------------------------------------------------------------------
@@ -77,8 +85,9 @@ namespace FG
 		{
 			auto	offsets = src.second->GetDynamicOffsets();
 
-			outResourceSet.resources.emplace_back( src.first, cb.CreateDescriptorSet( *src.second ),
-												   offset_count, CheckCast<uint>(offsets.size()) );
+			auto&	item	= outResourceSet.resources.emplace_back( src.first, null, offset_count, CheckCast<uint>(offsets.size()) );
+
+			cb.CreateDescriptorSet( *src.second, OUT item.pplnRes );
 			
 			for (size_t i = 0; i < offsets.size(); ++i, ++offset_count) {
 				outResourceSet.dynamicOffsets.push_back( offsets[i] );
@@ -32,7 +32,7 @@ namespace FG
 
 	inline VTaskProcessor::Statistic_t&  VTaskProcessor::Stat () const
 	{
-		return _fgThread.EditStatistic().renderer;
+		return _secondaryStat ? _secondaryStat->renderer : _fgThread.EditStatistic().renderer;
 	}
 //-----------------------------------------------------------------------------
 
@@ -131,11 +131,12 @@ namespace FG
 		VTaskProcessor &					_tp;
 		VFgTask<SubmitRenderPass> const*	_currTask;
 		VkCommandBuffer						_cmdBuffer;
+		const bool							_resolvePipelines;		// only create pipelines, see '_RecordDrawTasksParallel'
 
 
 	// methods
 	public:
-		DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd);
+		DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd, bool resolvePipelines = false);
 
 		void  Visit (const VFgDrawTask<FG::DrawVertices> &task);
 		void  Visit (const VFgDrawTask<FG::DrawIndexed> &task);
@@ -586,8 +587,8 @@ namespace FG
 	constructor
 =================================================
 */
-	VTaskProcessor::DrawTaskCommands::DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd) :
-		_tp{ tp },	_currTask{ task },	_cmdBuffer{ cmd }
+	VTaskProcessor::DrawTaskCommands::DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd, bool resolvePipelines) :
+		_tp{ tp },	_currTask{ task },	_cmdBuffer{ cmd },	_resolvePipelines{ resolvePipelines }
 	{
 	}
 
@@ -651,11 +652,14 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawVertices> &task)
 	{
+		if ( _resolvePipelines )
+			return _tp._ResolvePipeline( *_currTask->GetLogicalPass(), task );
+
 		//_tp._CmdDebugMarker( task.GetName() );
 
 		VPipelineLayout const*	layout = null;
 
-		_tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout );
+		CHECK_ERR( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ), void());
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 
@@ -677,11 +681,14 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawIndexed> &task)
 	{
+		if ( _resolvePipelines )
+			return _tp._ResolvePipeline( *_currTask->GetLogicalPass(), task );
+
 		//_tp._CmdDebugMarker( task.GetName() );
 		
 		VPipelineLayout const*	layout = null;
 
-		_tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout );
+		CHECK_ERR( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ), void());
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 
@@ -705,11 +712,14 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawVerticesIndirect> &task)
 	{
+		if ( _resolvePipelines )
+			return _tp._ResolvePipeline( *_currTask->GetLogicalPass(), task );
+
 		//_tp._CmdDebugMarker( task.GetName() );
 		
 		VPipelineLayout const*	layout = null;
 
-		_tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout );
+		CHECK_ERR( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ), void());
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 
@@ -735,11 +745,14 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawIndexedIndirect> &task)
 	{
+		if ( _resolvePipelines )
+			return _tp._ResolvePipeline( *_currTask->GetLogicalPass(), task );
+
 		//_tp._CmdDebugMarker( task.GetName() );
 		
 		VPipelineLayout const*	layout = null;
 
-		_tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout );
+		CHECK_ERR( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ), void());
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 
@@ -766,11 +779,14 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawMeshes> &task)
 	{
+		if ( _resolvePipelines )
+			return _tp._ResolvePipeline( *_currTask->GetLogicalPass(), task );
+
 		//_tp._CmdDebugMarker( task.GetName() );
 		
 		VPipelineLayout const*	layout = null;
 
-		_tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout );
+		CHECK_ERR( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ), void());
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 		
@@ -791,11 +807,14 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawMeshesIndirect> &task)
 	{
+		if ( _resolvePipelines )
+			return _tp._ResolvePipeline( *_currTask->GetLogicalPass(), task );
+
 		//_tp._CmdDebugMarker( task.GetName() );
 		
 		VPipelineLayout const*	layout = null;
 
-		_tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout );
+		CHECK_ERR( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ), void());
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 		
@@ -820,6 +839,8 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::CustomDraw> &task)
 	{
+		ASSERT( not _resolvePipelines );
+
 		DrawContext	ctx{ _tp, *_currTask->GetLogicalPass() };
 
 		task.callback( ctx );
@@ -1312,7 +1333,8 @@ namespace FG
 		_fgThread{ fgThread },
 		_cmdBuffer{ cmd },				_enableDebugUtils{ _fgThread.GetDevice().IsDebugUtilsEnabled() },
 		_isDefaultScissor{ false },		_perPassStatesUpdated{ false },
-		_pendingResourceBarriers{ fgThread.GetAllocator() }
+		_pendingResourceBarriers{ fgThread.GetAllocator() },
+		_barrierGroup{ fgThread.GetAllocator() }
 	{
 		ASSERT( _cmdBuffer );
 		
@@ -1321,6 +1343,19 @@ namespace FG
 		//_CmdPushDebugGroup( "SubBatch: "s << batchId.GetName() << ", index: " << ToString(indexInBatch) );
 	}
 	
+	VTaskProcessor::VTaskProcessor (VCommandBuffer &fgThread, VkCommandBuffer secondaryCmd, FullStatistic_t &stat) :
+		_fgThread{ fgThread },
+		_cmdBuffer{ secondaryCmd },		_enableDebugUtils{ false },
+		_isDefaultScissor{ false },		_perPassStatesUpdated{ false },
+		_pendingResourceBarriers{ fgThread.GetAllocator() },
+		_barrierGroup{ fgThread.GetAllocator() },
+		_secondaryStat{ &stat }
+	{
+		ASSERT( _cmdBuffer );
+		
+		VulkanDeviceFn_Init( _fgThread.GetDevice() );
+	}
+	
 /*
 =================================================
 	destructor
@@ -1675,7 +1710,7 @@ namespace FG
 	_BeginRenderPass
 =================================================
 */
-	void  VTaskProcessor::_BeginRenderPass (const VFgTask<SubmitRenderPass> &task)
+	void  VTaskProcessor::_BeginRenderPass (const VFgTask<SubmitRenderPass> &task, VkSubpassContents contents)
 	{
 		ASSERT( not task.IsSubpass() );
 
@@ -1737,7 +1772,7 @@ namespace FG
 		pass_info.pClearValues				= task.GetLogicalPass()->GetClearValues().data();
 		pass_info.framebuffer				= framebuffer->Handle();
 		
-		vkCmdBeginRenderPass( _cmdBuffer, &pass_info, VK_SUBPASS_CONTENTS_INLINE );
+		vkCmdBeginRenderPass( _cmdBuffer, &pass_info, contents );
 
 		_BindShadingRateImage( sri_view );
 	}
@@ -1747,13 +1782,13 @@ namespace FG
 	_BeginSubpass
 =================================================
 */
-	void  VTaskProcessor::_BeginSubpass (const VFgTask<SubmitRenderPass> &task)
+	void  VTaskProcessor::_BeginSubpass (const VFgTask<SubmitRenderPass> &task, VkSubpassContents contents)
 	{
 		ASSERT( task.IsSubpass() );
 
 		// TODO: barriers for attachments
 
-		vkCmdNextSubpass( _cmdBuffer, VK_SUBPASS_CONTENTS_INLINE );
+		vkCmdNextSubpass( _cmdBuffer, contents );
 		/*
 		// TODO
 		vkCmdClearAttachments( _cmdBuffer,
@@ -1776,26 +1811,36 @@ namespace FG
 		// invalidate some states
 		_isDefaultScissor		= false;
 		_perPassStatesUpdated	= false;
+		
+		const uint				range_count	= _GetDrawRangeCount( *task.GetLogicalPass() );
+		const VkSubpassContents	contents	= (range_count > 1 ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 
 		if ( not task.IsSubpass() )
 		{
 			_CmdPushDebugGroup( task.Name() );
-			_BeginRenderPass( task );
+			_BeginRenderPass( task, contents );
 		}
 		else
 		{
 			_CmdPopDebugGroup();
 			_CmdPushDebugGroup( task.Name() );
-			_BeginSubpass( task );
+			_BeginSubpass( task, contents );
 		}
 
 
 		// draw
-		DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
-		
-		for (auto& draw : task.GetLogicalPass()->GetDrawTasks())
+		if ( range_count > 1 )
+		{
+			_RecordDrawTasksParallel( task, range_count );
+		}
+		else
 		{
-			draw->Process2( &command_builder );
+			DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
+		
+			for (auto& draw : task.GetLogicalPass()->GetDrawTasks())
+			{
+				draw->Process2( &command_builder );
+			}
 		}
 
 		// end render pass
@@ -1806,6 +1851,152 @@ namespace FG
 		}
 	}
 	
+/*
+=================================================
+	_GetDrawRangeCount
+----
+	returns number of secondary command buffers for draw tasks,
+	0 or 1 means that draw tasks will be recorded into the primary command buffer.
+=================================================
+*/
+	uint  VTaskProcessor::_GetDrawRangeCount (const VLogicalRenderPass &logicalRP) const
+	{
+		if ( not EnumEq( _fgThread.GetCompilationFlags(), ECompilationFlags::ParallelRenderPass ) or
+			 logicalRP.HasCustomDraw() )	// custom draw context uses command buffer which is not thread safe
+			return 1;
+
+		auto	draw_tasks = logicalRP.GetDrawTasks();
+
+		for (auto* draw : draw_tasks)
+		{
+			// shader debugger requires access to the command batch
+			if ( draw->debugModeIndex != Default )
+				return 1;
+		}
+
+		return Min( _fgThread.GetSecondaryPoolCount(), uint(draw_tasks.size() / FG_MinDrawTasksPerThread) );
+	}
+	
+/*
+=================================================
+	_RecordDrawTasksParallel
+----
+	barriers are already commited and render pass is started with secondary command buffers contents,
+	draw tasks are splitted into ranges and each range is recorded on a separate thread.
+=================================================
+*/
+	void  VTaskProcessor::_RecordDrawTasksParallel (const VFgTask<SubmitRenderPass> &task, const uint rangeCount)
+	{
+		ASSERT( rangeCount > 1 and rangeCount <= FG_MaxRecordingThreads );
+
+		VLogicalRenderPass const&	logical_rp	= *task.GetLogicalPass();
+		ArrayView<IDrawTask *>		draw_tasks	= logical_rp.GetDrawTasks();
+		VFramebuffer const*			framebuffer	= _GetResource( logical_rp.GetFramebufferID() );
+		VRenderPass const*			render_pass	= _GetResource( logical_rp.GetRenderPassID() );
+		VDevice const&				dev			= _fgThread.GetDevice();
+
+		// pipeline cache is not thread safe, so create all pipelines here
+		{
+			DrawTaskCommands	resolver{ *this, &task, _cmdBuffer, true };
+
+			for (auto& draw : draw_tasks)
+			{
+				draw->Process2( &resolver );
+			}
+		}
+
+		// allocate secondary command buffers, each thread uses its own command pool
+		FixedArray< VkCommandBuffer, FG_MaxRecordingThreads >	cmd_buffers;
+		FixedArray< FullStatistic_t, FG_MaxRecordingThreads >	statistics;
+		FixedArray< VTaskProcessor, FG_MaxRecordingThreads >	processors;
+
+		for (uint i = 0; i < rangeCount; ++i)
+		{
+			VCommandPool&	pool	= _fgThread.GetSecondaryPool( i );
+			VkCommandBuffer	cmd		= pool.AllocSecondary( dev );
+			CHECK_ERR( cmd, void());
+
+			_fgThread.GetBatch().AddSecondaryCommandBuffer( cmd, &pool );
+			cmd_buffers.push_back( cmd );
+		}
+
+		statistics.resize( cmd_buffers.size() );
+
+		for (size_t i = 0; i < cmd_buffers.size(); ++i)
+		{
+			processors.emplace_back( _fgThread, cmd_buffers[i], statistics[i] );
+		}
+
+		VkCommandBufferInheritanceInfo	inheritance = {};
+		inheritance.sType		= VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritance.renderPass	= render_pass->Handle();
+		inheritance.subpass		= logical_rp.GetSubpassIndex();
+		inheritance.framebuffer	= framebuffer->Handle();
+
+		VkCommandBufferBeginInfo	begin_info = {};
+		begin_info.sType			= VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		begin_info.flags			= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		begin_info.pInheritanceInfo	= &inheritance;
+
+		const size_t	per_range	= (draw_tasks.size() + processors.size() - 1) / processors.size();
+		const auto		Record		= [&] (size_t index)
+		{
+			VTaskProcessor&		tp		= processors[index];
+			const size_t		first	= index * per_range;
+			const size_t		last	= Min( first + per_range, draw_tasks.size() );
+			DrawTaskCommands	command_builder{ tp, &task, tp._cmdBuffer };
+
+			VK_CALL( tp.vkBeginCommandBuffer( tp._cmdBuffer, &begin_info ));
+
+			// dynamic states are not inherited by secondary command buffers
+			tp._BindShadingRateImage( _shadingRateImage );
+
+			for (size_t i = first; i < last; ++i)
+			{
+				draw_tasks[i]->Process2( &command_builder );
+			}
+
+			VK_CALL( tp.vkEndCommandBuffer( tp._cmdBuffer ));
+		};
+
+		// first range is recorded in the current thread, pending jobs are executed here too
+		JobSystem&	jobs = _fgThread.GetInstance().GetRecordingJobs();
+		JobCounter	counter;
+
+		for (size_t i = 1; i < processors.size(); ++i)
+		{
+			jobs.Run( [&Record, i] () { Record( i ); }, &counter );
+		}
+
+		Record( 0 );
+		jobs.Wait( counter );
+
+		vkCmdExecuteCommands( _cmdBuffer, uint(cmd_buffers.size()), cmd_buffers.data() );
+		
+		for (auto& stat : statistics) {
+			_fgThread.EditStatistic().Merge( stat );
+		}
+
+		// states in primary command buffer are undefined after 'vkCmdExecuteCommands'
+		_ResetDrawContext();
+	}
+	
+/*
+=================================================
+	_ResetDrawContext
+=================================================
+*/
+	void  VTaskProcessor::_ResetDrawContext ()
+	{
+		_isDefaultScissor		= false;
+		_perPassStatesUpdated	= false;
+
+		_graphicsPipeline		= PipelineState{};
+		_indexBuffer			= VK_NULL_HANDLE;
+		_indexBufferOffset		= UMax;
+		_indexType				= VK_INDEX_TYPE_MAX_ENUM;
+	}
+
 /*
 =================================================
 	_ExtractDescriptorSets
@@ -1851,6 +2042,28 @@ namespace FG
 		}
 	}
 	
+/*
+=================================================
+	_AddPipelineResources
+----
+	same as '_ExtractDescriptorSets' but without descriptor sets and dynamic offsets reordering.
+=================================================
+*/
+	void  VTaskProcessor::_AddPipelineResources (const VPipelineLayout &layout, const VPipelineResourceSet &resourceSet)
+	{
+		for (auto& res : resourceSet.resources)
+		{
+			uint						binding	 = 0;
+			RawDescriptorSetLayoutID	ds_layout;
+
+			if ( not layout.GetDescriptorSetLayout( res.descSetId, OUT ds_layout, OUT binding ))
+				continue;
+
+			PipelineResourceBarriers	visitor{ *this, resourceSet.dynamicOffsets };
+			res.pplnRes->ForEachUniform( visitor );
+		}
+	}
+
 /*
 =================================================
 	_BindPipelineResources
@@ -2006,10 +2219,10 @@ namespace FG
 
 /*
 =================================================
-	_BindPipeline
+	_ResolvePipeline
 =================================================
 */
-	inline void  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, VPipelineLayout const* &pplnLayout)
+	void  VTaskProcessor::_ResolvePipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task)
 	{
 		RenderState				render_state;
 		EPipelineDynamicState	dynamic_states = EPipelineDynamicState::Viewport | EPipelineDynamicState::Scissor;
@@ -2028,7 +2241,9 @@ namespace FG
 									INOUT render_state.rasterization, INOUT dynamic_states, task.dynamicStates );
 		SetupExtensions( logicalRP, INOUT dynamic_states );
 
-		VkPipeline	ppln_id;
+		task.pipelineHandle	= VK_NULL_HANDLE;
+		task.pipelineLayout	= null;
+
 		_fgThread.GetPipelineCache().CreatePipelineInstance(
 										_fgThread,
 										logicalRP,
@@ -2037,17 +2252,15 @@ namespace FG
 										render_state,
 										dynamic_states,
 										task.debugModeIndex,
-										OUT ppln_id, OUT pplnLayout );
-
-		_BindPipeline2( logicalRP, ppln_id );
+										OUT task.pipelineHandle, OUT task.pipelineLayout );
 	}
 	
 /*
 =================================================
-	_BindPipeline
+	_ResolvePipeline
 =================================================
 */
-	inline void  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, VPipelineLayout const* &pplnLayout)
+	void  VTaskProcessor::_ResolvePipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task)
 	{
 		RenderState				render_state;
 		EPipelineDynamicState	dynamic_states = EPipelineDynamicState::Viewport | EPipelineDynamicState::Scissor;
@@ -2062,8 +2275,10 @@ namespace FG
 		OverrideDepthStencilStates( INOUT render_state.depth, INOUT render_state.stencil,
 									INOUT render_state.rasterization, INOUT dynamic_states, task.dynamicStates );
 		SetupExtensions( logicalRP, INOUT dynamic_states );
+		
+		task.pipelineHandle	= VK_NULL_HANDLE;
+		task.pipelineLayout	= null;
 
-		VkPipeline	ppln_id;
 		_fgThread.GetPipelineCache().CreatePipelineInstance(
 										_fgThread,
 										logicalRP,
@@ -2071,9 +2286,49 @@ namespace FG
 										render_state,
 										dynamic_states,
 										task.debugModeIndex,
-										OUT ppln_id, OUT pplnLayout );
-		
-		_BindPipeline2( logicalRP, ppln_id );
+										OUT task.pipelineHandle, OUT task.pipelineLayout );
+	}
+
+/*
+=================================================
+	_BindPipeline
+=================================================
+*/
+	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, VPipelineLayout const* &pplnLayout)
+	{
+		if ( not task.pipelineHandle )
+		{
+			// pipeline cache is not thread safe
+			CHECK_ERR( not _secondaryStat );
+			_ResolvePipeline( logicalRP, task );
+		}
+
+		pplnLayout = task.pipelineLayout;
+		CHECK_ERR( task.pipelineHandle and pplnLayout );
+
+		_BindPipeline2( logicalRP, task.pipelineHandle );
+		return true;
+	}
+	
+/*
+=================================================
+	_BindPipeline
+=================================================
+*/
+	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, VPipelineLayout const* &pplnLayout)
+	{
+		if ( not task.pipelineHandle )
+		{
+			// pipeline cache is not thread safe
+			CHECK_ERR( not _secondaryStat );
+			_ResolvePipeline( logicalRP, task );
+		}
+
+		pplnLayout = task.pipelineLayout;
+		CHECK_ERR( task.pipelineHandle and pplnLayout );
+
+		_BindPipeline2( logicalRP, task.pipelineHandle );
+		return true;
 	}
 
 /*
@@ -2646,6 +2901,161 @@ namespace FG
 		Stat().transferOps += uint(task.Regions().size());
 	}
 
+/*
+=================================================
+	ToVkSubresourceLayers
+=================================================
+*/
+	ND_ static VkImageSubresourceLayers  ToVkSubresourceLayers (const ImageSubresourceRange &src, const VLocalImage *image)
+	{
+		return { VEnumCast( src.aspectMask, image->PixelFormat() ), src.mipLevel.Get(), src.baseLayer.Get(), src.layerCount };
+	}
+	
+/*
+=================================================
+	ToVkBufferImageCopy
+=================================================
+*/
+	template <typename Region>
+	ND_ static VkBufferImageCopy  ToVkBufferImageCopy (const Region &src, const VLocalImage *image)
+	{
+		const int3			img_offset	= int3(src.imageOffset);
+		const uint3			img_size	= Max( src.imageSize, 1u );
+		VkBufferImageCopy	dst;
+
+		dst.bufferOffset		= VkDeviceSize( src.bufferOffset );
+		dst.bufferRowLength		= src.bufferRowLength;
+		dst.bufferImageHeight	= src.bufferImageHeight;
+		dst.imageSubresource	= ToVkSubresourceLayers( src.imageLayers, image );
+		dst.imageOffset			= VkOffset3D{ img_offset.x, img_offset.y, img_offset.z };
+		dst.imageExtent			= VkExtent3D{ img_size.x, img_size.y, img_size.z };
+		return dst;
+	}
+
+/*
+=================================================
+	VisitBarriers
+----
+	Adds resource states of the task without recording any commands,
+	same states will be added by 'Visit' when barriers are not batched.
+=================================================
+*/
+	void  VTaskProcessor::VisitBarriers (const VFgTask<DispatchCompute> &task)
+	{
+		_AddPipelineResources( *_GetResource( task.pipeline->GetLayoutID() ), task.GetResources() );
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<DispatchComputeIndirect> &task)
+	{
+		_AddPipelineResources( *_GetResource( task.pipeline->GetLayoutID() ), task.GetResources() );
+		
+		for (auto& cmd : task.commands)
+		{
+			_AddBuffer( task.indirectBuffer, EResourceState::IndirectBuffer, VkDeviceSize(cmd.indirectBufferOffset),
+						sizeof(DispatchComputeIndirect::DispatchIndirectCommand) );
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<CopyBuffer> &task)
+	{
+		for (auto& reg : task.regions)
+		{
+			_AddBuffer( task.srcBuffer, EResourceState::TransferSrc, VkDeviceSize(reg.srcOffset), VkDeviceSize(reg.size) );
+			_AddBuffer( task.dstBuffer, EResourceState::TransferDst, VkDeviceSize(reg.dstOffset), VkDeviceSize(reg.size) );
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<CopyImage> &task)
+	{
+		for (auto& reg : task.regions)
+		{
+			_AddImage( task.srcImage, EResourceState::TransferSrc, task.srcLayout, ToVkSubresourceLayers( reg.srcSubresource, task.srcImage ));
+			_AddImage( task.dstImage, EResourceState::TransferDst, task.dstLayout, ToVkSubresourceLayers( reg.dstSubresource, task.dstImage ));
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<CopyBufferToImage> &task)
+	{
+		for (auto& reg : task.regions)
+		{
+			const VkBufferImageCopy		region = ToVkBufferImageCopy( reg, task.dstImage );
+
+			_AddBuffer( task.srcBuffer, EResourceState::TransferSrc, region, task.dstImage );
+			_AddImage(  task.dstImage,  EResourceState::TransferDst, task.dstLayout, region.imageSubresource );
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<CopyImageToBuffer> &task)
+	{
+		for (auto& reg : task.regions)
+		{
+			const VkBufferImageCopy		region = ToVkBufferImageCopy( reg, task.srcImage );
+
+			_AddImage(  task.srcImage,  EResourceState::TransferSrc, task.srcLayout, region.imageSubresource );
+			_AddBuffer( task.dstBuffer, EResourceState::TransferDst, region, task.srcImage );
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<BlitImage> &task)
+	{
+		for (auto& reg : task.regions)
+		{
+			_AddImage( task.srcImage, EResourceState::TransferSrc, task.srcLayout, ToVkSubresourceLayers( reg.srcSubresource, task.srcImage ));
+			_AddImage( task.dstImage, EResourceState::TransferDst, task.dstLayout, ToVkSubresourceLayers( reg.dstSubresource, task.dstImage ));
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<ResolveImage> &task)
+	{
+		for (auto& reg : task.regions)
+		{
+			_AddImage( task.srcImage, EResourceState::TransferSrc, task.srcLayout, ToVkSubresourceLayers( reg.srcSubresource, task.srcImage ));
+			_AddImage( task.dstImage, EResourceState::TransferDst, task.dstLayout, ToVkSubresourceLayers( reg.dstSubresource, task.dstImage ));
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<FillBuffer> &task)
+	{
+		_AddBuffer( task.dstBuffer, EResourceState::TransferDst, task.dstOffset, task.size );
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<ClearColorImage> &task)
+	{
+		for (auto& src : task.ranges)
+		{
+			VkImageSubresourceRange	range;
+			range.aspectMask		= VK_IMAGE_ASPECT_COLOR_BIT;
+			range.baseMipLevel		= src.baseMipLevel.Get();
+			range.levelCount		= src.levelCount;
+			range.baseArrayLayer	= src.baseLayer.Get();
+			range.layerCount		= src.layerCount;
+
+			_AddImage( task.dstImage, EResourceState::TransferDst, task.dstLayout, range );
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<ClearDepthStencilImage> &task)
+	{
+		for (auto& src : task.ranges)
+		{
+			VkImageSubresourceRange	range;
+			range.aspectMask		= VEnumCast( src.aspectMask, task.dstImage->PixelFormat() );
+			range.baseMipLevel		= src.baseMipLevel.Get();
+			range.levelCount		= src.levelCount;
+			range.baseArrayLayer	= src.baseLayer.Get();
+			range.layerCount		= src.layerCount;
+
+			_AddImage( task.dstImage, EResourceState::TransferDst, task.dstLayout, range );
+		}
+	}
+
+	void  VTaskProcessor::VisitBarriers (const VFgTask<UpdateBuffer> &task)
+	{
+		for (auto& reg : task.Regions()) {
+			_AddBuffer( task.dstBuffer, EResourceState::TransferDst, reg.bufferOffset, reg.dataSize );
+		}
+	}
+
 /*
 =================================================
 	Visit (Present)
@@ -2905,6 +3315,9 @@ namespace FG
 		ASSERT( img );
 		ASSERT( not state.range.IsEmpty() );
 
+		if ( _SkipResourceState( img ))
+			return;
+
 		_pendingResourceBarriers.insert({ img, &CommitResourceBarrier<VLocalImage> });
 
 		img->AddPendingState( state );
@@ -2972,6 +3385,10 @@ namespace FG
 	inline void  VTaskProcessor::_AddBufferState (const VLocalBuffer *buf, const BufferState &state)
 	{
 		ASSERT( buf );
+
+		if ( _SkipResourceState( buf ))
+			return;
+
 		_pendingResourceBarriers.insert({ buf, &CommitResourceBarrier<VLocalBuffer> });
 
 		buf->AddPendingState( state );
@@ -3042,6 +3459,10 @@ namespace FG
 	void  VTaskProcessor::_AddRTGeometry (const VLocalRTGeometry *geom, EResourceState state)
 	{
 		ASSERT( geom );
+
+		if ( _SkipResourceState( geom ))
+			return;
+
 		_pendingResourceBarriers.insert({ geom, &CommitResourceBarrier<VLocalRTGeometry> });
 
 		geom->AddPendingState(RTGeometryState{ state, _currTask });
@@ -3058,6 +3479,10 @@ namespace FG
 	void  VTaskProcessor::_AddRTScene (const VLocalRTScene *scene, EResourceState state)
 	{
 		ASSERT( scene );
+
+		if ( _SkipResourceState( scene ))
+			return;
+
 		_pendingResourceBarriers.insert({ scene, &CommitResourceBarrier<VLocalRTScene> });
 
 		scene->AddPendingState(RTSceneState{ state, _currTask });
@@ -3068,10 +3493,31 @@ namespace FG
 
 /*
 =================================================
-	_CommitBarriers
+	_SkipResourceState
+----
+	returns 'true' if resource state must not be added,
+	in probe mode checks intersection with resources of the current barrier group.
 =================================================
 */
-	inline void  VTaskProcessor::_CommitBarriers ()
+	inline bool  VTaskProcessor::_SkipResourceState (const void *resource)
+	{
+		switch ( _barrierMode )
+		{
+			case EBarrierMode::Immediate :	return false;
+			case EBarrierMode::Probe :		_barrierGroup.hasIntersection |= !!_barrierGroup.resources.count( resource );  return true;
+			case EBarrierMode::Prepared :	return true;
+		}
+		return false;
+	}
+
+/*
+=================================================
+	_CommitResourceStates
+----
+	move pending resource states to the barrier manager.
+=================================================
+*/
+	inline void  VTaskProcessor::_CommitResourceStates ()
 	{
 		auto&	barrier_mngr = _fgThread.GetBarrierManager();
 
@@ -3081,6 +3527,27 @@ namespace FG
 		}
 
 		_pendingResourceBarriers.clear();
+	}
+
+/*
+=================================================
+	_CommitBarriers
+=================================================
+*/
+	inline void  VTaskProcessor::_CommitBarriers ()
+	{
+		_CommitResourceStates();
+		_FlushBarriers();
+	}
+
+/*
+=================================================
+	_FlushBarriers
+=================================================
+*/
+	inline void  VTaskProcessor::_FlushBarriers ()
+	{
+		auto&	barrier_mngr = _fgThread.GetBarrierManager();
 
 		// only for debugging!
 	#ifdef FG_DEBUG
@@ -3106,12 +3573,93 @@ namespace FG
 									// TODO: VK_ACCESS_SHADING_RATE_IMAGE_READ_BIT_NV, VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV, VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV
 			barrier.dstAccessMask	= barrier.srcAccessMask;
 
-			barrier_mngr.ForceCommit( _fgThread.GetDevice(), _cmdBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT );
+			if ( barrier_mngr.ForceCommit( _fgThread.GetDevice(), _cmdBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT ))
+				Stat().pipelineBarriers++;
 		}
 		else
 	#endif
 
-		barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer );
+		if ( barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer ))
+			Stat().pipelineBarriers++;
+	}
+
+/*
+=================================================
+	RunBatched
+----
+	Adds resource states of the task to the current barrier group,
+	the group is flushed when task uses any resource of the group.
+	Task commands are recorded in 'FlushBarrierGroup' after single pipeline barrier.
+=================================================
+*/
+	void  VTaskProcessor::RunBatched (VTask node)
+	{
+		ASSERT( node->CanBatchBarriers() );
+		ASSERT( _pendingResourceBarriers.empty() );
+
+		if ( _barrierGroup.tasks.size() )
+		{
+			_currTask		= node;
+			_barrierMode	= EBarrierMode::Probe;
+
+			node->ProcessBarriers( this );
+
+			_barrierMode	= EBarrierMode::Immediate;
+
+			if ( _barrierGroup.hasIntersection or _barrierGroup.tasks.size() == _barrierGroup.tasks.capacity() )
+				FlushBarrierGroup();
+		}
+
+		_currTask = node;
+		
+		if ( _fgThread.GetDebugger() )
+			_fgThread.GetDebugger()->AddTask( _currTask );
+
+		auto&			barrier_mngr	= _fgThread.GetBarrierManager();
+		const size_t	barrier_count	= barrier_mngr.BarrierCount();
+
+		node->ProcessBarriers( this );
+
+		for (auto& res : _pendingResourceBarriers) {
+			_barrierGroup.resources.insert( res.first );
+		}
+		_CommitResourceStates();
+
+		_barrierGroup.tasksWithBarriers += uint(barrier_mngr.BarrierCount() > barrier_count);
+		_barrierGroup.tasks.push_back( node );
+	}
+
+/*
+=================================================
+	FlushBarrierGroup
+=================================================
+*/
+	void  VTaskProcessor::FlushBarrierGroup ()
+	{
+		if ( _barrierGroup.tasks.empty() )
+			return;
+
+		_FlushBarriers();
+
+		if ( _fgThread.GetDebugger() and _barrierGroup.tasksWithBarriers > 1 )
+			_fgThread.GetDebugger()->AddSavedBarriers( _barrierGroup.tasksWithBarriers - 1 );
+
+		_barrierMode = EBarrierMode::Prepared;
+
+		for (auto& task : _barrierGroup.tasks)
+		{
+			FG_TRACE_SCOPE( task->Name(), "Visit" );
+
+			_currTask = task;
+			task->Process( this );
+		}
+
+		_barrierMode = EBarrierMode::Immediate;
+
+		_barrierGroup.tasks.clear();
+		_barrierGroup.resources.clear();
+		_barrierGroup.tasksWithBarriers	= 0;
+		_barrierGroup.hasIntersection	= false;
 	}
 	
 /*
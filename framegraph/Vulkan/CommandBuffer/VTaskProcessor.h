@@ -8,6 +8,7 @@
 #include "VLocalRTGeometry.h"
 #include "VLocalRTScene.h"
 #include "VBarrierManager.h"
+#include "stl/CompileTime/TypeList.h"
 
 namespace FG
 {
@@ -19,6 +20,11 @@ namespace FG
 	class VTaskProcessor final : public VulkanDeviceFn
 	{
 	// types
+	public:
+		// tasks without render passes and global barriers, their barriers can be merged with neighbours, see 'RunBatched'
+		using BatchableTasks_t			= TypeList< DispatchCompute, DispatchComputeIndirect, CopyBuffer, CopyImage, CopyBufferToImage,
+													CopyImageToBuffer, BlitImage, ResolveImage, FillBuffer, ClearColorImage,
+													ClearDepthStencilImage, UpdateBuffer >;
 	private:
 		class DrawTaskBarriers;
 		class DrawTaskCommands;
@@ -44,6 +50,7 @@ namespace FG
 		using ImageClearRanges_t		= FixedArray< VkImageSubresourceRange, FG_MaxClearRanges >;
 		
 		using Statistic_t				= IFrameGraph::RenderingStatistics;
+		using FullStatistic_t			= IFrameGraph::Statistics;
 		using StencilValue_t			= decltype(_fg_hidden_::DynamicStates::stencilReference);
 
 		struct PipelineState
@@ -51,6 +58,27 @@ namespace FG
 			VkPipeline		pipeline	= VK_NULL_HANDLE;
 		};
 
+		enum class EBarrierMode : uint8_t
+		{
+			Immediate,		// add resource states and commit barriers before each task
+			Probe,			// only check resource intersection with the current barrier group
+			Prepared,		// resource states are already commited by the barrier group
+		};
+
+		using GroupResources_t			= std::unordered_set< void const*, std::hash<void const*>, std::equal_to<void const*>, StdLinearAllocator<void const*> >;
+
+		static constexpr uint	MaxBarrierGroupSize = 32;
+
+		struct BarrierGroup
+		{
+			FixedArray< VTask, MaxBarrierGroupSize >	tasks;
+			GroupResources_t							resources;
+			uint										tasksWithBarriers	= 0;
+			bool										hasIntersection		= false;
+
+			explicit BarrierGroup (LinearAllocator<> &alloc) : resources{ alloc } {}
+		};
+
 
 	// variables
 	private:
@@ -64,6 +92,9 @@ namespace FG
 
 		PendingResourceBarriers_t	_pendingResourceBarriers;
 
+		EBarrierMode				_barrierMode		= EBarrierMode::Immediate;
+		BarrierGroup				_barrierGroup;
+
 		PipelineState				_graphicsPipeline;
 		PipelineState				_computePipeline;
 		PipelineState				_rayTracingPipeline;
@@ -75,12 +106,15 @@ namespace FG
 
 		VkImageView					_shadingRateImage	= VK_NULL_HANDLE;
 
+		FullStatistic_t *			_secondaryStat		= null;		// not null when recording secondary command buffer on a worker thread
+
 		static constexpr float		_dbgColor[4]		= { 1.0f, 1.0f, 1.0f, 1.0f };
 
 
 	// methods
 	public:
 		explicit VTaskProcessor (VCommandBuffer &, VkCommandBuffer);
+		VTaskProcessor (VCommandBuffer &, VkCommandBuffer secondaryCmd, FullStatistic_t &);
 		~VTaskProcessor ();
 
 		void  Visit (const VFgTask<SubmitRenderPass> &);
@@ -119,7 +153,22 @@ namespace FG
 		static void  Visit1_CustomDraw (void *, void *);
 		static void  Visit2_CustomDraw (void *, void *);
 
+		void  VisitBarriers (const VFgTask<DispatchCompute> &);
+		void  VisitBarriers (const VFgTask<DispatchComputeIndirect> &);
+		void  VisitBarriers (const VFgTask<CopyBuffer> &);
+		void  VisitBarriers (const VFgTask<CopyImage> &);
+		void  VisitBarriers (const VFgTask<CopyBufferToImage> &);
+		void  VisitBarriers (const VFgTask<CopyImageToBuffer> &);
+		void  VisitBarriers (const VFgTask<BlitImage> &);
+		void  VisitBarriers (const VFgTask<ResolveImage> &);
+		void  VisitBarriers (const VFgTask<FillBuffer> &);
+		void  VisitBarriers (const VFgTask<ClearColorImage> &);
+		void  VisitBarriers (const VFgTask<ClearDepthStencilImage> &);
+		void  VisitBarriers (const VFgTask<UpdateBuffer> &);
+
 		void  Run (VTask);
+		void  RunBatched (VTask);
+		void  FlushBarrierGroup ();
 
 
 	private:
@@ -131,17 +180,25 @@ namespace FG
 		template <typename ID>	ND_ auto const*  _GetResource (ID id) const;
 		
 		void  _CommitBarriers ();
+		void  _CommitResourceStates ();
+		void  _FlushBarriers ();
+		ND_ bool  _SkipResourceState (const void *resource);
+		void  _AddPipelineResources (const VPipelineLayout &layout, const VPipelineResourceSet &resourceSet);
 		
 		void  _AddRenderTargetBarriers (const VLogicalRenderPass &logicalRP, const DrawTaskBarriers &info);
 		void  _SetShadingRateImage (const VLogicalRenderPass &logicalRP, OUT VkImageView &view);
-		void  _BeginRenderPass (const VFgTask<SubmitRenderPass> &task);
-		void  _BeginSubpass (const VFgTask<SubmitRenderPass> &task);
+		void  _BeginRenderPass (const VFgTask<SubmitRenderPass> &task, VkSubpassContents contents);
+		void  _BeginSubpass (const VFgTask<SubmitRenderPass> &task, VkSubpassContents contents);
 		bool  _CreateRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses);
+		ND_ uint  _GetDrawRangeCount (const VLogicalRenderPass &logicalRP) const;
+		void  _RecordDrawTasksParallel (const VFgTask<SubmitRenderPass> &task, uint rangeCount);
 
 		void  _ExtractDescriptorSets (const VPipelineLayout &, const VPipelineResourceSet &, OUT VkDescriptorSets_t &);
 		void  _BindPipelineResources (const VPipelineLayout &layout, const VPipelineResourceSet &resourceSet, VkPipelineBindPoint bindPoint, ShaderDbgIndex debugModeIndex);
-		void  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, OUT VPipelineLayout const* &pplnLayout);
-		void  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, OUT VPipelineLayout const* &pplnLayout);
+		void  _ResolvePipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task);
+		void  _ResolvePipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task);
+		ND_ bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, OUT VPipelineLayout const* &pplnLayout);
+		ND_ bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, OUT VPipelineLayout const* &pplnLayout);
 		void  _BindPipeline2 (const VLogicalRenderPass &logicalRP, VkPipeline pipelineId);
 		void  _BindPipeline (const VComputePipeline* pipeline, const Optional<uint3> &localSize, ShaderDbgIndex debugModeIndex,
 							 VkPipelineCreateFlags flags, OUT VPipelineLayout const* &pplnLayout);
@@ -57,6 +57,7 @@ namespace {
 		}
 
 		++_counter;
+		_savedBarriers = 0;
 		_subBatchUID.clear();
 		_tasks.clear();
 		_images.clear();
@@ -81,6 +82,16 @@ namespace {
 		_tasks[idx] = TaskInfo{task};
 	}
 	
+/*
+=================================================
+	AddSavedBarriers
+=================================================
+*/
+	void VLocalDebugger::AddSavedBarriers (uint count)
+	{
+		_savedBarriers += count;
+	}
+	
 /*
 =================================================
 	AddHostWriteAccess
@@ -292,6 +303,12 @@ namespace {
 
 		_DumpQueue( _tasks, INOUT str );
 
+		if ( EnumEq( _flags, EDebugFlags::LogBarrierBatching ) )
+		{
+			str << "	-----------------------------------------------------------\n"
+				<< "	barriersSaved: " << ToString( _savedBarriers ) << '\n';
+		}
+
 		str << "}\n"
 			<< "===============================================================\n\n";
 	}
@@ -86,6 +86,7 @@ namespace FG
 
 		String						_subBatchUID;
 		uint						_counter	= 0;
+		uint						_savedBarriers	= 0;	// see 'EDebugFlags::LogBarrierBatching'
 
 		// settings
 		EDebugFlags					_flags;
@@ -139,6 +140,7 @@ namespace FG
 		void AddRTSceneUsage (const VRayTracingScene *, const VLocalRTScene::SceneState &state);
 
 		void AddTask (VTask task);
+		void AddSavedBarriers (uint count);
 
 
 	// dump to string
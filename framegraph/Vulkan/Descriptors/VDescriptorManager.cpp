@@ -59,6 +59,15 @@ namespace FG
 			}
 		}
 		_descriptorPools.clear();
+
+		EXLOCK( _transientGuard );
+		CHECK( _transientPools.size() == _transientPoolCount );	// some pools are still used by command batches
+
+		for (auto& pool : _transientPools) {
+			_device.vkDestroyDescriptorPool( _device.GetVkDevice(), pool, null );
+		}
+		_transientPools.clear();
+		_transientPoolCount = 0;
 	}
 	
 /*
@@ -141,6 +150,111 @@ namespace FG
 		return true;
 	}
 
+/*
+=================================================
+	AllocTransientDescriptorSet
+----
+	'pools' are owned by command batch, so only
+	acquiring of new pool requires synchronization.
+=================================================
+*/
+	bool  VDescriptorManager::AllocTransientDescriptorSet (VkDescriptorSetLayout layout, INOUT TransientPoolArray_t &pools, OUT VkDescriptorSet &ds)
+	{
+		VkDescriptorSetAllocateInfo		info = {};
+		info.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		info.descriptorSetCount	= 1;
+		info.pSetLayouts		= &layout;
+
+		if ( pools.size() )
+		{
+			info.descriptorPool = pools.back();
+
+			if ( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds ) == VK_SUCCESS )
+				return true;
+		}
+
+		CHECK_ERR( pools.size() < pools.capacity() );
+
+		VkDescriptorPool	pool;
+		CHECK_ERR( _AcquireTransientPool( OUT pool ));
+		pools.push_back( pool );
+
+		info.descriptorPool = pool;
+		VK_CHECK( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds ));
+		return true;
+	}
+	
+/*
+=================================================
+	ReleaseTransientPools
+=================================================
+*/
+	void  VDescriptorManager::ReleaseTransientPools (INOUT TransientPoolArray_t &pools)
+	{
+		if ( pools.empty() )
+			return;
+
+		for (auto& pool : pools) {
+			VK_CALL( _device.vkResetDescriptorPool( _device.GetVkDevice(), pool, 0 ));
+		}
+
+		EXLOCK( _transientGuard );
+		_transientPools.insert( _transientPools.end(), pools.begin(), pools.end() );
+		pools.clear();
+	}
+	
+/*
+=================================================
+	_AcquireTransientPool
+=================================================
+*/
+	bool  VDescriptorManager::_AcquireTransientPool (OUT VkDescriptorPool &pool)
+	{
+		{
+			EXLOCK( _transientGuard );
+
+			if ( _transientPools.size() )
+			{
+				pool = _transientPools.back();
+				_transientPools.pop_back();
+				return true;
+			}
+			++_transientPoolCount;
+		}
+
+		FixedArray< VkDescriptorPoolSize, 32 >	pool_sizes;
+
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_SAMPLER,						TransientPoolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,		TransientPoolSize * 4 });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,				TransientPoolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,				TransientPoolSize });
+
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,				TransientPoolSize * 4 });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,				TransientPoolSize * 2 });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,		TransientPoolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,		TransientPoolSize });
+		
+		if ( _device.IsRayTracingEnabled() ) {
+			pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV, TransientPoolSize });
+		}
+		
+		// without 'VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT' driver can use linear allocation
+		VkDescriptorPoolCreateInfo	info = {};
+		info.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		info.poolSizeCount	= uint(pool_sizes.size());
+		info.pPoolSizes		= pool_sizes.data();
+		info.maxSets		= TransientSets;
+		info.flags			= 0;
+
+		if ( _device.vkCreateDescriptorPool( _device.GetVkDevice(), &info, null, OUT &pool ) != VK_SUCCESS )
+		{
+			EXLOCK( _transientGuard );
+			--_transientPoolCount;
+			RETURN_ERR( "failed to create transient descriptor pool" );
+		}
+		return true;
+	}
+
 /*
 =================================================
 	_CreateDescriptorPool
@@ -10,6 +10,11 @@ namespace FG
 	//
 	// Vulkan Descriptor Manager
 	//
+	// Persistent descriptor sets are allocated from shared pools and freed individually.
+	// Transient descriptor sets are allocated from pools owned by command batch,
+	// batch is recorded in single thread so allocation doesn't require synchronization,
+	// all sets are released at once by 'vkResetDescriptorPool' when batch is completed.
+	//
 
 	class VDescriptorManager final
 	{
@@ -17,6 +22,8 @@ namespace FG
 	private:
 		static constexpr uint	MaxDescriptorPoolSize	= 1u << 11;
 		static constexpr uint	MaxDescriptorSets		= 1u << 10;
+		static constexpr uint	TransientPoolSize		= 1u << 8;
+		static constexpr uint	TransientSets			= 1u << 7;
 
 		struct DSPool
 		{
@@ -25,6 +32,10 @@ namespace FG
 
 		using DescriptorPoolArray_t		= FixedArray< DSPool, 8 >;
 		using DescriptorSet				= VDescriptorSetLayout::DescriptorSet;
+		using TransientPools_t			= Array< VkDescriptorPool >;
+
+	public:
+		using TransientPoolArray_t		= FixedArray< VkDescriptorPool, 8 >;
 
 
 	// variables
@@ -34,6 +45,10 @@ namespace FG
 		Mutex						_guard;
 		DescriptorPoolArray_t		_descriptorPools;
 
+		Mutex						_transientGuard;
+		TransientPools_t			_transientPools;		// available for command batches
+		uint						_transientPoolCount	= 0;
+
 
 	// methods
 	public:
@@ -47,8 +62,12 @@ namespace FG
 		bool DeallocDescriptorSet (const DescriptorSet &ds);
 		bool DeallocDescriptorSets (ArrayView<DescriptorSet> ds);
 
+		bool AllocTransientDescriptorSet (VkDescriptorSetLayout layout, INOUT TransientPoolArray_t &pools, OUT VkDescriptorSet &ds);
+		void ReleaseTransientPools (INOUT TransientPoolArray_t &pools);
+
 	private:
 		bool _CreateDescriptorPool ();
+		bool _AcquireTransientPool (OUT VkDescriptorPool &pool);
 	};
 
 
@@ -21,7 +21,7 @@ namespace FG
 		
 		_dataPtr	= PipelineResourcesHelper::CloneDynamicData( desc );
 		_layoutId	= desc.GetLayout();
-		_hash		= HashOf( _layoutId ) + _dataPtr->CalcHash();
+		_hash		= PipelineResourcesHelper::GetContentHash( desc );
 	}
 	
 /*
@@ -30,13 +30,13 @@ namespace FG
 =================================================
 */
 	VPipelineResources::VPipelineResources (INOUT PipelineResources &desc) :
+		_hash{ PipelineResourcesHelper::GetContentHash( desc )},
 		_dataPtr{ PipelineResourcesHelper::RemoveDynamicData( INOUT desc )},
 		_allowEmptyResources{ desc.IsEmptyResourcesAllowed() }
 	{
 		EXLOCK( _drCheck );
 		
 		_layoutId	= _dataPtr->layoutId;
-		_hash		= HashOf( _layoutId ) + _dataPtr->CalcHash();
 	}
 
 /*
@@ -233,7 +233,19 @@ namespace FG
 
 		VK_CHECK( dev.vkCreateImage( dev.GetVkDevice(), &info, null, OUT &_image ));
 
-		CHECK_ERR( memObj.AllocateForImage( resMngr.GetMemoryManager(), _image ));
+		// memory for transient image will be bound by command buffer
+		_isTransient = EnumEq( memObj.MemoryType(), EMemoryTypeExt::Transient );
+
+		// memory for relocated image is allocated before, see 'VResourceManager::DefragmentMemory'
+		if ( EnumEq( memObj.MemoryType(), EMemoryTypeExt::Relocation ))
+		{
+			VMemoryObj::MemoryInfo	mem_info;
+			CHECK_ERR( memObj.GetInfo( resMngr.GetMemoryManager(), OUT mem_info ));
+			VK_CHECK( dev.vkBindImageMemory( dev.GetVkDevice(), _image, mem_info.mem, VkDeviceSize(mem_info.offset) ));
+		}
+		else
+		if ( not _isTransient )
+			CHECK_ERR( memObj.AllocateForImage( resMngr.GetMemoryManager(), _image ));
 		
 		if ( not dbgName.empty() )
 		{
@@ -333,9 +345,41 @@ namespace FG
 		_aspectMask			= Zero;
 		_defaultLayout		= Zero;
 		_queueFamilyMask	= Default;
+		_isTransient		= false;
 		_onRelease			= {};
 	}
 	
+/*
+=================================================
+	SwapMemory
+----
+	exchange vulkan objects between images with same description,
+	used to move image to another memory without changing image ID.
+=================================================
+*/
+	void VImage::SwapMemory (VImage &other)
+	{
+		EXLOCK( _drCheck );
+		EXLOCK( other._drCheck );
+		ASSERT( All( _desc.dimension == other._desc.dimension ) and _desc.format == other._desc.format );
+		ASSERT( not _desc.isExternal and not other._desc.isExternal );
+		ASSERT( not _isTransient and not other._isTransient );
+
+		std::swap( _image, other._image );
+
+		// content of the previous image is in default layout of this image
+		other._defaultLayout = _defaultLayout;
+		{
+			EXLOCK( _viewMapLock );
+			EXLOCK( other._viewMapLock );
+			std::swap( _viewMap, other._viewMap );
+		}
+
+		RawMemoryID	mem_id	= _memoryId.Release();
+		_memoryId			= MemoryID{ other._memoryId.Release() };
+		other._memoryId		= MemoryID{ mem_id };
+	}
+
 /*
 =================================================
 	GetView
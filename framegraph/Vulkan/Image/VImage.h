@@ -38,6 +38,7 @@ namespace FG
 		VkImageLayout				_defaultLayout		= Zero;
 		VkAccessFlagBits			_readAccessMask		= Zero;
 		EQueueFamilyMask			_queueFamilyMask	= Default;
+		bool						_isTransient		= false;
 
 		DebugName_t					_debugName;
 		OnRelease_t					_onRelease;
@@ -58,6 +59,8 @@ namespace FG
 
 		void Destroy (VResourceManager &);
 
+		void SwapMemory (VImage &other);
+
 		ND_ VulkanImageDesc		GetApiSpecificDescription () const;
 
 		ND_ VkImageView			GetView (const VDevice &, const HashedImageViewDesc &) const;
@@ -86,6 +89,7 @@ namespace FG
 
 		ND_ bool				IsExclusiveSharing ()	const	{ SHAREDLOCK( _drCheck );  return _queueFamilyMask == Default; }
 		ND_ EQueueFamilyMask	GetQueueFamilyMask ()	const	{ SHAREDLOCK( _drCheck );  return _queueFamilyMask; }
+		ND_ bool				IsTransient ()			const	{ SHAREDLOCK( _drCheck );  return _isTransient; }
 		ND_ StringView			GetDebugName ()			const	{ SHAREDLOCK( _drCheck );  return _debugName; }
 		
 		ND_ static bool	IsSupported (const VDevice &dev, const ImageDesc &desc, EMemoryType memType);
@@ -24,7 +24,7 @@ namespace FG
 	Create
 =================================================
 */
-	bool VLocalImage::Create (const VImage *imageData)
+	bool VLocalImage::Create (const VImage *imageData, LinearAllocator<> &allocator)
 	{
 		CHECK_ERR( _imageData == null );
 		CHECK_ERR( imageData );
@@ -32,6 +32,9 @@ namespace FG
 		_imageData		= imageData;
 		_finalLayout	= _imageData->DefaultLayout();
 		_isImmutable	= false; //_imageData->IsReadOnly();
+
+		_pendingAccesses.SetAllocator( allocator );
+		_accessForReadWrite.SetAllocator( allocator );
 		
 		// set initial state
 		{
@@ -44,7 +47,7 @@ namespace FG
 			pending.index		= ExeOrderIndex::Initial;
 			pending.range		= SubRange{ 0, ArrayLayers() * MipmapLevels() };
 
-			_accessForReadWrite.push_back( std::move(pending) );
+			CHECK_ERR( _accessForReadWrite.push_back( std::move(pending) ));
 		}
 
 		return true;
@@ -63,8 +66,8 @@ namespace FG
 		ASSERT( _pendingAccesses.empty() );
 		ASSERT( _accessForReadWrite.empty() );
 
-		_pendingAccesses.clear();
-		_accessForReadWrite.clear();
+		_pendingAccesses.Release();
+		_accessForReadWrite.Release();
 	}
 
 /*
@@ -99,10 +102,17 @@ namespace FG
 	_ReplaceAccessRecords
 =================================================
 */
-	void VLocalImage::_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const ImageAccess &barrier)
+	bool VLocalImage::_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const ImageAccess &barrier)
 	{
 		ASSERT( iter >= arr.begin() and iter <= arr.end() );
 
+		// fast path: barrier overlaps all records
+		if ( arr.empty() or (barrier.range.begin <= arr.front().range.begin and barrier.range.end >= arr.back().range.end) )
+		{
+			arr.Assign( barrier );
+			return true;
+		}
+
 		bool replaced = false;
 
 		for (; iter != arr.end();)
@@ -130,9 +140,11 @@ namespace FG
 				iter->range.end = barrier.range.begin;
 
 				iter = arr.insert( iter+1, barrier );
+				CHECK_ERR( iter != arr.end() );
 				replaced = true;
 
 				iter = arr.insert( iter+1, src );
+				CHECK_ERR( iter != arr.end() );
 
 				iter->range.begin = barrier.range.end;
 				break;
@@ -150,7 +162,7 @@ namespace FG
 
 					if ( not replaced )
 					{
-						arr.insert( iter, barrier );
+						CHECK_ERR( arr.insert( iter, barrier ) != arr.end() );
 						replaced = true;
 					}
 					break;
@@ -177,8 +189,9 @@ namespace FG
 			
 		if ( not replaced )
 		{
-			arr.insert( iter, barrier );
+			CHECK_ERR( arr.insert( iter, barrier ) != arr.end() );
 		}
+		return true;
 	}
 	
 /*
@@ -227,37 +240,8 @@ namespace FG
 		pending.index			= is.task->ExecutionOrder();
 		
 
-		// extract sub ranges
-		const uint		arr_layers	= ArrayLayers();
-		const uint		mip_levels	= MipmapLevels();
-		Array<SubRange>	sub_ranges;
-		SubRange		layer_range	 { is.range.Layers().begin,  Min( is.range.Layers().end,  arr_layers )};
-		SubRange		mipmap_range { is.range.Mipmaps().begin, Min( is.range.Mipmaps().end, mip_levels )};
-
-		if ( is.range.IsWholeLayers() and is.range.IsWholeMipmaps() )
-		{
-			sub_ranges.push_back(SubRange{ 0, arr_layers * mip_levels });
-		}
-		else
-		if ( is.range.IsWholeLayers() )
-		{
-			uint	begin = mipmap_range.begin   * arr_layers + layer_range.begin;
-			uint	end   = (mipmap_range.end-1) * arr_layers + layer_range.end;
-				
-			sub_ranges.push_back(SubRange{ begin, end });
-		}
-		else
-		for (uint mip = mipmap_range.begin; mip < mipmap_range.end; ++mip)
-		{
-			uint	begin = mip * arr_layers + layer_range.begin;
-			uint	end   = mip * arr_layers + layer_range.end;
-
-			sub_ranges.push_back(SubRange{ begin, end });
-		}
-
-
 		// merge with pending
-		for (auto& range : sub_ranges)
+		const auto	MergeRange = [this, &pending] (SubRange range)
 		{
 			auto	iter = _FindFirstAccess( _pendingAccesses, range );
 
@@ -266,6 +250,7 @@ namespace FG
 				pending.range = { range.begin, iter->range.begin };
 
 				iter = _pendingAccesses.insert( iter, pending );
+				CHECK_ERR( iter != _pendingAccesses.end(), void() );
 				++iter;
 
 				range.begin = iter->range.begin;
@@ -289,8 +274,36 @@ namespace FG
 			if ( not range.IsEmpty() )
 			{
 				pending.range = range;
-				_pendingAccesses.insert( iter, pending );
+				CHECK( _pendingAccesses.insert( iter, pending ) != _pendingAccesses.end() );
 			}
+		};
+
+
+		// extract sub ranges
+		const uint		arr_layers	= ArrayLayers();
+		const uint		mip_levels	= MipmapLevels();
+		SubRange		layer_range	 { is.range.Layers().begin,  Min( is.range.Layers().end,  arr_layers )};
+		SubRange		mipmap_range { is.range.Mipmaps().begin, Min( is.range.Mipmaps().end, mip_levels )};
+
+		if ( is.range.IsWholeLayers() and is.range.IsWholeMipmaps() )
+		{
+			MergeRange( SubRange{ 0, arr_layers * mip_levels });
+		}
+		else
+		if ( is.range.IsWholeLayers() )
+		{
+			uint	begin = mipmap_range.begin   * arr_layers + layer_range.begin;
+			uint	end   = (mipmap_range.end-1) * arr_layers + layer_range.end;
+				
+			MergeRange( SubRange{ begin, end });
+		}
+		else
+		for (uint mip = mipmap_range.begin; mip < mipmap_range.end; ++mip)
+		{
+			uint	begin = mip * arr_layers + layer_range.begin;
+			uint	end   = mip * arr_layers + layer_range.end;
+
+			MergeRange( SubRange{ begin, end });
 		}
 	}
 	
@@ -316,7 +329,7 @@ namespace FG
 			pending.index			= index;
 			pending.range			= SubRange{ 0, ArrayLayers() * MipmapLevels() };
 
-			_pendingAccesses.push_back( std::move(pending) );
+			CHECK( _pendingAccesses.push_back( std::move(pending) ));
 		}
 
 		CommitBarrier( barrierMngr, debugger );
@@ -378,7 +391,7 @@ namespace FG
 				}
 			}
 
-			_ReplaceAccessRecords( _accessForReadWrite, first, pending );
+			CHECK( _ReplaceAccessRecords( _accessForReadWrite, first, pending ));
 		}
 
 		_pendingAccesses.clear();
@@ -5,6 +5,7 @@
 #include "VImage.h"
 #include "framegraph/Public/EResourceState.h"
 #include "framegraph/Shared/ImageDataRange.h"
+#include "VAccessRecords.h"
 
 namespace FG
 {
@@ -58,7 +59,7 @@ namespace FG
 		};
 
 		using ImageViewMap_t	= VImage::ImageViewMap_t;
-		using AccessRecords_t	= Array< ImageAccess >;		// TODO: fixed size array or custom allocator
+		using AccessRecords_t	= VAccessRecords< ImageAccess >;
 		using AccessIter_t		= AccessRecords_t::iterator;
 
 		
@@ -78,7 +79,7 @@ namespace FG
 		VLocalImage (VLocalImage &&) = delete;
 		~VLocalImage ();
 
-		bool Create (const VImage *);
+		bool Create (const VImage *, LinearAllocator<> &);
 		void Destroy ();
 
 		void SetInitialState (bool immutable, bool invalidate) const;
@@ -111,7 +112,7 @@ namespace FG
 		bool _CreateView (const VDevice &, const HashedImageViewDesc &, OUT VkImageView &) const;
 
 		ND_ static AccessIter_t	_FindFirstAccess (AccessRecords_t &arr, const SubRange &range);
-			static void			_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const ImageAccess &barrier);
+		ND_ static bool			_ReplaceAccessRecords (INOUT AccessRecords_t &arr, AccessIter_t iter, const ImageAccess &barrier);
 
 	};
 
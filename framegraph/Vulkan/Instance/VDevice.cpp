@@ -78,6 +78,8 @@ namespace FG
 		_enableRayTracingNV			= HasDeviceExtension( VK_NV_RAY_TRACING_EXTENSION_NAME );
 		_enableShadingRateImageNV	= HasDeviceExtension( VK_NV_SHADING_RATE_IMAGE_EXTENSION_NAME );
 		_samplerMirrorClamp			= HasDeviceExtension( VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE_EXTENSION_NAME );
+		_enablePipelineFeedback		= HasDeviceExtension( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME );
+		_enableMemoryBudget			= HasDeviceExtension( VK_EXT_MEMORY_BUDGET_EXTENSION_NAME ) and _vkVersion >= EShaderLangFormat::Vulkan_110;
 
 		// load extensions
 		if ( _vkVersion >= EShaderLangFormat::Vulkan_110 )
@@ -68,6 +68,8 @@ namespace FG
 		bool									_enableRayTracingNV			: 1;
 		bool									_samplerMirrorClamp			: 1;
 		bool									_enableShadingRateImageNV	: 1;
+		bool									_enablePipelineFeedback		: 1;
+		bool									_enableMemoryBudget			: 1;
 
 		struct {
 			VkPhysicalDeviceProperties						properties;
@@ -96,6 +98,8 @@ namespace FG
 		ND_ bool							IsRayTracingEnabled ()			const	{ return _enableRayTracingNV; }
 		ND_ bool							IsSamplerMirrorClampEnabled ()	const	{ return _samplerMirrorClamp; }
 		ND_ bool							IsShadingRateImageEnabled ()	const	{ return _enableShadingRateImageNV; }
+		ND_ bool							IsPipelineFeedbackEnabled ()	const	{ return _enablePipelineFeedback; }
+		ND_ bool							IsMemoryBudgetEnabled ()		const	{ return _enableMemoryBudget; }
 		ND_ EResourceState					GetGraphicsShaderStages ()		const	{ return _graphicsShaderStages; }
 		ND_ VkPipelineStageFlags			GetAllWritableStages ()			const	{ return _allWritableStages; }
 		ND_ VkPipelineStageFlags			GetAllReadableStages ()			const	{ return _allReadableStages; }
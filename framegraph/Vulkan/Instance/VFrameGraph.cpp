@@ -5,6 +5,7 @@
 #include "VSubmitted.h"
 #include "Shared/PipelineResourcesHelper.h"
 #include "stl/Algorithms/StringUtils.h"
+#include "stl/Stream/FileStream.h"
 
 namespace FG
 {
@@ -14,6 +15,7 @@ namespace FG
 	using PendingSwapchains_t	= FixedArray< VSwapchain const*, 16 >;
 	using TempFences_t			= FixedArray< VkFence, 32 >;
 	using TempSubmitted_t		= FixedArray< VSubmitted*, 32 >;
+	using PerQueueSemaphores_t	= StaticArray< VkSemaphore, uint(EQueueType::_Count) >;
 	using TimePoint_t			= std::chrono::high_resolution_clock::time_point;
 
 /*
@@ -49,8 +51,6 @@ namespace FG
 
 		// setup queues
 		{
-			EXLOCK( _queueGuard );
-
 			_AddGraphicsQueue();
 			_AddAsyncComputeQueue();
 			_AddAsyncTransferQueue();
@@ -68,6 +68,12 @@ namespace FG
 		}
 
 		CHECK_ERR( _resourceMngr.Initialize() );
+		CHECK_ERR( _CreateMergedPipelineCache( Default ));
+
+		// ring will grow with upload volume
+		for (auto& q : _queueMap) {
+			q.stagingRing.Initialize( _resourceMngr.GetHostWriteBufferSize() / 4, BytesU{_device.GetDeviceLimits().nonCoherentAtomSize} );
+		}
 		
 		CHECK_ERR( _SetState( EState::Initialization, EState::Idle ));
 		return true;
@@ -83,6 +89,25 @@ namespace FG
 		CHECK_ERR( _SetState( EState::Idle, EState::Destroyed ), void());
 		CHECK_ERR( WaitIdle(), void());
 
+		// stop recording threads
+		{
+			EXLOCK( _recording.guard );
+			_recording.jobs.Deinitialize();
+			_recording.started = false;
+		}
+
+		// asynchronous readback callbacks use staging buffers
+		for (; _asyncReadbackCount.load( memory_order_acquire ) > 0;) {
+			std::this_thread::yield();
+		}
+
+		// per-thread caches must not be used after destruction
+		{
+			EXLOCK( _pplnCache.guard );
+			_WaitPipelineCacheMerging();
+			_pplnCache.pending.clear();
+		}
+
 		// delete command buffers
 		{
 			FG_LOGD( "Max command buffers "s << ToString(_cmdBufferPool.CreatedObjectsCount()) );
@@ -96,18 +121,18 @@ namespace FG
 
 		// delete per queue data
 		{
-			EXLOCK( _queueGuard );
-
 			for (auto& q : _queueMap)
 			{
-				CHECK( q.pending.empty() );
+				EXLOCK( q.guard );
+				CHECK( q.ready.empty() );
+				CHECK( q.waitingCount.load( memory_order_relaxed ) == 0 );
 				CHECK( q.submitted.empty() );
 
 				q.cmdPool.Destroy( _device );
+				q.stagingRing.Deinitialize( _resourceMngr );
 
 				for (auto& sem : q.semaphores) {
-					_device.vkDestroySemaphore( _device.GetVkDevice(), sem, null );
-					sem = VK_NULL_HANDLE;
+					_device.vkDestroySemaphore( _device.GetVkDevice(), sem.exchange( VK_NULL_HANDLE, memory_order_relaxed ), null );
 				}
 			}
 		}
@@ -117,7 +142,21 @@ namespace FG
 			_queryPool = VK_NULL_HANDLE;
 		}
 
+		if ( _pplnCache.merged ) {
+			_device.vkDestroyPipelineCache( _device.GetVkDevice(), _pplnCache.merged, null );
+			_pplnCache.merged = VK_NULL_HANDLE;
+		}
+		_pplnCache.initialData.clear();
+
 		_shaderDebugCallback = {};
+		{
+			EXLOCK( _readback.guard );
+			_readback.executor = {};
+		}
+		{
+			EXLOCK( _memoryBudget.guard );
+			_memoryBudget.callback = {};
+		}
 		_resourceMngr.Deinitialize();
 	}
 	
@@ -134,6 +173,153 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	LoadPipelineCache
+=================================================
+*/
+	bool  VFrameGraph::LoadPipelineCache (NtStringView filename)
+	{
+		CHECK_ERR( _IsInitialized() );
+
+		Array<uint8_t>	blob;
+		{
+			FileRStream		file{ filename };
+
+			if ( not file.IsOpen() or not file.Read( size_t(file.Size()), OUT blob ))
+			{
+				FG_LOGI( "pipeline cache file '"s << filename.c_str() << "' is not found" );
+				return false;
+			}
+		}
+
+		ArrayView<uint8_t>	data;
+		if ( not VPipelineCache::DeserializeCache( _device, blob, OUT data ))
+		{
+			FG_LOGI( "pipeline cache '"s << filename.c_str() << "' is created for another device or driver, or corrupted" );
+			return false;
+		}
+
+		EXLOCK( _pplnCache.guard );
+		_WaitPipelineCacheMerging();
+
+		if ( _pplnCache.merged ) {
+			_device.vkDestroyPipelineCache( _device.GetVkDevice(), _pplnCache.merged, null );
+			_pplnCache.merged = VK_NULL_HANDLE;
+		}
+
+		CHECK_ERR( _CreateMergedPipelineCache( data ));
+		_pplnCache.initialData.assign( data.begin(), data.end() );
+		return true;
+	}
+	
+/*
+=================================================
+	SavePipelineCache
+=================================================
+*/
+	bool  VFrameGraph::SavePipelineCache (NtStringView filename)
+	{
+		CHECK_ERR( _IsInitialized() );
+
+		Array<uint8_t>	blob;
+		{
+			EXLOCK( _pplnCache.guard );
+			_WaitPipelineCacheMerging();
+			_MergePipelineCaches();
+			_WaitPipelineCacheMerging();
+
+			CHECK_ERR( VPipelineCache::SerializeCache( _device, _pplnCache.merged, OUT blob ));
+		}
+
+		FileWStream		file{ filename };
+		CHECK_ERR( file.IsOpen() );
+		CHECK_ERR( file.Write( ArrayView<uint8_t>{ blob }));
+		return true;
+	}
+	
+/*
+=================================================
+	InitPipelineCache
+=================================================
+*/
+	bool  VFrameGraph::InitPipelineCache (INOUT VPipelineCache &cache)
+	{
+		EXLOCK( _pplnCache.guard );
+		return cache.Initialize( _device, _pplnCache.initialData );
+	}
+	
+/*
+=================================================
+	AddPipelineCacheToMerge
+=================================================
+*/
+	void  VFrameGraph::AddPipelineCacheToMerge (const VPipelineCache &cache)
+	{
+		EXLOCK( _pplnCache.guard );
+
+		VkPipelineCache	handle = cache.GetCache();
+
+		if ( handle and std::find( _pplnCache.pending.begin(), _pplnCache.pending.end(), handle ) == _pplnCache.pending.end() )
+			_pplnCache.pending.push_back( handle );
+	}
+
+/*
+=================================================
+	_CreateMergedPipelineCache
+=================================================
+*/
+	bool  VFrameGraph::_CreateMergedPipelineCache (ArrayView<uint8_t> initialData)
+	{
+		CHECK_ERR( not _pplnCache.merged );
+
+		VkPipelineCacheCreateInfo	info = {};
+		info.sType				= VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		info.initialDataSize	= initialData.size();
+		info.pInitialData		= initialData.empty() ? null : initialData.data();
+
+		VK_CHECK( _device.vkCreatePipelineCache( _device.GetVkDevice(), &info, null, OUT &_pplnCache.merged ));
+		return true;
+	}
+	
+/*
+=================================================
+	_MergePipelineCaches
+----
+	'_pplnCache.guard' must be locked
+=================================================
+*/
+	void  VFrameGraph::_MergePipelineCaches ()
+	{
+		if ( _pplnCache.pending.empty() or not _pplnCache.merged )
+			return;
+
+		// previous merging is not complete yet
+		if ( _pplnCache.merging.valid() and _pplnCache.merging.wait_for( std::chrono::seconds{0} ) != std::future_status::ready )
+			return;
+
+		// only destination cache requires external synchronization
+		_pplnCache.merging = std::async( std::launch::async,
+			[dev = &_device, dst = _pplnCache.merged, src = std::move(_pplnCache.pending)] ()
+			{
+				VK_CALL( dev->vkMergePipelineCaches( dev->GetVkDevice(), dst, uint(src.size()), src.data() ));
+			});
+		_pplnCache.pending.clear();
+	}
+	
+/*
+=================================================
+	_WaitPipelineCacheMerging
+----
+	'_pplnCache.guard' must be locked
+=================================================
+*/
+	void  VFrameGraph::_WaitPipelineCacheMerging ()
+	{
+		if ( _pplnCache.merging.valid() )
+			_pplnCache.merging.get();
+	}
+
 /*
 =================================================
 	SetShaderDebugCallback
@@ -147,6 +333,105 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	SetReadbackExecutor
+=================================================
+*/
+	bool  VFrameGraph::SetReadbackExecutor (ReadbackExecutor_t &&executor)
+	{
+		CHECK_ERR( _IsInitialized() );
+
+		EXLOCK( _readback.guard );
+		_readback.executor = std::move(executor);
+		return true;
+	}
+	
+/*
+=================================================
+	GetReadbackExecutor
+----
+	returns copy because executor may be changed by another thread.
+=================================================
+*/
+	VFrameGraph::ReadbackExecutor_t  VFrameGraph::GetReadbackExecutor () const
+	{
+		EXLOCK( _readback.guard );
+		return _readback.executor;
+	}
+	
+/*
+=================================================
+	SetMemoryBudgetCallback
+=================================================
+*/
+	bool  VFrameGraph::SetMemoryBudgetCallback (float softBudget, MemoryBudgetCallback_t &&cb)
+	{
+		CHECK_ERR( _IsInitialized() );
+		CHECK_ERR( softBudget > 0.0f );
+
+		EXLOCK( _memoryBudget.guard );
+		_memoryBudget.softBudget	= softBudget;
+		_memoryBudget.callback		= std::move(cb);
+		return true;
+	}
+	
+/*
+=================================================
+	AddGpuTraceEvent
+----
+	GPU and CPU clocks are not synchronized, offset is chosen so that
+	batch never starts on the GPU before it was submitted on the CPU.
+=================================================
+*/
+#ifdef FG_ENABLE_CPU_TRACE
+	void  VFrameGraph::AddGpuTraceEvent (EQueueType queue, StringView name, uint64_t gpuBegin, uint64_t gpuEnd, uint64_t cpuSubmitTime)
+	{
+		const int64_t	min_offset	= int64_t(cpuSubmitTime) - int64_t(gpuBegin);
+		int64_t			offset		= _gpuTraceOffset.load( memory_order_relaxed );
+
+		for (; offset < min_offset and not _gpuTraceOffset.compare_exchange_weak( INOUT offset, min_offset, memory_order_relaxed );) {}
+
+		offset = Max( offset, min_offset );
+
+		TraceRecorder::AddEvent( TraceRecorder::ETrack::GPU, uint(queue), name, "GPU", uint64_t(int64_t(gpuBegin) + offset), uint64_t(int64_t(gpuEnd) + offset) );
+	}
+#endif
+	
+/*
+=================================================
+	_CheckMemoryBudget
+----
+	callback is called without lock so it can release resources or change callback.
+=================================================
+*/
+	void  VFrameGraph::_CheckMemoryBudget ()
+	{
+		MemoryBudgetCallback_t	cb;
+		float					soft_budget;
+		{
+			EXLOCK( _memoryBudget.guard );
+			if ( not _memoryBudget.callback )
+				return;
+
+			cb			= _memoryBudget.callback;
+			soft_budget	= _memoryBudget.softBudget;
+		}
+
+		decltype(ResourceStatistics::memoryHeaps)	heaps;
+		_resourceMngr.GetMemoryManager().GetHeapUsage( OUT heaps );
+
+		for (size_t i = 0; i < heaps.size(); ++i)
+		{
+			auto&			heap	= heaps[i];
+			const BytesU	budget	= heap.budget > 0_b ? heap.budget : heap.size;
+			const BytesU	usage	= Max( heap.usage, heap.used );
+
+			if ( double(uint64_t(usage)) > double(uint64_t(budget)) * soft_budget )
+				cb( uint(i), usage, budget );
+		}
+	}
+	
 /*
 =================================================
 	GetDeviceInfo
@@ -200,11 +485,11 @@ namespace FG
 		barrier.srcQueueFamilyIndex	= queueFamily;
 		barrier.dstQueueFamilyIndex	= queueFamily;
 
-		EXLOCK( _queueGuard );
 		for (auto& q : _queueMap)
 		{
 			if ( q.ptr and (uint(q.ptr->familyIndex) == queueFamily or queueFamily == VK_QUEUE_FAMILY_IGNORED) )
 			{
+				EXLOCK( q.guard );
 				q.imageBarriers.push_back( barrier );
 				return;
 			}
@@ -255,6 +540,7 @@ namespace FG
 	ImageID  VFrameGraph::CreateImage (const ImageDesc &desc, const MemoryDesc &mem, EResourceState defaultState, StringView dbgName)
 	{
 		CHECK_ERR( _IsInitialized() );
+		CHECK_ERR( not EnumEq( mem.type, EMemoryType::Transient ));	// use 'ICommandBuffer::CreateTransientImage'
 
 		RawImageID	result = _resourceMngr.CreateImage( desc, mem, _GetQueuesMask( desc.queues ), defaultState, dbgName );
 		
@@ -274,6 +560,7 @@ namespace FG
 	BufferID  VFrameGraph::CreateBuffer (const BufferDesc &desc, const MemoryDesc &mem, StringView dbgName)
 	{
 		CHECK_ERR( _IsInitialized() );
+		CHECK_ERR( not EnumEq( mem.type, EMemoryType::Transient ));	// use 'ICommandBuffer::CreateTransientBuffer'
 		return BufferID{ _resourceMngr.CreateBuffer( desc, mem, _GetQueuesMask( desc.queues ), dbgName )};
 	}
 
@@ -618,6 +905,8 @@ namespace FG
 */
 	CommandBuffer  VFrameGraph::Begin (const CommandBufferDesc &desc, ArrayView<CommandBuffer> dependsOn)
 	{
+		FG_TRACE_SCOPE( "Begin", "FrameGraph" );
+
 		CHECK_ERR( uint(desc.queueType) < _queueMap.size() );
 		
 		VCommandBuffer*	cmd		= null;
@@ -659,6 +948,31 @@ namespace FG
 		return CommandBuffer{ cmd, batch };
 	}
 	
+/*
+=================================================
+	GetRecordingJobs
+----
+	workers are started on first use,
+	one thread per secondary command pool, calling thread is used too.
+=================================================
+*/
+	JobSystem&  VFrameGraph::GetRecordingJobs ()
+	{
+		EXLOCK( _recording.guard );
+
+		if ( not _recording.started )
+		{
+			JobSystem::Config	cfg;
+			cfg.workerCount = Min( FG_MaxRecordingThreads, Max( 1u, std::thread::hardware_concurrency() )) - 1;
+
+			if ( cfg.workerCount > 0 )
+				CHECK( _recording.jobs.Initialize( cfg ));
+
+			_recording.started = true;
+		}
+		return _recording.jobs;
+	}
+
 /*
 =================================================
 	Execute
@@ -682,11 +996,11 @@ namespace FG
 			uint	q_idx = uint(batch->GetQueueType());
 			CHECK_ERR( q_idx < _queueMap.size() );
 
-			EXLOCK( _queueGuard );
-			_queueMap[q_idx].pending.push_back( batch );
-		}
+			_queueMap[q_idx].waitingCount.fetch_add( 1, memory_order_relaxed );
 
-		//_FlushQueue( batch->GetQueueUsage(), 3u );
+			// batch will be pushed to the 'ready' queue when all dependencies are ready
+			batch->OnExecuted();
+		}
 		return true;
 	}
 	
@@ -716,13 +1030,14 @@ namespace FG
 */
 	bool  VFrameGraph::Flush (EQueueUsage queues)
 	{
-		bool	res;
+		bool	res = _FlushAll( queues, 10u );
 		{
-			EXLOCK( _queueGuard );
-			res = _FlushAll( queues, 10u );
+			EXLOCK( _pplnCache.guard );
+			_MergePipelineCaches();
 		}
 
 		_resourceMngr.RunValidation( 100 );
+		_CheckMemoryBudget();
 		return res;
 	}
 	
@@ -743,7 +1058,7 @@ namespace FG
 			for (size_t qi = 0; qi < _queueMap.size(); ++qi)
 			{
 				if ( _queueMap[qi].ptr and EnumEq( queues, 1u<<qi ) )
-					changed |= size_t(_FlushQueue( EQueueType(qi), 10u ));
+					changed |= size_t(_FlushQueue( EQueueType(qi) ));
 			}
 		}
 		return true;
@@ -754,8 +1069,10 @@ namespace FG
 	_FlushQueue
 =================================================
 */
-	bool  VFrameGraph::_FlushQueue (EQueueType queueIndex, uint maxIter)
+	bool  VFrameGraph::_FlushQueue (EQueueType queueIndex)
 	{
+		FG_TRACE_SCOPE( "FlushQueue", "FrameGraph" );
+
 		const auto	start_time = TimePoint_t::clock::now();
 
 		uint				qi			= uint(queueIndex);
@@ -767,46 +1084,23 @@ namespace FG
 		SubmitInfos_t		submit_infos;
 		TempSemaphores_t	release_semaphores;
 		PendingSwapchains_t	swapchains;
+		PerQueueSemaphores_t	signal_semaphores	{};
 
-		// find batches that can be submitted
-		for (size_t b = 0, b_max = Min( maxIter, q.pending.size()), changed = 1;
-			 changed and (b < b_max);
-			 ++b)
-		{
-			changed = 0;
-
-			for (auto iter = q.pending.begin(); iter != q.pending.end();)
-			{
-				auto&		batch	 = *iter;
-				bool		is_ready = true;
-				EQueueUsage	q_mask2	 = Default;
+		EXLOCK( q.guard );
 
-				ASSERT( batch->GetState() == EBatchState::Backed );
+		// all batches in the 'ready' queue can be submitted,
+		// batches from the same queue that depend on current batch will be pushed to the end of the queue
+		for (VCmdBatchPtr batch; (pending.size() < pending.capacity()) and q.ready.Pop( OUT batch );)
+		{
+			ASSERT( batch->GetState() == EBatchState::Backed );
 				
-				for (auto& dep : batch->GetDependencies())
-				{
-					const auto	min_state = (dep->GetQueueType() == queueIndex ? EBatchState::Ready : EBatchState::Submitted);
-
-					q_mask2		|= dep->GetQueueType();
-					is_ready	&= (dep->GetState() >= min_state);
-				}
-
-				if ( is_ready )
-				{
-					if ( pending.size() == pending.capacity() )
-						break;
-
-					wait_idle |= batch->IsQueueSyncRequired();
-					batch->OnReadyToSubmit();
-					pending.push_back( std::move(batch) );
-							
-					changed	= 1;
-					iter	= q.pending.erase( iter );
-					q_mask	|= q_mask2;
-				}
-				else
-					++iter;
+			for (auto& dep : batch->GetDependencies()) {
+				q_mask |= dep->GetQueueType();
 			}
+
+			wait_idle |= batch->IsQueueSyncRequired();
+			batch->OnReadyToSubmit();
+			pending.push_back( std::move(batch) );
 		}
 		
 		if ( pending.empty() )
@@ -815,6 +1109,8 @@ namespace FG
 			return false;
 		}
 
+		q.waitingCount.fetch_sub( uint(pending.size()), memory_order_relaxed );
+
 		// add semaphores
 		for (size_t qj = 0; qj < _queueMap.size(); ++qj)
 		{
@@ -824,22 +1120,22 @@ namespace FG
 				continue;
 			
 			// input
-			if ( EnumEq( q_mask, 1u<<qj ) and q2.semaphores[qi] )
+			if ( EnumEq( q_mask, 1u<<qj ))
 			{
-				pending.front()->WaitSemaphore( q2.semaphores[qi], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT );
-				release_semaphores.push_back( q2.semaphores[qi] );
-				q2.semaphores[qi] = VK_NULL_HANDLE;
+				// semaphore is published after submission, so signal operation is already submitted
+				if ( VkSemaphore sem = q2.semaphores[qi].exchange( VK_NULL_HANDLE, memory_order_acquire ))
+				{
+					pending.front()->WaitSemaphore( sem, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT );
+					release_semaphores.push_back( sem );
+				}
 			}
 						
 			// output
 			{
-				if ( q.semaphores[qj] )
-					release_semaphores.push_back( q.semaphores[qj] );
-
 				VkSemaphore	sem = _CreateSemaphore();
 
 				pending.back()->SignalSemaphore( sem );
-				q.semaphores[qj] = sem;
+				signal_semaphores[qj] = sem;
 			}
 		}
 
@@ -890,6 +1186,17 @@ namespace FG
 			EXLOCK( q.ptr->guard );
 
 			VK_CALL( _device.vkQueueSubmit( q.ptr->handle, uint(pending.size()), submit_infos.data(), OUT submit->GetFence() ));
+
+			// publish semaphores before batches will be marked as submitted,
+			// previous semaphore was not waited and will be destroyed when current batches complete
+			for (size_t qj = 0; qj < signal_semaphores.size(); ++qj)
+			{
+				if ( not signal_semaphores[qj] )
+					continue;
+
+				if ( VkSemaphore old = q.semaphores[qj].exchange( signal_semaphores[qj], memory_order_acq_rel ))
+					submit->_AddSemaphore( old );
+			}
 			
 			for (uint i = 0; i < pending.size(); ++i)
 			{
@@ -935,7 +1242,9 @@ namespace FG
 				}
 
 				iter = q.submitted.erase( iter );
-				_submittedPool.Unassign( submitted->GetIndexInPool() );
+
+				if ( submitted->_ReleaseRef() )
+					_submittedPool.Unassign( submitted->GetIndexInPool() );
 			}
 			else
 				break;
@@ -958,51 +1267,24 @@ namespace FG
 	{
 		const auto	start_time = TimePoint_t::clock::now();
 
-		EXLOCK( _queueGuard );
-
 		TempFences_t		tmp_fences;
 		TempSubmitted_t		tmp_submitted;
 		bool				result = true;
 
-		const auto	WaitAndRelease = [this, &tmp_fences, &tmp_submitted, &result, timeout] ()
+		for (size_t i = 0; i < commands.size();)
 		{
-			auto  res = _device.vkWaitForFences( _device.GetVkDevice(), uint(tmp_fences.size()), tmp_fences.data(), VK_TRUE, uint64_t(timeout.count()) );
+			// submitted batches are referenced under the lock, so fences will not be reused while waiting
+			_LockAllQueues();
 
-			if ( res == VK_SUCCESS )
+			for (; i < commands.size() and tmp_fences.size() < tmp_fences.capacity(); ++i)
 			{
-				EXLOCK( _statisticGuard );
+				auto*	batch = Cast<VCmdBatch>(commands[i].GetBatch());
+				if ( not batch or batch->GetState() != EBatchState::Submitted )
+					continue;
 
-				// release resources
-				for (auto* submitted : tmp_submitted) {
-					submitted->_Release( _device, _debugger, _shaderDebugCallback, INOUT _lastStatistic );
-				}
-			}
-			else
-			{
-				result = false;
-				CHECK( res == VK_TIMEOUT );
-			}
-
-			tmp_fences.clear();
-			tmp_submitted.clear();
-		};
-
-		for (auto& cmd : commands)
-		{
-			auto*	batch = Cast<VCmdBatch>(cmd.GetBatch());
-			if ( not batch )
-				continue;
-
-			auto	state		= batch->GetState();
-			auto*	submitted	= batch->GetSubmitted();
-
-			if ( state == EBatchState::Complete )
-			{}
-			else
-			if ( state == EBatchState::Submitted )
-			{
-				auto	fence = submitted->GetFence();
-				bool	found = false;
+				auto*	submitted	= batch->GetSubmitted();
+				auto	fence		= submitted->GetFence();
+				bool	found		= false;
 
 				ASSERT( fence );
 
@@ -1012,17 +1294,44 @@ namespace FG
 
 				if ( not found )
 				{
+					submitted->_AddRef();
 					tmp_fences.push_back( fence );
 					tmp_submitted.push_back( submitted );
 				}
 			}
 
-			if ( tmp_fences.size() == tmp_fences.capacity() )
-				WaitAndRelease();
-		}
+			_UnlockAllQueues();
+
+			if ( tmp_fences.empty() )
+				continue;
+
+			auto	res = _device.vkWaitForFences( _device.GetVkDevice(), uint(tmp_fences.size()), tmp_fences.data(), VK_TRUE, uint64_t(timeout.count()) );
+
+			if ( res != VK_SUCCESS )
+			{
+				result = false;
+				CHECK( res == VK_TIMEOUT );
+			}
+
+			// release resources, batches may already be retired by 'Flush'
+			_LockAllQueues();
+			{
+				EXLOCK( _statisticGuard );
+
+				for (auto* submitted : tmp_submitted)
+				{
+					if ( res == VK_SUCCESS )
+						submitted->_Release( _device, _debugger, _shaderDebugCallback, INOUT _lastStatistic );
+
+					if ( submitted->_ReleaseRef() )
+						_submittedPool.Unassign( submitted->GetIndexInPool() );
+				}
+			}
+			_UnlockAllQueues();
 
-		if ( tmp_fences.size() )
-			WaitAndRelease();
+			tmp_fences.clear();
+			tmp_submitted.clear();
+		}
 		
 		_waitingTime.fetch_add( (TimePoint_t::clock::now() - start_time).count(), memory_order_relaxed );
 		return result;
@@ -1037,18 +1346,17 @@ namespace FG
 	{
 		const auto	start_time = TimePoint_t::clock::now();
 
+		CHECK_ERR( _FlushAll( EQueueUsage::All, 10u ));
 		{
-			EXLOCK( _queueGuard );
+			_LockAllQueues();
 
 			TempFences_t	fences;
-
-			CHECK_ERR( _FlushAll( EQueueUsage::All, 10u ));
 		
 			for (size_t i = 0; i < _queueMap.size(); ++i)
 			{
 				auto&	q = _queueMap[i];
 
-				CHECK( q.pending.empty() );	// circular dependency
+				CHECK( q.waitingCount.load( memory_order_relaxed ) == 0 );	// circular dependency
 
 				for (auto& s : q.submitted)
 				{
@@ -1066,12 +1374,17 @@ namespace FG
 
 			for (auto& q : _queueMap)
 			{
-				for (auto* s : q.submitted) {
+				for (auto* s : q.submitted)
+				{
 					s->_Release( GetDevice(), _debugger, _shaderDebugCallback, INOUT _lastStatistic );
-					_submittedPool.Unassign( s->GetIndexInPool() );
+
+					if ( s->_ReleaseRef() )
+						_submittedPool.Unassign( s->GetIndexInPool() );
 				}
 				q.submitted.clear();
 			}
+
+			_UnlockAllQueues();
 		}
 
 		_resourceMngr.RunValidation( 100 );
@@ -1123,6 +1436,11 @@ namespace FG
 		result = _lastStatistic;
 		result.renderer.submitingTime   = Nanoseconds{_submitingTime.exchange( 0, memory_order_relaxed )};
 		result.renderer.waitingTime	 = Nanoseconds{_waitingTime.exchange( 0, memory_order_relaxed )};
+
+		for (auto& q : _queueMap) {
+			q.stagingRing.GetStatistic( INOUT result.resources );
+		}
+		_resourceMngr.GetMemoryManager().GetStatistic( INOUT result.resources );
 		
 		_lastStatistic = Default;
 		return true;
@@ -1389,6 +1707,42 @@ namespace FG
 	{
 		_cmdBatchPool.Unassign( batch->GetIndexInPool() );
 	}
+	
+/*
+=================================================
+	EnqueueReadyBatch
+----
+	called when batch is executed and all dependencies are in required state,
+	queue capacity is same as batch pool capacity, so it never overflows
+=================================================
+*/
+	void  VFrameGraph::EnqueueReadyBatch (VCmdBatch *batch)
+	{
+		auto&	q = _queueMap[ uint(batch->GetQueueType()) ];
+
+		CHECK( q.ready.Push( VCmdBatchPtr{ batch }));
+	}
+	
+/*
+=================================================
+	_LockAllQueues
+----
+	always in the same order to avoid deadlocks
+=================================================
+*/
+	void  VFrameGraph::_LockAllQueues ()
+	{
+		for (auto& q : _queueMap) {
+			q.guard.lock();
+		}
+	}
+	
+	void  VFrameGraph::_UnlockAllQueues ()
+	{
+		for (size_t i = _queueMap.size(); i > 0; --i) {
+			_queueMap[i-1].guard.unlock();
+		}
+	}
 
 
 }	// FG
@@ -7,7 +7,11 @@
 #include "VDevice.h"
 #include "VCmdBatch.h"
 #include "VDebugger.h"
+#include "VStagingRing.h"
 #include "stl/ThreadSafe/LfIndexedPool.h"
+#include "stl/ThreadSafe/LfFixedQueue.h"
+#include "stl/ThreadSafe/JobSystem.h"
+#include <future>
 
 namespace FG
 {
@@ -29,7 +33,11 @@ namespace FG
 		};
 		
 		using EBatchState		= VCmdBatch::EState;
-		using PerQueueSem_t		= StaticArray< VkSemaphore, uint(EQueueType::_Count) >;
+		using PerQueueSem_t		= StaticArray< Atomic<VkSemaphore>, uint(EQueueType::_Count) >;
+
+		using CmdBufferPool_t	= LfIndexedPool< VCommandBuffer, uint, 32, 4 >;
+		using CmdBatchPool_t	= LfIndexedPool< VCmdBatch, uint, 32, 16 >;
+		using ReadyBatches_t	= LfFixedQueue< VCmdBatchPtr, CmdBatchPool_t::Capacity() >;
 
 		struct QueueData
 		{
@@ -37,21 +45,26 @@ namespace FG
 			VDeviceQueueInfoPtr			ptr;			// pointer to the physical queue
 			EQueueType					type			= Default;
 
-		// mutable data
-			Array<VCmdBatchPtr>			pending;		// TODO: circular queue
-			Array<VSubmitted *>			submitted;
-			PerQueueSem_t				semaphores		{};
+		// lock-free data
+			ReadyBatches_t				ready;			// batches with all dependencies in required state, pushed by any thread
+			Atomic<uint>				waitingCount	{0};	// executed but not submitted batches
+			PerQueueSem_t				semaphores		{};		// signaled by this queue, waited by other queue
 
+		// internally synchronized
+			mutable VStagingRing		stagingRing;	// host-to-device staging memory, statistic is reset in 'GetStatistics'
+
+		// mutable data, protected by 'guard'
+			Mutex						guard;
+			Array<VSubmitted *>			submitted;
 			VCommandPool				cmdPool;
 			Array<VkImageMemoryBarrier>	imageBarriers;
 		};
 
-		using CmdBufferPool_t	= LfIndexedPool< VCommandBuffer, uint, 32, 4 >;
-		using CmdBatchPool_t	= LfIndexedPool< VCmdBatch, uint, 32, 16 >;
 		using SubmittedPool_t	= LfIndexedPool< VSubmitted, uint, 32, 8 >;
 		using QueueMap_t		= StaticArray< QueueData, uint(EQueueType::_Count) >;
 		using Fences_t			= Array< VkFence >;
 		using Semaphores_t		= Array< VkSemaphore >;
+		using PipelineCaches_t	= Array< VkPipelineCache >;
 
 
 	// variables
@@ -60,7 +73,6 @@ namespace FG
 
 		VDevice					_device;
 
-		Mutex					_queueGuard;		// TODO: remove global lock
 		QueueMap_t				_queueMap;
 		EQueueUsage				_queueUsage;
 
@@ -73,6 +85,32 @@ namespace FG
 		VkQueryPool				_queryPool;			// for time measurements
 
 		ShaderDebugCallback_t	_shaderDebugCallback;
+		Atomic<uint>			_asyncReadbackCount	{0};	// number of batches with unfinished asynchronous readback callbacks
+
+		struct {
+			Mutex					guard;
+			VkPipelineCache			merged			= VK_NULL_HANDLE;
+			Array<uint8_t>			initialData;	// used to initialize pipeline cache in command buffers
+			PipelineCaches_t		pending;		// caches that will be merged at next 'Flush'
+			std::future<void>		merging;
+		}						_pplnCache;
+
+		struct {
+			Mutex					guard;
+			JobSystem				jobs;			// workers for 'ECompilationFlags::ParallelRenderPass'
+			bool					started			= false;
+		}						_recording;
+
+		struct {
+			Mutex					guard;
+			float					softBudget		= 1.0f;
+			MemoryBudgetCallback_t	callback;
+		}						_memoryBudget;
+
+		struct {
+			mutable Mutex			guard;
+			ReadbackExecutor_t		executor;		// may be changed while other threads complete batches
+		}						_readback;
 
 		mutable Mutex			_statisticGuard;
 		mutable Statistics		_lastStatistic;
@@ -80,6 +118,10 @@ namespace FG
 		mutable Atomic<uint64_t>   _submitingTime {0};
 		mutable Atomic<uint64_t>   _waitingTime   {0};
 
+	#ifdef FG_ENABLE_CPU_TRACE
+		Atomic<int64_t>			_gpuTraceOffset	{ std::numeric_limits<int64_t>::min() };	// GPU time to CPU trace time
+	#endif
+
 
 	// methods
 	public:
@@ -90,7 +132,11 @@ namespace FG
 		bool			Initialize ();
 		void			Deinitialize () override;
 		bool			AddPipelineCompiler (const PipelineCompiler &comp) override;
+		bool			LoadPipelineCache (NtStringView filename) override;
+		bool			SavePipelineCache (NtStringView filename) override;
 		bool			SetShaderDebugCallback (ShaderDebugCallback_t &&) override;
+		bool			SetReadbackExecutor (ReadbackExecutor_t &&) override;
+		bool			SetMemoryBudgetCallback (float softBudget, MemoryBudgetCallback_t &&) override;
 		DeviceInfo_t	GetDeviceInfo () const override;
 		EQueueUsage		GetAvilableQueues () const override		{ return _queueUsage; }
 
@@ -158,12 +204,26 @@ namespace FG
 
 		// //
 		void			RecycleBatch (const VCmdBatch *);
+		void			EnqueueReadyBatch (VCmdBatch *);
+		bool			InitPipelineCache (INOUT VPipelineCache &);
+		void			AddPipelineCacheToMerge (const VPipelineCache &);
 
 		
 		ND_ VDeviceQueueInfoPtr	FindQueue (EQueueType type) const;
 		ND_ VDevice const&		GetDevice ()				const	{ return _device; }
 		ND_ VResourceManager &	GetResourceManager ()				{ return _resourceMngr; }
 		ND_ VkQueryPool			GetQueryPool ()				const	{ return _queryPool; }
+		ND_ VStagingRing &		GetStagingRing (EQueueType type)	{ return _GetQueueData( type ).stagingRing; }
+
+		ND_ ReadbackExecutor_t	GetReadbackExecutor ()		const;
+		ND_ uint				GetRecordingCommandBufferCount ()	{ return uint(_cmdBufferPool.AssignedBitsCount()); }
+		ND_ JobSystem &			GetRecordingJobs ();
+			void						BeginAsyncReadback ()			{ _asyncReadbackCount.fetch_add( 1, memory_order_relaxed ); }
+			void						EndAsyncReadback ()				{ _asyncReadbackCount.fetch_sub( 1, memory_order_release ); }
+
+	#ifdef FG_ENABLE_CPU_TRACE
+			void						AddGpuTraceEvent (EQueueType queue, StringView name, uint64_t gpuBegin, uint64_t gpuEnd, uint64_t cpuSubmitTime);
+	#endif
 
 
 	private:
@@ -191,8 +251,18 @@ namespace FG
 
 			bool  _TryFlush (const VCmdBatchPtr &batch);
 			bool  _FlushAll (EQueueUsage queues, uint maxIter);
-			bool  _FlushQueue (EQueueType queue, uint maxIter);
+			bool  _FlushQueue (EQueueType queue);
 			bool  _WaitQueue (EQueueType queue, Nanoseconds timeout);
+			void  _LockAllQueues ();
+			void  _UnlockAllQueues ();
+		
+		// pipeline cache //
+			bool  _CreateMergedPipelineCache (ArrayView<uint8_t> initialData);
+			void  _MergePipelineCaches ();
+			void  _WaitPipelineCacheMerging ();
+
+		// memory //
+			void  _CheckMemoryBudget ();
 
 
 		// states //
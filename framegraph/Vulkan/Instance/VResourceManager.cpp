@@ -828,6 +828,32 @@ namespace FG
 		return true;
 	}
 
+/*
+=================================================
+	CreateMemory
+----
+	allocates memory block without resource,
+	used to place transient resources.
+=================================================
+*/
+	RawMemoryID  VResourceManager::CreateMemory (const VkMemoryRequirements &memReq, const MemoryDesc &mem, StringView dbgName)
+	{
+		ASSERT( not EnumEq( mem.type, EMemoryType::Transient ));
+
+		RawMemoryID					mem_id;
+		ResourceBase<VMemoryObj>*	mem_obj	= null;
+		CHECK_ERR( _CreateMemory( OUT mem_id, OUT mem_obj, mem, dbgName ));
+
+		if ( not mem_obj->Data().AllocateMemory( _memoryMngr, memReq ))
+		{
+			ReleaseResource( mem_id );
+			RETURN_ERR( "failed when allocating memory" );
+		}
+
+		mem_obj->AddRef();
+		return mem_id;
+	}
+
 /*
 =================================================
 	CreateImage
@@ -1023,7 +1049,8 @@ namespace FG
 	CreateDescriptorSet
 =================================================
 */
-	VPipelineResources const*  VResourceManager::CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &resourceMap)
+	VPipelineResources const*  VResourceManager::CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &resourceMap,
+																	   INOUT IFrameGraph::ResourceStatistics &stat)
 	{
 		using Resource_t = VCmdBatch::Resource;
 
@@ -1040,6 +1067,7 @@ namespace FG
 					res.AddRef();
 				
 				ASSERT( res.Data().IsAllResourcesAlive( *this ));
+				stat.descriptorSetCacheHits++;
 				return &res.Data();
 			}
 		}
@@ -1049,12 +1077,15 @@ namespace FG
 		auto&	layout = _GetResourcePool( desc.GetLayout() )[ desc.GetLayout().Index() ];
 		CHECK_ERR( layout.IsCreated() and desc.GetLayout().InstanceID() == layout.GetInstanceID() );
 
+		bool	is_created = false;
+
 		id = _CreateCachedResource<RawPipelineResourcesID>( "failed when creating descriptor set",
 								   [&] (auto& data) { return Replace( data, desc ); },
 								   [&] (auto& data) {
 										if (data.Create( *this )) {
 											layout.AddRef();
 											_validation.createdPplnResources.fetch_add( 1, memory_order_relaxed );
+											is_created = true;
 											return true;
 										}
 										return false;
@@ -1062,6 +1093,11 @@ namespace FG
 
 		if ( id )
 		{
+			if ( is_created )
+				stat.descriptorSetCacheMisses++;
+			else
+				stat.descriptorSetDedupHits++;
+
 			PipelineResourcesHelper::SetCache( desc, id );
 
 			auto&	res = _GetResourcePool( id )[ id.Index() ];
@@ -1270,7 +1306,7 @@ namespace FG
 */
 	void  VResourceManager::RunValidation (uint maxIter)
 	{
-		static constexpr uint	scale = MaxCached / 16;
+		static constexpr uint	scale = CachedChunkSize / 16;
 
 		const auto	UpdateCounter = [] (INOUT Atomic<uint> &counter, uint maxValue) -> uint
 		{
@@ -1325,6 +1361,309 @@ namespace FG
 		ValidateResources( _validation.createdFramebuffers, _validation.lastCheckedFramebuffer, _framebufferCache );
 	}
 	
+/*
+=================================================
+	DefragmentMemory
+----
+	moves resources from sparsely used memory blocks to more used blocks,
+	new vulkan object takes place of the previous, so resource ID is not changed,
+	previous vulkan object and memory are moved to temporary resource which is returned
+	in 'buffers' and 'images', content must be copied and temporary resource must be released by the caller.
+	Skipped resources that may be used in command buffers, cached descriptor sets and framebuffers.
+	Pools and caches are not locked, caller must guarantee that resources are not created, destroyed
+	or acquired by other command buffers, see 'VCommandBuffer::DefragmentMemory'.
+=================================================
+*/
+	bool  VResourceManager::DefragmentMemory (BytesU maxBytesToMove, OUT RelocatedBuffers_t &buffers, OUT RelocatedImages_t &images, OUT BytesU &movedSize)
+	{
+		struct Candidate
+		{
+			Index_t			index;
+			bool			isImage;
+			BytesU			size;
+			VkDeviceMemory	mem;
+		};
+
+		BlockUsage_t			block_usage;
+		HashSet< RawBufferID >	used_buffers;
+		HashSet< RawImageID >	used_images;
+		Array< Candidate >		candidates;
+
+		buffers.clear();
+		images.clear();
+		movedSize = 0_b;
+
+		// calculate used size for each memory block
+		for (size_t i = 0, count = _memoryObjPool.size(); i < count; ++i)
+		{
+			auto&	res = _memoryObjPool[ Index_t(i) ];
+			
+			VMemoryObj::MemoryInfo	info;
+			if ( res.IsCreated() and not EnumEq( res.Data().MemoryType(), EMemoryTypeExt::Transient ) and
+				 res.Data().GetInfo( _memoryMngr, OUT info ))
+			{
+				block_usage[ info.mem ] += info.size;
+			}
+		}
+
+		// find resources that are used in cached descriptor sets and framebuffers
+		for (size_t i = 0, count = _pplnResourcesCache.size(); i < count; ++i)
+		{
+			auto&	res = _pplnResourcesCache[ Index_t(i) ];
+			if ( not res.IsCreated() )
+				continue;
+
+			res.Data().ForEachUniform( [&] (const UniformID &, const auto &un)
+				{
+					using T = std::remove_cv_t< std::remove_reference_t< decltype(un) >>;
+
+					if constexpr( IsSameTypes< T, PipelineResources::Buffer > or IsSameTypes< T, PipelineResources::TexelBuffer >)
+					{
+						for (uint j = 0; j < un.elementCount; ++j) {
+							used_buffers.insert( un.elements[j].bufferId );
+						}
+					}
+					if constexpr( IsSameTypes< T, PipelineResources::Image > or IsSameTypes< T, PipelineResources::Texture >)
+					{
+						for (uint j = 0; j < un.elementCount; ++j) {
+							used_images.insert( un.elements[j].imageId );
+						}
+					}
+				});
+		}
+		for (size_t i = 0, count = _framebufferCache.size(); i < count; ++i)
+		{
+			auto&	res = _framebufferCache[ Index_t(i) ];
+			if ( not res.IsCreated() )
+				continue;
+
+			for (auto& att : res.Data().Attachments()) {
+				used_images.insert( att.first );
+			}
+		}
+
+		const auto	IsMovable = [this] (RawMemoryID memId, OUT VkDeviceMemory &mem, OUT BytesU &size)
+		{
+			auto*	mem_obj = GetResource( memId, false, true );
+			if ( not mem_obj or EnumAny( mem_obj->MemoryType(), EMemoryTypeExt::HostVisible | EMemoryTypeExt::Dedicated | EMemoryTypeExt::Transient ))
+				return false;
+
+			VMemoryObj::MemoryInfo	info;
+			if ( not mem_obj->GetInfo( _memoryMngr, OUT info ))
+				return false;
+
+			mem		= info.mem;
+			size	= info.size;
+			return true;
+		};
+
+		// find resources that are not used anywhere except resource owner
+		for (size_t i = 0, count = _bufferPool.size(); i < count; ++i)
+		{
+			const Index_t	index	= Index_t(i);
+			auto&			res		= _bufferPool[ index ];
+			
+			if ( not res.IsCreated() or res.GetRefCount() != 1 )
+				continue;
+
+			auto&		desc = res.Data().Description();
+			Candidate	item { index, false };
+
+			if ( not desc.isExternal and EnumEq( desc.usage, EBufferUsage::Transfer )	and
+				 not used_buffers.count( RawBufferID{ index, res.GetInstanceID() })		and
+				 IsMovable( res.Data().GetMemoryID(), OUT item.mem, OUT item.size ))
+			{
+				candidates.push_back( item );
+			}
+		}
+		for (size_t i = 0, count = _imagePool.size(); i < count; ++i)
+		{
+			const Index_t	index	= Index_t(i);
+			auto&			res		= _imagePool[ index ];
+			
+			if ( not res.IsCreated() or res.GetRefCount() != 1 )
+				continue;
+
+			auto&		desc = res.Data().Description();
+			Candidate	item { index, true };
+
+			if ( not desc.isExternal and EnumEq( desc.usage, EImageUsage::Transfer )	and
+				 not used_images.count( RawImageID{ index, res.GetInstanceID() })		and
+				 IsMovable( res.Data().GetMemoryID(), OUT item.mem, OUT item.size ))
+			{
+				candidates.push_back( item );
+			}
+		}
+
+		// move resources from less used blocks first, large resources frees more space
+		std::sort( candidates.begin(), candidates.end(), [&block_usage] (auto& lhs, auto& rhs)
+				  {
+					  const BytesU	lhs_usage = block_usage[ lhs.mem ];
+					  const BytesU	rhs_usage = block_usage[ rhs.mem ];
+					  return lhs_usage != rhs_usage ? lhs_usage < rhs_usage : lhs.size > rhs.size;
+				  });
+
+		for (auto& item : candidates)
+		{
+			if ( movedSize + item.size > maxBytesToMove )
+				continue;
+
+			if ( item.isImage )
+			{
+				RawImageID	old_id;
+				if ( _RelocateImage( item.index, INOUT block_usage, OUT old_id ))
+				{
+					images.emplace_back( RawImageID{ item.index, _imagePool[ item.index ].GetInstanceID() }, old_id );
+					movedSize += item.size;
+				}
+			}
+			else
+			{
+				RawBufferID	old_id;
+				if ( _RelocateBuffer( item.index, INOUT block_usage, OUT old_id ))
+				{
+					buffers.emplace_back( RawBufferID{ item.index, _bufferPool[ item.index ].GetInstanceID() }, old_id );
+					movedSize += item.size;
+				}
+			}
+		}
+		return true;
+	}
+	
+/*
+=================================================
+	_AllocForRelocation
+----
+	allocates memory in existing block that is more used than current block,
+	returns 'false' without error if there is no suitable space.
+=================================================
+*/
+	bool  VResourceManager::_AllocForRelocation (const VMemoryObj &srcMem, const VkMemoryRequirements &memReq, StringView dbgName, INOUT BlockUsage_t &blockUsage,
+												 OUT RawMemoryID &memId, OUT ResourceBase<VMemoryObj>* &memPtr)
+	{
+		VMemoryObj::MemoryInfo	src_info;
+		CHECK_ERR( srcMem.GetInfo( _memoryMngr, OUT src_info ));
+
+		MemoryDesc				desc	= srcMem.Description();
+		VkMemoryRequirements	mem_req	= memReq;
+		const auto&				props	= _device.GetDeviceMemoryProperties();
+		uint					bits	= 0;
+
+		desc.type = EMemoryType(uint(desc.type) | uint(EMemoryTypeExt::Relocation));
+
+		// keep the same memory properties, otherwise resource may be moved to slower memory
+		for (uint i = 0; i < props.memoryTypeCount; ++i)
+		{
+			if ( props.memoryTypes[i].propertyFlags == src_info.flags )
+				bits |= (1u << i);
+		}
+		mem_req.memoryTypeBits &= bits;
+
+		if ( auto* req = UnionGetIf<VulkanMemRequirements>( &desc.req ))
+		{
+			mem_req.alignment		= Max( mem_req.alignment, req->alignment );
+			mem_req.memoryTypeBits	&= (req->memTypeBits ? req->memTypeBits : ~0u);
+		}
+
+		if ( mem_req.memoryTypeBits == 0 )
+			return false;
+
+		CHECK_ERR( _CreateMemory( OUT memId, OUT memPtr, desc, dbgName ));
+
+		VMemoryObj::MemoryInfo	dst_info;
+		const bool				allocated	= memPtr->Data().AllocateMemory( _memoryMngr, mem_req ) and
+											  memPtr->Data().GetInfo( _memoryMngr, OUT dst_info );
+
+		// moving to the same or less used block doesn't reduce fragmentation
+		if ( not allocated or dst_info.mem == src_info.mem or blockUsage[ dst_info.mem ] < blockUsage[ src_info.mem ] )
+		{
+			ReleaseResource( memId );
+			return false;
+		}
+
+		blockUsage[ dst_info.mem ] += dst_info.size;
+		blockUsage[ src_info.mem ] -= src_info.size;
+		return true;
+	}
+
+/*
+=================================================
+	_RelocateBuffer
+=================================================
+*/
+	bool  VResourceManager::_RelocateBuffer (Index_t index, INOUT BlockUsage_t &blockUsage, OUT RawBufferID &oldId)
+	{
+		VBuffer&	buf		= _bufferPool[ index ].Data();
+		auto*		src_mem	= GetResource( buf.GetMemoryID() );
+		CHECK_ERR( src_mem );
+
+		VkMemoryRequirements	mem_req = {};
+		_device.vkGetBufferMemoryRequirements( _device.GetVkDevice(), buf.Handle(), OUT &mem_req );
+
+		RawMemoryID					mem_id;
+		ResourceBase<VMemoryObj>*	mem_obj	= null;
+		if ( not _AllocForRelocation( *src_mem, mem_req, buf.GetDebugName(), INOUT blockUsage, OUT mem_id, OUT mem_obj ))
+			return false;
+
+		CHECK_ERR( _Assign( OUT oldId ));
+
+		auto&	data = _bufferPool[ oldId.Index() ];
+		Replace( data );
+
+		if ( not data.Create( *this, buf.Description(), mem_id, mem_obj->Data(), buf.GetQueueFamilyMask(), buf.GetDebugName() ))
+		{
+			ReleaseResource( mem_id );
+			_Unassign( oldId );
+			RETURN_ERR( "failed when creating buffer" );
+		}
+
+		mem_obj->AddRef();
+		data.AddRef();
+
+		// new buffer takes place of the previous
+		buf.SwapMemory( data.Data() );
+		return true;
+	}
+
+/*
+=================================================
+	_RelocateImage
+=================================================
+*/
+	bool  VResourceManager::_RelocateImage (Index_t index, INOUT BlockUsage_t &blockUsage, OUT RawImageID &oldId)
+	{
+		VImage&		img		= _imagePool[ index ].Data();
+		auto*		src_mem	= GetResource( img.GetMemoryID() );
+		CHECK_ERR( src_mem );
+
+		VkMemoryRequirements	mem_req = {};
+		_device.vkGetImageMemoryRequirements( _device.GetVkDevice(), img.Handle(), OUT &mem_req );
+
+		RawMemoryID					mem_id;
+		ResourceBase<VMemoryObj>*	mem_obj	= null;
+		if ( not _AllocForRelocation( *src_mem, mem_req, img.GetDebugName(), INOUT blockUsage, OUT mem_id, OUT mem_obj ))
+			return false;
+
+		CHECK_ERR( _Assign( OUT oldId ));
+
+		auto&	data = _imagePool[ oldId.Index() ];
+		Replace( data );
+
+		if ( not data.Create( *this, img.Description(), mem_id, mem_obj->Data(), img.GetQueueFamilyMask(), Default, img.GetDebugName() ))
+		{
+			ReleaseResource( mem_id );
+			_Unassign( oldId );
+			RETURN_ERR( "failed when creating image" );
+		}
+
+		mem_obj->AddRef();
+		data.AddRef();
+
+		// new image takes place of the previous
+		img.SwapMemory( data.Data() );
+		return true;
+	}
+
 /*
 =================================================
 	_CheckHostVisibleMemory
@@ -1430,14 +1769,6 @@ namespace FG
 
 		switch ( usage )
 		{
-			case EBufferUsage::TransferSrc :
-				pool		= &_staging.write;
-				desc.size	= _staging.writeBufPageSize;
-				mem_type	= EMemoryType::HostWrite;
-				idx_mask	= 1u << 30;
-				name		= "HostWriteBuffer";
-				break;
-
 			case EBufferUsage::TransferDst :
 				pool		= &_staging.read;
 				desc.size	= _staging.readBufPageSize;
@@ -1485,10 +1816,6 @@ namespace FG
 
 		switch ( uint(index) >> 30 )
 		{
-			case 1 :
-				_staging.write.Unassign( idx );
-				break;
-
 			case 2 :
 				_staging.read.Unassign( idx );
 				break;
@@ -1515,7 +1842,6 @@ namespace FG
 			ReleaseResource( id.Release() );
 		};
 
-		_staging.write.Release( dtor );
 		_staging.read.Release( dtor );
 	}
 	
@@ -7,8 +7,8 @@
 #include "framegraph/Shared/HashCollisionCheck.h"
 #include "stl/Memory/LinearAllocator.h"
 #include "stl/Containers/ChunkedIndexedPool.h"
-#include "stl/Containers/CachedIndexedPool.h"
 #include "stl/ThreadSafe/LfIndexedPool.h"
+#include "stl/ThreadSafe/LfCachedIndexedPool.h"
 #include "VBuffer.h"
 #include "VImage.h"
 #include "VSampler.h"
@@ -38,36 +38,37 @@ namespace FG
 	public:
 		using Index_t			= RawImageID::Index_t;
 		using AssignOpGuard_t	= Mutex;
-		using CacheGuard_t		= std::shared_mutex;
+		using CacheGuard_t		= Mutex;		// only for insertion and removal, search is lock-free
 
 		template <typename T, size_t ChunkSize, size_t MaxChunks>
 		using PoolTmpl			= ChunkedIndexedPool< T, Index_t, ChunkSize, MaxChunks, UntypedAlignedAllocator, AssignOpGuard_t, AtomicPtr >;
 
 		template <typename T, size_t ChunkSize, size_t MaxChunks>
-		using CachedPoolTmpl	= CachedIndexedPool< T, Index_t, ChunkSize, MaxChunks, UntypedAlignedAllocator, AssignOpGuard_t, CacheGuard_t, AtomicPtr >;
-
-		static constexpr uint	MaxImages		= 1u << 10;
-		static constexpr uint	MaxBuffers		= 1u << 10;
-		static constexpr uint	MaxMemoryObjs	= 1u << 10;
-		static constexpr uint	MaxCached		= 1u << 9;
-		static constexpr uint	MaxRTObjects	= 1u << 9;
-
-		using ImagePool_t			= PoolTmpl<			ResourceBase<VImage>,					MaxImages,		32 >;
-		using BufferPool_t			= PoolTmpl<			ResourceBase<VBuffer>,					MaxBuffers,		32 >;
-		using MemoryPool_t			= PoolTmpl<			ResourceBase<VMemoryObj>,				MaxMemoryObjs,	63 >;
-		using SamplerPool_t			= CachedPoolTmpl<	ResourceBase<VSampler>,					MaxCached,		8 >;
-		using GPipelinePool_t		= PoolTmpl<			ResourceBase<VGraphicsPipeline>,		MaxCached,		8 >;
-		using CPipelinePool_t		= PoolTmpl<			ResourceBase<VComputePipeline>,			MaxCached,		8 >;
-		using MPipelinePool_t		= PoolTmpl<			ResourceBase<VMeshPipeline>,			MaxCached,		8 >;
-		using RTPipelinePool_t		= PoolTmpl<			ResourceBase<VRayTracingPipeline>,		MaxCached,		8 >;
-		using PplnLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VPipelineLayout>,			MaxCached,		8 >;
-		using DSLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VDescriptorSetLayout>,		MaxCached,		8 >;
-		using RenderPassPool_t		= CachedPoolTmpl<	ResourceBase<VRenderPass>,				MaxCached,		8 >;
-		using FramebufferPool_t		= CachedPoolTmpl<	ResourceBase<VFramebuffer>,				MaxCached,		8 >;
-		using PplnResourcesPool_t	= CachedPoolTmpl<	ResourceBase<VPipelineResources>,		MaxCached,		8 >;
-		using RTGeometryPool_t		= PoolTmpl<			ResourceBase<VRayTracingGeometry>,		MaxRTObjects,	16 >;
-		using RTScenePool_t			= PoolTmpl<			ResourceBase<VRayTracingScene>,			MaxRTObjects,	16 >;
-		using RTShaderTablePool_t	= PoolTmpl<			ResourceBase<VRayTracingShaderTable>,	MaxRTObjects,	16 >;
+		using CachedPoolTmpl	= LfCachedIndexedPool< T, Index_t, ChunkSize, MaxChunks, UntypedAlignedAllocator, AssignOpGuard_t, CacheGuard_t, AtomicPtr >;
+
+		// pools grow by chunks on demand, chunks are never moved so indices stay valid while the pool grows.
+		// chunk count only limits the index range, the last 16 bit index is reserved for invalid ID.
+		static constexpr uint	ResChunkSize	= 1u << 10;
+		static constexpr uint	ResMaxChunks	= 63;
+		static constexpr uint	CachedChunkSize	= 1u << 9;
+		static constexpr uint	CachedMaxChunks	= 64;
+
+		using ImagePool_t			= PoolTmpl<			ResourceBase<VImage>,					ResChunkSize,		ResMaxChunks >;
+		using BufferPool_t			= PoolTmpl<			ResourceBase<VBuffer>,					ResChunkSize,		ResMaxChunks >;
+		using MemoryPool_t			= PoolTmpl<			ResourceBase<VMemoryObj>,				ResChunkSize,		ResMaxChunks >;
+		using SamplerPool_t			= CachedPoolTmpl<	ResourceBase<VSampler>,					CachedChunkSize,	CachedMaxChunks >;
+		using GPipelinePool_t		= PoolTmpl<			ResourceBase<VGraphicsPipeline>,		CachedChunkSize,	CachedMaxChunks >;
+		using CPipelinePool_t		= PoolTmpl<			ResourceBase<VComputePipeline>,			CachedChunkSize,	CachedMaxChunks >;
+		using MPipelinePool_t		= PoolTmpl<			ResourceBase<VMeshPipeline>,			CachedChunkSize,	CachedMaxChunks >;
+		using RTPipelinePool_t		= PoolTmpl<			ResourceBase<VRayTracingPipeline>,		CachedChunkSize,	CachedMaxChunks >;
+		using PplnLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VPipelineLayout>,			CachedChunkSize,	CachedMaxChunks >;
+		using DSLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VDescriptorSetLayout>,		CachedChunkSize,	CachedMaxChunks >;
+		using RenderPassPool_t		= CachedPoolTmpl<	ResourceBase<VRenderPass>,				CachedChunkSize,	CachedMaxChunks >;
+		using FramebufferPool_t		= CachedPoolTmpl<	ResourceBase<VFramebuffer>,				CachedChunkSize,	CachedMaxChunks >;
+		using PplnResourcesPool_t	= CachedPoolTmpl<	ResourceBase<VPipelineResources>,		CachedChunkSize,	CachedMaxChunks >;
+		using RTGeometryPool_t		= PoolTmpl<			ResourceBase<VRayTracingGeometry>,		CachedChunkSize,	CachedMaxChunks >;
+		using RTScenePool_t			= PoolTmpl<			ResourceBase<VRayTracingScene>,			CachedChunkSize,	CachedMaxChunks >;
+		using RTShaderTablePool_t	= PoolTmpl<			ResourceBase<VRayTracingShaderTable>,	CachedChunkSize,	CachedMaxChunks >;
 		using SwapchainPool_t		= PoolTmpl<			ResourceBase<VSwapchain>,				64,				1 >;
 		
 		using PipelineCompilers_t	= HashSet< PipelineCompiler >;
@@ -78,6 +79,9 @@ namespace FG
 		using DebugLayoutCache_t	= HashMap< uint, RawDescriptorSetLayoutID >;
 		
 		using StagingBufferfPool_t	= LfIndexedPool< BufferID, uint, 32, 2 >;
+		using BlockUsage_t			= HashMap< VkDeviceMemory, BytesU >;
+		using RelocatedBuffers_t	= Array< Pair< RawBufferID, RawBufferID >>;		// { buffer, buffer with previous memory }
+		using RelocatedImages_t		= Array< Pair< RawImageID, RawImageID >>;		// { image, image with previous memory }
 
 
 	// variables
@@ -125,10 +129,9 @@ namespace FG
 		}							_shaderDbg;
 
 		struct {
-			StagingBufferfPool_t		write;
 			StagingBufferfPool_t		read;
 			StagingBufferfPool_t		uniform;
-			BytesU						writeBufPageSize;
+			BytesU						writeBufPageSize;	// host-to-device memory is allocated in 'VStagingRing', this is a hint for initial size
 			BytesU						readBufPageSize;
 			BytesU						uniformBufPageSize;
 		}							_staging;
@@ -172,6 +175,7 @@ namespace FG
 		ND_ RawImageID			CreateImage (const ImageDesc &desc, const MemoryDesc &mem, EQueueFamilyMask queueFamilyMask, EResourceState defaultState, StringView dbgName);
 		ND_ RawBufferID			CreateBuffer (const BufferDesc &desc, const MemoryDesc &mem, EQueueFamilyMask queueFamilyMask, StringView dbgName);
 		ND_ RawSamplerID		CreateSampler (const SamplerDesc &desc, StringView dbgName);
+		ND_ RawMemoryID			CreateMemory (const VkMemoryRequirements &memReq, const MemoryDesc &mem, StringView dbgName);
 		
 		ND_ RawImageID			CreateImage (const VulkanImageDesc &desc, IFrameGraph::OnExternalImageReleased_t &&onRelease, StringView dbgName);
 		ND_ RawBufferID			CreateBuffer (const VulkanBufferDesc &desc, IFrameGraph::OnExternalBufferReleased_t &&onRelease, StringView dbgName);
@@ -179,7 +183,7 @@ namespace FG
 		ND_ RawRenderPassID		CreateRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses, StringView dbgName);
 		ND_ RawFramebufferID	CreateFramebuffer (ArrayView<Pair<RawImageID, ImageViewDesc>> attachments, RawRenderPassID rp, uint2 dim, uint layers, StringView dbgName);
 
-		ND_ VPipelineResources const*	CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &);
+		ND_ VPipelineResources const*	CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &, INOUT IFrameGraph::ResourceStatistics &);
 			bool						CacheDescriptorSet (INOUT PipelineResources &desc);
 		
 		ND_ RawRTGeometryID		CreateRayTracingGeometry (const RayTracingGeometryDesc &desc, const MemoryDesc &mem, StringView dbgName);
@@ -213,6 +217,7 @@ namespace FG
 
 		ND_ VDevice const&		GetDevice ()				const	{ return _device; }
 		ND_ VMemoryManager&		GetMemoryManager ()					{ return _memoryMngr; }
+		ND_ VMemoryManager const& GetMemoryManager ()		const	{ return _memoryMngr; }
 		ND_ VDescriptorManager&	GetDescriptorManager ()				{ return _descMngr; }
 		
 		ND_ uint				GetSubmitIndex ()			const	{ return _submissionCounter.load( memory_order_relaxed ); }
@@ -232,12 +237,19 @@ namespace FG
 		bool  CreateStagingBuffer (EBufferUsage usage, OUT RawBufferID &id, OUT StagingBufferIdx &index);
 		void  ReleaseStagingBuffer (StagingBufferIdx index);
 
+		bool  DefragmentMemory (BytesU maxBytesToMove, OUT RelocatedBuffers_t &buffers, OUT RelocatedImages_t &images, OUT BytesU &movedSize);
+
 
 	private:
 		bool  _CheckHostVisibleMemory ();
 
 		bool  _CreateMemory (OUT RawMemoryID &id, OUT ResourceBase<VMemoryObj>* &memPtr, const MemoryDesc &desc, StringView dbgName);
 
+		bool  _AllocForRelocation (const VMemoryObj &srcMem, const VkMemoryRequirements &memReq, StringView dbgName, INOUT BlockUsage_t &blockUsage,
+								   OUT RawMemoryID &memId, OUT ResourceBase<VMemoryObj>* &memPtr);
+		bool  _RelocateBuffer (Index_t index, INOUT BlockUsage_t &blockUsage, OUT RawBufferID &oldId);
+		bool  _RelocateImage (Index_t index, INOUT BlockUsage_t &blockUsage, OUT RawImageID &oldId);
+
 		bool  _CreatePipelineLayout (OUT RawPipelineLayoutID &id, OUT ResourceBase<VPipelineLayout> const* &layoutPtr,
 									 PipelineDescription::PipelineLayout &&desc);
 
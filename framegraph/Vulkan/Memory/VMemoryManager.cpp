@@ -1,6 +1,7 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "VMemoryManager.h"
+#include "VDevice.h"
 
 namespace FG
 {
@@ -45,7 +46,7 @@ namespace FG
 		_allocators.push_back(AllocatorPtr{ new HostMemAllocator{ _frameGraph, MT::HostCached | MT::HostRead | MT::ForBuffer } });
 		_allocators.push_back(AllocatorPtr{ new DedicatedMemAllocator{ _frameGraph, MT::LocalInGPU | MT::Dedicated | MT::ForBuffer | MT::ForImage } });
 		_allocators.push_back(AllocatorPtr{ new DeviceMemAllocator{ _frameGraph, MT::LocalInGPU | MT::ForBuffer | MT::ForImage } });
-		_allocators.push_back(AllocatorPtr{ new VirtualMemAllocator{ _frameGraph, MT::LocalInGPU | MT::Virtual | MT::AllowAliasing | MT::ForBuffer | MT::ForImage } });
+		_allocators.push_back(AllocatorPtr{ new VirtualMemAllocator{ _frameGraph, MT::LocalInGPU | MT::Virtual | MT::Transient | MT::ForBuffer | MT::ForImage } });
 #	endif
 		return true;
 	}
@@ -137,6 +138,35 @@ namespace FG
 		RETURN_ERR( "unsupported memory type" );
 	}
 
+/*
+=================================================
+	AllocateMemory
+=================================================
+*/
+	bool VMemoryManager::AllocateMemory (const VkMemoryRequirements &memReq, const MemoryDesc &desc, OUT Storage_t &data)
+	{
+		SHAREDLOCK( _drCheck );
+		ASSERT( not _allocators.empty() );
+
+		for (size_t i = 0; i < _allocators.size(); ++i)
+		{
+			auto&	alloc = _allocators[i];
+
+			if ( alloc->IsSupported( desc.type ) )
+			{
+				*data.Cast<uint>() = uint(i);
+
+				// relocation may fail if there is no free space in existing blocks
+				if ( EnumEq( desc.type, EMemoryTypeExt::Relocation ))
+					return alloc->AllocMemory( memReq, desc, OUT data );
+
+				CHECK_ERR( alloc->AllocMemory( memReq, desc, OUT data ));
+				return true;
+			}
+		}
+		RETURN_ERR( "unsupported memory type" );
+	}
+
 /*
 =================================================
 	Deallocate
@@ -168,6 +198,79 @@ namespace FG
 		CHECK_ERR( _allocators[alloc_id]->GetMemoryInfo( data, OUT info ));
 		return true;
 	}
+	
+/*
+=================================================
+	GetStatistic
+=================================================
+*/
+	void VMemoryManager::GetStatistic (INOUT ResourceStatistics_t &stat) const
+	{
+		SHAREDLOCK( _drCheck );
+
+		_GetHeapInfo( OUT stat.memoryHeaps );
+
+		for (auto& alloc : _allocators) {
+			alloc->GetStatistic( INOUT stat );
+		}
+	}
+	
+/*
+=================================================
+	GetHeapUsage
+=================================================
+*/
+	void VMemoryManager::GetHeapUsage (OUT MemoryHeaps_t &heaps) const
+	{
+		SHAREDLOCK( _drCheck );
+
+		_GetHeapInfo( OUT heaps );
+
+		for (auto& alloc : _allocators) {
+			alloc->GetHeapUsage( INOUT heaps );
+		}
+	}
+	
+/*
+=================================================
+	_GetHeapInfo
+----
+	heap size and budget, budget is updated by driver
+	in 'vkGetPhysicalDeviceMemoryProperties2' call.
+=================================================
+*/
+	void VMemoryManager::_GetHeapInfo (OUT MemoryHeaps_t &heaps) const
+	{
+		const auto&		mem_props = _device.GetDeviceMemoryProperties();
+
+		heaps.resize( Min( mem_props.memoryHeapCount, uint(heaps.capacity()) ));
+
+		for (size_t i = 0; i < heaps.size(); ++i)
+		{
+			auto&	heap = heaps[i];
+			heap				= Default;
+			heap.size			= BytesU(mem_props.memoryHeaps[i].size);
+			heap.isDeviceLocal	= EnumEq( mem_props.memoryHeaps[i].flags, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT );
+		}
+
+		if ( not _device.IsMemoryBudgetEnabled() )
+			return;
+
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT	budget_props = {};
+		budget_props.sType	= VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2			mem_props2 = {};
+		mem_props2.sType	= VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		mem_props2.pNext	= &budget_props;
+
+		vkGetPhysicalDeviceMemoryProperties2( _device.GetVkPhysicalDevice(), OUT &mem_props2 );
+
+		for (size_t i = 0; i < heaps.size(); ++i)
+		{
+			heaps[i].budget	= BytesU(budget_props.heapBudget[i]);
+			heaps[i].usage	= BytesU(budget_props.heapUsage[i]);
+		}
+	}
 
 
 }	// FG
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "framegraph/Public/FrameGraph.h"
 #include "VMemoryObj.h"
 
 namespace FG
@@ -15,8 +16,10 @@ namespace FG
 	{
 	// types
 	protected:
-		using Storage_t		= VMemoryObj::Storage_t;
-		using MemoryInfo_t	= VMemoryObj::MemoryInfo;
+		using Storage_t				= VMemoryObj::Storage_t;
+		using MemoryInfo_t			= VMemoryObj::MemoryInfo;
+		using ResourceStatistics_t	= IFrameGraph::ResourceStatistics;
+		using MemoryHeaps_t			= decltype(ResourceStatistics_t::memoryHeaps);
 
 		class DedicatedMemAllocator;
 		class HostMemAllocator;
@@ -36,10 +39,16 @@ namespace FG
 			virtual bool AllocForImage (VkImage image, const MemoryDesc &desc, OUT Storage_t &data) = 0;
 			virtual bool AllocForBuffer (VkBuffer buffer, const MemoryDesc &desc, OUT Storage_t &data) = 0;
 			virtual bool AllocForAccelStruct (VkAccelerationStructureNV as, const MemoryDesc &desc, OUT Storage_t &data) = 0;
+			virtual bool AllocMemory (const VkMemoryRequirements &memReq, const MemoryDesc &desc, OUT Storage_t &data) = 0;
 
 			virtual bool Dealloc (INOUT Storage_t &data) = 0;
 			
 			virtual bool GetMemoryInfo (const Storage_t &data, OUT MemoryInfo_t &info) const = 0;
+
+			virtual void GetStatistic (INOUT ResourceStatistics_t &) const = 0;
+
+			// lock-free, used and allocation count only
+			virtual void GetHeapUsage (INOUT MemoryHeaps_t &) const = 0;
 		};
 
 		using AllocatorPtr	= UniquePtr< IMemoryAllocator >;
@@ -65,13 +74,22 @@ namespace FG
 		virtual bool AllocateForImage (VkImage image, const MemoryDesc &desc, OUT Storage_t &data);
 		virtual bool AllocateForBuffer (VkBuffer buffer, const MemoryDesc &desc, OUT Storage_t &data);
 		virtual bool AllocateForAccelStruct (VkAccelerationStructureNV as, const MemoryDesc &desc, OUT Storage_t &data);
+		virtual bool AllocateMemory (const VkMemoryRequirements &memReq, const MemoryDesc &desc, OUT Storage_t &data);
 		virtual bool Deallocate (INOUT Storage_t &data);
 
 		virtual bool GetMemoryInfo (const Storage_t &data, OUT MemoryInfo_t &info) const;
 
+		// high-water marks will be reset to current usage
+		virtual void GetStatistic (INOUT ResourceStatistics_t &) const;
+
+		// fast path for budget check, doesn't reset statistic
+		virtual void GetHeapUsage (OUT MemoryHeaps_t &) const;
+
 
 	private:
 		ND_ AllocatorPtr  _CreateVMA ();
+
+		void _GetHeapInfo (OUT MemoryHeaps_t &) const;
 	};
 
 
@@ -56,11 +56,21 @@ namespace FG
 			VmaAllocation	allocation;
 		};
 
+		// updated on allocation and deallocation, can be read without locks
+		struct HeapCounters
+		{
+			Atomic<uint64_t>	used			{0};
+			Atomic<uint64_t>	highWaterMark	{0};
+			Atomic<uint>		allocationCount	{0};
+		};
+		using HeapCounters_t	= StaticArray< HeapCounters, VK_MAX_MEMORY_HEAPS >;
+
 
 	// variables
 	private:
-		VDevice const&		_device;
-		VmaAllocator		_allocator;
+		VDevice const&			_device;
+		VmaAllocator			_allocator;
+		mutable HeapCounters_t	_heapCounters;
 
 
 	// methods
@@ -73,14 +83,20 @@ namespace FG
 		bool AllocForImage (VkImage image, const MemoryDesc &mem, OUT Storage_t &data) override;
 		bool AllocForBuffer (VkBuffer buffer, const MemoryDesc &mem, OUT Storage_t &data) override;
 		bool AllocForAccelStruct (VkAccelerationStructureNV as, const MemoryDesc &desc, OUT Storage_t &data) override;
+		bool AllocMemory (const VkMemoryRequirements &memReq, const MemoryDesc &desc, OUT Storage_t &data) override;
 
 		bool Dealloc (INOUT Storage_t &data) override;
 		
 		bool GetMemoryInfo (const Storage_t &data, OUT MemoryInfo_t &info) const override;
 
+		void GetStatistic (INOUT ResourceStatistics_t &) const override;
+		void GetHeapUsage (INOUT MemoryHeaps_t &) const override;
+
 	private:
 		bool _CreateAllocator (OUT VmaAllocator &alloc) const;
 
+		void _UpdateHeapCounters (VmaAllocation mem, bool allocated);
+
 		ND_ static Data *					_CastStorage (Storage_t &data);
 		ND_ static Data const*				_CastStorage (const Storage_t &data);
 		
@@ -193,6 +209,8 @@ namespace FG
 
 		VK_CHECK( vmaBindImageMemory( _allocator, mem, image ));
 		
+		_UpdateHeapCounters( mem, true );
+
 		_CastStorage( data )->allocation = mem;
 		return true;
 	}
@@ -240,6 +258,8 @@ namespace FG
 
 		VK_CHECK( vmaBindBufferMemory( _allocator, mem, buffer ));
 		
+		_UpdateHeapCounters( mem, true );
+
 		_CastStorage( data )->allocation = mem;
 		return true;
 	}
@@ -284,6 +304,50 @@ namespace FG
 		bind_info.memoryOffset			= alloc_info.offset;
 		VK_CHECK( _device.vkBindAccelerationStructureMemoryNV( _device.GetVkDevice(), 1, &bind_info ));
 
+		_UpdateHeapCounters( mem, true );
+
+		_CastStorage( data )->allocation = mem;
+		return true;
+	}
+
+/*
+=================================================
+	AllocMemory
+----
+	allocates memory without binding,
+	suballocation type is unknown so memory can be used for both linear and optimal resources.
+=================================================
+*/
+	bool VMemoryManager::VulkanMemoryAllocator::AllocMemory (const VkMemoryRequirements &memReq, const MemoryDesc &desc, OUT Storage_t &data)
+	{
+		VmaAllocationCreateInfo		info = {};
+		info.flags			= _ConvertToMemoryFlags( desc.type );
+		info.usage			= _ConvertToMemoryUsage( desc.type );
+		info.requiredFlags	= _ConvertToMemoryProperties( desc.type );
+		info.preferredFlags	= 0;
+		info.memoryTypeBits	= 0;
+		info.pool			= VK_NULL_HANDLE;
+		info.pUserData		= null;
+		
+		CHECK_ERR( memReq.memoryTypeBits != 0 );
+
+		// because used private api
+	    VMA_DEBUG_GLOBAL_MUTEX_LOCK
+
+		VmaAllocation	mem = null;
+		VkResult		err = _allocator->AllocateMemory( memReq, false, false, VK_NULL_HANDLE, VK_NULL_HANDLE, info, VMA_SUBALLOCATION_TYPE_UNKNOWN, 1, OUT &mem );
+
+		// there may be no free space in existing blocks, it is not an error
+		if ( err == VK_ERROR_OUT_OF_DEVICE_MEMORY and EnumEq( desc.type, EMemoryTypeExt::Relocation ))
+		{
+			_CastStorage( data )->allocation = null;
+			return false;
+		}
+
+		VK_CHECK( err );
+
+		_UpdateHeapCounters( mem, true );
+
 		_CastStorage( data )->allocation = mem;
 		return true;
 	}
@@ -297,6 +361,9 @@ namespace FG
 	{
 		VmaAllocation&	mem = _CastStorage( data )->allocation;
 
+		if ( mem )
+			_UpdateHeapCounters( mem, false );
+
 		vmaFreeMemory( _allocator, mem );
 
 		mem = null;
@@ -325,6 +392,85 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	GetStatistic
+=================================================
+*/
+	void VMemoryManager::VulkanMemoryAllocator::GetStatistic (INOUT ResourceStatistics_t &stat) const
+	{
+		VmaStats	vma_stat = {};
+		vmaCalculateStats( _allocator, OUT &vma_stat );
+
+		const VmaStatInfo&	total = vma_stat.total;
+
+		stat.memoryBlockCount		+= total.blockCount;
+		stat.memoryUsed				+= BytesU(total.usedBytes);
+		stat.memoryUnused			+= BytesU(total.unusedBytes);
+		stat.memoryLargestFreeRange	 = Max( stat.memoryLargestFreeRange, BytesU(total.unusedRangeCount ? total.unusedRangeSizeMax : 0) );
+
+		GetHeapUsage( INOUT stat.memoryHeaps );
+
+		for (size_t i = 0; i < stat.memoryHeaps.size(); ++i)
+		{
+			const VmaStatInfo&	heap = vma_stat.memoryHeap[i];
+
+			stat.memoryHeaps[i].allocated += BytesU(heap.usedBytes + heap.unusedBytes);
+
+			// reset high-water mark
+			auto&	counters = _heapCounters[i];
+			counters.highWaterMark.store( counters.used.load( memory_order_relaxed ), memory_order_relaxed );
+		}
+	}
+
+/*
+=================================================
+	GetHeapUsage
+=================================================
+*/
+	void VMemoryManager::VulkanMemoryAllocator::GetHeapUsage (INOUT MemoryHeaps_t &heaps) const
+	{
+		for (size_t i = 0; i < heaps.size(); ++i)
+		{
+			auto&	counters = _heapCounters[i];
+			auto&	heap	 = heaps[i];
+
+			heap.used				+= BytesU(counters.used.load( memory_order_relaxed ));
+			heap.highWaterMark		+= BytesU(counters.highWaterMark.load( memory_order_relaxed ));
+			heap.allocationCount	+= counters.allocationCount.load( memory_order_relaxed );
+		}
+	}
+
+/*
+=================================================
+	_UpdateHeapCounters
+=================================================
+*/
+	void VMemoryManager::VulkanMemoryAllocator::_UpdateHeapCounters (VmaAllocation mem, bool allocated)
+	{
+		VmaAllocationInfo	alloc_info	= {};
+		vmaGetAllocationInfo( _allocator, mem, OUT &alloc_info );
+		
+		const auto&		mem_props = _device.GetDeviceMemoryProperties();
+		ASSERT( alloc_info.memoryType < mem_props.memoryTypeCount );
+
+		auto&	counters = _heapCounters[ mem_props.memoryTypes[ alloc_info.memoryType ].heapIndex ];
+
+		if ( not allocated )
+		{
+			counters.used.fetch_sub( alloc_info.size, memory_order_relaxed );
+			counters.allocationCount.fetch_sub( 1, memory_order_relaxed );
+			return;
+		}
+		
+		const uint64_t	used	= counters.used.fetch_add( alloc_info.size, memory_order_relaxed ) + alloc_info.size;
+		uint64_t		hwm		= counters.highWaterMark.load( memory_order_relaxed );
+
+		counters.allocationCount.fetch_add( 1, memory_order_relaxed );
+
+		for (; hwm < used and not counters.highWaterMark.compare_exchange_weak( INOUT hwm, used, memory_order_relaxed );) {}
+	}
+
 /*
 =================================================
 	_ConvertToMemoryFlags
@@ -340,7 +486,8 @@ namespace FG
 		if ( EnumEq( memType, EMemoryTypeExt::HostRead ) or EnumEq( memType, EMemoryTypeExt::HostWrite ))
 			result |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-		// TODO: VMA_ALLOCATION_CREATE_NEVER_ALLOCATE_BIT
+		if ( EnumEq( memType, EMemoryTypeExt::Relocation ))
+			result |= VMA_ALLOCATION_CREATE_NEVER_ALLOCATE_BIT;
 
 		return result;
 	}
@@ -385,14 +532,15 @@ namespace FG
 				case EMemoryTypeExt::HostCoherent :		flags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;	break;
 				case EMemoryTypeExt::HostCached :		flags |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;	break;
 				case EMemoryTypeExt::Dedicated :
-				//case EMemoryTypeExt::AllowAliasing :
+				case EMemoryTypeExt::Transient :
 				//case EMemoryTypeExt::Sparse :
 				case EMemoryTypeExt::ForBuffer :
 				case EMemoryTypeExt::ForImage :			break;
 				case EMemoryTypeExt::_Last :
 				case EMemoryTypeExt::All :
 				case EMemoryTypeExt::HostVisible :
-				case EMemoryTypeExt::Virtual :			break;	// to shutup warnings
+				case EMemoryTypeExt::Virtual :
+				case EMemoryTypeExt::Relocation :		break;	// to shutup warnings
 				default :								RETURN_ERR( "unknown memory type flag!" );
 			}
 			END_ENUM_CHECKS();
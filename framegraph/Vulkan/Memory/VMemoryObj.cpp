@@ -70,6 +70,18 @@ namespace FG
 		return true;
 	}
 
+/*
+=================================================
+	AllocateMemory
+=================================================
+*/
+	bool VMemoryObj::AllocateMemory (VMemoryManager &memMngr, const VkMemoryRequirements &memReq)
+	{
+		EXLOCK( _drCheck );
+		
+		return memMngr.AllocateMemory( memReq, _desc, INOUT _storage );
+	}
+
 /*
 =================================================
 	Destroy
@@ -79,7 +91,9 @@ namespace FG
 	{
 		EXLOCK( _drCheck );
 
-		resMngr.GetMemoryManager().Deallocate( INOUT _storage );
+		// transient resource is bound to the memory that is owned by command batch
+		if ( not EnumEq( _desc.type, EMemoryType::Transient ))
+			resMngr.GetMemoryManager().Deallocate( INOUT _storage );
 
 		_debugName.clear();
 	}
@@ -92,6 +106,7 @@ namespace FG
 	bool VMemoryObj::GetInfo (VMemoryManager &memMngr, OUT MemoryInfo &info) const
 	{
 		SHAREDLOCK( _drCheck );
+		CHECK_ERR( not EnumEq( _desc.type, EMemoryType::Transient ));
 
 		return memMngr.GetMemoryInfo( _storage, OUT info );
 	}
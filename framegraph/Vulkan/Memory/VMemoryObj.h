@@ -50,11 +50,12 @@ namespace FG
 		bool AllocateForImage (VMemoryManager &, VkImage);
 		bool AllocateForBuffer (VMemoryManager &, VkBuffer);
 		bool AllocateForAccelStruct (VMemoryManager &, VkAccelerationStructureNV);
+		bool AllocateMemory (VMemoryManager &, const VkMemoryRequirements &);
 
 		bool GetInfo (VMemoryManager &, OUT MemoryInfo &) const;
 
-		//ND_ MemoryDesc const&	Description ()	const	{ SHAREDLOCK( _drCheck );  return _desc; }
-		ND_ EMemoryTypeExt	MemoryType ()		const	{ SHAREDLOCK( _drCheck );  return EMemoryTypeExt(_desc.type); }
+		ND_ MemoryDesc const&	Description ()	const	{ SHAREDLOCK( _drCheck );  return _desc; }
+		ND_ EMemoryTypeExt		MemoryType ()	const	{ SHAREDLOCK( _drCheck );  return EMemoryTypeExt(_desc.type); }
 	};
 
 
@@ -0,0 +1,341 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VStagingRing.h"
+#include "VResourceManager.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	VStagingRing::~VStagingRing ()
+	{
+		CHECK( _rings.empty() );
+		CHECK( _blocks.empty() );
+	}
+
+/*
+=================================================
+	Initialize
+=================================================
+*/
+	void  VStagingRing::Initialize (BytesU initialSize, BytesU nonCoherentAtomSize)
+	{
+		EXLOCK( _guard );
+		ASSERT( _rings.empty() );
+
+		_blockAlign		= Max( nonCoherentAtomSize, 1_b );
+		_initialSize	= AlignToLarger( initialSize, _blockAlign );
+	}
+
+/*
+=================================================
+	Deinitialize
+=================================================
+*/
+	void  VStagingRing::Deinitialize (VResourceManager &rm)
+	{
+		EXLOCK( _guard );
+		CHECK( _blocks.empty() );
+
+		for (auto& ring : _rings) {
+			rm.ReleaseResource( ring.bufferId );
+		}
+
+		_rings.clear();
+		_blocks.clear();
+		_firstBlockUID	= 0;
+		_firstRingUID	= 0;
+		_usedSize		= 0_b;
+		_highWaterMark	= 0_b;
+		_growCount		= 0;
+		_recentPeak		= 0_b;
+		_lowUsageCount	= 0;
+	}
+
+/*
+=================================================
+	Allocate
+----
+	allocated size is less than 'size' only if there is
+	contiguous free space that is not less than 'minSize',
+	otherwise ring grows so that request is not splitted.
+=================================================
+*/
+	bool  VStagingRing::Allocate (VResourceManager &rm, BytesU size, BytesU minSize, BytesU blockAlign, BytesU offsetAlign, INOUT Array<Block> &blocks,
+								  OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &outSize, OUT void* &mappedPtr)
+	{
+		EXLOCK( _guard );
+		ASSERT( size > 0_b and offsetAlign > 0_b and blockAlign > 0_b );
+		ASSERT( minSize <= size );
+
+		const Request	req		 { size, Max( minSize, blockAlign ), blockAlign };
+		const uint64_t	next_uid = _firstBlockUID + _blocks.size();
+		BytesU			offset;
+
+		// extend last block, allowed only if there are no other allocations after it
+		if ( blocks.size() and blocks.back().uid + 1 == next_uid and _rings.size() )
+		{
+			Block&		last	= blocks.back();
+			BlockInfo&	info	= _blocks.back();
+			RingBuffer&	ring	= _rings.back();
+
+			if ( info.ring == _firstRingUID + _rings.size() - 1 and
+				 _AllocInRing( ring, req, offsetAlign, false, OUT offset, OUT outSize ))
+			{
+				const BytesU	end = AlignToLarger( offset + outSize, _blockAlign );
+
+				_usedSize		+= (end - info.end);
+				_highWaterMark	 = Max( _highWaterMark, _usedSize );
+				_recentPeak		 = Max( _recentPeak, _usedSize );
+
+				info.end	= end;
+				last.end	= end;
+				ring.head	= end;
+
+				dstBuffer	= ring.bufferId;
+				dstOffset	= offset;
+				mappedPtr	= ring.mappedPtr + offset;
+				return true;
+			}
+		}
+
+		// allocate new block
+		const BytesU	align = Max( offsetAlign, _blockAlign );
+
+		if ( _lowUsageCount >= ShrinkDelay and _rings.size() )
+		{
+			// ring is too large for current upload volume
+			_lowUsageCount = 0;
+			CHECK_ERR( _CreateRing( rm, Max( _initialSize, _rings.back().capacity / 2 )));
+		}
+
+		if ( _rings.empty() or not _AllocInRing( _rings.back(), req, align, true, OUT offset, OUT outSize ))
+		{
+			// ring is too small for current upload volume
+			BytesU	new_size = _rings.empty() ? _initialSize : _rings.back().capacity * 2;
+
+			for (; new_size < _usedSize + size + align;) {
+				new_size *= 2;
+			}
+
+			if ( _rings.size() )
+				++_growCount;
+
+			_lowUsageCount = 0;
+			CHECK_ERR( _CreateRing( rm, new_size ));
+			CHECK_ERR( _AllocInRing( _rings.back(), req, align, true, OUT offset, OUT outSize ));
+		}
+
+		RingBuffer&		ring	= _rings.back();
+		const BytesU	end		= AlignToLarger( offset + outSize, _blockAlign );
+
+		if ( ring.blockCount == 0 )
+			ring.tail = offset;
+
+		ring.head = end;
+		++ring.blockCount;
+
+		_blocks.push_back({ uint(_firstRingUID + _rings.size() - 1), offset, end, false });
+		_usedSize		+= (end - offset);
+		_highWaterMark	 = Max( _highWaterMark, _usedSize );
+		_recentPeak		 = Max( _recentPeak, _usedSize );
+
+		Block&	block	= blocks.emplace_back();
+		block.uid		= next_uid;
+		block.bufferId	= ring.bufferId;
+		block.mem		= ring.mem;
+		block.memOffset	= ring.memOffset;
+		block.begin		= offset;
+		block.end		= end;
+		block.isCoherent= ring.isCoherent;
+
+		dstBuffer	= ring.bufferId;
+		dstOffset	= offset;
+		mappedPtr	= ring.mappedPtr + offset;
+		return true;
+	}
+
+/*
+=================================================
+	_AllocInRing
+----
+	free space is between head and end of the buffer and between begin of the buffer and tail,
+	space that fits whole request is preferred, otherwise the largest part is used
+	if it is not less than minimal size.
+=================================================
+*/
+	bool  VStagingRing::_AllocInRing (RingBuffer &ring, const Request &req, BytesU align, bool allowWrap, OUT BytesU &offset, OUT BytesU &outSize) const
+	{
+		if ( ring.blockCount == 0 )
+		{
+			ring.head = ring.tail = 0_b;
+		}
+
+		BytesU	first_off	= AlignToLarger( ring.head, align );
+		BytesU	first_size	= 0_b;
+		BytesU	second_size	= 0_b;
+
+		if ( ring.blockCount == 0 or ring.head > ring.tail )
+		{
+			first_size = ring.capacity - Min( first_off, ring.capacity );
+
+			if ( allowWrap )
+				second_size = ring.blockCount == 0 ? ring.capacity : ring.tail;
+		}
+		else
+			first_size = ring.tail - Min( first_off, ring.tail );
+
+		// whole request
+		if ( first_size >= req.size or second_size >= req.size )
+		{
+			offset	= first_size >= req.size ? first_off : 0_b;
+			outSize	= req.size;
+			return true;
+		}
+
+		// largest part
+		first_size	= AlignToSmaller( first_size, req.blockAlign );
+		second_size	= AlignToSmaller( second_size, req.blockAlign );
+
+		if ( Max( first_size, second_size ) >= req.minSize )
+		{
+			offset	= first_size >= second_size ? first_off : 0_b;
+			outSize	= Max( first_size, second_size );
+			return true;
+		}
+		return false;
+	}
+
+/*
+=================================================
+	Release
+=================================================
+*/
+	void  VStagingRing::Release (VResourceManager &rm, ArrayView<Block> blocks)
+	{
+		if ( blocks.empty() )
+			return;
+
+		EXLOCK( _guard );
+
+		for (auto& block : blocks)
+		{
+			ASSERT( block.uid >= _firstBlockUID and block.uid < _firstBlockUID + _blocks.size() );
+
+			BlockInfo&	info = _blocks[ size_t(block.uid - _firstBlockUID) ];
+			ASSERT( not info.released );
+
+			info.released	= true;
+			_usedSize		-= (info.end - info.begin);
+		}
+
+		// ring will be shrinked in 'Allocate' if it stays mostly unused
+		if ( _rings.size() and _rings.back().capacity > _initialSize and _recentPeak < _rings.back().capacity / 4 )
+			++_lowUsageCount;
+		else
+			_lowUsageCount = 0;
+
+		_recentPeak = _usedSize;
+
+		// move tail over released blocks
+		size_t	count = 0;
+		for (; count < _blocks.size() and _blocks[count].released; ++count)
+		{
+			RingBuffer&	ring = _rings[ size_t(_blocks[count].ring - _firstRingUID) ];
+			--ring.blockCount;
+		}
+
+		if ( count == 0 )
+			return;
+
+		_blocks.erase( _blocks.begin(), _blocks.begin() + count );
+		_firstBlockUID += count;
+
+		if ( _blocks.size() )
+		{
+			auto&	first = _blocks.front();
+			_rings[ size_t(first.ring - _firstRingUID) ].tail = first.begin;
+		}
+
+		_ReleaseRings( rm );
+	}
+
+/*
+=================================================
+	_ReleaseRings
+----
+	destroy previous rings that are not used anymore,
+	rings are released in creation order because blocks are released in allocation order.
+=================================================
+*/
+	void  VStagingRing::_ReleaseRings (VResourceManager &rm)
+	{
+		for (; _rings.size() > 1 and _rings.front().blockCount == 0;)
+		{
+			rm.ReleaseResource( _rings.front().bufferId );
+			_rings.erase( _rings.begin() );
+			++_firstRingUID;
+		}
+	}
+
+/*
+=================================================
+	_CreateRing
+=================================================
+*/
+	bool  VStagingRing::_CreateRing (VResourceManager &rm, BytesU size)
+	{
+		// previous rings may be still in use by the GPU
+		_ReleaseRings( rm );
+
+		size = AlignToLarger( size, _blockAlign );
+
+		RawBufferID		buf_id = rm.CreateBuffer( BufferDesc{ size, EBufferUsage::TransferSrc }, MemoryDesc{ EMemoryType::HostWrite },
+												  EQueueFamilyMask::Unknown, "HostWriteRing" );
+		CHECK_ERR( buf_id );
+
+		VMemoryObj::MemoryInfo	info;
+		VMemoryObj const*		mem = rm.GetResource( rm.GetResource( buf_id )->GetMemoryID() );
+
+		if ( not (mem and mem->GetInfo( rm.GetMemoryManager(), OUT info ) and info.mappedPtr) )
+		{
+			rm.ReleaseResource( buf_id );
+			RETURN_ERR( "failed to map staging ring buffer" );
+		}
+
+		auto&	ring = _rings.emplace_back();
+		ring.bufferId	= buf_id;
+		ring.mem		= info.mem;
+		ring.memOffset	= info.offset;
+		ring.mappedPtr	= info.mappedPtr;
+		ring.capacity	= size;
+		ring.isCoherent	= EnumEq( info.flags, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT );
+		return true;
+	}
+
+/*
+=================================================
+	GetStatistic
+=================================================
+*/
+	void  VStagingRing::GetStatistic (INOUT ResourceStatistics_t &stat)
+	{
+		EXLOCK( _guard );
+
+		for (auto& ring : _rings) {
+			stat.stagingBufferSize += ring.capacity;
+		}
+		stat.stagingHighWaterMark	+= _highWaterMark;
+		stat.stagingBufferUsed		+= _usedSize;
+		stat.stagingRingGrowCount	+= _growCount;
+
+		_highWaterMark	= _usedSize;
+		_growCount		= 0;
+	}
+
+
+}	// FG
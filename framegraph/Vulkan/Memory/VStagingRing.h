@@ -0,0 +1,126 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Host-to-device staging memory for a single queue.
+
+	Persistently mapped buffer is used as ring, each command batch allocates contiguous blocks
+	from the head and blocks are returned when batch is completed on the GPU,
+	tail is moved only over released blocks so memory is reused in allocation order.
+
+	If there is no free space then ring is replaced by larger one,
+	previous buffer is destroyed when all its blocks are released.
+	If usage stays below a quarter of capacity for 'ShrinkDelay' completed batches
+	then ring is replaced by smaller one in the same way.
+	Request is splitted only if there is free space for the minimal size that caller allows,
+	otherwise ring grows and request fits into single block.
+*/
+
+#pragma once
+
+#include "framegraph/Public/FrameGraph.h"
+#include "VCommon.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Staging Ring Buffer
+	//
+
+	class VStagingRing final
+	{
+	// types
+	public:
+		struct Block
+		{
+			uint64_t		uid			= UMax;		// unique block index
+			RawBufferID		bufferId;
+			VkDeviceMemory	mem			= VK_NULL_HANDLE;
+			BytesU			memOffset;				// offset of ring buffer in device memory
+			BytesU			begin;
+			BytesU			end;
+			bool			isCoherent	= false;
+		};
+
+		using ResourceStatistics_t	= IFrameGraph::ResourceStatistics;
+
+	private:
+		struct RingBuffer
+		{
+			RawBufferID		bufferId;
+			VkDeviceMemory	mem			= VK_NULL_HANDLE;
+			BytesU			memOffset;
+			void *			mappedPtr	= null;
+			BytesU			capacity;
+			BytesU			head;					// next allocation starts from here
+			BytesU			tail;					// begin of the oldest unreleased block
+			uint			blockCount	= 0;		// number of blocks in '_blocks'
+			bool			isCoherent	= false;
+		};
+
+		struct BlockInfo
+		{
+			uint			ring;					// ring uid
+			BytesU			begin;
+			BytesU			end;
+			bool			released	= false;
+		};
+
+		struct Request
+		{
+			BytesU			size;
+			BytesU			minSize;				// request may be splitted into parts that are not less than this size
+			BytesU			blockAlign;				// size of each part is aligned to this value
+		};
+
+		using Rings_t	= Array< RingBuffer >;
+
+		static constexpr uint	ShrinkDelay	= 128;
+
+
+	// variables
+	private:
+		Mutex				_guard;
+		Rings_t				_rings;					// last is active, other rings are waiting until all blocks are released
+		Array<BlockInfo>	_blocks;				// in allocation order
+		uint64_t			_firstBlockUID	= 0;	// uid of '_blocks.front()'
+		uint				_firstRingUID	= 0;	// uid of '_rings.front()'
+
+		BytesU				_initialSize;
+		BytesU				_blockAlign;			// to flush non-coherent memory
+
+		// statistic
+		BytesU				_usedSize;				// sum of all unreleased blocks
+		BytesU				_highWaterMark;
+		uint				_growCount		= 0;
+
+		// shrink policy
+		BytesU				_recentPeak;			// max used size since last 'Release'
+		uint				_lowUsageCount	= 0;	// number of releases while usage is below a quarter of capacity
+
+
+	// methods
+	public:
+		VStagingRing () {}
+		~VStagingRing ();
+
+		void  Initialize (BytesU initialSize, BytesU nonCoherentAtomSize);
+		void  Deinitialize (VResourceManager &);
+
+		// extends last block if possible, otherwise adds new block
+		ND_ bool  Allocate (VResourceManager &, BytesU size, BytesU minSize, BytesU blockAlign, BytesU offsetAlign, INOUT Array<Block> &blocks,
+							OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &outSize, OUT void* &mappedPtr);
+
+		// must be called when GPU has finished using blocks
+			void  Release (VResourceManager &, ArrayView<Block> blocks);
+
+		// high-water mark will be reset to current usage
+			void  GetStatistic (INOUT ResourceStatistics_t &);
+
+	private:
+		ND_ bool  _AllocInRing (RingBuffer &ring, const Request &req, BytesU align, bool allowWrap, OUT BytesU &offset, OUT BytesU &outSize) const;
+		ND_ bool  _CreateRing (VResourceManager &, BytesU size);
+			void  _ReleaseRings (VResourceManager &);
+	};
+
+
+}	// FG
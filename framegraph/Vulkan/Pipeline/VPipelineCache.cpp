@@ -9,6 +9,88 @@
 
 namespace FG
 {
+namespace
+{
+	//
+	// Pipeline Cache File Header
+	//
+	struct PipelineCacheHeader
+	{
+		static constexpr uint	Magic	= 0x43504746;	// 'FGPC'
+		static constexpr uint	Version	= 1;
+
+		uint		magic;
+		uint		version;
+		uint		vendorID;
+		uint		deviceID;
+		uint		driverVersion;
+		uint8_t		pipelineCacheUUID [VK_UUID_SIZE];
+		uint64_t	featuresHash;
+		uint64_t	dataSize;
+		uint64_t	dataHash;
+	};
+
+
+	//
+	// Pipeline Creation Feedback
+	//
+	struct PipelineFeedback
+	{
+		VkPipelineCreationFeedbackCreateInfoEXT				info		{};
+		VkPipelineCreationFeedbackEXT						pipeline	{};
+		StaticArray< VkPipelineCreationFeedbackEXT, 32 >	stages		{};
+
+		PipelineFeedback (const VDevice &dev, uint stageCount, INOUT const void* &pNext)
+		{
+			if ( not dev.IsPipelineFeedbackEnabled() or stageCount > stages.size() )
+				return;
+
+			info.sType								= VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+			info.pNext								= pNext;
+			info.pPipelineCreationFeedback			= &pipeline;
+			info.pipelineStageCreationFeedbackCount	= stageCount;
+			info.pPipelineStageCreationFeedbacks	= stages.data();
+			pNext = &info;
+		}
+
+		void  UpdateStatistic (INOUT IFrameGraph::ResourceStatistics &stat) const
+		{
+			if ( not (pipeline.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) )
+				return;
+
+			if ( pipeline.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT )
+				stat.pipelineCacheHits++;
+			else
+				stat.pipelineCacheMisses++;
+		}
+	};
+	
+/*
+=================================================
+	InitCacheHeader
+=================================================
+*/
+	void  InitCacheHeader (const VDevice &dev, OUT PipelineCacheHeader &header)
+	{
+		auto&	props = dev.GetDeviceProperties();
+
+		memset( OUT &header, 0, sizeof(header) );
+		header.magic			= PipelineCacheHeader::Magic;
+		header.version			= PipelineCacheHeader::Version;
+		header.vendorID			= props.vendorID;
+		header.deviceID			= props.deviceID;
+		header.driverVersion	= props.driverVersion;
+		memcpy( OUT header.pipelineCacheUUID, props.pipelineCacheUUID, sizeof(header.pipelineCacheUUID) );
+
+		const uint	ext_flags	= (uint(dev.IsMeshShaderEnabled())		 << 0) |
+								  (uint(dev.IsRayTracingEnabled())		 << 1) |
+								  (uint(dev.IsShadingRateImageEnabled()) << 2);
+
+		header.featuresHash = StableHashOf( &dev.GetDeviceFeatures(), sizeof(VkPhysicalDeviceFeatures) );
+		header.featuresHash = StableHashOf( &ext_flags, sizeof(ext_flags), header.featuresHash );
+	}
+
+}	// namespace
 
 /*
 =================================================
@@ -16,7 +98,8 @@ namespace FG
 =================================================
 */
 	VPipelineCache::VPipelineCache () :
-		_pipelinesCache{ VK_NULL_HANDLE }
+		_pipelinesCache{ VK_NULL_HANDLE },
+		_isModified{ false }
 	{
 		const uint	max_stages = 32;
 
@@ -42,9 +125,9 @@ namespace FG
 	Initialize
 =================================================
 */
-	bool VPipelineCache::Initialize (const VDevice &dev)
+	bool VPipelineCache::Initialize (const VDevice &dev, ArrayView<uint8_t> initialData)
 	{
-		CHECK_ERR( _CreatePipelineCache( dev ));
+		CHECK_ERR( _CreatePipelineCache( dev, initialData ));
 		return true;
 	}
 	
@@ -60,17 +143,71 @@ namespace FG
 			dev.vkDestroyPipelineCache( dev.GetVkDevice(), _pipelinesCache, null );
 			_pipelinesCache = VK_NULL_HANDLE;
 		}
+		_isModified = false;
 	}
 
 /*
 =================================================
-	MergeCache
+	SerializeCache
 =================================================
 */
-	bool VPipelineCache::MergeCache (VPipelineCache &)
+	bool VPipelineCache::SerializeCache (const VDevice &dev, VkPipelineCache cache, OUT Array<uint8_t> &blob)
 	{
-		// TODO
-		return false;
+		CHECK_ERR( cache );
+
+		size_t	data_size = 0;
+		VK_CHECK( dev.vkGetPipelineCacheData( dev.GetVkDevice(), cache, OUT &data_size, null ));
+
+		blob.resize( sizeof(PipelineCacheHeader) + data_size );
+		VK_CHECK( dev.vkGetPipelineCacheData( dev.GetVkDevice(), cache, INOUT &data_size, OUT blob.data() + sizeof(PipelineCacheHeader) ));
+		blob.resize( sizeof(PipelineCacheHeader) + data_size );
+
+		PipelineCacheHeader	header;
+		InitCacheHeader( dev, OUT header );
+		header.dataSize	= data_size;
+		header.dataHash	= StableHashOf( blob.data() + sizeof(header), data_size );
+
+		memcpy( OUT blob.data(), &header, sizeof(header) );
+		return true;
+	}
+	
+/*
+=================================================
+	DeserializeCache
+----
+	returns 'false' if blob was created on another device or driver,
+	or if blob is corrupted.
+=================================================
+*/
+	bool VPipelineCache::DeserializeCache (const VDevice &dev, ArrayView<uint8_t> blob, OUT ArrayView<uint8_t> &cacheData)
+	{
+		cacheData = Default;
+
+		PipelineCacheHeader	expected;
+		PipelineCacheHeader	header;
+		InitCacheHeader( dev, OUT expected );
+
+		if ( blob.size() < sizeof(header) )
+			return false;
+
+		memcpy( OUT &header, blob.data(), sizeof(header) );
+
+		if ( header.magic != expected.magic or header.version != expected.version )
+			return false;
+
+		if ( header.vendorID		!= expected.vendorID		or
+			 header.deviceID		!= expected.deviceID		or
+			 header.driverVersion	!= expected.driverVersion	or
+			 header.featuresHash	!= expected.featuresHash	or
+			 memcmp( header.pipelineCacheUUID, expected.pipelineCacheUUID, sizeof(header.pipelineCacheUUID) ) != 0 )
+			return false;
+
+		if ( header.dataSize != blob.size() - sizeof(header) or
+			 header.dataHash != StableHashOf( blob.data() + sizeof(header), size_t(header.dataSize) ))
+			return false;
+
+		cacheData = blob.section( sizeof(header), size_t(header.dataSize) );
+		return true;
 	}
 	
 /*
@@ -78,7 +215,7 @@ namespace FG
 	_CreatePipelineCache
 =================================================
 */
-	bool  VPipelineCache::_CreatePipelineCache (const VDevice &dev)
+	bool  VPipelineCache::_CreatePipelineCache (const VDevice &dev, ArrayView<uint8_t> initialData)
 	{
 		CHECK_ERR( not _pipelinesCache );
 
@@ -86,8 +223,8 @@ namespace FG
 		info.sType				= VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 		info.pNext				= null;
 		info.flags				= 0;
-		info.initialDataSize	= 0;
-		info.pInitialData		= null;
+		info.initialDataSize	= initialData.size();
+		info.pInitialData		= initialData.empty() ? null : initialData.data();
 
 		VK_CHECK( dev.vkCreatePipelineCache( dev.GetVkDevice(), &info, null, OUT &_pipelinesCache ));
 		return true;
@@ -280,8 +417,13 @@ namespace FG
 			pipeline_info.pColorBlendState		= null;
 		}
 
+		PipelineFeedback	feedback{ dev, pipeline_info.stageCount, INOUT pipeline_info.pNext };
+
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateGraphicsPipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		
+		_isModified = true;
+		feedback.UpdateStatistic( INOUT fgThread.EditStatistic().resources );
 
 		fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
 		
@@ -412,9 +554,14 @@ namespace FG
 			pipeline_info.pColorBlendState		= null;
 		}
 
+		PipelineFeedback	feedback{ dev, pipeline_info.stageCount, INOUT pipeline_info.pNext };
+
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateGraphicsPipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
 		
+		_isModified = true;
+		feedback.UpdateStatistic( INOUT fgThread.EditStatistic().resources );
+		
 		fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
 		
 		// try to insert new instance
@@ -521,9 +668,14 @@ namespace FG
 			pipeline_info.stage.pSpecializationInfo	= &spec;
 		}
 
+		PipelineFeedback	feedback{ dev, 1, INOUT pipeline_info.pNext };
+
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateComputePipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
 		
+		_isModified = true;
+		feedback.UpdateStatistic( INOUT fgThread.EditStatistic().resources );
+		
 		fgThread.EditStatistic().resources.newComputePipelineCount++;
 		
 		// try to insert new instance
@@ -711,10 +863,15 @@ namespace FG
 			pipeline_info.layout				= fgThread.AcquireTemporary( layout_id )->Handle();
 			pipeline_info.basePipelineIndex		= -1;
 			pipeline_info.basePipelineHandle	= VK_NULL_HANDLE;
+			
+			PipelineFeedback	feedback{ dev, pipeline_info.stageCount, INOUT pipeline_info.pNext };
 
 			VK_CHECK( dev.vkCreateRayTracingPipelinesNV( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &table.pipeline ));
 			fgThread.EditStatistic().resources.newRayTracingPipelineCount++;
 			
+			_isModified = true;
+			feedback.UpdateStatistic( INOUT fgThread.EditStatistic().resources );
+			
 			CHECK( res_mngr.AcquireResource( layout_id ));
 			table.layoutId = PipelineLayoutID{layout_id};
 			
@@ -72,6 +72,7 @@ namespace FG
 	// variables
 	private:
 		VkPipelineCache				_pipelinesCache;
+		bool						_isModified;			// new pipelines was added since last merge
 
 		// temporary arrays
 		ShaderStages_t				_tempStages;			// TODO: use custom allocator?
@@ -94,10 +95,18 @@ namespace FG
 		VPipelineCache ();
 		~VPipelineCache ();
 		
-		bool Initialize (const VDevice &dev);
+		bool Initialize (const VDevice &dev, ArrayView<uint8_t> initialData = Default);
 		void Deinitialize (const VDevice &dev);
 
-		bool MergeCache (VPipelineCache &);
+		ND_ bool			IsCreated ()		const	{ return _pipelinesCache != VK_NULL_HANDLE; }
+		ND_ VkPipelineCache	GetCache ()			const	{ return _pipelinesCache; }
+
+		// returns 'true' if cache has been changed since last call.
+		ND_ bool			ResetModified ()			{ bool res = _isModified;  _isModified = false;  return res; }
+
+		// cache blob with header that contains device and driver info.
+		ND_ static bool  SerializeCache (const VDevice &dev, VkPipelineCache cache, OUT Array<uint8_t> &blob);
+		ND_ static bool  DeserializeCache (const VDevice &dev, ArrayView<uint8_t> blob, OUT ArrayView<uint8_t> &cacheData);
 
 		bool CreatePipelineInstance (VCommandBuffer					&fgThread,
 									 const VLogicalRenderPass		&logicalRP,
@@ -137,7 +146,7 @@ namespace FG
 
 
 	private:
-		bool _CreatePipelineCache (const VDevice &dev);
+		bool _CreatePipelineCache (const VDevice &dev, ArrayView<uint8_t> initialData);
 
 		template <typename Pipeline>
 		bool _SetupShaderDebugging (VCommandBuffer &fgThread, const Pipeline &ppln, ShaderDbgIndex debugModeIndex,
@@ -53,6 +53,7 @@ namespace FG
 		ND_ uint2 const&		Dimension ()		const	{ SHAREDLOCK( _drCheck );  return _dimension; }
 		ND_ uint				Layers ()			const	{ SHAREDLOCK( _drCheck );  return _layers.Get(); }
 		ND_ HashVal				GetHash ()			const	{ SHAREDLOCK( _drCheck );  return _hash; }
+		ND_ auto				Attachments ()		const	{ SHAREDLOCK( _drCheck );  return ArrayView<Pair<RawImageID, ImageViewDesc>>{ _attachments }; }
 	};
 
 
@@ -250,7 +250,8 @@ namespace {
 
 		_allocator.Destroy();
 
-		_shadingRateImage = null;
+		_shadingRateImage	= null;
+		_hasCustomDraw		= false;
 	}
 	
 /*
@@ -79,6 +79,7 @@ namespace FG
 
 		RectI						_area;
 		bool						_isSubmited				= false;
+		bool						_hasCustomDraw			= false;
 		
 		VPipelineResourceSet		_perPassResources;
 
@@ -106,6 +107,7 @@ namespace FG
 		{
 			auto*	ptr = _allocator->Alloc<DrawTaskType>();
 			_drawTasks.push_back( PlacementNew<DrawTaskType>( ptr, *this, std::forward<Args&&>(args)... ));
+			_hasCustomDraw |= IsSameTypes< DrawTaskType, VFgDrawTask<CustomDraw> >;
 			return true;
 		}
 
@@ -119,6 +121,7 @@ namespace FG
 
 
 		ND_ bool								HasShadingRateImage ()		const	{ return _shadingRateImage != null; }
+		ND_ bool								HasCustomDraw ()			const	{ return _hasCustomDraw; }
 
 		ND_ ArrayView< IDrawTask *>				GetDrawTasks ()				const	{ return _drawTasks; }
 		
@@ -0,0 +1,159 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Sorted array of non-overlapping resource access records.
+	First 'InlineCount' records are stored inside the object,
+	larger arrays are allocated in the command buffer linear allocator,
+	memory is never freed and will be discarded with allocator after command buffer compilation.
+	Growing past inline storage requires an allocator, without it 'push_back' and 'insert' fail and the array is unchanged.
+*/
+
+#pragma once
+
+#include "VCommon.h"
+
+namespace FG
+{
+
+	//
+	// Access Records
+	//
+
+	template <typename AccessType, uint InlineCount = 4>
+	struct VAccessRecords
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v< AccessType >);
+		STATIC_ASSERT( InlineCount > 0 );
+
+	// types
+	public:
+		using Self				= VAccessRecords< AccessType, InlineCount >;
+		using Value_t			= AccessType;
+		using Allocator_t		= LinearAllocator<>;
+		using iterator			= AccessType *;
+		using const_iterator	= AccessType const *;
+
+
+	// variables
+	private:
+		AccessType *		_data		= null;
+		uint				_count		= 0;
+		uint				_capacity	= InlineCount;
+		Ptr<Allocator_t>	_alloc;
+		alignas(AccessType) uint8_t	_inline [sizeof(AccessType) * InlineCount];
+
+
+	// methods
+	public:
+		VAccessRecords () : _data{ Cast<AccessType>( &_inline[0] )} {}
+
+		VAccessRecords (const Self &) = delete;
+		VAccessRecords (Self &&) = delete;
+
+		Self&  operator = (const Self &) = delete;
+		Self&  operator = (Self &&) = delete;
+
+		void  SetAllocator (Allocator_t &alloc)
+		{
+			ASSERT( not _alloc or _alloc == Ptr<Allocator_t>{ &alloc });
+			_alloc = &alloc;
+		}
+
+		// returns to inline storage, dynamic memory may be discarded after this call
+		void  Release ()
+		{
+			_data		= Cast<AccessType>( &_inline[0] );
+			_count		= 0;
+			_capacity	= InlineCount;
+			_alloc		= null;
+		}
+
+		// replace all records by single record, fast path for whole resource access
+		void  Assign (const AccessType &value)
+		{
+			_data[0]	= value;
+			_count		= 1;
+		}
+
+		ND_ bool  push_back (const AccessType &value)
+		{
+			CHECK_ERR( _Reserve( _count + 1 ));
+			_data[_count++] = value;
+			return true;
+		}
+
+		// returns 'end()' on failure
+		ND_ iterator  insert (const_iterator pos, const AccessType &value)
+		{
+			ASSERT( pos >= begin() and pos <= end() );
+
+			const AccessType	temp	= value;	// 'value' may be in this array
+			const size_t		idx		= pos - begin();
+
+			CHECK_ERR( _Reserve( _count + 1 ), end() );
+
+			if ( idx < _count )
+				std::memmove( _data + idx + 1, _data + idx, sizeof(AccessType) * (_count - idx) );
+
+			_data[idx] = temp;
+			++_count;
+			return _data + idx;
+		}
+
+		iterator  erase (const_iterator pos)
+		{
+			ASSERT( pos >= begin() and pos < end() );
+
+			const size_t	idx = pos - begin();
+
+			--_count;
+			if ( idx < _count )
+				std::memmove( _data + idx, _data + idx + 1, sizeof(AccessType) * (_count - idx) );
+
+			return _data + idx;
+		}
+
+		void  clear ()											{ _count = 0; }
+
+		ND_ bool				empty ()				const	{ return _count == 0; }
+		ND_ size_t				size ()					const	{ return _count; }
+		ND_ size_t				capacity ()				const	{ return _capacity; }
+
+		ND_ iterator			begin ()						{ return _data; }
+		ND_ iterator			end ()							{ return _data + _count; }
+		ND_ const_iterator		begin ()				const	{ return _data; }
+		ND_ const_iterator		end ()					const	{ return _data + _count; }
+
+		ND_ AccessType &		front ()						{ ASSERT( _count > 0 );  return _data[0]; }
+		ND_ AccessType const&	front ()				const	{ ASSERT( _count > 0 );  return _data[0]; }
+		ND_ AccessType &		back ()							{ ASSERT( _count > 0 );  return _data[_count-1]; }
+		ND_ AccessType const&	back ()					const	{ ASSERT( _count > 0 );  return _data[_count-1]; }
+
+		ND_ AccessType &		operator [] (size_t i)			{ ASSERT( i < _count );  return _data[i]; }
+		ND_ AccessType const&	operator [] (size_t i)	const	{ ASSERT( i < _count );  return _data[i]; }
+
+		ND_ operator ArrayView<AccessType> ()			const	{ return ArrayView<AccessType>{ _data, _count }; }
+
+
+	private:
+		ND_ bool  _Reserve (size_t count)
+		{
+			if ( count <= _capacity )
+				return true;
+
+			CHECK_ERR( _alloc );
+
+			const uint		new_cap		= Max( _capacity * 2, uint(count) );
+			AccessType*		new_data	= _alloc->Alloc<AccessType>( new_cap );
+			CHECK_ERR( new_data );
+
+			// previous memory will be discarded with allocator
+			std::memcpy( new_data, _data, sizeof(AccessType) * _count );
+
+			_data		= new_data;
+			_capacity	= new_cap;
+			return true;
+		}
+	};
+
+
+}	// FG
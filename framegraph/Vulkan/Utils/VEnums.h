@@ -13,7 +13,7 @@ namespace FG
 		HostRead		= uint(EMemoryType::HostRead),
 		HostWrite		= uint(EMemoryType::HostWrite),
 		Dedicated		= uint(EMemoryType::Dedicated),
-		//AllowAliasing	= uint(EMemoryType::AllowAliasing),
+		Transient		= uint(EMemoryType::Transient),
 		//Sparse		= uint(EMemoryType::Sparse),
 		_Offset			= uint(EMemoryType::_Last)-1,
 
@@ -23,6 +23,7 @@ namespace FG
 		ForBuffer		= _Offset << 4,
 		ForImage		= _Offset << 5,
 		Virtual			= _Offset << 6,
+		Relocation		= _Offset << 7,		// allocate only in existing memory blocks, memory is allocated before resource creation
 		_Last,
 		
 		All				= ((_Last-1) << 1) - 1,
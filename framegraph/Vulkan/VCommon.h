@@ -14,6 +14,7 @@
 #include "extensions/vulkan_loader/VulkanCheckError.h"
 
 #include "stl/ThreadSafe/DataRaceCheck.h"
+#include "stl/Log/TraceRecorder.h"
 #include "stl/Containers/Appendable.h"
 #include "stl/Containers/InPlace.h"
 #include "stl/Memory/LinearAllocator.h"
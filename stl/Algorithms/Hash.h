@@ -122,6 +122,77 @@ namespace FGC
 		#endif
 	}
 
+
+/*
+=================================================
+	StableHashOf
+----
+	FNV-1a, result doesn't depend on std library and platform,
+	so it can be stored in file
+=================================================
+*/
+	ND_ inline uint64_t  StableHashOf (const void *ptr, size_t sizeInBytes, uint64_t seed = 0xcbf29ce484222325ull)
+	{
+		const uint8_t*	bytes	= static_cast<const uint8_t*>(ptr);
+		uint64_t		hash	= seed;
+
+		for (size_t i = 0; i < sizeInBytes; ++i) {
+			hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+		}
+		return hash;
+	}
+//-----------------------------------------------------------------------------
+
+
+
+	//
+	// Hash Stream (64 bit)
+	//
+	// Combines values in order, unlike 'HashVal::operator <<' the result depends on order
+	// and values don't cancel each other. Based on XXH64 round and avalanche functions.
+	//
+
+	struct HashStream64
+	{
+	// variables
+	private:
+		uint64_t	_value	= 0x27D4EB2F165667C5ull;
+
+		static constexpr uint64_t	_Prime1	= 0x9E3779B185EBCA87ull;
+		static constexpr uint64_t	_Prime2	= 0xC2B2AE3D27D4EB4Full;
+		static constexpr uint64_t	_Prime3	= 0x165667B19E3779F9ull;
+
+	// methods
+	public:
+		constexpr HashStream64 () {}
+		explicit constexpr HashStream64 (uint64_t seed) : _value{seed} {}
+
+		constexpr HashStream64&  Update (uint64_t value)
+		{
+			value	*= _Prime2;
+			value	 = (value << 31) | (value >> 33);
+			_value	^= value * _Prime1;
+			_value	 = ((_value << 27) | (_value >> 37)) * _Prime1 + _Prime3;
+			return *this;
+		}
+
+		constexpr HashStream64&  Update (const HashVal &value)
+		{
+			return Update( uint64_t(size_t(value)) );
+		}
+
+		ND_ constexpr uint64_t  Get () const
+		{
+			uint64_t	h = _value;
+			h ^= h >> 33;	h *= _Prime2;
+			h ^= h >> 29;	h *= _Prime3;
+			h ^= h >> 32;
+			return h;
+		}
+
+		ND_ constexpr HashVal  GetHash () const		{ return HashVal{size_t(Get())}; }
+	};
+
 }	// FGC
 
 
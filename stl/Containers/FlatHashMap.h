@@ -0,0 +1,318 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Open-addressed hash map with linear probing, specialized for 64-bit keys.
+
+	Key with all bits set is reserved as empty slot marker.
+	Values must be trivially destructible, 'clear' only resets keys and keeps allocated memory.
+	Allocator must have 'Allocate (size, align)' and 'Deallocate (ptr, size, align)' methods,
+	for example 'UntypedAlignedAllocator' or 'UntypedLinearAllocator'.
+*/
+
+#pragma once
+
+#include "stl/Algorithms/Cast.h"
+#include "stl/Memory/UntypedAllocator.h"
+#include "stl/Math/Math.h"
+
+namespace FGC
+{
+
+	//
+	// Flat Hash Map
+	//
+
+	template <typename Key, typename Value, typename AllocatorType = UntypedAlignedAllocator>
+	struct FlatHashMap
+	{
+		STATIC_ASSERT( sizeof(Key) == sizeof(uint64_t), "only 64-bit keys are supported" );
+		STATIC_ASSERT( std::is_trivially_copyable_v<Key> );
+		STATIC_ASSERT( std::is_trivially_destructible_v<Value> );
+
+	// types
+	private:
+		using Self				= FlatHashMap< Key, Value, AllocatorType >;
+		using Pair_t			= Pair< const Key, Value >;
+
+		template <typename PairType>
+		struct TIterator
+		{
+			friend struct FlatHashMap;
+
+		private:
+			PairType *	_ptr	= null;
+			PairType *	_end	= null;
+
+			TIterator (PairType *ptr, PairType *end) : _ptr{ptr}, _end{end}		{ _SkipEmpty(); }
+
+			void _SkipEmpty ()
+			{
+				for (; _ptr != _end and _IsEmpty( _ptr->first ); ++_ptr) {}
+			}
+
+		public:
+			TIterator () {}
+
+			TIterator&  operator ++ ()								{ ++_ptr;  _SkipEmpty();  return *this; }
+
+			ND_ PairType&	operator *  ()					const	{ return *_ptr; }
+			ND_ PairType*	operator -> ()					const	{ return _ptr; }
+
+			ND_ bool		operator == (const TIterator &rhs)	const	{ return _ptr == rhs._ptr; }
+			ND_ bool		operator != (const TIterator &rhs)	const	{ return _ptr != rhs._ptr; }
+		};
+
+	public:
+		using iterator			= TIterator< Pair_t >;
+		using const_iterator	= TIterator< Pair_t const >;
+		using pair_type			= Pair< Key, Value >;
+		using key_type			= Key;
+		using value_type		= Value;
+		using Allocator_t		= AllocatorType;
+
+	private:
+		static constexpr uint64_t	EmptyKey		= UMax;
+		static constexpr size_t		MinCapacity		= 16;
+
+
+	// variables
+	private:
+		pair_type *		_slots		= null;
+		size_t			_capacity	= 0;	// power of 2
+		size_t			_count		= 0;
+		Allocator_t		_alloc;
+
+
+	// methods
+	public:
+		FlatHashMap () {}
+		explicit FlatHashMap (const Allocator_t &alloc) : _alloc{alloc} {}
+		FlatHashMap (Self &&);
+		FlatHashMap (const Self &) = delete;
+
+		~FlatHashMap ()		{ release(); }
+
+		Self&  operator = (const Self &) = delete;
+
+		ND_ size_t			size ()			const	{ return _count; }
+		ND_ bool			empty ()		const	{ return _count == 0; }
+		ND_ size_t			capacity ()		const	{ return _capacity; }
+
+		ND_ iterator		begin ()				{ return iterator{ _Slots(), _Slots() + _capacity }; }
+		ND_ const_iterator	begin ()		const	{ return const_iterator{ _Slots(), _Slots() + _capacity }; }
+		ND_ iterator		end ()					{ return iterator{ _Slots() + _capacity, _Slots() + _capacity }; }
+		ND_ const_iterator	end ()			const	{ return const_iterator{ _Slots() + _capacity, _Slots() + _capacity }; }
+
+			Pair<iterator,bool>  insert (const pair_type &value);
+
+		ND_ iterator		find (const key_type &key);
+		ND_ const_iterator	find (const key_type &key) const;
+		ND_ size_t			count (const key_type &key) const	{ return find( key ) != end() ? 1 : 0; }
+
+			void			reserve (size_t count);
+			void			clear ();
+			void			release ();
+
+
+	private:
+		ND_ Pair_t *		_Slots ()		const	{ return BitCast< Pair_t *>( _slots ); }
+
+		ND_ static bool		_IsEmpty (const Key &key)	{ return BitCast<uint64_t>( key ) == EmptyKey; }
+		ND_ static size_t	_Hash (const Key &key);
+
+		ND_ size_t			_FindSlot (const Key &key) const;
+			void			_Rehash (size_t newCapacity);
+	};
+
+
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline FlatHashMap<K,V,A>::FlatHashMap (Self &&other) :
+		_slots{ other._slots },			_capacity{ other._capacity },
+		_count{ other._count },			_alloc{ std::move(other._alloc) }
+	{
+		other._slots	= null;
+		other._capacity	= 0;
+		other._count	= 0;
+	}
+
+/*
+=================================================
+	_Hash
+----
+	64-bit finalizer from MurmurHash3,
+	resource IDs have most of entropy in low bits
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	forceinline size_t  FlatHashMap<K,V,A>::_Hash (const K &key)
+	{
+		uint64_t	h = BitCast<uint64_t>( key );
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return size_t(h);
+	}
+
+/*
+=================================================
+	_FindSlot
+----
+	returns index of slot with same key or index of first empty slot
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	forceinline size_t  FlatHashMap<K,V,A>::_FindSlot (const K &key) const
+	{
+		ASSERT( _capacity > 0 );
+		ASSERT( not _IsEmpty( key ));
+
+		const uint64_t	bits	= BitCast<uint64_t>( key );
+		const size_t	mask	= _capacity - 1;
+
+		for (size_t i = _Hash( key ) & mask;; i = (i + 1) & mask)
+		{
+			const uint64_t	slot = BitCast<uint64_t>( _slots[i].first );
+
+			if ( slot == bits or slot == EmptyKey )
+				return i;
+		}
+	}
+
+/*
+=================================================
+	insert
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline Pair< typename FlatHashMap<K,V,A>::iterator, bool >
+		FlatHashMap<K,V,A>::insert (const pair_type &value)
+	{
+		// keep load factor less than 0.75
+		if ( (_count + 1) * 4 > _capacity * 3 )
+			_Rehash( Max( MinCapacity, _capacity * 2 ));
+
+		const size_t	i		= _FindSlot( value.first );
+		const bool		is_new	= _IsEmpty( _slots[i].first );
+
+		if ( is_new )
+		{
+			_slots[i] = value;
+			++_count;
+		}
+		return { iterator{ _Slots() + i, _Slots() + _capacity }, is_new };
+	}
+
+/*
+=================================================
+	find
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline typename FlatHashMap<K,V,A>::iterator  FlatHashMap<K,V,A>::find (const key_type &key)
+	{
+		if ( _count == 0 )
+			return end();
+
+		const size_t	i = _FindSlot( key );
+		return _IsEmpty( _slots[i].first ) ? end() : iterator{ _Slots() + i, _Slots() + _capacity };
+	}
+
+	template <typename K, typename V, typename A>
+	inline typename FlatHashMap<K,V,A>::const_iterator  FlatHashMap<K,V,A>::find (const key_type &key) const
+	{
+		if ( _count == 0 )
+			return end();
+
+		const size_t	i = _FindSlot( key );
+		return _IsEmpty( _slots[i].first ) ? end() : const_iterator{ _Slots() + i, _Slots() + _capacity };
+	}
+
+/*
+=================================================
+	reserve
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline void  FlatHashMap<K,V,A>::reserve (size_t count)
+	{
+		size_t	new_cap = MinCapacity;
+		for (; new_cap * 3 < count * 4; new_cap <<= 1) {}
+
+		if ( new_cap > _capacity )
+			_Rehash( new_cap );
+	}
+
+/*
+=================================================
+	clear
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline void  FlatHashMap<K,V,A>::clear ()
+	{
+		if ( _count == 0 )
+			return;
+
+		for (size_t i = 0; i < _capacity; ++i) {
+			_slots[i].first = BitCast<K>( EmptyKey );
+		}
+		_count = 0;
+	}
+
+/*
+=================================================
+	release
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline void  FlatHashMap<K,V,A>::release ()
+	{
+		if ( _slots )
+			_alloc.Deallocate( _slots, SizeOf<pair_type> * _capacity, AlignOf<pair_type> );
+
+		_slots		= null;
+		_capacity	= 0;
+		_count		= 0;
+	}
+
+/*
+=================================================
+	_Rehash
+=================================================
+*/
+	template <typename K, typename V, typename A>
+	inline void  FlatHashMap<K,V,A>::_Rehash (size_t newCapacity)
+	{
+		ASSERT( IsPowerOfTwo( newCapacity ));
+		ASSERT( newCapacity > _count );
+
+		pair_type*		old_slots	= _slots;
+		const size_t	old_cap		= _capacity;
+
+		_slots		= Cast<pair_type>( _alloc.Allocate( SizeOf<pair_type> * newCapacity, AlignOf<pair_type> ));
+		_capacity	= newCapacity;
+		CHECK( _slots );
+
+		for (size_t i = 0; i < _capacity; ++i) {
+			PlacementNew<pair_type>( _slots + i, BitCast<K>( EmptyKey ), V{} );
+		}
+
+		for (size_t i = 0; i < old_cap; ++i)
+		{
+			if ( not _IsEmpty( old_slots[i].first ))
+				_slots[ _FindSlot( old_slots[i].first )] = old_slots[i];
+		}
+
+		if ( old_slots )
+			_alloc.Deallocate( old_slots, SizeOf<pair_type> * old_cap, AlignOf<pair_type> );
+	}
+
+
+}	// FGC
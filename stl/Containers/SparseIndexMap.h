@@ -0,0 +1,156 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Maps index in range [0, MaxIndices) to value.
+	Pages are allocated on first insertion, so memory usage is proportional to the used index range.
+	'Clear' only increments generation counter, entries from previous generations are treated as empty.
+*/
+
+#pragma once
+
+#include "stl/CompileTime/Math.h"
+#include "stl/Math/Bytes.h"
+
+namespace FGC
+{
+
+	//
+	// Sparse Index Map
+	//
+
+	template <typename IndexType,
+			  typename ValueType,
+			  size_t MaxIndices,
+			  size_t PageSize = 256
+			 >
+	struct SparseIndexMap final
+	{
+		STATIC_ASSERT( IsPowerOfTwo( PageSize ));
+		STATIC_ASSERT( std::is_trivially_copyable_v< ValueType >);
+
+	// types
+	public:
+		using Self			= SparseIndexMap< IndexType, ValueType, MaxIndices, PageSize >;
+		using Index_t		= IndexType;
+		using Value_t		= ValueType;
+
+	private:
+		static constexpr size_t		MaxPages	= (MaxIndices + PageSize - 1) / PageSize;
+
+		struct Entry
+		{
+			uint		generation	= 0;
+			Value_t		value;
+		};
+
+		using Page_t		= StaticArray< Entry, PageSize >;
+		using Pages_t		= StaticArray< UniquePtr< Page_t >, MaxPages >;
+
+
+	// variables
+	private:
+		Pages_t		_pages;
+		uint		_generation		= 1;
+
+
+	// methods
+	public:
+		SparseIndexMap () {}
+
+		SparseIndexMap (const Self &) = delete;
+		SparseIndexMap (Self &&) = default;
+
+		Self&  operator = (const Self &) = delete;
+		Self&  operator = (Self &&) = default;
+
+
+		ND_ Value_t*  Find (Index_t index)
+		{
+			ASSERT( size_t(index) < MaxIndices );
+			auto&	page = _pages[ size_t(index) / PageSize ];
+
+			if ( not page )
+				return null;
+
+			Entry&	e = (*page)[ size_t(index) % PageSize ];
+			return e.generation == _generation ? &e.value : null;
+		}
+
+
+		ND_ Value_t const*  Find (Index_t index) const
+		{
+			return const_cast<Self *>(this)->Find( index );
+		}
+
+
+		// returns existing value or inserts new one
+		ND_ Value_t&  Emplace (Index_t index, const Value_t &initial, OUT bool &inserted)
+		{
+			ASSERT( size_t(index) < MaxIndices );
+			auto&	page = _pages[ size_t(index) / PageSize ];
+
+			if ( not page )
+				page.reset( new Page_t{} );
+
+			Entry&	e = (*page)[ size_t(index) % PageSize ];
+			inserted = (e.generation != _generation);
+
+			if ( inserted )
+			{
+				e.generation = _generation;
+				e.value		 = initial;
+			}
+			return e.value;
+		}
+
+
+		void  Erase (Index_t index)
+		{
+			ASSERT( size_t(index) < MaxIndices );
+			auto&	page = _pages[ size_t(index) / PageSize ];
+
+			if ( page )
+				(*page)[ size_t(index) % PageSize ].generation = 0;
+		}
+
+
+		// O(1), pages are reused by next generation
+		void  Clear ()
+		{
+			if ( ++_generation != 0 )
+				return;
+
+			// generation counter overflow, reset all entries
+			for (auto& page : _pages)
+			{
+				if ( page ) {
+					for (auto& e : *page) { e.generation = 0; }
+				}
+			}
+			_generation = 1;
+		}
+
+
+		// frees all pages
+		void  Release ()
+		{
+			for (auto& page : _pages) {
+				page.reset();
+			}
+			_generation = 1;
+		}
+
+
+		ND_ BytesU  DynamicSize () const
+		{
+			BytesU	sz { sizeof(*this) };
+			for (auto& page : _pages) {
+				sz += (page ? sizeof(Page_t) : 0);
+			}
+			return sz;
+		}
+
+		ND_ static constexpr size_t  capacity ()	{ return MaxIndices; }
+	};
+
+
+}	// FGC
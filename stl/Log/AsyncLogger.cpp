@@ -0,0 +1,473 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Log/AsyncLogger.h"
+#include "stl/Math/BitMath.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace FGC
+{
+namespace
+{
+	using FormatFn_t = void (*) (ArrayView<uint8_t> data, INOUT String &str);
+
+	static constexpr size_t		MinBufferSize	= 4u << 10;
+
+	//
+	// Record Header
+	//
+	struct RecordHeader
+	{
+		uint		size;			// aligned size of the record including header
+		uint		fileLength;
+		uint		dataSize;
+		int			line;
+		FormatFn_t	format;			// null for padding record
+	};
+	STATIC_ASSERT( sizeof(RecordHeader) % alignof(RecordHeader) == 0 );
+
+	//
+	// Thread Ring Buffer
+	//
+	struct ThreadRing
+	{
+		// written by producer
+		alignas(FG_CACHE_LINE) Atomic<uint64_t>	head		{0};
+		uint64_t								pending		= 0;	// head after '_Alloc'
+		uint64_t								cachedTail	= 0;
+		Atomic<uint64_t>						dropped		{0};
+
+		// written by consumer
+		alignas(FG_CACHE_LINE) Atomic<uint64_t>	tail		{0};
+
+		Atomic<bool>							inUse		{true};
+		const uint								generation;
+		const size_t							capacity;
+		UniquePtr<uint8_t[]>					data;
+
+		ThreadRing (size_t size, uint gen) : generation{gen}, capacity{size}, data{new uint8_t[size]} {}
+	};
+	using ThreadRingPtr = SharedPtr< ThreadRing >;
+
+	//
+	// Thread Ring Reference
+	//
+	struct ThreadRingRef
+	{
+		ThreadRingPtr	ring;
+
+		// ring may be reused by another thread before all messages are drained,
+		// new producer continues from the same head, so pending messages are written before its messages
+		~ThreadRingRef () { Release(); }
+
+		void  Release ()
+		{
+			if ( ring )
+				ring->inUse.store( false, memory_order_release );
+			ring.reset();
+		}
+	};
+
+	//
+	// Logger State
+	//
+	struct LoggerState
+	{
+		std::mutex					controlGuard;		// protects 'Start', 'Stop'
+		std::mutex					drainGuard;			// only one thread can read from rings
+		std::mutex					ringsGuard;			// protects 'rings'
+		std::mutex					wakeupGuard;
+		std::condition_variable		wakeup;
+
+		Array<ThreadRingPtr>		rings;
+		Array<ThreadRingPtr>		drainList;			// protected by 'drainGuard'
+		AsyncLogger::Config			config;				// protected by 'drainGuard'
+		size_t						capacity	= 0;
+		std::thread					thread;
+
+		Atomic<bool>				running		{false};
+		Atomic<uint>				generation	{0};
+		Atomic<uint64_t>			dropped		{0};
+
+		~LoggerState ()
+		{
+			AsyncLogger::Stop();
+		}
+	};
+
+	static LoggerState					s_logger;
+	static thread_local ThreadRingRef	t_ring;
+	static thread_local bool			t_isDraining	= false;
+
+/*
+=================================================
+	DrainRing
+----
+	returns number of messages
+=================================================
+*/
+	static uint  DrainRing (ThreadRing &ring, INOUT String &str)
+	{
+		const size_t	mask	= ring.capacity - 1;
+		const uint64_t	head	= ring.head.load( memory_order_acquire );
+		uint64_t		tail	= ring.tail.load( memory_order_relaxed );
+		uint			count	= 0;
+
+		for (; tail < head;)
+		{
+			const size_t	idx		= size_t(tail) & mask;
+			const size_t	to_end	= ring.capacity - idx;
+
+			// implicit padding
+			if ( to_end < sizeof(RecordHeader) )
+			{
+				tail += to_end;
+				continue;
+			}
+
+			RecordHeader	hdr;
+			std::memcpy( OUT &hdr, ring.data.get() + idx, sizeof(hdr) );
+			ASSERT( hdr.size > 0 and hdr.size <= to_end );
+
+			if ( hdr.format )
+			{
+				const uint8_t*	ptr		= ring.data.get() + idx + sizeof(hdr);
+				const StringView	file	{ Cast<char>(ptr), hdr.fileLength };
+
+				str.clear();
+				hdr.format( ArrayView<uint8_t>{ ptr + hdr.fileLength, hdr.dataSize }, INOUT str );
+
+				if ( s_logger.config.output )
+					s_logger.config.output( str, file, hdr.line );
+				else
+					Logger::InfoSync( str, "", file, hdr.line );
+
+				++count;
+			}
+
+			tail += hdr.size;
+			ring.tail.store( tail, memory_order_release );
+		}
+		ring.tail.store( tail, memory_order_release );
+
+		if ( uint64_t dropped = ring.dropped.exchange( 0, memory_order_relaxed ))
+		{
+			s_logger.dropped.fetch_add( dropped, memory_order_relaxed );
+
+			str = "AsyncLogger: "s << ToString( dropped ) << " messages were dropped";
+
+			if ( s_logger.config.output )
+				s_logger.config.output( str, __FILE__, __LINE__ );
+			else
+				Logger::InfoSync( str, "", __FILE__, __LINE__ );
+		}
+		return count;
+	}
+
+/*
+=================================================
+	DrainAll
+=================================================
+*/
+	static void  DrainAll ()
+	{
+		t_isDraining = true;
+		{
+			std::unique_lock	drain_lock{ s_logger.drainGuard };
+			{
+				std::unique_lock	lock{ s_logger.ringsGuard };
+				s_logger.drainList.assign( s_logger.rings.begin(), s_logger.rings.end() );
+			}
+
+			String	str;
+			uint	count = 0;
+
+			for (auto& ring : s_logger.drainList) {
+				count += DrainRing( *ring, INOUT str );
+			}
+			s_logger.drainList.clear();
+
+			if ( count and not s_logger.config.output )
+				Logger::FlushOutput();
+		}
+		t_isDraining = false;
+	}
+
+/*
+=================================================
+	DrainLoop
+=================================================
+*/
+	static void  DrainLoop ()
+	{
+		for (; s_logger.running.load( memory_order_relaxed );)
+		{
+			DrainAll();
+
+			std::unique_lock	lock{ s_logger.wakeupGuard };
+			s_logger.wakeup.wait_for( lock, s_logger.config.drainInterval );
+		}
+	}
+
+/*
+=================================================
+	AttachThread
+----
+	reuses ring of finished thread or creates new ring
+=================================================
+*/
+	ND_ static ThreadRing*  AttachThread ()
+	{
+		t_ring.Release();
+
+		std::unique_lock	lock{ s_logger.ringsGuard };
+
+		if ( not s_logger.running.load( memory_order_relaxed ))
+			return null;
+
+		const uint	gen = s_logger.generation.load( memory_order_relaxed );
+
+		for (auto& ring : s_logger.rings)
+		{
+			if ( not ring->inUse.load( memory_order_acquire ))
+			{
+				ring->inUse.store( true, memory_order_relaxed );
+				t_ring.ring = ring;
+				return ring.get();
+			}
+		}
+
+		t_ring.ring = MakeShared<ThreadRing>( s_logger.capacity, gen );
+		s_logger.rings.push_back( t_ring.ring );
+		return t_ring.ring.get();
+	}
+
+/*
+=================================================
+	WakeupDrainThread
+=================================================
+*/
+	static void  WakeupDrainThread ()
+	{
+		s_logger.wakeup.notify_one();
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	Start
+=================================================
+*/
+	bool  AsyncLogger::Start (const Config &cfg)
+	{
+		std::unique_lock	ctrl_lock{ s_logger.controlGuard };
+		CHECK_ERR( not s_logger.running.load( memory_order_relaxed ));
+
+		{
+			std::unique_lock	drain_lock{ s_logger.drainGuard };
+			std::unique_lock	lock{ s_logger.ringsGuard };
+
+			const size_t	size = Max( size_t(cfg.bufferSize), MinBufferSize );
+
+			s_logger.config		= cfg;
+			s_logger.capacity	= size_t(1) << (IntLog2( size ) + int(not IsPowerOfTwo( size )));
+			s_logger.dropped.store( 0, memory_order_relaxed );
+			s_logger.generation.fetch_add( 1, memory_order_relaxed );
+			s_logger.running.store( true, memory_order_release );
+		}
+
+		s_logger.thread = std::thread{ &DrainLoop };
+		return true;
+	}
+
+/*
+=================================================
+	Stop
+=================================================
+*/
+	void  AsyncLogger::Stop ()
+	{
+		std::unique_lock	ctrl_lock{ s_logger.controlGuard };
+
+		if ( not s_logger.running.load( memory_order_relaxed ))
+			return;
+
+		{
+			std::unique_lock	lock{ s_logger.ringsGuard };
+			s_logger.running.store( false, memory_order_release );
+			s_logger.generation.fetch_add( 1, memory_order_relaxed );
+		}
+		{
+			std::unique_lock	lock{ s_logger.wakeupGuard };
+			WakeupDrainThread();
+		}
+		s_logger.thread.join();
+
+		DrainAll();
+
+		std::unique_lock	lock{ s_logger.ringsGuard };
+		s_logger.rings.clear();
+	}
+
+/*
+=================================================
+	Flush
+----
+	drains all rings in the current thread
+=================================================
+*/
+	void  AsyncLogger::Flush ()
+	{
+		// logger was called from output function
+		if ( t_isDraining )
+			return;
+
+		if ( IsRunning() )
+			DrainAll();
+	}
+
+/*
+=================================================
+	IsRunning
+=================================================
+*/
+	bool  AsyncLogger::IsRunning ()
+	{
+		return s_logger.running.load( memory_order_acquire );
+	}
+
+/*
+=================================================
+	DroppedCount
+----
+	returns number of dropped messages that are reported by drain thread
+=================================================
+*/
+	uint64_t  AsyncLogger::DroppedCount ()
+	{
+		return s_logger.dropped.load( memory_order_relaxed );
+	}
+
+/*
+=================================================
+	Enqueue
+=================================================
+*/
+	bool  AsyncLogger::Enqueue (StringView msg, StringView file, int line)
+	{
+		if ( not IsRunning() )
+			return false;
+
+		// long message may not fit into the ring, write it synchronously after all previous messages
+		if_unlikely( msg.size() + file.size() > s_logger.capacity / 4 )
+		{
+			Flush();
+			return false;
+		}
+
+		if ( uint8_t* dst = _Alloc( file, line, &_FormatText, msg.size() ))
+		{
+			std::memcpy( OUT dst, msg.data(), msg.size() );
+			_Commit();
+		}
+		return true;
+	}
+
+/*
+=================================================
+	_FormatText
+=================================================
+*/
+	void  AsyncLogger::_FormatText (ArrayView<uint8_t> data, INOUT String &str)
+	{
+		str << StringView{ Cast<char>(data.data()), data.size() };
+	}
+
+/*
+=================================================
+	_Alloc
+----
+	returns pointer to the message data or null if message is dropped.
+	'_Commit' must be called after data is written.
+=================================================
+*/
+	uint8_t*  AsyncLogger::_Alloc (StringView file, int line, FormatFn_t fn, size_t size)
+	{
+		ThreadRing*	ring = t_ring.ring.get();
+
+		if_unlikely( not ring or ring->generation != s_logger.generation.load( memory_order_relaxed ))
+		{
+			ring = AttachThread();
+			if ( not ring )
+				return null;
+		}
+
+		const size_t	rec_size	= AlignToLarger( sizeof(RecordHeader) + file.size() + size, alignof(RecordHeader) );
+		const uint64_t	head		= ring->head.load( memory_order_relaxed );
+		const size_t	idx			= size_t(head) & (ring->capacity - 1);
+		const size_t	to_end		= ring->capacity - idx;
+		const size_t	skip		= (to_end < rec_size ? to_end : 0);		// record must be contiguous
+		const uint64_t	new_head	= head + skip + rec_size;
+
+		if ( new_head - ring->cachedTail > ring->capacity )
+		{
+			ring->cachedTail = ring->tail.load( memory_order_acquire );
+
+			if ( new_head - ring->cachedTail > ring->capacity )
+			{
+				ring->dropped.fetch_add( 1, memory_order_relaxed );
+				WakeupDrainThread();
+				return null;
+			}
+		}
+
+		if ( skip >= sizeof(RecordHeader) )
+		{
+			RecordHeader	pad = {};
+			pad.size = uint(skip);
+			std::memcpy( OUT ring->data.get() + idx, &pad, sizeof(pad) );
+		}
+
+		uint8_t*		dst	= ring->data.get() + (size_t(head + skip) & (ring->capacity - 1));
+		RecordHeader	hdr;
+		hdr.size		= uint(rec_size);
+		hdr.fileLength	= uint(file.size());
+		hdr.dataSize	= uint(size);
+		hdr.line		= line;
+		hdr.format		= fn;
+
+		std::memcpy( OUT dst, &hdr, sizeof(hdr) );
+		std::memcpy( OUT dst + sizeof(hdr), file.data(), file.size() );
+
+		ring->pending = new_head;
+
+		// wakeup drain thread before ring is full
+		if ( new_head - ring->cachedTail > ring->capacity * 3 / 4 )
+		{
+			ring->cachedTail = ring->tail.load( memory_order_acquire );
+
+			if ( new_head - ring->cachedTail > ring->capacity * 3 / 4 )
+				WakeupDrainThread();
+		}
+
+		return dst + sizeof(hdr) + file.size();
+	}
+
+/*
+=================================================
+	_Commit
+=================================================
+*/
+	void  AsyncLogger::_Commit ()
+	{
+		ThreadRing*	ring = t_ring.ring.get();
+		ring->head.store( ring->pending, memory_order_release );
+	}
+
+
+}	// FGC
@@ -0,0 +1,180 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Asynchronous backend for 'Logger'.
+
+	While logger is running, 'Logger::Info' only copies message into the ring buffer of the current thread,
+	background thread drains all buffers and writes messages to the platform output.
+	Each buffer has fixed size, if buffer is full then message is dropped and drop counter is incremented.
+	'Logger::Error' (asserts, checks) flushes all buffers and writes message synchronously.
+
+	Messages from the same thread are written in order, messages from different threads may be reordered.
+	Messages that are written concurrently with 'Stop' may be lost.
+
+	'FG_LOGI_ASYNC' stores arguments in binary form, they will be converted to string in the background thread.
+	Format string must be a string literal, '{}' is replaced by the next argument.
+	Only the pointer to the format string is stored and it is read later in the background thread.
+	'FG_LOGI_ASYNC' fails to compile with non-literal format, 'AsyncLogger::Info' also accepts char arrays,
+	such array must not be changed or destroyed until the message is written.
+*/
+
+#pragma once
+
+#include "stl/Algorithms/StringUtils.h"
+#include <chrono>
+#include <functional>
+#include <new>
+
+namespace FGC
+{
+
+	//
+	// Async Logger
+	//
+
+	class AsyncLogger final
+	{
+	// types
+	public:
+		using Output_t	= std::function< void (StringView msg, StringView file, int line) >;
+
+		struct Config
+		{
+			BytesU						bufferSize		= 64_Kb;	// per thread, rounded to power of 2
+			std::chrono::milliseconds	drainInterval	{5};
+			Output_t					output;						// if not set then 'Logger::InfoSync' is used
+		};
+
+	private:
+		using FormatFn_t = void (*) (ArrayView<uint8_t> data, INOUT String &str);
+
+
+	// methods
+	public:
+		AsyncLogger () = delete;
+
+		static bool  Start (const Config &cfg = Default);
+		static void  Stop ();
+
+		// writes all pending messages in the current thread
+		static void  Flush ();
+
+		ND_ static bool		 IsRunning ();
+		ND_ static uint64_t  DroppedCount ();
+
+		// returns 'false' if logger is not running
+		static bool  Enqueue (StringView msg, StringView file, int line);
+
+		template <size_t N, typename ...Args>
+		static void  Info (StringView file, int line, const char (&fmt)[N], const Args& ...args);
+
+	private:
+		ND_ static uint8_t*  _Alloc (StringView file, int line, FormatFn_t fn, size_t size);
+			static void		 _Commit ();
+
+		template <typename ...Args>
+		static void  _Encode (OUT uint8_t *dst, const char *fmt, const Args& ...args);
+
+		template <typename ...Args>
+		static void  _Format (ArrayView<uint8_t> data, INOUT String &str);
+
+		template <typename T>
+		static void  _FormatArg (const uint8_t* &src, INOUT StringView &fmt, INOUT String &str);
+
+		static void  _FormatText (ArrayView<uint8_t> data, INOUT String &str);
+	};
+
+
+/*
+=================================================
+	Info
+=================================================
+*/
+	template <size_t N, typename ...Args>
+	inline void  AsyncLogger::Info (StringView file, int line, const char (&fmt)[N], const Args& ...args)
+	{
+		STATIC_ASSERT( ((std::is_trivially_copyable_v<Args> and not IsPointer<Args> and not IsSameTypes<Args, StringView>) and ...),
+					   "arguments are copied as bytes and must not reference memory" );
+
+		constexpr size_t	size = sizeof(const char*) + (sizeof(Args) + ... + 0);
+
+		if ( IsRunning() )
+		{
+			if ( uint8_t* dst = _Alloc( file, line, &_Format<Args...>, size ))
+			{
+				_Encode( OUT dst, fmt, args... );
+				_Commit();
+			}
+			return;
+		}
+
+		// synchronous output
+		uint8_t		data [size];
+		String		str;
+		_Encode( OUT data, fmt, args... );
+		_Format<Args...>( ArrayView<uint8_t>{ data, size }, INOUT str );
+
+		FG_PRIVATE_LOGI( str, file, line );
+	}
+
+/*
+=================================================
+	_Encode
+=================================================
+*/
+	template <typename ...Args>
+	inline void  AsyncLogger::_Encode (OUT uint8_t *dst, const char *fmt, const Args& ...args)
+	{
+		std::memcpy( OUT dst, &fmt, sizeof(fmt) );
+		dst += sizeof(fmt);
+
+		((std::memcpy( OUT dst, &args, sizeof(args) ), dst += sizeof(args)), ...);
+	}
+
+/*
+=================================================
+	_Format
+----
+	called in background thread
+=================================================
+*/
+	template <typename ...Args>
+	inline void  AsyncLogger::_Format (ArrayView<uint8_t> data, INOUT String &str)
+	{
+		const char*	fmt;
+		std::memcpy( OUT &fmt, data.data(), sizeof(fmt) );
+
+		const uint8_t*	src		= data.data() + sizeof(fmt);
+		StringView		fmt_str	{ fmt };
+
+		(_FormatArg<Args>( INOUT src, INOUT fmt_str, INOUT str ), ...);
+		str << fmt_str;
+	}
+
+	template <typename T>
+	inline void  AsyncLogger::_FormatArg (const uint8_t* &src, INOUT StringView &fmt, INOUT String &str)
+	{
+		// argument may be not default constructible, so copy bytes to aligned storage and copy-construct from it
+		alignas(T) uint8_t	storage [sizeof(T)];
+		std::memcpy( OUT storage, src, sizeof(T) );
+		src += sizeof(T);
+
+		const T		value( *std::launder( reinterpret_cast<const T *>( storage )));
+
+		const size_t	pos = fmt.find( "{}" );
+
+		if ( pos == StringView::npos )
+		{
+			str << fmt << ' ' << ToString( value );
+			fmt = Default;
+			return;
+		}
+
+		str << fmt.substr( 0, pos ) << ToString( value );
+		fmt = fmt.substr( pos + 2 );
+	}
+
+}	// FGC
+
+
+// "" concatenation fails to compile if format is not a string literal
+#define FG_LOGI_ASYNC( ... )	::FGC::AsyncLogger::Info( __FILE__, __LINE__, "" __VA_ARGS__ )
@@ -1,6 +1,6 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
-#include "stl/Algorithms/StringUtils.h"
+#include "stl/Log/AsyncLogger.h"
 #include <iostream>
 
 using namespace FGC;
@@ -15,10 +15,11 @@ using namespace FGC;
 	{
 		const String str = String{file} << '(' << ToString( line ) << "): " << message;
 
+		// info messages are flushed in 'Logger::FlushOutput'
 		if ( isError )
 			std::cerr << str << std::endl;
 		else
-			std::cout << str << std::endl;
+			std::cout << str << '\n';
 	}
 	
 /*
@@ -35,6 +36,42 @@ using namespace FGC;
 	{
 		return Error( StringView{msg}, StringView{func}, StringView{file}, line );
 	}
+
+/*
+=================================================
+	Info
+=================================================
+*/
+	Logger::EResult  FGC::Logger::Info (const StringView &msg, const StringView &func, const StringView &file, int line)
+	{
+		if ( not AsyncLogger::Enqueue( msg, file, line ))
+		{
+			InfoSync( msg, func, file, line );
+			FlushOutput();
+		}
+		return EResult::Continue;
+	}
+
+/*
+=================================================
+	Error
+=================================================
+*/
+	Logger::EResult  FGC::Logger::Error (const StringView &msg, const StringView &func, const StringView &file, int line)
+	{
+		AsyncLogger::Flush();
+		return _ErrorSync( msg, func, file, line );
+	}
+
+/*
+=================================================
+	FlushOutput
+=================================================
+*/
+	void  FGC::Logger::FlushOutput ()
+	{
+		std::cout.flush();
+	}
 //-----------------------------------------------------------------------------
 
 
@@ -50,21 +87,20 @@ namespace {
 
 /*
 =================================================
-	Info
+	InfoSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Info (const StringView &msg, const StringView &func, const StringView &file, int line)
+	void  FGC::Logger::InfoSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		(void)__android_log_print( ANDROID_LOG_WARN, FG_ANDROID_TAG, "%s (%i): %s", file.data(), line, msg.data() );
-		return EResult::Continue;
 	}
 	
 /*
 =================================================
-	Error
+	_ErrorSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Error (const StringView &msg, const StringView &func, const StringView &file, int line)
+	Logger::EResult  FGC::Logger::_ErrorSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		(void)__android_log_print( ANDROID_LOG_ERROR, FG_ANDROID_TAG, "%s (%i): %s", file.data(), line, msg.data() );
 		return EResult::Continue;
@@ -94,23 +130,21 @@ namespace {
 	
 /*
 =================================================
-	Info
+	InfoSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Info (const StringView &msg, const StringView &, const StringView &file, int line)
+	void  FGC::Logger::InfoSync (const StringView &msg, const StringView &, const StringView &file, int line)
 	{
 		IDEConsoleMessage( msg, file, line, false );
 		ConsoleOutput( msg, file, line, false );
-
-		return EResult::Continue;
 	}
 	
 /*
 =================================================
-	Error
+	_ErrorSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Error (const StringView &msg, const StringView &func, const StringView &file, int line)
+	Logger::EResult  FGC::Logger::_ErrorSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		IDEConsoleMessage( msg, file, line, true );
 		ConsoleOutput( msg, file, line, true );
@@ -142,21 +176,20 @@ namespace {
 
 /*
 =================================================
-	Info
+	InfoSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Info (const StringView &msg, const StringView &func, const StringView &file, int line)
+	void  FGC::Logger::InfoSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		ConsoleOutput( msg, file, line, false );
-		return EResult::Continue;
 	}
 
 /*
 =================================================
-	Error
+	_ErrorSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Error (const StringView &msg, const StringView &func, const StringView &file, int line)
+	Logger::EResult  FGC::Logger::_ErrorSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		ConsoleOutput( msg, file, line, true );
 		return EResult::Abort;
@@ -174,21 +207,20 @@ namespace {
 
 /*
 =================================================
-	Info
+	InfoSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Info (const StringView &msg, const StringView &func, const StringView &file, int line)
+	void  FGC::Logger::InfoSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		ConsoleOutput( msg, file, line, false );
-		return EResult::Continue;
 	}
 	
 /*
 =================================================
-	Error
+	_ErrorSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Error (const StringView &msg, const StringView &func, const StringView &file, int line)
+	Logger::EResult  FGC::Logger::_ErrorSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		/*Widget top_wid, button;
 		XtAppContext  app;
@@ -219,21 +251,20 @@ namespace {
 
 /*
 =================================================
-	Info
+	InfoSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Info (const StringView &msg, const StringView &func, const StringView &file, int line)
+	void  FGC::Logger::InfoSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		ConsoleOutput( msg, file, line, false );
-		return EResult::Continue;
 	}
 	
 /*
 =================================================
-	Error
+	_ErrorSync
 =================================================
 */
-	Logger::EResult  FGC::Logger::Error (const StringView &msg, const StringView &func, const StringView &file, int line)
+	Logger::EResult  FGC::Logger::_ErrorSync (const StringView &msg, const StringView &func, const StringView &file, int line)
 	{
 		ConsoleOutput( msg, file, line, true );
 		return EResult::Abort;
@@ -21,11 +21,20 @@ namespace FGC
 			Abort,
 		};
 		
+		// message is written asynchronously if 'AsyncLogger' is running
 		static EResult  Info (const char *msg, const char *func, const char *file, int line);
 		static EResult  Info (const StringView &msg, const StringView &func, const StringView &file, int line);
 
+		// always synchronous, pending asynchronous messages are written before
 		static EResult  Error (const char *msg, const char *func, const char *file, int line);
 		static EResult  Error (const StringView &msg, const StringView &func, const StringView &file, int line);
+
+		// platform specific output, used by 'AsyncLogger'
+		static void  InfoSync (const StringView &msg, const StringView &func, const StringView &file, int line);
+		static void  FlushOutput ();
+
+	private:
+		static EResult  _ErrorSync (const StringView &msg, const StringView &func, const StringView &file, int line);
 	};
 
 }	// FGC
@@ -0,0 +1,262 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_CPU_TRACE
+
+#include "stl/Log/TraceRecorder.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "stl/Stream/FileStream.h"
+#include <chrono>
+
+namespace FGC
+{
+namespace
+{
+	using Clock_t	= std::chrono::high_resolution_clock;
+	using Event		= TraceRecorder::Event;
+
+	static constexpr uint	ChunkSize		= 1u << 12;
+	static constexpr uint	MaxChunks		= 256;		// up to 1M events per thread
+	static constexpr size_t	MaxNameLength	= 63;
+
+	//
+	// Thread Buffer
+	//
+	struct ThreadBuffer
+	{
+		std::atomic<uint>		count	{0};
+		std::atomic<Event *>	chunks [MaxChunks] = {};
+		uint					index	= 0;
+		ThreadBuffer *			next	= null;
+
+		~ThreadBuffer ()
+		{
+			for (auto& chunk : chunks) {
+				delete[] chunk.load( std::memory_order_relaxed );
+			}
+		}
+	};
+
+	//
+	// Thread Buffer List
+	//
+	struct ThreadBufferList
+	{
+		std::atomic<ThreadBuffer *>		head		{null};
+		std::atomic<uint>				count		{0};
+		std::atomic<int64_t>			startTime	{0};
+
+		~ThreadBufferList ()
+		{
+			for (ThreadBuffer* buf = head.load(); buf;)
+			{
+				ThreadBuffer*	next = buf->next;
+				delete buf;
+				buf = next;
+			}
+		}
+	};
+
+	static ThreadBufferList		s_buffers;
+	static thread_local ThreadBuffer*	t_buffer = null;
+
+/*
+=================================================
+	GetThreadBuffer
+----
+	buffer is created once per thread and added to the lock-free list
+=================================================
+*/
+	ND_ static ThreadBuffer&  GetThreadBuffer ()
+	{
+		if ( t_buffer )
+			return *t_buffer;
+
+		ThreadBuffer*	buf = new ThreadBuffer{};
+		buf->index	= s_buffers.count.fetch_add( 1, std::memory_order_relaxed );
+		buf->next	= s_buffers.head.load( std::memory_order_relaxed );
+
+		for (; not s_buffers.head.compare_exchange_weak( INOUT buf->next, buf, std::memory_order_release, std::memory_order_relaxed );) {}
+
+		t_buffer = buf;
+		return *buf;
+	}
+
+/*
+=================================================
+	AppendJsonString
+=================================================
+*/
+	static void  AppendJsonString (INOUT String &str, StringView value)
+	{
+		str << '"';
+		for (char c : value)
+		{
+			switch ( c )
+			{
+				case '"' :	str << "\\\"";	break;
+				case '\\' :	str << "\\\\";	break;
+				case '\n' :	str << "\\n";	break;
+				case '\t' :	str << "\\t";	break;
+				default :	if ( uint8_t(c) >= 0x20 ) str << c;	break;
+			}
+		}
+		str << '"';
+	}
+
+/*
+=================================================
+	AppendMicroseconds
+----
+	chrome trace uses microseconds, keep nanosecond precision
+=================================================
+*/
+	static void  AppendMicroseconds (INOUT String &str, uint64_t ns)
+	{
+		const uint	frac = uint(ns % 1000);
+
+		str << ToString( ns / 1000 ) << '.'
+			<< char('0' + frac / 100) << char('0' + (frac / 10) % 10) << char('0' + frac % 10);
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+/*
+=================================================
+	Start
+=================================================
+*/
+	void  TraceRecorder::Start ()
+	{
+		_enabled.store( false, std::memory_order_relaxed );
+
+		for (ThreadBuffer* buf = s_buffers.head.load( std::memory_order_acquire ); buf; buf = buf->next) {
+			buf->count.store( 0, std::memory_order_relaxed );
+		}
+
+		s_buffers.startTime.store( Clock_t::now().time_since_epoch().count(), std::memory_order_relaxed );
+		_enabled.store( true, std::memory_order_release );
+	}
+
+/*
+=================================================
+	Stop
+=================================================
+*/
+	void  TraceRecorder::Stop ()
+	{
+		_enabled.store( false, std::memory_order_release );
+	}
+
+/*
+=================================================
+	Now
+=================================================
+*/
+	uint64_t  TraceRecorder::Now ()
+	{
+		const int64_t	start	= s_buffers.startTime.load( std::memory_order_relaxed );
+		const int64_t	now		= Clock_t::now().time_since_epoch().count();
+
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>( Clock_t::duration{ Max( now, start ) - start }).count());
+	}
+
+/*
+=================================================
+	AddEvent
+=================================================
+*/
+	void  TraceRecorder::AddEvent (StringView name, const char *category, uint64_t begin, uint64_t end)
+	{
+		AddEvent( ETrack::CPU, UMax, name, category, begin, end );
+	}
+
+	void  TraceRecorder::AddEvent (ETrack process, uint track, StringView name, const char *category, uint64_t begin, uint64_t end)
+	{
+		if ( not IsEnabled() )
+			return;
+
+		ThreadBuffer&	buf		= GetThreadBuffer();
+		const uint		idx		= buf.count.load( std::memory_order_relaxed );
+		const uint		chunk	= idx / ChunkSize;
+
+		// buffer overflow, event is dropped
+		if ( chunk >= MaxChunks )
+			return;
+
+		Event*	events = buf.chunks[chunk].load( std::memory_order_relaxed );
+		if ( not events )
+		{
+			events = new Event[ ChunkSize ];
+			buf.chunks[chunk].store( events, std::memory_order_relaxed );
+		}
+
+		Event&	ev = events[ idx % ChunkSize ];
+		ev.name		= Name_t{ name.data(), Min( name.length(), MaxNameLength )};
+		ev.category	= category;
+		ev.begin	= begin;
+		ev.duration	= end > begin ? end - begin : 0;
+		ev.process	= process;
+		ev.track	= (process == ETrack::CPU and track == UMax ? buf.index : track);
+
+		// publish event and chunk pointer
+		buf.count.store( idx + 1, std::memory_order_release );
+	}
+
+/*
+=================================================
+	ToChromeTrace
+=================================================
+*/
+	bool  TraceRecorder::ToChromeTrace (OUT String &str)
+	{
+		str.clear();
+		str << "{\"traceEvents\":[\n"
+			<< "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU\"}},\n"
+			<< "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+
+		for (ThreadBuffer* buf = s_buffers.head.load( std::memory_order_acquire ); buf; buf = buf->next)
+		{
+			const uint	count = buf->count.load( std::memory_order_acquire );
+
+			for (uint i = 0; i < count; ++i)
+			{
+				const Event&	ev = buf->chunks[ i / ChunkSize ].load( std::memory_order_relaxed )[ i % ChunkSize ];
+
+				str << ",\n{\"name\":";
+				AppendJsonString( INOUT str, ev.name );
+				str << ",\"cat\":";
+				AppendJsonString( INOUT str, ev.category ? ev.category : "" );
+				str << ",\"ph\":\"X\",\"pid\":" << ToString( uint(ev.process) ) << ",\"tid\":" << ToString( ev.track ) << ",\"ts\":";
+				AppendMicroseconds( INOUT str, ev.begin );
+				str << ",\"dur\":";
+				AppendMicroseconds( INOUT str, ev.duration );
+				str << '}';
+			}
+		}
+
+		str << "\n],\n\"displayTimeUnit\":\"ns\"}\n";
+		return true;
+	}
+
+/*
+=================================================
+	SaveChromeTrace
+=================================================
+*/
+	bool  TraceRecorder::SaveChromeTrace (NtStringView filename)
+	{
+		String	str;
+		CHECK_ERR( ToChromeTrace( OUT str ));
+
+		FileWStream		file{ filename };
+		CHECK_ERR( file.IsOpen() );
+		CHECK_ERR( file.Write( StringView{str} ));
+		return true;
+	}
+
+
+}	// FGC
+
+#endif	// FG_ENABLE_CPU_TRACE
@@ -0,0 +1,113 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	CPU events recorder, events are exported in chrome trace format,
+	use 'chrome://tracing' or 'ui.perfetto.dev' to view it.
+
+	Each thread writes events into its own buffer without locks,
+	buffers are reused between recordings and released at exit.
+	'Start', 'Stop' and export must not be called while other threads are recording events.
+
+	Recorder is compiled out if 'FG_ENABLE_CPU_TRACE' is not defined.
+*/
+
+#pragma once
+
+#ifdef FG_ENABLE_CPU_TRACE
+
+#include "stl/Containers/StaticString.h"
+#include "stl/Containers/NtStringView.h"
+#include <atomic>
+
+namespace FGC
+{
+
+	//
+	// Trace Recorder
+	//
+
+	class TraceRecorder final
+	{
+	// types
+	public:
+		using Name_t	= StaticString<64>;
+
+		enum class ETrack : uint
+		{
+			CPU		= 0,	// thread index is used as track
+			GPU		= 1,	// queue index is used as track
+		};
+
+		struct Event
+		{
+			Name_t			name;
+			const char *	category	= null;		// must be string literal
+			uint64_t		begin		= 0;		// nanoseconds since 'Start'
+			uint64_t		duration	= 0;
+			ETrack			process		= ETrack::CPU;
+			uint			track		= 0;
+		};
+
+
+	// variables
+	private:
+		inline static std::atomic<bool>		_enabled	{false};
+
+
+	// methods
+	public:
+		TraceRecorder () = delete;
+
+		// clear previous events and start recording
+		static void  Start ();
+		static void  Stop ();
+
+		ND_ static bool  IsEnabled ()	{ return _enabled.load( std::memory_order_relaxed ); }
+
+		// nanoseconds since 'Start'
+		ND_ static uint64_t  Now ();
+
+		static void  AddEvent (StringView name, const char *category, uint64_t begin, uint64_t end);
+		static void  AddEvent (ETrack process, uint track, StringView name, const char *category, uint64_t begin, uint64_t end);
+
+		static bool  ToChromeTrace (OUT String &result);
+		static bool  SaveChromeTrace (NtStringView filename);
+	};
+
+
+
+	//
+	// Trace Scope
+	//
+
+	struct TraceScope
+	{
+	private:
+		StringView		_name;
+		const char *	_category;
+		uint64_t		_begin	= UMax;
+
+	public:
+		TraceScope (StringView name, const char *category) : _name{ name }, _category{ category }
+		{
+			if ( TraceRecorder::IsEnabled() )
+				_begin = TraceRecorder::Now();
+		}
+
+		~TraceScope ()
+		{
+			if ( _begin != UMax )
+				TraceRecorder::AddEvent( _name, _category, _begin, TraceRecorder::Now() );
+		}
+	};
+
+
+}	// FGC
+
+#	define FG_TRACE_SCOPE( _name_, _category_ ) \
+		::FGC::TraceScope	FG_PRIVATE_UNITE_RAW( __traceScope, __COUNTER__ ) { (_name_), (_category_) }
+
+#else
+
+#	define FG_TRACE_SCOPE( _name_, _category_ )
+
+#endif	// FG_ENABLE_CPU_TRACE
@@ -0,0 +1,305 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Stream/MappedFileStream.h"
+#include "stl/Algorithms/StringUtils.h"
+
+#ifdef PLATFORM_WINDOWS
+#	include "stl/Platforms/WindowsHeader.h"
+#elif defined(PLATFORM_LINUX) or defined(PLATFORM_ANDROID)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#	define FG_POSIX_MMAP
+#endif
+
+namespace FGC
+{
+namespace
+{
+/*
+=================================================
+	MapFile
+----
+	returns 'false' if file can't be opened,
+	returns 'true' and null 'mapped' if file is opened but can't be mapped.
+=================================================
+*/
+#if defined(PLATFORM_WINDOWS)
+	template <typename PathType>
+	static bool  MapFile (const PathType &path, OUT uint8_t const* &mapped, OUT uint64_t &size)
+	{
+		HANDLE	file;
+		if constexpr ( IsSameTypes< PathType, const wchar_t* > )
+			file = ::CreateFileW( path, GENERIC_READ, FILE_SHARE_READ, null, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, null );
+		else
+			file = ::CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, null, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, null );
+
+		if ( file == INVALID_HANDLE_VALUE )
+			return false;
+
+		LARGE_INTEGER	file_size = {};
+		if ( not ::GetFileSizeEx( file, OUT &file_size ))
+		{
+			::CloseHandle( file );
+			return false;
+		}
+		size = uint64_t(file_size.QuadPart);
+
+		if ( size > 0 )
+		{
+			// view keeps reference to the mapping object, so handles can be closed immediately
+			HANDLE	mapping = ::CreateFileMappingW( file, null, PAGE_READONLY, 0, 0, null );
+			if ( mapping )
+			{
+				mapped = static_cast<uint8_t const*>( ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ));
+				::CloseHandle( mapping );
+			}
+		}
+		::CloseHandle( file );
+		return true;
+	}
+
+	static void  UnmapFile (uint8_t const* mapped, uint64_t)
+	{
+		CHECK( ::UnmapViewOfFile( mapped ));
+	}
+
+#elif defined(FG_POSIX_MMAP)
+	static bool  MapFile (const char *path, OUT uint8_t const* &mapped, OUT uint64_t &size)
+	{
+		const int	fd = ::open( path, O_RDONLY | O_CLOEXEC );
+		if ( fd < 0 )
+			return false;
+
+		struct stat	st = {};
+		if ( ::fstat( fd, OUT &st ) != 0 )
+		{
+			::close( fd );
+			return false;
+		}
+		size = uint64_t(st.st_size);
+
+		if ( size > 0 and size <= uint64_t(std::numeric_limits<size_t>::max()) )
+		{
+			void*	ptr = ::mmap( null, size_t(size), PROT_READ, MAP_PRIVATE, fd, 0 );
+			if ( ptr != MAP_FAILED )
+			{
+				mapped = static_cast<uint8_t const*>( ptr );
+				::madvise( ptr, size_t(size), MADV_SEQUENTIAL );
+			}
+		}
+
+		// mapping keeps reference to the file
+		::close( fd );
+		return true;
+	}
+
+	static void  UnmapFile (uint8_t const* mapped, uint64_t size)
+	{
+		CHECK( ::munmap( const_cast<uint8_t *>(mapped), size_t(size) ) == 0 );
+	}
+
+#else
+	template <typename PathType>
+	static bool  MapFile (const PathType &, OUT uint8_t const* &, OUT uint64_t &)
+	{
+		// not supported, use fallback
+		return true;
+	}
+
+	static void  UnmapFile (uint8_t const*, uint64_t) {}
+#endif
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	MappedFileRStream::MappedFileRStream (NtStringView filename)
+	{
+		_Open( filename.c_str(), StringView{filename} );
+	}
+
+	MappedFileRStream::MappedFileRStream (const char *filename) : MappedFileRStream{ NtStringView{filename} }
+	{}
+
+	MappedFileRStream::MappedFileRStream (const String &filename) : MappedFileRStream{ NtStringView{filename} }
+	{}
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+#ifdef FG_STD_FILESYSTEM
+	MappedFileRStream::MappedFileRStream (const std::filesystem::path &path)
+	{
+	#ifdef PLATFORM_WINDOWS
+		_Open( path.c_str(), path.string() );
+	#else
+		_Open( path.c_str(), path.native() );
+	#endif
+	}
+#endif
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	MappedFileRStream::~MappedFileRStream ()
+	{
+		_Close();
+	}
+
+/*
+=================================================
+	_Open
+=================================================
+*/
+	template <typename PathType>
+	void  MappedFileRStream::_Open (const PathType &path, StringView name)
+	{
+		uint64_t	size = 0;
+
+		if ( not MapFile( path, OUT _mapped, OUT size ))
+		{
+			FG_LOGI( "Can't open file: \""s << name << '"' );
+			return;
+		}
+
+		_isOpen		= true;
+		_fileSize	= BytesU{size};
+
+		if ( _mapped or size == 0 )
+			return;
+
+		// fallback to buffered reading
+		FG_LOGI( "Can't map file: \""s << name << "\", file will be read without mapping" );
+
+		_fallback.reset( new FileRStream{ path });
+		_isOpen = _fallback->IsOpen();
+	}
+
+/*
+=================================================
+	_Close
+=================================================
+*/
+	void  MappedFileRStream::_Close ()
+	{
+		if ( _mapped )
+			UnmapFile( _mapped, uint64_t(_fileSize) );
+
+		_mapped		= null;
+		_isOpen		= false;
+		_fileSize	= 0_b;
+		_position	= 0_b;
+		_fallback.reset();
+	}
+
+/*
+=================================================
+	SeekSet
+=================================================
+*/
+	bool  MappedFileRStream::SeekSet (BytesU pos)
+	{
+		ASSERT( IsOpen() );
+
+		_position = Min( pos, _fileSize );
+		return _position == pos;
+	}
+
+/*
+=================================================
+	Read2
+=================================================
+*/
+	BytesU  MappedFileRStream::Read2 (OUT void *buffer, BytesU size)
+	{
+		ASSERT( IsOpen() );
+
+		size = Min( size, _fileSize - _position );
+
+		if ( _mapped )
+		{
+			std::memcpy( OUT buffer, _mapped + size_t(_position), size_t(size) );
+		}
+		else
+		if ( _fallback )
+		{
+			if ( _fallback->Position() != _position )
+				CHECK_ERR( _fallback->SeekSet( _position ));
+
+			size = _fallback->Read2( OUT buffer, size );
+		}
+		else
+			size = 0_b;
+
+		_position += size;
+		return size;
+	}
+
+/*
+=================================================
+	GetView
+=================================================
+*/
+	ArrayView<uint8_t>  MappedFileRStream::GetView (BytesU offset, BytesU size)
+	{
+		ASSERT( IsOpen() );
+
+		offset	= Min( offset, _fileSize );
+		size	= Min( size, _fileSize - offset );
+
+		if ( _mapped )
+			return ArrayView<uint8_t>{ _mapped + size_t(offset), size_t(size) };
+
+		if ( not _fallback )
+			return Default;
+
+		_fallbackView.resize( size_t(size) );
+
+		CHECK_ERR( _fallback->SeekSet( offset ));
+		_fallbackView.resize( size_t(_fallback->Read2( OUT _fallbackView.data(), size )));
+
+		return _fallbackView;
+	}
+
+/*
+=================================================
+	WillNeed
+=================================================
+*/
+	void  MappedFileRStream::WillNeed (BytesU offset, BytesU size) const
+	{
+	#ifdef FG_POSIX_MMAP
+		if ( not _mapped )
+			return;
+
+		offset	= Min( offset, _fileSize );
+		size	= Min( size, _fileSize - offset );
+
+		// address must be aligned to the page size
+		const size_t	page	= size_t(::sysconf( _SC_PAGESIZE ));
+		const size_t	begin	= size_t(offset) & ~(page - 1);
+		const size_t	end		= size_t(offset + size);
+
+		if ( end > begin )
+			::madvise( const_cast<uint8_t *>(_mapped) + begin, end - begin, MADV_WILLNEED );
+
+	#else
+		// Windows 7 doesn't support 'PrefetchVirtualMemory'
+		FG_UNUSED( offset, size );
+	#endif
+	}
+
+
+}	// FGC
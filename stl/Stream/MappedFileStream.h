@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Read-only stream on top of memory mapped file.
+	'GetView' returns pointer to the mapped memory without copying,
+	if mapping failed then file is read with 'FileRStream'.
+*/
+
+#pragma once
+
+#include "stl/Stream/FileStream.h"
+
+namespace FGC
+{
+
+	//
+	// Read-only Memory Mapped File Stream
+	//
+
+	class MappedFileRStream final : public RStream
+	{
+	// variables
+	private:
+		uint8_t const*			_mapped		= null;
+		BytesU					_fileSize;
+		BytesU					_position;
+		bool					_isOpen		= false;
+
+		UniquePtr<FileRStream>	_fallback;
+		Array<uint8_t>			_fallbackView;		// used by 'GetView' when file is not mapped
+
+
+	// methods
+	public:
+		MappedFileRStream () {}
+		MappedFileRStream (NtStringView filename);
+		MappedFileRStream (const char *filename);
+		MappedFileRStream (const String &filename);
+	#ifdef FG_STD_FILESYSTEM
+		MappedFileRStream (const std::filesystem::path &path);
+	#endif
+		~MappedFileRStream ();
+
+		bool	IsOpen ()	const override		{ return _isOpen; }
+		BytesU	Position ()	const override		{ return _position; }
+		BytesU	Size ()		const override		{ return _fileSize; }
+
+		bool	SeekSet (BytesU pos) override;
+		BytesU	Read2 (OUT void *buffer, BytesU size) override;
+
+		ND_ bool  IsMapped ()	const			{ return _mapped != null; }
+
+		// returns view of the byte range, range is clamped to the file size.
+		// view is valid while stream is alive, if file is not mapped then only until next call of 'GetView'.
+		ND_ ArrayView<uint8_t>  GetView (BytesU offset, BytesU size);
+
+		// hint that range will be accessed soon
+		void  WillNeed (BytesU offset, BytesU size) const;
+
+	private:
+		template <typename PathType>
+		void  _Open (const PathType &path, StringView name);
+		void  _Close ();
+	};
+
+
+}	// FGC
@@ -0,0 +1,391 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/JobSystem.h"
+#include "stl/Platforms/ThreadName.h"
+#include "stl/Algorithms/StringUtils.h"
+
+#ifdef PLATFORM_WINDOWS
+#	include "stl/Platforms/WindowsHeader.h"
+#elif defined(PLATFORM_LINUX) or defined(PLATFORM_ANDROID)
+#	include <sched.h>
+#endif
+
+namespace FGC
+{
+namespace
+{
+	struct CurrentWorker
+	{
+		JobSystem const*	owner	= null;
+		uint				index	= UMax;
+	};
+
+	static thread_local CurrentWorker	t_worker;
+
+/*
+=================================================
+	SetCurrentThreadAffinity
+=================================================
+*/
+	static bool  SetCurrentThreadAffinity (uint64_t mask)
+	{
+		if ( mask == 0 )
+			return true;
+
+	#if defined(PLATFORM_WINDOWS)
+		return ::SetThreadAffinityMask( ::GetCurrentThread(), DWORD_PTR(mask) ) != 0;
+
+	#elif defined(PLATFORM_LINUX) or defined(PLATFORM_ANDROID)
+		cpu_set_t	cpu_set;
+		CPU_ZERO( &cpu_set );
+
+		for (uint i = 0; i < 64; ++i)
+		{
+			if ( mask & (uint64_t(1) << i) )
+				CPU_SET( i, &cpu_set );
+		}
+		return ::sched_setaffinity( 0, sizeof(cpu_set), &cpu_set ) == 0;
+
+	#else
+		return false;
+	#endif
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	JobSystem::~JobSystem ()
+	{
+		Deinitialize();
+	}
+
+/*
+=================================================
+	Initialize
+=================================================
+*/
+	bool  JobSystem::Initialize (const Config &cfg)
+	{
+		CHECK_ERR( not _running.load( memory_order_relaxed ));
+		CHECK_ERR( _workers.empty() );
+
+		const uint	count = cfg.workerCount ? cfg.workerCount : Max( 1u, std::thread::hardware_concurrency() ) - 1;
+
+		_workers.resize( count );
+		for (uint i = 0; i < count; ++i)
+		{
+			_workers[i].reset( new Worker{} );
+			_workers[i]->affinity = (i < cfg.affinity.size() ? cfg.affinity[i] : 0);
+		}
+
+		_running.store( true, memory_order_relaxed );
+		_activeWorkers.store( count, memory_order_relaxed );
+
+		// flush cache
+		std::atomic_thread_fence( memory_order_release );
+
+		for (uint i = 0; i < count; ++i)
+		{
+			if ( cfg.threadStarter )
+				cfg.threadStarter( i, [this, i] () { _WorkerLoop( i ); });
+			else
+				_threads.emplace_back( [this, i] () { _WorkerLoop( i ); });
+		}
+		return true;
+	}
+
+/*
+=================================================
+	Deinitialize
+----
+	workers are stopped, pending jobs are executed in the current thread
+=================================================
+*/
+	void  JobSystem::Deinitialize ()
+	{
+		if ( not _running.exchange( false, memory_order_relaxed ))
+			return;
+
+		{
+			std::unique_lock	lock{ _sleepGuard };
+			_sleepCV.notify_all();
+		}
+
+		for (auto& t : _threads) {
+			t.join();
+		}
+		_threads.clear();
+
+		// wait for application threads
+		for (; _activeWorkers.load( memory_order_acquire ) > 0;)
+		{
+			_sleepCV.notify_all();
+			std::this_thread::yield();
+		}
+
+		// steal remaining jobs
+		for (; _ExecuteOne( UMax );) {}
+
+		_workers.clear();
+	}
+
+/*
+=================================================
+	IsWorkerThread
+=================================================
+*/
+	bool  JobSystem::IsWorkerThread () const
+	{
+		return t_worker.owner == this;
+	}
+
+/*
+=================================================
+	Run
+=================================================
+*/
+	void  JobSystem::Run (Job_t &&job, JobCounter *signal)
+	{
+		if ( signal )
+			signal->_value.fetch_add( 1, memory_order_relaxed );
+
+		JobIndex_t	index;
+		if ( _AllocJob( std::move(job), signal, OUT index ))
+			return _Schedule( index );
+
+		// job pool overflow
+		job();
+		_Signal( signal );
+	}
+
+	void  JobSystem::Run (Job_t &&job, const JobCounter &dependsOn, JobCounter *signal)
+	{
+		auto&	dep = const_cast<JobCounter &>( dependsOn );
+
+		if ( signal )
+			signal->_value.fetch_add( 1, memory_order_relaxed );
+
+		JobIndex_t	index;
+		if ( not _AllocJob( std::move(job), signal, OUT index ))
+		{
+			// job pool overflow
+			Wait( dependsOn );
+			job();
+			_Signal( signal );
+			return;
+		}
+
+		{
+			EXLOCK( dep._guard );
+			if ( dep._value.load( memory_order_acquire ) > 0 )
+			{
+				dep._waiters.push_back( index );
+				return;
+			}
+		}
+		_Schedule( index );
+	}
+
+/*
+=================================================
+	Wait
+=================================================
+*/
+	void  JobSystem::Wait (const JobCounter &counter)
+	{
+		const uint	worker = (t_worker.owner == this ? t_worker.index : UMax);
+
+		for (uint i = 0; counter._value.load( memory_order_acquire ) > 0;)
+		{
+			if ( _ExecuteOne( worker ))
+			{
+				i = 0;
+				continue;
+			}
+
+			if ( ++i > 100 )
+			{
+				i = 0;
+				std::this_thread::yield();
+			}
+		}
+
+		// counter may be destroyed after return, wait until '_Execute' releases the lock
+		EXLOCK( counter._guard );
+	}
+
+/*
+=================================================
+	_AllocJob
+=================================================
+*/
+	bool  JobSystem::_AllocJob (Job_t &&func, JobCounter *signal, OUT JobIndex_t &index)
+	{
+		if ( not _jobPool.Assign( OUT index ))
+			return false;
+
+		auto&	job = _jobPool[ index ];
+		job.func	= std::move(func);
+		job.signal	= signal;
+		return true;
+	}
+
+/*
+=================================================
+	_Schedule
+=================================================
+*/
+	void  JobSystem::_Schedule (JobIndex_t index)
+	{
+		_pendingJobs.fetch_add( 1, memory_order_relaxed );
+
+		bool	pushed = false;
+
+		if ( t_worker.owner == this )
+			pushed = _workers[ t_worker.index ]->deque.Push( index );
+
+		if ( not pushed )
+			pushed = _injected.Push( JobIndex_t{index} );
+
+		if ( not pushed )
+		{
+			// queue overflow
+			_pendingJobs.fetch_sub( 1, memory_order_relaxed );
+			return _Execute( index );
+		}
+
+		if ( _sleeping.load( memory_order_relaxed ) > 0 )
+			_sleepCV.notify_one();
+	}
+
+/*
+=================================================
+	_ExecuteOne
+=================================================
+*/
+	bool  JobSystem::_ExecuteOne (uint workerIndex)
+	{
+		JobIndex_t	index;
+		bool		found	= false;
+		const uint	count	= uint(_workers.size());
+
+		// own deque
+		if ( workerIndex < count )
+			found = _workers[ workerIndex ]->deque.Pop( OUT index );
+
+		// injected jobs
+		if ( not found and _injectedPopGuard.try_lock() )
+		{
+			found = _injected.Pop( OUT index );
+			_injectedPopGuard.unlock();
+		}
+
+		// steal from other workers
+		for (uint i = 1; not found and i <= count; ++i)
+		{
+			const uint	victim = (workerIndex + i) % count;
+
+			if ( victim != workerIndex )
+				found = _workers[ victim ]->deque.Steal( OUT index );
+		}
+
+		if ( not found )
+			return false;
+
+		_pendingJobs.fetch_sub( 1, memory_order_relaxed );
+		_Execute( index );
+		return true;
+	}
+
+/*
+=================================================
+	_Execute
+=================================================
+*/
+	void  JobSystem::_Execute (JobIndex_t index)
+	{
+		auto&			job		= _jobPool[ index ];
+		JobCounter*		signal	= job.signal;
+
+		job.func();
+		job.func	= null;
+		job.signal	= null;
+		_jobPool.Unassign( index );
+
+		_Signal( signal );
+	}
+
+/*
+=================================================
+	_Signal
+----
+	decrements counter and schedules dependent jobs
+=================================================
+*/
+	void  JobSystem::_Signal (JobCounter *signal)
+	{
+		if ( not signal )
+			return;
+
+		// decrement under lock, so 'Wait' can't return while the counter is in use
+		Array<JobIndex_t>	waiters;
+		{
+			EXLOCK( signal->_guard );
+			if ( signal->_value.fetch_sub( 1, memory_order_acq_rel ) == 1 )
+				std::swap( waiters, signal->_waiters );
+		}
+
+		for (auto& w : waiters) {
+			_Schedule( w );
+		}
+	}
+
+/*
+=================================================
+	_WorkerLoop
+=================================================
+*/
+	void  JobSystem::_WorkerLoop (uint workerIndex)
+	{
+		t_worker = CurrentWorker{ this, workerIndex };
+
+		SetCurrentThreadName( "JobWorker" );
+		if ( not SetCurrentThreadAffinity( _workers[ workerIndex ]->affinity ))
+			FG_LOGI( "failed to set affinity for job worker "s << ToString( workerIndex ));
+
+		for (uint spin = 0; _running.load( memory_order_relaxed );)
+		{
+			if ( _ExecuteOne( workerIndex ))
+			{
+				spin = 0;
+				continue;
+			}
+
+			if ( ++spin < 64 )
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// notification may be missed, so sleep with timeout
+			std::unique_lock	lock{ _sleepGuard };
+			_sleeping.fetch_add( 1, memory_order_relaxed );
+			_sleepCV.wait_for( lock, std::chrono::milliseconds{1},
+							   [this] () { return _pendingJobs.load( memory_order_relaxed ) > 0 or not _running.load( memory_order_relaxed ); });
+			_sleeping.fetch_sub( 1, memory_order_relaxed );
+			spin = 0;
+		}
+
+		t_worker = Default;
+		_activeWorkers.fetch_sub( 1, memory_order_release );
+	}
+
+
+}	// FGC
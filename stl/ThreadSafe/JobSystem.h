@@ -0,0 +1,190 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Work-stealing job system.
+
+	Each worker owns Chase-Lev deque, jobs that are added in worker thread are pushed into its deque,
+	jobs from other threads are pushed into the shared injection queue.
+	Worker takes jobs from own deque, then from injection queue, then steals from other workers.
+
+	Dependencies are expressed with counters:
+	job may signal counter when it is complete and may wait for another counter before start.
+	If job pool or queue is full then job is executed immediately in the current thread.
+*/
+
+#pragma once
+
+#include "stl/ThreadSafe/LfWorkStealingDeque.h"
+#include "stl/ThreadSafe/LfFixedQueue.h"
+#include "stl/ThreadSafe/LfIndexedPool.h"
+#include "stl/ThreadSafe/SpinLock.h"
+#include "stl/Containers/ArrayView.h"
+#include <functional>
+#include <condition_variable>
+#include <thread>
+
+namespace FGC
+{
+
+	//
+	// Job Counter
+	//
+
+	class JobCounter final
+	{
+		friend class JobSystem;
+
+	// variables
+	private:
+		Atomic<uint>		_value		{0};
+		mutable SpinLock	_guard;
+		Array<uint>			_waiters;		// jobs that will be started when counter reaches zero, protected by '_guard'
+
+	// methods
+	public:
+		JobCounter () {}
+
+		JobCounter (const JobCounter &) = delete;
+		JobCounter (JobCounter &&) = delete;
+
+		JobCounter&  operator = (const JobCounter &) = delete;
+		JobCounter&  operator = (JobCounter &&) = delete;
+
+		ND_ uint  Value ()			const	{ return _value.load( memory_order_acquire ); }
+		ND_ bool  IsComplete ()		const	{ return Value() == 0; }
+	};
+
+
+
+	//
+	// Job System
+	//
+
+	class JobSystem final
+	{
+	// types
+	public:
+		using Job_t				= std::function< void () >;
+		using WorkerLoop_t		= std::function< void () >;
+		using ThreadStarter_t	= std::function< void (uint workerIndex, WorkerLoop_t &&) >;
+
+		struct Config
+		{
+			uint				workerCount		= 0;	// 0 - hardware concurrency minus one
+			Array<uint64_t>		affinity;				// CPU mask for each worker, zero or missing mask - any CPU
+			ThreadStarter_t		threadStarter;			// application thread pool: must call 'WorkerLoop_t' in one of its threads,
+														// loop returns after 'Deinitialize'. If not set then 'std::thread' is created for each worker.
+		};
+
+	private:
+		using JobIndex_t	= uint;
+
+		struct Job
+		{
+			Job_t			func;
+			JobCounter *	signal	= null;
+		};
+
+		struct alignas(FG_CACHE_LINE) Worker
+		{
+			LfWorkStealingDeque< JobIndex_t, (1u << 12) >	deque;
+			uint64_t										affinity	= 0;
+		};
+
+		using JobPool_t			= LfIndexedPool< Job, JobIndex_t, 64, 1024 >;
+		using InjectionQueue_t	= LfFixedQueue< JobIndex_t, (1u << 12) >;
+		using Workers_t			= Array< UniquePtr< Worker >>;
+
+
+	// variables
+	private:
+		JobPool_t				_jobPool;
+		Workers_t				_workers;
+
+		InjectionQueue_t		_injected;
+		SpinLock				_injectedPopGuard;		// 'LfFixedQueue' supports only single consumer
+
+		Array<std::thread>		_threads;
+		Atomic<bool>			_running		{false};
+		Atomic<uint>			_activeWorkers	{0};
+
+		// sleeping
+		Atomic<uint>			_pendingJobs	{0};
+		Atomic<uint>			_sleeping		{0};
+		Mutex					_sleepGuard;
+		std::condition_variable	_sleepCV;
+
+
+	// methods
+	public:
+		JobSystem () {}
+		~JobSystem ();
+
+		JobSystem (const JobSystem &) = delete;
+		JobSystem (JobSystem &&) = delete;
+
+		JobSystem&  operator = (const JobSystem &) = delete;
+		JobSystem&  operator = (JobSystem &&) = delete;
+
+		bool  Initialize (const Config &cfg);
+		void  Deinitialize ();
+
+		// 'signal' is incremented immediately and decremented when job is complete
+		void  Run (Job_t &&job, JobCounter *signal = null);
+
+		// job will be started when 'dependsOn' reaches zero
+		void  Run (Job_t &&job, const JobCounter &dependsOn, JobCounter *signal = null);
+
+		// executes pending jobs in the current thread until counter reaches zero
+		void  Wait (const JobCounter &counter);
+
+		// calls 'fn( item, index )' for each item, returns when all items are processed
+		template <typename T, typename FN>
+		void  ParallelFor (ArrayView<T> items, const FN &fn, size_t batchSize = 0);
+
+		ND_ uint  WorkerCount ()		const	{ return uint(_workers.size()); }
+		ND_ bool  IsWorkerThread ()		const;
+
+	private:
+		ND_ bool  _AllocJob (Job_t &&func, JobCounter *signal, OUT JobIndex_t &index);
+			void  _Schedule (JobIndex_t index);
+		ND_ bool  _ExecuteOne (uint workerIndex);
+			void  _Execute (JobIndex_t index);
+			void  _Signal (JobCounter *signal);
+			void  _WorkerLoop (uint workerIndex);
+	};
+
+
+/*
+=================================================
+	ParallelFor
+=================================================
+*/
+	template <typename T, typename FN>
+	inline void  JobSystem::ParallelFor (ArrayView<T> items, const FN &fn, size_t batchSize)
+	{
+		if ( items.empty() )
+			return;
+
+		if ( batchSize == 0 )
+			batchSize = Max( size_t(1), items.size() / (4 * (_workers.size() + 1)) );
+
+		JobCounter	counter;
+
+		for (size_t i = 0; i < items.size(); i += batchSize)
+		{
+			const size_t	end = Min( i + batchSize, items.size() );
+
+			Run( [&fn, items, i, end] ()
+				 {
+					for (size_t j = i; j < end; ++j) {
+						fn( items[j], j );
+					}
+				 },
+				 &counter );
+		}
+
+		Wait( counter );
+	}
+
+
+}	// FGC
@@ -0,0 +1,331 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Same as CachedIndexedPool, but 'Find' is lock-free.
+
+	Cache index is an open-addressing hash table with linear probing,
+	each slot contains 32 bit hash and value index packed into single atomic,
+	so value is compared only when hash matches.
+	Table grows with the number of cached values and keeps load factor below 1/2,
+	previous table is destroyed when all readers that may use it are finished.
+
+	Insertion and removal are synchronized by 'CacheGuard', readers never take the lock.
+	Removal uses backward shift instead of tombstones, concurrent 'Find' may miss the value that is being moved,
+	this is allowed: caller must handle a false negative by calling 'AddToCache', which returns already cached index.
+
+	Readers increment one of the striped counters of the current epoch,
+	'RemoveFromCache' switches epoch twice and waits until readers of both epochs are finished (like SRCU),
+	so after it returns the value can be safely destroyed.
+*/
+
+#pragma once
+
+#include "stl/Containers/ChunkedIndexedPool.h"
+#include "stl/Math/BitMath.h"
+#include <thread>
+
+namespace FGC
+{
+
+	//
+	// Lock-free Cached Chunked Indexed Pool
+	//
+
+	template <typename ValueType,
+			  typename IndexType,
+			  size_t ChunkSize,
+			  size_t MaxChunks = 16,
+			  typename AllocatorType = UntypedAlignedAllocator,
+			  typename AssignOpGuard = DummyLock,
+			  typename CacheGuard = DummyLock,
+			  template <typename T> class AtomicChunkPtr = AtomicPtr
+			 >
+	struct LfCachedIndexedPool final
+	{
+	// types
+	public:
+		using Self			= LfCachedIndexedPool< ValueType, IndexType, ChunkSize, MaxChunks, AllocatorType, AssignOpGuard, CacheGuard, AtomicChunkPtr >;
+		using Index_t		= IndexType;
+		using Value_t		= ValueType;
+		using Allocator_t	= AllocatorType;
+
+	private:
+		using Pool_t		= ChunkedIndexedPool< Value_t, IndexType, ChunkSize, MaxChunks, AllocatorType, AssignOpGuard, AtomicChunkPtr >;
+		using Slot_t		= Atomic< uint64_t >;
+
+		static constexpr uint64_t	EmptySlot	= 0;
+
+		static constexpr uint		MinTableSize	= 64;
+		static constexpr uint		ReaderStripes	= 16;
+
+		struct Table
+		{
+			const uint					mask;
+			std::unique_ptr< Slot_t[] >	slots;
+
+			explicit Table (uint size) : mask{size - 1}, slots{ new Slot_t[size]() } {}
+		};
+
+		struct alignas(FG_CACHE_LINE) ReaderCounter
+		{
+			Atomic<uint>	value {0};
+		};
+
+		STATIC_ASSERT( Slot_t::is_always_lock_free );
+		STATIC_ASSERT( ChunkSize * MaxChunks < (1ull << 31) );
+
+
+	// variables
+	private:
+		Atomic< Table *>			_table;
+		uint						_count		= 0;	// number of used slots, protected by '_cacheGuard'
+		mutable CacheGuard			_cacheGuard;		// protects all writes into '_table'
+		Atomic<uint>				_epoch		{0};
+		mutable ReaderCounter		_readers [2][ReaderStripes];
+		Pool_t						_pool;
+
+
+	// methods
+	public:
+		LfCachedIndexedPool (const Self &) = delete;
+		Self&  operator = (const Self &) = delete;
+
+		explicit LfCachedIndexedPool (const Allocator_t &alloc = Allocator_t()) :
+			_table{ new Table{ MinTableSize }}, _pool{ alloc }
+		{
+			// flush cache
+			std::atomic_thread_fence( memory_order_release );
+		}
+
+		~LfCachedIndexedPool ()
+		{
+			delete _table.load( memory_order_acquire );
+		}
+
+
+		void  Release ()
+		{
+			EXLOCK( _cacheGuard );
+			_pool.Release();
+
+			Table*	table = _table.load( memory_order_relaxed );
+
+			for (uint i = 0; i <= table->mask; ++i) {
+				table->slots[i].store( EmptySlot, memory_order_relaxed );
+			}
+			_count = 0;
+			std::atomic_thread_fence( memory_order_release );
+		}
+
+
+		ND_ Pair<Index_t, bool>  Insert (Index_t index, Value_t&& value)
+		{
+			std::swap( _pool[index], value );
+
+			return AddToCache( index );
+		}
+
+
+		ND_ Pair<Index_t, bool>  AddToCache (Index_t index)
+		{
+			EXLOCK( _cacheGuard );
+
+			const uint	hash	= _HashOf( _pool[index] );
+			Table*		table	= _table.load( memory_order_relaxed );
+			uint		i		= hash & table->mask;
+
+			for (;; i = (i + 1) & table->mask)
+			{
+				const uint64_t	slot = table->slots[i].load( memory_order_relaxed );
+
+				if ( slot == EmptySlot )
+					break;
+
+				if ( _SlotHash( slot ) == hash and _pool[ _SlotIndex( slot )] == _pool[index] )
+					return { _SlotIndex( slot ), false };
+			}
+
+			if ( (_count + 1) * 2 > table->mask + 1 )
+			{
+				table	= _Grow();
+				i		= _FindEmptySlot( *table, hash );
+			}
+
+			// value must be visible to other threads before the slot
+			table->slots[i].store( _PackSlot( hash, index ), memory_order_release );
+			++_count;
+			return { index, true };
+		}
+
+
+		bool  RemoveFromCache (Index_t index)
+		{
+			EXLOCK( _cacheGuard );
+
+			Table&			table	= *_table.load( memory_order_relaxed );
+			const uint64_t	key		= _PackSlot( _HashOf( _pool[index] ), index );
+			uint			i		= _SlotHash( key ) & table.mask;
+
+			for (;; i = (i + 1) & table.mask)
+			{
+				const uint64_t	slot = table.slots[i].load( memory_order_relaxed );
+
+				if ( slot == EmptySlot )
+					return false;
+
+				if ( slot == key )
+					break;
+			}
+
+			// backward shift: move following slots of the same probe sequence into the hole
+			for (uint j = i;;)
+			{
+				j = (j + 1) & table.mask;
+
+				const uint64_t	slot = table.slots[j].load( memory_order_relaxed );
+
+				if ( slot == EmptySlot )
+					break;
+
+				const uint	home = _SlotHash( slot ) & table.mask;
+
+				// skip if 'home' is cyclically in range (i, j]
+				if ( i <= j ? (i < home and home <= j) : (i < home or home <= j) )
+					continue;
+
+				table.slots[i].store( slot, memory_order_release );
+				i = j;
+			}
+
+			table.slots[i].store( EmptySlot, memory_order_release );
+			--_count;
+
+			_WaitForReaders();
+			return true;
+		}
+
+
+		ND_ Index_t  Find (const Value_t *value) const
+		{
+			const uint		hash	= _HashOf( *value );
+			auto&			counter	= _readers[ _epoch.load( memory_order_relaxed ) & 1 ][ _ReaderStripe() ].value;
+			Index_t			result	= UMax;
+
+			counter.fetch_add( 1, std::memory_order_seq_cst );
+
+			const Table&	table	= *_table.load( std::memory_order_seq_cst );
+
+			for (uint i = hash & table.mask;; i = (i + 1) & table.mask)
+			{
+				const uint64_t	slot = table.slots[i].load( std::memory_order_seq_cst );
+
+				if ( slot == EmptySlot )
+					break;
+
+				if ( _SlotHash( slot ) == hash and _pool[ _SlotIndex( slot )] == *value )
+				{
+					result = _SlotIndex( slot );
+					break;
+				}
+			}
+
+			counter.fetch_sub( 1, memory_order_release );
+			return result;
+		}
+
+
+		ND_ BytesU  DynamicSize () const
+		{
+			EXLOCK( _cacheGuard );
+			return _pool.DynamicSize() + SizeOf<Slot_t> * (_table.load( memory_order_relaxed )->mask + 1);
+		}
+
+
+		template <typename ArrayType>
+		ND_ size_t  Assign (size_t count, INOUT ArrayType &arr)			{ return _pool.Assign( count, INOUT arr ); }
+
+		template <typename ArrayType>
+			void  Unassign (size_t count, INOUT ArrayType &arr)			{ return _pool.Unassign( count, INOUT arr ); }
+
+		ND_ bool  Assign (OUT Index_t &index)							{ return _pool.Assign( OUT index ); }
+			void  Unassign (Index_t index)								{ return _pool.Unassign( index ); }
+
+		ND_ Value_t &			operator [] (Index_t index)				{ return _pool[ index ]; }
+		ND_ Value_t const&		operator [] (Index_t index)		const	{ return _pool[ index ]; }
+
+		ND_ bool				empty ()						const	{ return _pool.empty(); }
+		ND_ size_t				size ()							const	{ return _pool.size(); }
+		ND_ constexpr size_t	capacity ()						const	{ return _pool.capacity(); }
+
+
+	private:
+		ND_ static uint  _HashOf (const Value_t &value)
+		{
+			const uint64_t	h = uint64_t(std::hash<Value_t>()( value ));
+			return uint(h ^ (h >> 32));
+		}
+
+		// doubles the table size, previous table is destroyed when it is not used by readers
+		ND_ Table*  _Grow ()
+		{
+			Table*	old_table	= _table.load( memory_order_relaxed );
+			Table*	new_table	= new Table{ (old_table->mask + 1) * 2 };
+
+			for (uint i = 0; i <= old_table->mask; ++i)
+			{
+				const uint64_t	slot = old_table->slots[i].load( memory_order_relaxed );
+
+				if ( slot != EmptySlot )
+					new_table->slots[ _FindEmptySlot( *new_table, _SlotHash( slot ))].store( slot, memory_order_relaxed );
+			}
+
+			_table.store( new_table, std::memory_order_seq_cst );
+			_WaitForReaders();
+
+			delete old_table;
+			return new_table;
+		}
+
+		ND_ static uint  _FindEmptySlot (const Table &table, uint hash)
+		{
+			uint	i = hash & table.mask;
+			for (; table.slots[i].load( memory_order_relaxed ) != EmptySlot; i = (i + 1) & table.mask) {}
+			return i;
+		}
+
+		// wait until all readers, that may see removed slot or previous table, are finished
+		void  _WaitForReaders ()
+		{
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+
+			// a reader that loaded outdated epoch may increment counter of the current epoch,
+			// so both epochs are switched and waited
+			for (uint e = 0; e < 2; ++e)
+			{
+				const uint	prev = _epoch.fetch_add( 1, std::memory_order_seq_cst ) & 1;
+
+				for (auto& counter : _readers[prev])
+				{
+					for (uint i = 0; counter.value.load( memory_order_acquire ) != 0; ++i)
+					{
+						if ( i > 100 ) {
+							i = 0;
+							std::this_thread::yield();
+						}
+					}
+				}
+			}
+		}
+
+		ND_ static uint  _ReaderStripe ()
+		{
+			static thread_local const uint	stripe = uint(std::hash<std::thread::id>()( std::this_thread::get_id() )) % ReaderStripes;
+			return stripe;
+		}
+
+		ND_ static uint64_t	_PackSlot (uint hash, Index_t index)	{ return (uint64_t(hash) << 32) | (uint64_t(index) + 1); }
+		ND_ static uint		_SlotHash (uint64_t slot)				{ return uint(slot >> 32); }
+		ND_ static Index_t	_SlotIndex (uint64_t slot)				{ return Index_t((slot & 0xFFFFFFFFull) - 1); }
+	};
+
+
+}	// FGC
@@ -0,0 +1,128 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Bounded lock-free queue for multiple producers and single consumer.
+	Each cell has sequence number that tells whether cell is free for producer or contains value for consumer.
+	'Pop' must be externally synchronized.
+*/
+
+#pragma once
+
+#include "stl/Memory/MemUtils.h"
+#include "stl/Algorithms/Cast.h"
+#include <atomic>
+
+namespace FGC
+{
+
+	//
+	// Lock-free Fixed Size Queue
+	//
+
+	template <typename T, size_t Size>
+	struct LfFixedQueue
+	{
+		STATIC_ASSERT( Size > 0 and ((Size & (Size - 1)) == 0) );
+
+	// types
+	public:
+		using Self		= LfFixedQueue< T, Size >;
+		using Value_t	= T;
+
+	private:
+		static constexpr size_t		Mask = Size - 1;
+
+		struct Cell
+		{
+			Atomic<size_t>						seq;
+			alignas(T) uint8_t					data [sizeof(T)];
+		};
+
+
+	// variables
+	private:
+		alignas(FG_CACHE_LINE) Atomic<size_t>	_tail	{0};	// producers
+		alignas(FG_CACHE_LINE) size_t			_head	= 0;	// consumer
+		Cell									_cells [Size];
+
+
+	// methods
+	public:
+		LfFixedQueue ()
+		{
+			for (size_t i = 0; i < Size; ++i) {
+				_cells[i].seq.store( i, memory_order_relaxed );
+			}
+			std::atomic_thread_fence( memory_order_release );
+		}
+
+		LfFixedQueue (const Self &) = delete;
+		Self&  operator = (const Self &) = delete;
+
+		~LfFixedQueue ()
+		{
+			T	temp;
+			while ( Pop( OUT temp )) {}
+		}
+
+
+		// returns 'false' if queue is full
+		ND_ bool  Push (T &&value)
+		{
+			size_t	pos = _tail.load( memory_order_relaxed );
+			Cell*	cell;
+
+			for (;;)
+			{
+				cell = &_cells[ pos & Mask ];
+
+				const size_t	seq		= cell->seq.load( memory_order_acquire );
+				const intptr_t	diff	= intptr_t(seq) - intptr_t(pos);
+
+				if ( diff == 0 )
+				{
+					if ( _tail.compare_exchange_weak( INOUT pos, pos + 1, memory_order_relaxed ))
+						break;
+				}
+				else
+				if ( diff < 0 )
+					return false;
+				else
+					pos = _tail.load( memory_order_relaxed );
+			}
+
+			PlacementNew<T>( cell->data, std::move(value) );
+			cell->seq.store( pos + 1, memory_order_release );
+			return true;
+		}
+
+
+		// single consumer only
+		ND_ bool  Pop (OUT T &value)
+		{
+			Cell&			cell	= _cells[ _head & Mask ];
+			const size_t	seq		= cell.seq.load( memory_order_acquire );
+
+			if ( seq != _head + 1 )
+				return false;
+
+			T*	ptr = Cast<T>( &cell.data[0] );
+			value = std::move( *ptr );
+			ptr->~T();
+
+			cell.seq.store( _head + Size, memory_order_release );
+			++_head;
+			return true;
+		}
+
+
+		// approximate, only for consumer
+		ND_ bool  empty () const
+		{
+			return _cells[ _head & Mask ].seq.load( memory_order_acquire ) != _head + 1;
+		}
+
+		ND_ static constexpr size_t  capacity ()	{ return Size; }
+	};
+
+
+}	// FGC
@@ -0,0 +1,130 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Bounded Chase-Lev work-stealing deque.
+	'Push' and 'Pop' may be called only by owner thread and work with the bottom side (LIFO),
+	'Steal' may be called by any thread and takes from the top side (FIFO).
+
+	based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Nardelli, 2013).
+*/
+
+#pragma once
+
+#include "stl/Math/Math.h"
+#include <atomic>
+
+namespace FGC
+{
+
+	//
+	// Lock-free Work-Stealing Deque
+	//
+
+	template <typename T, size_t Size>
+	struct LfWorkStealingDeque
+	{
+		STATIC_ASSERT( Size > 1 and ((Size & (Size - 1)) == 0) );
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		STATIC_ASSERT( Atomic<T>::is_always_lock_free );
+
+	// types
+	public:
+		using Self		= LfWorkStealingDeque< T, Size >;
+		using Value_t	= T;
+
+	private:
+		static constexpr int64_t	Mask = int64_t(Size - 1);
+
+
+	// variables
+	private:
+		alignas(FG_CACHE_LINE) Atomic<int64_t>	_top		{0};
+		alignas(FG_CACHE_LINE) Atomic<int64_t>	_bottom		{0};
+		alignas(FG_CACHE_LINE) Atomic<T>		_buffer [Size];
+
+
+	// methods
+	public:
+		LfWorkStealingDeque () {}
+
+		LfWorkStealingDeque (const Self &) = delete;
+		LfWorkStealingDeque (Self &&) = delete;
+
+		Self&  operator = (const Self &) = delete;
+		Self&  operator = (Self &&) = delete;
+
+
+		// owner thread only, returns 'false' if deque is full
+		ND_ bool  Push (const T &value)
+		{
+			const int64_t	b = _bottom.load( std::memory_order_relaxed );
+			const int64_t	t = _top.load( std::memory_order_acquire );
+
+			if ( b - t >= int64_t(Size) )
+				return false;
+
+			_buffer[ b & Mask ].store( value, std::memory_order_relaxed );
+			std::atomic_thread_fence( std::memory_order_release );
+			_bottom.store( b + 1, std::memory_order_relaxed );
+			return true;
+		}
+
+
+		// owner thread only
+		ND_ bool  Pop (OUT T &value)
+		{
+			const int64_t	b = _bottom.load( std::memory_order_relaxed ) - 1;
+			_bottom.store( b, std::memory_order_relaxed );
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+			int64_t			t = _top.load( std::memory_order_relaxed );
+
+			if ( t > b )
+			{
+				// empty
+				_bottom.store( b + 1, std::memory_order_relaxed );
+				return false;
+			}
+
+			value = _buffer[ b & Mask ].load( std::memory_order_relaxed );
+
+			if ( t == b )
+			{
+				// last element, race with thieves
+				const bool	won = _top.compare_exchange_strong( INOUT t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+				_bottom.store( b + 1, std::memory_order_relaxed );
+				return won;
+			}
+			return true;
+		}
+
+
+		// any thread
+		ND_ bool  Steal (OUT T &value)
+		{
+			int64_t			t = _top.load( std::memory_order_acquire );
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+			const int64_t	b = _bottom.load( std::memory_order_acquire );
+
+			if ( t >= b )
+				return false;
+
+			value = _buffer[ t & Mask ].load( std::memory_order_relaxed );
+
+			return _top.compare_exchange_strong( INOUT t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+		}
+
+
+		// approximate value
+		ND_ size_t  size () const
+		{
+			const int64_t	b = _bottom.load( std::memory_order_relaxed );
+			const int64_t	t = _top.load( std::memory_order_relaxed );
+			return size_t(Max( b - t, int64_t(0) ));
+		}
+
+		ND_ bool  empty () const						{ return size() == 0; }
+
+		ND_ static constexpr size_t  capacity ()		{ return Size; }
+	};
+
+
+}	// FGC
@@ -0,0 +1,9 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#pragma once
+
+#include "extensions/capture/CaptureSerializer.h"
+
+using namespace FG;
+
+#define TEST	CHECK_FATAL
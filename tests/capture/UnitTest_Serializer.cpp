@@ -0,0 +1,658 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "UnitTest_Common.h"
+
+namespace
+{
+	// captured IDs and IDs that are used during replay
+	static const RawImageID			img_c0		{ 1, 1 },	img_r0	{ 10, 3 };
+	static const RawImageID			img_c1		{ 2, 1 },	img_r1	{ 11, 3 };
+	static const RawBufferID		buf_c0		{ 1, 2 },	buf_r0	{ 20, 5 };
+	static const RawBufferID		buf_c1		{ 2, 2 },	buf_r1	{ 21, 5 };
+	static const RawCPipelineID		cppln_c		{ 3, 0 },	cppln_r	{ 30, 1 };
+	static const RawGPipelineID		gppln_c		{ 4, 0 },	gppln_r	{ 40, 1 };
+	static const LogicalPassID		pass_c		{ 5, 0 },	pass_r	{ 50, 1 };
+
+	static uint8_t					task_storage [4];
+
+
+	//
+	// Round Trip
+	//
+	struct RoundTrip
+	{
+		CaptureWriter					writer;
+		CaptureReader::ResourceMap_t	resMap;
+		Array<Task>						tasks;
+
+		RoundTrip ()
+		{
+			for (auto& t : task_storage) {
+				tasks.push_back( reinterpret_cast<IFrameGraphTask *>( &t ));
+				writer.AddTask( tasks.back() );
+			}
+		}
+
+		template <typename ...Args>
+		void  Write (const Args& ...args)
+		{
+			CaptureSerializer::All( writer, const_cast<Args &>(args)... );
+		}
+
+		template <typename ...Args>
+		void  Read (OUT Args& ...args)
+		{
+			CaptureReader	reader{ writer.GetData() };
+			reader.SetContext( &resMap, null, null, tasks );
+
+			reader.AddResource( img_c0, img_r0 );
+			reader.AddResource( img_c1, img_r1 );
+			reader.AddResource( buf_c0, buf_r0 );
+			reader.AddResource( buf_c1, buf_r1 );
+			reader.AddResource( cppln_c, cppln_r );
+			reader.AddResource( gppln_c, gppln_r );
+			reader.AddResource( pass_c, pass_r );
+
+			CaptureSerializer::All( reader, args... );
+
+			TEST( reader.IsValid() );
+			TEST( reader.IsEnd() );
+			TEST( not reader.HasMissingResources() );
+		}
+	};
+
+
+	template <typename T>
+	ND_ bool  PodEqual (const T &lhs, const T &rhs)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		return std::memcmp( &lhs, &rhs, sizeof(T) ) == 0;
+	}
+
+	template <typename T>
+	ND_ bool  PodEqual (ArrayView<T> lhs, ArrayView<T> rhs)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		return lhs.size() == rhs.size() and (lhs.empty() or std::memcmp( lhs.data(), rhs.data(), lhs.size() * sizeof(T) ) == 0);
+	}
+
+	template <typename ...Types>
+	ND_ bool  EqualUnion (const Union<Types...> &lhs, const Union<Types...> &rhs)
+	{
+		if ( lhs.index() != rhs.index() )
+			return false;
+
+		bool	result = true;
+		Visit( lhs, [&] (const auto &value)
+			{
+				using T = std::remove_cv_t< std::remove_reference_t< decltype(value) >>;
+				if constexpr( not IsSameTypes< T, NullUnion >)
+					result = PodEqual( value, std::get<T>( rhs ));
+			});
+		return result;
+	}
+
+	// vertex locations are assigned from the pipeline, so 'VertexInputState::operator ==' can not be used
+	ND_ bool  EqualVertexInput (const VertexInputState &lhs, const VertexInputState &rhs)
+	{
+		if ( not (lhs.BufferBindings() == rhs.BufferBindings()) or lhs.Vertices().size() != rhs.Vertices().size() )
+			return false;
+
+		for (auto& [id, vi] : lhs.Vertices())
+		{
+			auto	iter = rhs.Vertices().find( id );
+			if ( iter == rhs.Vertices().end() or
+				 vi.type			!= iter->second.type	or
+				 vi.offset			!= iter->second.offset	or
+				 vi.bufferBinding	!= iter->second.bufferBinding )
+				return false;
+		}
+		return true;
+	}
+
+	template <typename T>
+	ND_ bool  EqualBase (const _fg_hidden_::BaseTask<T> &lhs, const _fg_hidden_::BaseTask<T> &rhs)
+	{
+		return	lhs.depends		== ArrayView<Task>{rhs.depends}	and
+				lhs.taskName	== StringView{rhs.taskName}		and
+				lhs.debugColor	== rhs.debugColor;
+	}
+
+	template <typename T>
+	ND_ bool  EqualBase (const _fg_hidden_::BaseDrawVertices<T> &lhs, const _fg_hidden_::BaseDrawVertices<T> &rhs)
+	{
+		if ( lhs.scissors.size() != rhs.scissors.size() )
+			return false;
+
+		for (size_t i = 0; i < lhs.scissors.size(); ++i) {
+			if ( not All( lhs.scissors[i] == rhs.scissors[i] ))
+				return false;
+		}
+
+		return	lhs.taskName		== StringView{rhs.taskName}					and
+				lhs.debugColor		== rhs.debugColor							and
+				lhs.resources.empty() and rhs.resources.empty()					and
+				PodEqual<_fg_hidden_::PushConstantData>( lhs.pushConstants, rhs.pushConstants ) and
+				lhs.colorBuffers	== rhs.colorBuffers							and
+				PodEqual( lhs.dynamicStates, rhs.dynamicStates )				and
+				PodEqual( lhs.debugMode, rhs.debugMode )						and
+				EqualVertexInput( lhs.vertexInput, rhs.vertexInput )			and
+				lhs.topology		== rhs.topology								and
+				lhs.primitiveRestart == rhs.primitiveRestart;
+	}
+}
+//-----------------------------------------------------------------------------
+
+
+
+static void Serializer_Test1 ()
+{
+	// resource descriptions are stored as POD
+	ImageDesc		img_desc	{ EImage::Tex2DArray, uint3{256, 128, 1}, EPixelFormat::RGBA16F, EImageUsage::Sampled | EImageUsage::TransferDst,
+								  6_layer, 8_mipmap, 1_samples, EQueueUsage::Graphics };
+	BufferDesc		buf_desc	{ 4_Mb, EBufferUsage::Uniform | EBufferUsage::TransferDst, EQueueUsage::AsyncTransfer };
+	SamplerDesc		samp_desc;
+	MemoryDesc		mem_desc	{ EMemoryType::HostWrite };
+	EResourceState	state		= EResourceState::ShaderSample;
+	String			name		= "image";
+
+	samp_desc.SetFilter( EFilter::Linear, EFilter::Nearest, EMipmapFilter::Linear )
+			 .SetAddressMode( EAddressMode::MirrorRepeat, EAddressMode::ClampToEdge, EAddressMode::Repeat )
+			 .SetAnisotropy( 8.0f ).SetCompareOp( ECompareOp::LEqual );
+
+	RoundTrip	rt;
+	rt.Write( img_desc, buf_desc, samp_desc, mem_desc, state, name );
+
+	ImageDesc		img_desc2;
+	BufferDesc		buf_desc2;
+	SamplerDesc		samp_desc2;
+	MemoryDesc		mem_desc2;
+	EResourceState	state2;
+	String			name2;
+	rt.Read( OUT img_desc2, OUT buf_desc2, OUT samp_desc2, OUT mem_desc2, OUT state2, OUT name2 );
+
+	TEST( img_desc2.imageType	== img_desc.imageType );
+	TEST( All( img_desc2.dimension == img_desc.dimension ));
+	TEST( img_desc2.format		== img_desc.format );
+	TEST( img_desc2.usage		== img_desc.usage );
+	TEST( img_desc2.arrayLayers	== img_desc.arrayLayers );
+	TEST( img_desc2.maxLevel	== img_desc.maxLevel );
+	TEST( img_desc2.samples		== img_desc.samples );
+	TEST( img_desc2.queues		== img_desc.queues );
+
+	TEST( buf_desc2.size		== buf_desc.size );
+	TEST( buf_desc2.usage		== buf_desc.usage );
+	TEST( buf_desc2.queues		== buf_desc.queues );
+
+	TEST( samp_desc2.magFilter		== samp_desc.magFilter );
+	TEST( samp_desc2.minFilter		== samp_desc.minFilter );
+	TEST( samp_desc2.mipmapMode		== samp_desc.mipmapMode );
+	TEST( All( samp_desc2.addressMode == samp_desc.addressMode ));
+	TEST( samp_desc2.maxAnisotropy	== samp_desc.maxAnisotropy );
+	TEST( samp_desc2.compareOp		== samp_desc.compareOp );
+
+	TEST( mem_desc2.type	== mem_desc.type );
+	TEST( mem_desc2.poolId	== mem_desc.poolId );
+	TEST( state2			== state );
+	TEST( name2				== name );
+}
+
+
+static void Serializer_Test2 ()
+{
+	// pipelines
+	GraphicsPipelineDesc	gdesc;
+	gdesc.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", String{"void main () { gl_Position = vec4(0.0); }"}, "vs" )
+		 .AddShader( EShader::Fragment, EShaderLangFormat::SPIRV_100, "main", Array<uint>{ 0x07230203u, 0x00010000u, 1, 2, 3 }, "fs" )
+		 .AddTopology( EPrimitive::TriangleList ).AddTopology( EPrimitive::TriangleStrip )
+		 .SetFragmentOutputs({ { RenderTargetID::Color_0, 0, EFragOutput::Float4 }, { RenderTargetID::Color_1, 1, EFragOutput::UInt4 } })
+		 .SetVertexAttribs({ { VertexID{"at_Position"}, 0, EVertexType::Float3 }, { VertexID{"at_Color"}, 1, EVertexType::UByte4_Norm } })
+		 .SetEarlyFragmentTests( false )
+		 .AddDescriptorSet( DescriptorSetID{"0"}, 0,
+							{{ UniformID{"un_Texture"}, EImage::Tex2D, BindingIndex{0, 0}, 1, EShaderStages::Fragment }},
+							{}, {}, {},
+							{{ UniformID{"un_Constants"}, 64_b, BindingIndex{1, 1}, 1, EShaderStages::Vertex | EShaderStages::Fragment }},
+							{} )
+		 .SetPushConstants({ { PushConstantID{"pc"}, EShaderStages::Vertex, 0_b, 16_b } });
+	gdesc._patchControlPoints = 3;
+
+	ComputePipelineDesc		cdesc;
+	cdesc.AddShader( EShaderLangFormat::GLSL_450, "main", String{"void main () {}"}, "cs" )
+		 .AddShader( EShaderLangFormat::SPIRV_110, "main", Array<uint8_t>{ 1, 2, 3, 4, 5 }, "cs-bin" )
+		 .SetLocalGroupSize( 8, 4, 1 )
+		 .AddDescriptorSet( DescriptorSetID{"1"}, 1, {}, {}, {},
+							{{ UniformID{"un_Image"}, EImage::Tex2D, EPixelFormat::RGBA8_UNorm, EShaderAccess::WriteOnly, BindingIndex{0, 0}, 1, EShaderStages::Compute }},
+							{},
+							{{ UniformID{"un_SSB"}, 16_b, 4_b, EShaderAccess::ReadWrite, BindingIndex{1, 1}, 1, EShaderStages::Compute }} );
+
+	RoundTrip	rt;
+	rt.Write( gdesc, cdesc );
+
+	GraphicsPipelineDesc	gdesc2;
+	ComputePipelineDesc		cdesc2;
+	rt.Read( OUT gdesc2, OUT cdesc2 );
+
+	const auto	CompareLayout = [] (const PipelineDescription::PipelineLayout &lhs, const PipelineDescription::PipelineLayout &rhs)
+	{
+		TEST( lhs.descriptorSets.size() == rhs.descriptorSets.size() );
+		for (size_t i = 0; i < lhs.descriptorSets.size(); ++i)
+		{
+			auto&	lds = lhs.descriptorSets[i];
+			auto&	rds = rhs.descriptorSets[i];
+			TEST( lds.id			== rds.id );
+			TEST( lds.bindingIndex	== rds.bindingIndex );
+			TEST( lds.uniforms and rds.uniforms );
+			TEST( *lds.uniforms		== *rds.uniforms );
+		}
+
+		TEST( lhs.pushConstants.size() == rhs.pushConstants.size() );
+		for (auto& [id, pc] : lhs.pushConstants)
+		{
+			auto	iter = rhs.pushConstants.find( id );
+			TEST( iter != rhs.pushConstants.end() );
+			TEST( pc.stageFlags	== iter->second.stageFlags );
+			TEST( pc.offset		== iter->second.offset );
+			TEST( pc.size		== iter->second.size );
+		}
+	};
+
+	const auto	CompareShader = [] (const PipelineDescription::Shader &lhs, const PipelineDescription::Shader &rhs)
+	{
+		TEST( lhs.specConstants == rhs.specConstants );
+		TEST( lhs.data.size() == rhs.data.size() );
+
+		for (auto& [fmt, data] : lhs.data)
+		{
+			auto	iter = rhs.data.find( fmt );
+			TEST( iter != rhs.data.end() );
+			TEST( data.index() == iter->second.index() );
+
+			Visit( data,
+				[&] (const auto &sh)
+				{
+					using T = std::remove_cv_t< std::remove_reference_t< decltype(sh) >>;
+					auto&	sh2 = std::get<T>( iter->second );
+
+					TEST( sh->GetEntry()		== sh2->GetEntry() );
+					TEST( sh->GetDebugName()	== sh2->GetDebugName() );
+					TEST( sh->GetData()			== sh2->GetData() );
+				},
+				[] (const NullUnion &) {}
+			);
+		}
+	};
+
+	CompareLayout( gdesc._pipelineLayout, gdesc2._pipelineLayout );
+	TEST( gdesc._shaders.size() == gdesc2._shaders.size() );
+	for (auto& [type, sh] : gdesc._shaders)
+	{
+		auto	iter = gdesc2._shaders.find( type );
+		TEST( iter != gdesc2._shaders.end() );
+		CompareShader( sh, iter->second );
+	}
+	TEST( gdesc._supportedTopology		== gdesc2._supportedTopology );
+	TEST( gdesc._fragmentOutput			== ArrayView<GraphicsPipelineDesc::FragmentOutput>{gdesc2._fragmentOutput} );
+	TEST( gdesc._vertexAttribs			== ArrayView<GraphicsPipelineDesc::VertexAttrib>{gdesc2._vertexAttribs} );
+	TEST( gdesc._patchControlPoints		== gdesc2._patchControlPoints );
+	TEST( gdesc._earlyFragmentTests		== gdesc2._earlyFragmentTests );
+
+	CompareLayout( cdesc._pipelineLayout, cdesc2._pipelineLayout );
+	CompareShader( cdesc._shader, cdesc2._shader );
+	TEST( All( cdesc._defaultLocalGroupSize == cdesc2._defaultLocalGroupSize ));
+	TEST( All( cdesc._localSizeSpec == cdesc2._localSizeSpec ));
+}
+
+
+static void Serializer_Test3 ()
+{
+	// render pass and vertex input
+	RenderPassDesc		rp_desc{ int2{800, 600} };
+	rp_desc.AddTarget( RenderTargetID::Color_0, img_c0, RGBA32f{0.5f}, EAttachmentStoreOp::Store )
+		   .AddTarget( RenderTargetID::Color_1, img_c1, ImageViewDesc{}.SetFormat( EPixelFormat::RGBA8_UNorm ), EAttachmentLoadOp::Load, EAttachmentStoreOp::Invalidate )
+		   .AddViewport( RectF{0.0f, 0.0f, 800.0f, 600.0f}, 0.1f, 0.9f )
+		   .AddColorBuffer( RenderTargetID::Color_0, EBlendFactor::SrcAlpha, EBlendFactor::OneMinusSrcAlpha, EBlendOp::Add )
+		   .SetDepthTestEnabled( true ).SetCullMode( ECullMode::Back );
+
+	VertexInputState	vert_input;
+	vert_input.Bind( VertexBufferID{"vb0"}, 16_b )
+			  .Bind( VertexBufferID{"vb1"}, 4_b, 1, EVertexInputRate::Instance )
+			  .Add( VertexID{"at_Position"}, EVertexType::Float3, 0_b, VertexBufferID{"vb0"} )
+			  .Add( VertexID{"at_Texcoord"}, EVertexType::UShort2_Norm, 12_b, VertexBufferID{"vb0"} )
+			  .Add( VertexID{"at_Color"}, EVertexType::UByte4_Norm, 0_b, VertexBufferID{"vb1"} );
+
+	RoundTrip	rt;
+	rt.Write( rp_desc, vert_input );
+
+	RenderPassDesc		rp_desc2;
+	VertexInputState	vert_input2;
+	rt.Read( OUT rp_desc2, OUT vert_input2 );
+
+	TEST( rp_desc2.colorState			== rp_desc.colorState );
+	TEST( rp_desc2.depthState			== rp_desc.depthState );
+	TEST( rp_desc2.stencilState			== rp_desc.stencilState );
+	TEST( rp_desc2.rasterizationState	== rp_desc.rasterizationState );
+	TEST( rp_desc2.multisampleState		== rp_desc.multisampleState );
+	TEST( All( rp_desc2.area == rp_desc.area ));
+	TEST( rp_desc2.perPassResources.empty() );
+
+	// resource IDs are remapped
+	const RawImageID	replayed[] = { img_r0, img_r1 };
+	for (size_t i = 0; i < rp_desc.renderTargets.size(); ++i)
+	{
+		auto&	lhs = rp_desc.renderTargets[i];
+		auto&	rhs = rp_desc2.renderTargets[i];
+
+		TEST( rhs.image		== (i < CountOf(replayed) ? replayed[i] : RawImageID{}) );
+		TEST( rhs.desc		== lhs.desc );
+		TEST( EqualUnion( rhs.clearValue, lhs.clearValue ));
+		TEST( rhs.loadOp	== lhs.loadOp );
+		TEST( rhs.storeOp	== lhs.storeOp );
+	}
+
+	TEST( rp_desc2.viewports.size() == rp_desc.viewports.size() );
+	for (size_t i = 0; i < rp_desc.viewports.size(); ++i)
+	{
+		TEST( All( rp_desc2.viewports[i].rect == rp_desc.viewports[i].rect ));
+		TEST( rp_desc2.viewports[i].minDepth	== rp_desc.viewports[i].minDepth );
+		TEST( rp_desc2.viewports[i].maxDepth	== rp_desc.viewports[i].maxDepth );
+		TEST( rp_desc2.viewports[i].palette		== ArrayView<EShadingRatePalette>{rp_desc.viewports[i].palette} );
+	}
+
+	TEST( EqualVertexInput( vert_input2, vert_input ));
+}
+
+
+static void Serializer_Test4 ()
+{
+	// transfer tasks
+	const Task	dep0	= reinterpret_cast<IFrameGraphTask *>( &task_storage[1] );
+	const Task	dep1	= reinterpret_cast<IFrameGraphTask *>( &task_storage[3] );
+	const auto	layers	= ImageSubresourceRange{ 1_mipmap, 2_layer, 3, EImageAspect::Color };
+	uint8_t		bytes[]	= { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	SubmitRenderPass		submit_rp	{ pass_c };
+	DispatchCompute			dispatch;
+	DispatchComputeIndirect	dispatch_ind;
+	CopyBuffer				copy_buf;
+	CopyImage				copy_img;
+	CopyBufferToImage		copy_b2i;
+	CopyImageToBuffer		copy_i2b;
+	BlitImage				blit;
+	ResolveImage			resolve;
+	GenerateMipmaps			gen_mips;
+	FillBuffer				fill_buf;
+	ClearColorImage			clear_color;
+	ClearDepthStencilImage	clear_ds;
+	UpdateBuffer			update_buf;
+	UpdateImage				update_img;
+	ReadBuffer				read_buf;
+	ReadImage				read_img;
+
+	submit_rp.AddImage( img_c0 ).AddBuffer( buf_c0, EResourceState::ShaderRead ).DependsOn( dep0 ).SetName( "submit" );
+	dispatch.SetPipeline( cppln_c ).Dispatch( uint2{4, 5} ).Dispatch( uint3{1, 2, 3}, uint3{4, 5, 6} ).SetLocalSize( 8, 8 )
+			.AddPushConstant( PushConstantID{"pc"}, 1.5f ).EnableDebugTrace( uint3{1, 2, 3} ).DependsOn( dep0, dep1 );
+	dispatch_ind.SetPipeline( cppln_c ).SetIndirectBuffer( buf_c1 ).Dispatch( 16_b ).Dispatch( 32_b ).SetLocalSize( 64 );
+	copy_buf.From( buf_c0 ).To( buf_c1 ).AddRegion( 0_b, 16_b, 128_b ).AddRegion( 256_b, 0_b, 64_b ).SetDebugColor( HtmlColor::Red );
+	copy_img.From( img_c0 ).To( img_c1 ).AddRegion( layers, int2{1, 2}, ImageSubresourceRange{}, int2{3, 4}, uint2{16, 32} );
+	copy_b2i.From( buf_c0 ).To( img_c1 ).AddRegion( 64_b, 128, 64, layers, int2{2, 4}, uint2{128, 64} );
+	copy_i2b.From( img_c0 ).To( buf_c1 ).AddRegion( layers, int3{1, 2, 3}, uint3{4, 5, 6}, 8_b, 16, 32 );
+	blit.From( img_c0 ).To( img_c1 ).SetFilter( EFilter::Linear ).AddRegion( layers, int2{0}, int2{64}, layers, int2{0}, int2{32} );
+	resolve.From( img_c0 ).To( img_c1 ).AddRegion( layers, int2{0}, layers, int2{8}, uint2{64} );
+	gen_mips.SetImage( img_c1 ).SetRange( 1_mipmap, 4 );
+	fill_buf.SetBuffer( buf_c1, 128_b, 1_Kb ).SetPattern( 0xDEADBEEF );
+	clear_color.SetImage( img_c0 ).Clear( RGBA32u{1, 2, 3, 4} ).AddRange( 0_mipmap, 2, 1_layer, 3 );
+	clear_ds.SetImage( img_c1 ).Clear( 0.5f, 7 ).AddRange( 1_mipmap, 1, 0_layer, 1 );
+	update_buf.SetBuffer( buf_c0 ).AddData( bytes, CountOf(bytes), 64_b ).AddData( bytes, 3, 0_b );
+	update_img.SetImage( img_c1, int2{4, 8}, 2_layer, 1_mipmap ).SetData( ArrayView<uint8_t>{bytes}, uint2{2, 1}, 4_b );
+	read_buf.SetBuffer( buf_c1, 16_b, 256_b ).SetContiguous();
+	read_img.SetImage( img_c0, int2{1, 2}, uint2{3, 4}, 1_layer, 2_mipmap );
+
+	RoundTrip	rt;
+	rt.Write( submit_rp, dispatch, dispatch_ind, copy_buf, copy_img, copy_b2i, copy_i2b, blit, resolve, gen_mips,
+			  fill_buf, clear_color, clear_ds, update_buf, update_img, read_buf, read_img );
+
+	SubmitRenderPass		submit_rp2	{ LogicalPassID{} };
+	DispatchCompute			dispatch2;
+	DispatchComputeIndirect	dispatch_ind2;
+	CopyBuffer				copy_buf2;
+	CopyImage				copy_img2;
+	CopyBufferToImage		copy_b2i2;
+	CopyImageToBuffer		copy_i2b2;
+	BlitImage				blit2;
+	ResolveImage			resolve2;
+	GenerateMipmaps			gen_mips2;
+	FillBuffer				fill_buf2;
+	ClearColorImage			clear_color2;
+	ClearDepthStencilImage	clear_ds2;
+	UpdateBuffer			update_buf2;
+	UpdateImage				update_img2;
+	ReadBuffer				read_buf2;
+	ReadImage				read_img2;
+
+	rt.Read( OUT submit_rp2, OUT dispatch2, OUT dispatch_ind2, OUT copy_buf2, OUT copy_img2, OUT copy_b2i2, OUT copy_i2b2, OUT blit2,
+			 OUT resolve2, OUT gen_mips2, OUT fill_buf2, OUT clear_color2, OUT clear_ds2, OUT update_buf2, OUT update_img2,
+			 OUT read_buf2, OUT read_img2 );
+
+	// task dependencies are restored by index
+	TEST( submit_rp2.depends.size() == 1 and submit_rp2.depends[0] == dep0 );
+	TEST( dispatch2.depends.size() == 2 and dispatch2.depends[0] == dep0 and dispatch2.depends[1] == dep1 );
+
+	TEST( EqualBase( submit_rp2, submit_rp ));
+	TEST( submit_rp2.renderPassId == pass_r );
+	TEST( submit_rp2.images.size() == 1 and submit_rp2.images[0].first == img_r0 and submit_rp2.images[0].second == submit_rp.images[0].second );
+	TEST( submit_rp2.buffers.size() == 1 and submit_rp2.buffers[0].first == buf_r0 and submit_rp2.buffers[0].second == submit_rp.buffers[0].second );
+
+	TEST( EqualBase( dispatch2, dispatch ));
+	TEST( dispatch2.pipeline == cppln_r );
+	TEST( dispatch2.resources.empty() );
+	TEST( PodEqual<DispatchCompute::ComputeCmd>( dispatch2.commands, dispatch.commands ));
+	TEST( dispatch2.localGroupSize.has_value() and All( *dispatch2.localGroupSize == *dispatch.localGroupSize ));
+	TEST( PodEqual<_fg_hidden_::PushConstantData>( dispatch2.pushConstants, dispatch.pushConstants ));
+	TEST( PodEqual( dispatch2.debugMode, dispatch.debugMode ));
+
+	TEST( EqualBase( dispatch_ind2, dispatch_ind ));
+	TEST( dispatch_ind2.pipeline == cppln_r );
+	TEST( dispatch_ind2.indirectBuffer == buf_r1 );
+	TEST( PodEqual<DispatchComputeIndirect::ComputeCmd>( dispatch_ind2.commands, dispatch_ind.commands ));
+	TEST( dispatch_ind2.localGroupSize.has_value() and All( *dispatch_ind2.localGroupSize == *dispatch_ind.localGroupSize ));
+
+	TEST( EqualBase( copy_buf2, copy_buf ));
+	TEST( copy_buf2.srcBuffer == buf_r0 and copy_buf2.dstBuffer == buf_r1 );
+	TEST( PodEqual<CopyBuffer::Region>( copy_buf2.regions, copy_buf.regions ));
+
+	TEST( EqualBase( copy_img2, copy_img ));
+	TEST( copy_img2.srcImage == img_r0 and copy_img2.dstImage == img_r1 );
+	TEST( PodEqual<CopyImage::Region>( copy_img2.regions, copy_img.regions ));
+
+	TEST( EqualBase( copy_b2i2, copy_b2i ));
+	TEST( copy_b2i2.srcBuffer == buf_r0 and copy_b2i2.dstImage == img_r1 );
+	TEST( PodEqual<CopyBufferToImage::Region>( copy_b2i2.regions, copy_b2i.regions ));
+
+	TEST( EqualBase( copy_i2b2, copy_i2b ));
+	TEST( copy_i2b2.srcImage == img_r0 and copy_i2b2.dstBuffer == buf_r1 );
+	TEST( PodEqual<CopyImageToBuffer::Region>( copy_i2b2.regions, copy_i2b.regions ));
+
+	TEST( EqualBase( blit2, blit ));
+	TEST( blit2.srcImage == img_r0 and blit2.dstImage == img_r1 );
+	TEST( blit2.filter == blit.filter );
+	TEST( PodEqual<BlitImage::Region>( blit2.regions, blit.regions ));
+
+	TEST( EqualBase( resolve2, resolve ));
+	TEST( resolve2.srcImage == img_r0 and resolve2.dstImage == img_r1 );
+	TEST( PodEqual<ResolveImage::Region>( resolve2.regions, resolve.regions ));
+
+	TEST( EqualBase( gen_mips2, gen_mips ));
+	TEST( gen_mips2.image == img_r1 );
+	TEST( gen_mips2.baseLevel == gen_mips.baseLevel and gen_mips2.levelCount == gen_mips.levelCount );
+
+	TEST( EqualBase( fill_buf2, fill_buf ));
+	TEST( fill_buf2.dstBuffer == buf_r1 );
+	TEST( fill_buf2.dstOffset == fill_buf.dstOffset and fill_buf2.size == fill_buf.size and fill_buf2.pattern == fill_buf.pattern );
+
+	TEST( EqualBase( clear_color2, clear_color ));
+	TEST( clear_color2.dstImage == img_r0 );
+	TEST( PodEqual<ClearColorImage::Range>( clear_color2.ranges, clear_color.ranges ));
+	TEST( EqualUnion( clear_color2.clearValue, clear_color.clearValue ));
+
+	TEST( EqualBase( clear_ds2, clear_ds ));
+	TEST( clear_ds2.dstImage == img_r1 );
+	TEST( PodEqual<ClearDepthStencilImage::Range>( clear_ds2.ranges, clear_ds.ranges ));
+	TEST( PodEqual( clear_ds2.clearValue, clear_ds.clearValue ));
+
+	TEST( EqualBase( update_buf2, update_buf ));
+	TEST( update_buf2.dstBuffer == buf_r0 );
+	TEST( update_buf2.regions.size() == update_buf.regions.size() );
+	for (size_t i = 0; i < update_buf.regions.size(); ++i)
+	{
+		TEST( update_buf2.regions[i].offset == update_buf.regions[i].offset );
+		TEST( update_buf2.regions[i].data == update_buf.regions[i].data );
+	}
+
+	TEST( EqualBase( update_img2, update_img ));
+	TEST( update_img2.dstImage == img_r1 );
+	TEST( All( update_img2.imageOffset == update_img.imageOffset ));
+	TEST( All( update_img2.imageSize == update_img.imageSize ));
+	TEST( update_img2.arrayLayer == update_img.arrayLayer and update_img2.mipmapLevel == update_img.mipmapLevel );
+	TEST( update_img2.dataRowPitch == update_img.dataRowPitch and update_img2.dataSlicePitch == update_img.dataSlicePitch );
+	TEST( update_img2.aspectMask == update_img.aspectMask );
+	TEST( update_img2.data == update_img.data );
+
+	TEST( EqualBase( read_buf2, read_buf ));
+	TEST( read_buf2.srcBuffer == buf_r1 );
+	TEST( read_buf2.offset == read_buf.offset and read_buf2.size == read_buf.size and read_buf2.contiguous == read_buf.contiguous );
+
+	TEST( EqualBase( read_img2, read_img ));
+	TEST( read_img2.srcImage == img_r0 );
+	TEST( All( read_img2.imageOffset == read_img.imageOffset ));
+	TEST( All( read_img2.imageSize == read_img.imageSize ));
+	TEST( read_img2.arrayLayer == read_img.arrayLayer and read_img2.mipmapLevel == read_img.mipmapLevel );
+	TEST( read_img2.aspectMask == read_img.aspectMask and read_img2.contiguous == read_img.contiguous );
+}
+
+
+static void Serializer_Test5 ()
+{
+	// draw tasks
+	VertexInputState	vert_input;
+	vert_input.Bind( VertexBufferID{"vb"}, 16_b )
+			  .Add( VertexID{"at_Position"}, EVertexType::Float3, 0_b, VertexBufferID{"vb"} );
+
+	DrawVertices			draw;
+	DrawIndexed				draw_idx;
+	DrawVerticesIndirect	draw_ind;
+	DrawIndexedIndirect		draw_idx_ind;
+
+	draw.SetPipeline( gppln_c ).SetTopology( EPrimitive::TriangleList ).SetVertexInput( vert_input )
+		.AddBuffer( VertexBufferID{"vb"}, buf_c0, 64_b ).Draw( 3 ).Draw( 6, 2, 3, 1 )
+		.AddScissor( RectI{0, 0, 64, 32} ).AddColorBuffer( RenderTargetID::Color_0, bool4{true, false, true, false} )
+		.SetStencilTestEnabled( true ).SetStencilReference( 3 ).SetCullMode( ECullMode::Front ).SetDepthCompareOp( ECompareOp::Greater )
+		.AddPushConstant( PushConstantID{"pc"}, uint2{7, 8} ).EnableFragmentDebugTrace( 10, 20 ).SetName( "draw" );
+	draw_idx.SetPipeline( gppln_c ).SetTopology( EPrimitive::TriangleStrip ).SetPrimitiveRestartEnabled( true ).SetVertexInput( vert_input )
+			.AddBuffer( VertexBufferID{"vb"}, buf_c0 ).SetIndexBuffer( buf_c1, 128_b, EIndex::UShort ).Draw( 12, 1, 0, -4 );
+	draw_ind.SetPipeline( gppln_c ).SetVertexInput( vert_input ).AddBuffer( VertexBufferID{"vb"}, buf_c0 )
+			.SetIndirectBuffer( buf_c1 ).Draw( 4, 32_b );
+	draw_idx_ind.SetPipeline( gppln_c ).SetVertexInput( vert_input ).AddBuffer( VertexBufferID{"vb"}, buf_c0 )
+				.SetIndexBuffer( buf_c1, 0_b, EIndex::UInt ).SetIndirectBuffer( buf_c0 ).Draw( 2, 0_b, 32_b );
+
+	RoundTrip	rt;
+	rt.Write( draw, draw_idx, draw_ind, draw_idx_ind );
+
+	DrawVertices			draw2;
+	DrawIndexed				draw_idx2;
+	DrawVerticesIndirect	draw_ind2;
+	DrawIndexedIndirect		draw_idx_ind2;
+	rt.Read( OUT draw2, OUT draw_idx2, OUT draw_ind2, OUT draw_idx_ind2 );
+
+	const auto	CompareBuffers = [] (const auto &lhs, const auto &rhs)
+	{
+		TEST( lhs.pipeline == gppln_r );
+		TEST( lhs.vertexBuffers.size() == rhs.vertexBuffers.size() );
+		for (auto& [id, vb] : rhs.vertexBuffers)
+		{
+			auto	iter = lhs.vertexBuffers.find( id );
+			TEST( iter != lhs.vertexBuffers.end() );
+			TEST( iter->second.buffer == buf_r0 );
+			TEST( iter->second.offset == vb.offset );
+		}
+	};
+
+	TEST( EqualBase( draw2, draw ));
+	CompareBuffers( draw2, draw );
+	TEST( PodEqual<DrawVertices::DrawCmd>( draw2.commands, draw.commands ));
+
+	TEST( EqualBase( draw_idx2, draw_idx ));
+	CompareBuffers( draw_idx2, draw_idx );
+	TEST( draw_idx2.indexBuffer == buf_r1 );
+	TEST( draw_idx2.indexBufferOffset == draw_idx.indexBufferOffset and draw_idx2.indexType == draw_idx.indexType );
+	TEST( PodEqual<DrawIndexed::DrawCmd>( draw_idx2.commands, draw_idx.commands ));
+
+	TEST( EqualBase( draw_ind2, draw_ind ));
+	CompareBuffers( draw_ind2, draw_ind );
+	TEST( draw_ind2.indirectBuffer == buf_r1 );
+	TEST( PodEqual<DrawVerticesIndirect::DrawCmd>( draw_ind2.commands, draw_ind.commands ));
+
+	TEST( EqualBase( draw_idx_ind2, draw_idx_ind ));
+	CompareBuffers( draw_idx_ind2, draw_idx_ind );
+	TEST( draw_idx_ind2.indexBuffer == buf_r1 and draw_idx_ind2.indirectBuffer == buf_r0 );
+	TEST( draw_idx_ind2.indexBufferOffset == draw_idx_ind.indexBufferOffset and draw_idx_ind2.indexType == draw_idx_ind.indexType );
+	TEST( PodEqual<DrawIndexedIndirect::DrawCmd>( draw_idx_ind2.commands, draw_idx_ind.commands ));
+}
+
+
+static void Serializer_Test6 ()
+{
+	// records and missing resources
+	CaptureWriter	writer;
+	{
+		const size_t	outer = writer.BeginRecord( ECaptureCmd::Execute );
+		const size_t	inner = writer.BeginRecord( ECaptureCmd::FillBuffer );
+
+		FillBuffer	task;
+		task.SetBuffer( buf_c0, 0_b, 64_b ).SetPattern( 1 );
+		CaptureSerializer::Serialize( writer, task );
+
+		writer.EndRecord( inner );
+		writer.EndRecord( outer );
+	}
+
+	CaptureReader::ResourceMap_t	res_map;
+	CaptureReader					reader{ writer.GetData() };
+	reader.SetContext( &res_map, null, null );
+
+	ECaptureCmd		cmd;
+	CaptureReader	cmd_buf;
+	TEST( reader.ReadRecord( OUT cmd, OUT cmd_buf ));
+	TEST( cmd == ECaptureCmd::Execute );
+	TEST( reader.IsEnd() );
+
+	CaptureReader	payload;
+	TEST( cmd_buf.ReadRecord( OUT cmd, OUT payload ));
+	TEST( cmd == ECaptureCmd::FillBuffer );
+	TEST( cmd_buf.IsEnd() );
+
+	// buffer is not registered, so ID can not be remapped
+	FillBuffer	task;
+	CaptureSerializer::Serialize( payload, task );
+	TEST( payload.IsValid() and payload.IsEnd() );
+	TEST( payload.HasMissingResources() );
+	TEST( not task.dstBuffer );
+	TEST( task.pattern == 1 );
+
+	// truncated data
+	CaptureReader	truncated{ ArrayView<uint8_t>{ writer.GetData().data(), writer.GetData().size() - 1 }};
+	TEST( not truncated.ReadRecord( OUT cmd, OUT cmd_buf ));
+	TEST( not truncated.IsValid() );
+}
+
+
+extern void UnitTest_Serializer ()
+{
+	Serializer_Test1();
+	Serializer_Test2();
+	Serializer_Test3();
+	Serializer_Test4();
+	Serializer_Test5();
+	Serializer_Test6();
+
+	FG_LOGI( "UnitTest_Serializer - passed" );
+}
@@ -0,0 +1,14 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "UnitTest_Common.h"
+
+extern void UnitTest_Serializer ();
+
+
+int main ()
+{
+	UnitTest_Serializer();
+
+	FG_LOGI( "Tests.Capture finished" );
+	return 0;
+}
@@ -58,6 +58,18 @@ namespace {
 		_tests.push_back({ &FGApp::ImplTest_Multithreading2, 1 });
 		_tests.push_back({ &FGApp::ImplTest_Multithreading3, 1 });
 		_tests.push_back({ &FGApp::ImplTest_Multithreading4, 1 });
+		_tests.push_back({ &FGApp::ImplTest_Multithreading5, 1 });
+		_tests.push_back({ &FGApp::ImplTest_Multithreading6, 1 });
+		_tests.push_back({ &FGApp::ImplTest_BarrierBatching1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_ParallelRenderPass1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_PipelineCache1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_DescriptorCache1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_AsyncReadback1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_StagingRing1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_TransientAliasing1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_Defragmentation1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_MemoryBudget1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_CaptureReplay1, 1 });
 		
 		// RTX only
 		_tests.push_back({ &FGApp::Test_DrawMeshes1,		1 });
@@ -82,6 +82,18 @@ namespace FG
 		bool ImplTest_Multithreading2 ();
 		bool ImplTest_Multithreading3 ();
 		bool ImplTest_Multithreading4 ();
+		bool ImplTest_Multithreading5 ();
+		bool ImplTest_Multithreading6 ();
+		bool ImplTest_BarrierBatching1 ();
+		bool ImplTest_ParallelRenderPass1 ();
+		bool ImplTest_PipelineCache1 ();
+		bool ImplTest_DescriptorCache1 ();
+		bool ImplTest_AsyncReadback1 ();
+		bool ImplTest_StagingRing1 ();
+		bool ImplTest_TransientAliasing1 ();
+		bool ImplTest_Defragmentation1 ();
+		bool ImplTest_MemoryBudget1 ();
+		bool ImplTest_CaptureReplay1 ();
 
 
 	// drawing tests
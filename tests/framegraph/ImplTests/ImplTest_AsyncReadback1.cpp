@@ -0,0 +1,135 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	ReadBuffer and ReadImage callbacks are executed in worker thread,
+	contiguous readback must be in single part.
+*/
+
+#include "../FGApp.h"
+#include <thread>
+#include <condition_variable>
+#include <deque>
+
+namespace FG
+{
+	class ReadbackWorker
+	{
+	private:
+		std::mutex							_guard;
+		std::condition_variable				_cv;
+		std::deque<std::function<void ()>>	_queue;
+		bool								_looping	= true;
+		std::thread							_thread;
+
+	public:
+		ReadbackWorker () : _thread{[this] () { _Loop(); }}
+		{}
+
+		~ReadbackWorker ()
+		{
+			{
+				std::unique_lock	lock{ _guard };
+				_looping = false;
+			}
+			_cv.notify_one();
+			_thread.join();
+		}
+
+		void  Enqueue (std::function<void ()> &&task)
+		{
+			{
+				std::unique_lock	lock{ _guard };
+				_queue.push_back( std::move(task) );
+			}
+			_cv.notify_one();
+		}
+
+		ND_ std::thread::id  ThreadId () const	{ return _thread.get_id(); }
+
+	private:
+		void  _Loop ()
+		{
+			for (;;)
+			{
+				std::function<void ()>	task;
+				{
+					std::unique_lock	lock{ _guard };
+					_cv.wait( lock, [this] () { return not _queue.empty() or not _looping; });
+
+					if ( _queue.empty() )
+						return;
+
+					task = std::move( _queue.front() );
+					_queue.pop_front();
+				}
+				task();
+			}
+		}
+	};
+
+
+	bool FGApp::ImplTest_AsyncReadback1 ()
+	{
+		const BytesU		buf_size	= 1_Mb;
+		const uint2			img_dim		{ 256, 256 };
+		ReadbackWorker		worker;
+		Atomic<uint>		cb_counter	{0};
+		Atomic<bool>		is_correct	{true};
+		const auto			main_thread	= std::this_thread::get_id();
+		const auto			worker_id	= worker.ThreadId();
+
+		CHECK_ERR( _frameGraph->SetReadbackExecutor( [&worker] (std::function<void ()> &&task) { worker.Enqueue( std::move(task) ); }));
+
+		BufferID	buffer	= _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" );
+		ImageID		image	= _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{ img_dim.x, img_dim.y, 1 }, EPixelFormat::RGBA8_UNorm, EImageUsage::Transfer },
+													    Default, "Image" );
+		CHECK_ERR( buffer and image );
+
+		const auto	OnBufferLoaded = [&] (BufferView data)
+		{
+			bool	ok = (std::this_thread::get_id() == worker_id) and (data.Parts().size() == 1) and (data.size() == size_t(buf_size));
+
+			for (size_t i = 0; ok and i < data.size(); i += 4) {
+				ok = (data[i] == 0x11);
+			}
+
+			if ( not ok ) is_correct = false;
+			++cb_counter;
+		};
+
+		const auto	OnImageLoaded = [&] (const ImageView &view)
+		{
+			bool	ok = (std::this_thread::get_id() == worker_id) and (view.Parts().size() == 1) and All( view.Dimension() == uint3{ img_dim.x, img_dim.y, 1 } );
+
+			if ( not ok ) is_correct = false;
+			++cb_counter;
+		};
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		Task	t_fill		= cmd->AddTask( FillBuffer().SetBuffer( buffer ).SetPattern( 0x11 ));
+		Task	t_clear		= cmd->AddTask( ClearColorImage().SetImage( image ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{1.0f} ));
+		Task	t_read_buf	= cmd->AddTask( ReadBuffer().SetBuffer( buffer, 0_b, buf_size ).SetContiguous().SetCallback( OnBufferLoaded ).DependsOn( t_fill ));
+		Task	t_read_img	= cmd->AddTask( ReadImage().SetImage( image, int2(), img_dim ).SetContiguous().SetCallback( OnImageLoaded ).DependsOn( t_clear ));
+		FG_UNUSED( t_read_buf, t_read_img );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		// callbacks are executed in worker thread
+		for (uint i = 0; cb_counter.load() < 2 and i < 1000; ++i) {
+			std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+		}
+
+		CHECK_ERR( main_thread != worker_id );
+		CHECK_ERR( cb_counter.load() == 2 );
+		CHECK_ERR( is_correct.load() );
+
+		CHECK_ERR( _frameGraph->SetReadbackExecutor( {} ));
+		DeleteResources( buffer, image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,67 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_BarrierBatching1 ()
+	{
+		static constexpr uint	count		= 4;
+		const uint2				img_dim		= {64, 64};
+		ImageID					src_images [count];
+		ImageID					dst_images [count];
+
+		for (uint i = 0; i < count; ++i)
+		{
+			src_images[i] = _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{img_dim.x, img_dim.y, 1}, EPixelFormat::RGBA8_UNorm,
+																 EImageUsage::Transfer }, Default, "SrcImage-"s << ToString(i) );
+			dst_images[i] = _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{img_dim.x, img_dim.y, 1}, EPixelFormat::RGBA8_UNorm,
+																 EImageUsage::Transfer }, Default, "DstImage-"s << ToString(i) );
+			CHECK_ERR( src_images[i] and dst_images[i] );
+		}
+
+		// returns number of pipeline barriers
+		const auto	RunFrame = [&] (ECompilationFlags flags, OUT String &dump) -> uint
+		{
+			IFrameGraph::Statistics	stat;
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));	// reset
+			
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetCompilationFlags( flags )
+																		  .SetDebugFlags( EDebugFlags::Default | EDebugFlags::LogBarrierBatching ));
+			CHECK_ERR( cmd );
+
+			for (uint i = 0; i < count; ++i)
+			{
+				Task	t_clear	= cmd->AddTask( ClearColorImage{}.SetImage( src_images[i] ).Clear( RGBA32f{float(i)} ).AddRange( 0_mipmap, 1, 0_layer, 1 ));
+				Task	t_copy	= cmd->AddTask( CopyImage().From( src_images[i] ).To( dst_images[i] ).AddRegion( {}, int2(), {}, int2(), img_dim ).DependsOn( t_clear ));
+				FG_UNUSED( t_copy );
+			}
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+			
+			CHECK_ERR( _frameGraph->DumpToString( OUT dump ));
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+			return stat.renderer.pipelineBarriers;
+		};
+
+		String		dump1, dump2;
+		const uint	barriers1	= RunFrame( Default, OUT dump1 );
+		const uint	barriers2	= RunFrame( ECompilationFlags::BatchBarriers, OUT dump2 );
+
+		// all clears and all copies are independent, so each group needs single barrier
+		CHECK_ERR( barriers1 > 0 );
+		CHECK_ERR( barriers2 + (count - 1) * 2 == barriers1 );
+		CHECK_ERR( HasSubString( dump1, "barriersSaved: 0\n" ));
+		CHECK_ERR( HasSubString( dump2, "barriersSaved: "s << ToString( (count - 1) * 2 ) << '\n' ));
+
+		for (uint i = 0; i < count; ++i) {
+			DeleteResources( src_images[i], dst_images[i] );
+		}
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,70 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Replay capture that contains more command buffers than the batch pool can hold,
+	replayer must release command buffers that are not referenced by the following records.
+*/
+
+#include "../FGApp.h"
+#include "extensions/capture/FrameGraphCapture.h"
+#include "extensions/capture/CaptureReplayer.h"
+#include "stl/Stream/MemStream.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_CaptureReplay1 ()
+	{
+		const uint		cmd_count	= 600;		// batch pool size is 512
+		const uint		wait_step	= 64;
+		const BytesU	buf_size	= 256_b;
+
+		auto		stream	= MakeShared<MemWStream>();
+		FrameGraph	capture	= FrameGraphCapture::Create( _frameGraph, stream );
+		CHECK_ERR( capture );
+
+		BufferID	buffer = capture->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" );
+		CHECK_ERR( buffer );
+
+		CommandBuffer	prev;
+		for (uint i = 0; i < cmd_count; ++i)
+		{
+			CommandBuffer	cmd = capture->Begin( CommandBufferDesc{}, {prev} );
+			CHECK_ERR( cmd );
+
+			Task	t_fill = cmd->AddTask( FillBuffer().SetBuffer( buffer ).SetPattern( i ));
+			FG_UNUSED( t_fill );
+
+			CHECK_ERR( capture->Execute( cmd ));
+
+			if ( (i+1) % wait_step == 0 )
+			{
+				CHECK_ERR( capture->Flush() );
+				CHECK_ERR( capture->Wait({ cmd }));
+			}
+			prev = std::move(cmd);
+		}
+		prev = null;
+
+		CHECK_ERR( capture->WaitIdle() );
+		capture->ReleaseResource( INOUT buffer );
+		capture.reset();
+
+		// replay
+		CaptureReplayer	replayer;
+		{
+			MemRStream	rstream{ stream->GetData() };
+			CHECK_ERR( replayer.Load( rstream ));
+		}
+
+		CaptureReplayer::Statistics	stats;
+		CHECK_ERR( replayer.Replay( _frameGraph, OUT stats ));
+
+		CHECK_ERR( stats.commandBuffers == cmd_count );
+		CHECK_ERR( stats.tasks == cmd_count );
+		CHECK_ERR( stats.skipped == 0 );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
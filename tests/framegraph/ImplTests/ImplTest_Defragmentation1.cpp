@@ -0,0 +1,119 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Resources that was moved to another memory block
+	must keep the same ID and content.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_Defragmentation1 ()
+	{
+		const uint		count		= 16;
+		const BytesU	buf_size	= 256_Kb;
+		const uint2		img_dim		{ 128, 128 };
+
+		Array<BufferID>	buffers;
+		for (uint i = 0; i < count; ++i)
+		{
+			buffers.push_back( _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer-"s << ToString(i) ));
+			CHECK_ERR( buffers.back() );
+		}
+
+		ImageID		image = _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{ img_dim.x, img_dim.y, 1 }, EPixelFormat::RGBA8_UNorm, EImageUsage::Transfer },
+													  Default, "Image" );
+		CHECK_ERR( image );
+
+		// fill
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+			CHECK_ERR( cmd );
+
+			for (uint i = 0; i < count; ++i) {
+				cmd->AddTask( FillBuffer().SetBuffer( buffers[i] ).SetPattern( i ));
+			}
+			cmd->AddTask( ClearColorImage().SetImage( image ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{ 0.0f, 1.0f, 0.0f, 1.0f }));
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		// make holes in memory blocks
+		for (uint i = 0; i < count; i += 2) {
+			_frameGraph->ReleaseResource( INOUT buffers[i] );
+		}
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));		// reset statistics
+
+		// defragment
+		BytesU	moved_size;
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+			CHECK_ERR( cmd );
+
+			moved_size = cmd->DefragmentMemory( buf_size * count );
+			CHECK_ERR( moved_size <= buf_size * count );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+		}
+
+		// read
+		bool	buf_is_correct	= true;
+		bool	img_is_correct	= false;
+		uint	cb_counter		= 0;
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+			CHECK_ERR( cmd );
+
+			for (uint i = 1; i < count; i += 2)
+			{
+				cmd->AddTask( ReadBuffer().SetBuffer( buffers[i], 0_b, buf_size ).SetCallback( [&buf_is_correct, &cb_counter, i] (const BufferView &data)
+					{
+						for (auto& part : data.Parts())
+						{
+							ArrayView<uint>	arr{ Cast<uint>(part.data()), part.size() / sizeof(uint) };
+
+							for (auto& val : arr) {
+								buf_is_correct &= (val == i);
+							}
+						}
+						++cb_counter;
+					}));
+			}
+			cmd->AddTask( ReadImage().SetImage( image, int2(), img_dim ).SetCallback( [&img_is_correct, &cb_counter] (const ImageView &view)
+				{
+					RGBA32f		color;
+					view.Load( uint3{ 7, 9, 0 }, OUT color );
+
+					img_is_correct = All( Equals( color, RGBA32f{ 0.0f, 1.0f, 0.0f, 1.0f }, 0.01f ));
+					++cb_counter;
+				}));
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		CHECK_ERR( cb_counter == count/2 + 1 );
+		CHECK_ERR( buf_is_correct );
+		CHECK_ERR( img_is_correct );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.defragmentedBytes == moved_size );
+		CHECK_ERR( (stat.resources.defragmentedResources > 0) == (moved_size > 0_b) );
+		CHECK_ERR( stat.resources.memoryBlockCount > 0 );
+		CHECK_ERR( stat.resources.memoryUsed > 0_b );
+		CHECK_ERR( stat.resources.memoryLargestFreeRange <= stat.resources.memoryUnused );
+
+		for (auto& buf : buffers) {
+			if ( buf ) _frameGraph->ReleaseResource( INOUT buf );
+		}
+		DeleteResources( image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
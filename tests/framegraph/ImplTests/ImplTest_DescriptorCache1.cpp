@@ -0,0 +1,85 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_DescriptorCache1 ()
+	{
+		ComputePipelineDesc	ppln;
+
+		ppln.AddShader( EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding=0, rgba8) writeonly uniform image2D  un_OutImage;
+
+void main ()
+{
+	imageStore( un_OutImage, ivec2(gl_GlobalInvocationID.xy), vec4(1.0, 0.0, 1.0, 0.0) );
+}
+)#" );
+		
+		const uint2		image_dim	= { 16, 16 };
+		const ImageDesc	image_desc	{ EImage::Tex2D, uint3{image_dim.x, image_dim.y, 1}, EPixelFormat::RGBA8_UNorm, EImageUsage::Storage };
+
+		ImageID			image1		= _frameGraph->CreateImage( image_desc, Default, "Image1" );
+		ImageID			image2		= _frameGraph->CreateImage( image_desc, Default, "Image2" );
+		CPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( pipeline );
+
+		PipelineResources	resources1, resources2;
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources1 ));
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources2 ));
+
+		const auto	Dispatch = [&] (const PipelineResources &res) -> bool
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{} );
+			CHECK_ERR( cmd );
+
+			Task	t_run = cmd->AddTask( DispatchCompute().SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), &res ).Dispatch({ 2, 2 }) );
+			FG_UNUSED( t_run );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+			return true;
+		};
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));		// reset statistics
+
+		// new descriptor set
+		resources1.BindImage( UniformID("un_OutImage"), image1 );
+		CHECK_ERR( Dispatch( resources1 ));
+
+		// same content, must reuse descriptor set from 'resources1'
+		resources2.BindImage( UniformID("un_OutImage"), image1 );
+		CHECK_ERR( Dispatch( resources2 ));
+
+		// unchanged, must use cached descriptor set without hashing
+		for (uint i = 0; i < 4; ++i) {
+			resources1.BindImage( UniformID("un_OutImage"), image1 );
+			CHECK_ERR( Dispatch( resources1 ));
+		}
+
+		// changed and restored
+		resources2.BindImage( UniformID("un_OutImage"), image2 );
+		CHECK_ERR( Dispatch( resources2 ));
+		resources2.BindImage( UniformID("un_OutImage"), image1 );
+		CHECK_ERR( Dispatch( resources2 ));
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.descriptorSetCacheMisses == 2 );
+		CHECK_ERR( stat.resources.descriptorSetDedupHits == 2 );
+		CHECK_ERR( stat.resources.descriptorSetCacheHits == 4 );
+
+		DeleteResources( pipeline, image1, image2 );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
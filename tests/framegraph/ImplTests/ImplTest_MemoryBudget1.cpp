@@ -0,0 +1,61 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Per-heap memory statistics must track allocations,
+	budget callback must be called in 'Flush' when usage exceeds soft budget.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_MemoryBudget1 ()
+	{
+		const BytesU	buf_size = 16_Mb;
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.memoryHeaps.size() > 0 );
+
+		BytesU	used_before;
+		for (auto& heap : stat.resources.memoryHeaps) {
+			used_before += heap.used;
+		}
+
+		BufferID	buffer = _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" );
+		CHECK_ERR( buffer );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+
+		BytesU	used_after;
+		for (auto& heap : stat.resources.memoryHeaps)
+		{
+			CHECK_ERR( heap.highWaterMark >= heap.used );
+			CHECK_ERR( heap.size > 0_b );
+			used_after += heap.used;
+		}
+		CHECK_ERR( used_after >= used_before + buf_size );
+
+		// callback must be called for at least one heap
+		uint	cb_counter = 0;
+
+		CHECK_ERR( _frameGraph->SetMemoryBudgetCallback( 1.0e-6f, [&cb_counter] (uint, BytesU usage, BytesU budget)
+													   {
+														   if ( usage > 0_b and budget > 0_b ) ++cb_counter;
+													   }));
+		CHECK_ERR( _frameGraph->Flush() );
+		CHECK_ERR( cb_counter > 0 );
+
+		// callback is disabled
+		cb_counter = 0;
+		CHECK_ERR( _frameGraph->SetMemoryBudgetCallback( 1.0f, {} ));
+		CHECK_ERR( _frameGraph->Flush() );
+		CHECK_ERR( cb_counter == 0 );
+
+		DeleteResources( buffer );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,153 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Descriptor allocation from many threads.
+	Each thread rebinds resources every frame, so persistent descriptor sets are searched in cache or created,
+	and uses shader debugger (if enabled) that allocates transient descriptor sets per command batch.
+*/
+
+#include "../FGApp.h"
+#include "stl/ThreadSafe/Barrier.h"
+#include <thread>
+#include <chrono>
+
+namespace FG
+{
+	static constexpr uint	thread_count		= 8;
+	static constexpr uint	frame_count			= 200;
+	static constexpr uint	images_per_thread	= 4;
+
+
+	static bool RenderThread (const FrameGraph &fg, CPipelineID pipeline, CPipelineID dbgPipeline, uint threadIndex, Barrier &sync)
+	{
+		const uint2		image_dim	= { 64, 64 };
+		const ImageDesc	image_desc	{ EImage::Tex2D, uint3{image_dim.x, image_dim.y, 1}, EPixelFormat::RGBA8_UNorm, EImageUsage::Storage };
+
+		ImageID				images[images_per_thread];
+		PipelineResources	resources;
+		PipelineResources	dbg_resources;
+		CommandBuffer		per_frame[2];
+
+		for (auto& img : images) {
+			img = fg->CreateImage( image_desc, Default, "Image_"s << ToString(threadIndex) );
+			CHECK_ERR( img );
+		}
+
+		CHECK_ERR( fg->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources ));
+
+		if ( dbgPipeline )
+			CHECK_ERR( fg->InitPipelineResources( dbgPipeline, DescriptorSetID("0"), OUT dbg_resources ));
+
+		sync.wait();
+
+		for (uint i = 0; i < frame_count; ++i)
+		{
+			CHECK_ERR( fg->Wait({ per_frame[i&1] }));
+
+			CommandBuffer	cmd = fg->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			per_frame[i&1] = cmd;
+
+			for (uint j = 0; j < images_per_thread; ++j)
+			{
+				resources.BindImage( UniformID("un_OutImage"), images[(i + j) % images_per_thread] );
+
+				Task	t_comp = cmd->AddTask( DispatchCompute().SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), &resources ).Dispatch({ 8, 8 }) );
+				FG_UNUSED( t_comp );
+			}
+
+			if ( dbgPipeline )
+			{
+				dbg_resources.BindImage( UniformID("un_OutImage"), images[i % images_per_thread] );
+
+				Task	t_dbg = cmd->AddTask( DispatchCompute().SetPipeline( dbgPipeline ).AddResources( DescriptorSetID("0"), &dbg_resources )
+														.Dispatch({ 8, 8 }).EnableDebugTrace(uint3{ 0, 0, 0 }) );
+				FG_UNUSED( t_dbg );
+			}
+
+			CHECK_ERR( fg->Execute( cmd ));
+			CHECK_ERR( fg->Flush() );
+		}
+
+		CHECK_ERR( fg->Wait({ per_frame[0], per_frame[1] }));
+
+		for (auto& img : images) {
+			fg->ReleaseResource( img );
+		}
+		return true;
+	}
+
+
+	bool FGApp::ImplTest_Multithreading5 ()
+	{
+		const char	source[] = R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding=0, rgba8) writeonly uniform image2D  un_OutImage;
+
+void main ()
+{
+	imageStore( un_OutImage, ivec2(gl_GlobalInvocationID.xy), vec4(gl_LocalInvocationID.xy, 0.0, 1.0) / 8.0 );
+}
+)#";
+		ComputePipelineDesc	ppln;
+		ppln.AddShader( EShaderLangFormat::VKSL_100, "main", source );
+
+		CPipelineID		pipeline = _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( pipeline );
+
+		CPipelineID		dbg_pipeline;
+		if ( FG_EnableShaderDebugging )
+		{
+			ComputePipelineDesc	dbg_ppln;
+			dbg_ppln.AddShader( EShaderLangFormat::VKSL_100 | EShaderLangFormat::EnableDebugTrace, "main", source );
+
+			dbg_pipeline = _frameGraph->CreatePipeline( dbg_ppln );
+			CHECK_ERR( dbg_pipeline );
+
+			_frameGraph->SetShaderDebugCallback( [] (StringView, StringView, EShaderStages, ArrayView<String>) {});
+		}
+
+		Barrier			sync	{ thread_count + 1 };
+		bool			results [thread_count] = {};
+		std::thread		threads [thread_count];
+
+		for (uint i = 0; i < thread_count; ++i) {
+			threads[i] = std::thread{ [&, i] () { results[i] = RenderThread( _frameGraph, pipeline, dbg_pipeline, i, sync ); }};
+		}
+
+		sync.wait();
+		const auto	start = std::chrono::high_resolution_clock::now();
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		const auto	dt = std::chrono::high_resolution_clock::now() - start;
+
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		for (bool res : results) {
+			CHECK_ERR( res );
+		}
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+
+		FG_LOGI( "Threads: "s << ToString( thread_count ) << ", frames: " << ToString( frame_count ) << ", time: " << ToString( dt )
+				 << ", descriptor sets: cache hits " << ToString( stat.resources.descriptorSetCacheHits )
+				 << ", dedup hits " << ToString( stat.resources.descriptorSetDedupHits )
+				 << ", created " << ToString( stat.resources.descriptorSetCacheMisses ));
+
+		DeleteResources( pipeline );
+		if ( dbg_pipeline )
+			DeleteResources( dbg_pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,100 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Submission contention benchmark.
+	Each thread records small command buffers for graphics and async compute queues
+	with cross-queue dependency and flushes them, measures time for 1..16 threads.
+*/
+
+#include "../FGApp.h"
+#include "stl/ThreadSafe/Barrier.h"
+#include <thread>
+#include <chrono>
+
+namespace FG
+{
+	static constexpr uint	max_threads		= 16;
+	static constexpr uint	frame_count		= 500;
+
+
+	static bool ProducerThread (const FrameGraph &fg, uint threadIndex, Barrier &sync)
+	{
+		BufferID		gbuffer	= fg->CreateBuffer( BufferDesc{ 256_b, EBufferUsage::TransferDst }, Default, "GraphicsBuffer_"s << ToString(threadIndex) );
+		BufferID		cbuffer	= fg->CreateBuffer( BufferDesc{ 256_b, EBufferUsage::TransferDst }, Default, "ComputeBuffer_"s << ToString(threadIndex) );
+		CommandBuffer	per_frame[2];
+		
+		CHECK_ERR( gbuffer and cbuffer );
+
+		sync.wait();
+
+		for (uint i = 0; i < frame_count; ++i)
+		{
+			CHECK_ERR( fg->Wait({ per_frame[i&1] }));
+
+			CommandBuffer	cmd1 = fg->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd1 );
+
+			Task	t_fill1 = cmd1->AddTask( FillBuffer().SetBuffer( gbuffer ).SetPattern( i ));
+			FG_UNUSED( t_fill1 );
+
+			CHECK_ERR( fg->Execute( cmd1 ));
+
+			CommandBuffer	cmd2 = fg->Begin( CommandBufferDesc{ EQueueType::AsyncCompute }, {cmd1} );
+			CHECK_ERR( cmd2 );
+
+			Task	t_fill2 = cmd2->AddTask( FillBuffer().SetBuffer( cbuffer ).SetPattern( i ));
+			FG_UNUSED( t_fill2 );
+
+			CHECK_ERR( fg->Execute( cmd2 ));
+			CHECK_ERR( fg->Flush() );
+
+			per_frame[i&1] = cmd2;
+		}
+
+		CHECK_ERR( fg->Wait({ per_frame[0], per_frame[1] }));
+
+		fg->ReleaseResource( gbuffer );
+		fg->ReleaseResource( cbuffer );
+		return true;
+	}
+
+
+	bool FGApp::ImplTest_Multithreading6 ()
+	{
+		for (uint thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+		{
+			Barrier			sync	{ thread_count + 1 };
+			bool			results [max_threads] = {};
+			std::thread		threads [max_threads];
+
+			for (uint i = 0; i < thread_count; ++i) {
+				threads[i] = std::thread{ [&, i] () { results[i] = ProducerThread( _frameGraph, i, sync ); }};
+			}
+
+			sync.wait();
+			const auto	start = std::chrono::high_resolution_clock::now();
+
+			for (uint i = 0; i < thread_count; ++i) {
+				threads[i].join();
+			}
+
+			const auto	dt = std::chrono::high_resolution_clock::now() - start;
+
+			CHECK_ERR( _frameGraph->WaitIdle() );
+
+			for (uint i = 0; i < thread_count; ++i) {
+				CHECK_ERR( results[i] );
+			}
+
+			IFrameGraph::Statistics	stat;
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+
+			FG_LOGI( "Producers: "s << ToString( thread_count ) << ", batches: " << ToString( thread_count * frame_count * 2 )
+					 << ", time: " << ToString( dt ) << ", submission: " << ToString( stat.renderer.submitingTime )
+					 << ", waiting: " << ToString( stat.renderer.waitingTime ));
+		}
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
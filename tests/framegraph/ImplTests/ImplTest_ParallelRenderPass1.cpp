@@ -0,0 +1,110 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_ParallelRenderPass1 ()
+	{
+		GraphicsPipelineDesc	ppln;
+
+		ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(vertex)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec3  v_Color;
+
+const vec2	g_Positions[6] = vec2[](
+	vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0),
+	vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 1.0)
+);
+
+void main() {
+	const int	grid = 32;
+	vec2		cell = vec2( gl_InstanceIndex % grid, gl_InstanceIndex / grid );
+
+	gl_Position	= vec4( (cell + g_Positions[gl_VertexIndex]) * (2.0 / float(grid)) - 1.0, 0.0, 1.0 );
+	v_Color		= vec3( cell / float(grid-1), 1.0 );
+}
+)#" );
+
+		ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(fragment)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec4  out_Color;
+
+layout(location=0) in  vec3  v_Color;
+
+void main() {
+	out_Color = vec4(v_Color, 1.0);
+}
+)#" );
+
+		static constexpr uint	grid_size	= 32;
+		static constexpr uint	draw_count	= grid_size * grid_size;
+		const uint2				view_size	= {512, 512};
+		ImageID					image		= _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{view_size.x, view_size.y, 1}, EPixelFormat::RGBA8_UNorm,
+																					EImageUsage::ColorAttachment | EImageUsage::TransferSrc }, Default, "RenderTarget" );
+
+		GPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( pipeline );
+
+
+		bool		data_is_correct = false;
+
+		const auto	OnLoaded =	[OUT &data_is_correct] (const ImageView &imageData)
+		{
+			const uint	cell_size = imageData.Dimension().x / grid_size;
+
+			data_is_correct = true;
+
+			for (uint y = 0; y < grid_size; ++y)
+			for (uint x = 0; x < grid_size; ++x)
+			{
+				RGBA32f	col;
+				imageData.Load( uint3(x * cell_size + cell_size/2, y * cell_size + cell_size/2, 0), OUT col );
+
+				bool	is_equal = All(Equals( col, RGBA32f{ float(x) / (grid_size-1), float(y) / (grid_size-1), 1.0f, 1.0f }, 0.01f ));
+				ASSERT( is_equal );
+				data_is_correct &= is_equal;
+			}
+		};
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));	// reset
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetCompilationFlags( ECompilationFlags::ParallelRenderPass ));
+		CHECK_ERR( cmd );
+
+		LogicalPassID	render_pass	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+											.AddTarget( RenderTargetID::Color_0, image, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+											.AddViewport( view_size ) );
+
+		// each draw task is a single cell of the grid
+		for (uint i = 0; i < draw_count; ++i)
+		{
+			cmd->AddTask( render_pass, DrawVertices().Draw( 6, 1, 0, i ).SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList ));
+		}
+
+		Task	t_draw	= cmd->AddTask( SubmitRenderPass{ render_pass });
+		Task	t_read	= cmd->AddTask( ReadImage().SetImage( image, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_draw ) );
+		FG_UNUSED( t_read );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.renderer.drawCalls == draw_count );
+		CHECK_ERR( data_is_correct );
+
+		DeleteResources( image, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
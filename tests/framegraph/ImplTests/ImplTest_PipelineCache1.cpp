@@ -0,0 +1,93 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+#include "stl/Stream/FileStream.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_PipelineCache1 ()
+	{
+		ComputePipelineDesc	ppln;
+
+		ppln.AddShader( EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding=0, rgba8) writeonly uniform image2D  un_OutImage;
+
+void main ()
+{
+	imageStore( un_OutImage, ivec2(gl_GlobalInvocationID.xy), vec4(1.0, 0.0, 1.0, 0.0) );
+}
+)#" );
+
+		const char		cache_file[]	= "pipeline_cache_test.bin";
+		const uint2		image_dim		= { 16, 16 };
+
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{image_dim.x, image_dim.y, 1}, EPixelFormat::RGBA8_UNorm,
+																		   EImageUsage::Storage }, Default, "MyImage" );
+		CPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( pipeline );
+
+		PipelineResources	resources;
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources ));
+		resources.BindImage( UniformID("un_OutImage"), image );
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{} );
+		CHECK_ERR( cmd );
+
+		Task	t_run = cmd->AddTask( DispatchCompute().SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), &resources ).Dispatch({ 2, 2 }) );
+		FG_UNUSED( t_run );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->Flush() );
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		// save and load valid cache
+		CHECK_ERR( _frameGraph->SavePipelineCache( cache_file ));
+		CHECK_ERR( _frameGraph->LoadPipelineCache( cache_file ));
+
+		// truncated cache must be rejected
+		{
+			Array<uint8_t>	blob;
+			{
+				FileRStream		file{ cache_file };
+				CHECK_ERR( file.IsOpen() );
+				CHECK_ERR( file.Read( size_t(file.Size()), OUT blob ));
+			}
+			CHECK_ERR( blob.size() > 16 );
+			{
+				FileWStream		file{ cache_file };
+				CHECK_ERR( file.IsOpen() );
+				CHECK_ERR( file.Write( ArrayView<uint8_t>{ blob }.section( 0, blob.size()-16 )));
+			}
+			CHECK_ERR( not _frameGraph->LoadPipelineCache( cache_file ));
+		}
+
+		// blob from another device must be rejected
+		{
+			const uint	magic	= 0x43504746;
+			const uint	version	= 1;
+			{
+				FileWStream		file{ cache_file };
+				CHECK_ERR( file.IsOpen() );
+				CHECK_ERR( file.Write( magic ));
+				CHECK_ERR( file.Write( version ));
+				CHECK_ERR( file.Write( StringView{"not a pipeline cache for this device"} ));
+			}
+			CHECK_ERR( not _frameGraph->LoadPipelineCache( cache_file ));
+		}
+
+		CHECK_ERR( not _frameGraph->LoadPipelineCache( "" ));
+		std::remove( cache_file );
+
+		DeleteResources( pipeline, image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,91 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Large image upload must not be splitted,
+	staging ring must grow and report high-water mark.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_StagingRing1 ()
+	{
+		const uint2		img_dim		{ 4096, 4096 };
+		const uint2		read_offset	{ 4000, 4000 };
+		const uint2		read_dim	{ 64, 64 };
+		const uint		bpp			= 4;
+		const BytesU	data_size	= BytesU{img_dim.x} * img_dim.y * bpp;
+
+		ImageID		image = _frameGraph->CreateImage( ImageDesc{ EImage::Tex2D, uint3{ img_dim.x, img_dim.y, 1 }, EPixelFormat::RGBA8_UNorm, EImageUsage::Transfer },
+													  Default, "Image" );
+		CHECK_ERR( image );
+
+		Array<uint8_t>	data;
+		data.resize( size_t(data_size) );
+
+		for (uint y = 0; y < img_dim.y; ++y)
+		for (uint x = 0; x < img_dim.x; ++x)
+		{
+			uint8_t*	ptr = &data[ (size_t(y) * img_dim.x + x) * bpp ];
+			ptr[0] = uint8_t(x);
+			ptr[1] = uint8_t(y);
+			ptr[2] = uint8_t((x >> 8) | ((y >> 8) << 4));
+			ptr[3] = 0xFF;
+		}
+
+		bool	cb_was_called	= false;
+		bool	data_is_correct	= true;
+
+		const auto	OnLoaded = [&] (const ImageView &view)
+		{
+			cb_was_called = true;
+
+			for (uint y = 0; y < read_dim.y; ++y)
+			{
+				ArrayView<uint8_t>	row = view.GetRow( y );
+
+				for (uint x = 0; x < read_dim.x; ++x)
+				{
+					const uint	sx = x + read_offset.x;
+					const uint	sy = y + read_offset.y;
+
+					data_is_correct &= (row[x*bpp+0] == uint8_t(sx) and
+										row[x*bpp+1] == uint8_t(sy) and
+										row[x*bpp+2] == uint8_t((sx >> 8) | ((sy >> 8) << 4)) and
+										row[x*bpp+3] == 0xFF);
+				}
+			}
+		};
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));		// reset statistics
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		Task	t_update	= cmd->AddTask( UpdateImage().SetImage( image ).SetData( data, img_dim ));
+		Task	t_read		= cmd->AddTask( ReadImage().SetImage( image, int2(read_offset), read_dim ).SetCallback( OnLoaded ).DependsOn( t_update ));
+		FG_UNUSED( t_read );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( cb_was_called );
+		CHECK_ERR( data_is_correct );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.stagingHighWaterMark >= data_size );
+		CHECK_ERR( stat.resources.stagingBufferSize >= data_size );
+
+		// all blocks are released after 'WaitIdle'
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.stagingHighWaterMark == 0_b );
+
+		DeleteResources( image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
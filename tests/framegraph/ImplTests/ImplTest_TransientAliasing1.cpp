@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Transient images with non-overlapping lifetime must share memory,
+	content of aliased image must not be corrupted by previous image.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_TransientAliasing1 ()
+	{
+		const uint2		img_dim		{ 256, 256 };
+		const ImageDesc	desc		{ EImage::Tex2D, uint3{ img_dim.x, img_dim.y, 1 }, EPixelFormat::RGBA8_UNorm, EImageUsage::Transfer };
+
+		bool	cb_was_called	= false;
+		bool	data_is_correct	= true;
+
+		const auto	CheckColor = [&] (const ImageView &view, const RGBA32f &expected)
+		{
+			cb_was_called = true;
+
+			for (uint y = 0; y < img_dim.y; ++y)
+			for (uint x = 0; x < img_dim.x; ++x)
+			{
+				RGBA32f		color;
+				view.Load( uint3(x, y, 0), OUT color );
+
+				data_is_correct &= All( Equals( color, expected, 0.01f ));
+			}
+		};
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));		// reset statistics
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		// 'image_a' is not used after copying, so 'image_c' can reuse its memory
+		RawImageID	image_a	= cmd->CreateTransientImage( desc, "ImageA" );
+		RawImageID	image_b	= cmd->CreateTransientImage( desc, "ImageB" );
+		RawImageID	image_c	= cmd->CreateTransientImage( desc, "ImageC" );
+		CHECK_ERR( image_a and image_b and image_c );
+
+		Task	t_clear_a	= cmd->AddTask( ClearColorImage().SetImage( image_a ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{1.0f, 0.0f, 0.0f, 1.0f} ));
+		Task	t_copy		= cmd->AddTask( CopyImage().From( image_a ).To( image_b ).AddRegion( {}, int2(), {}, int2(), img_dim ).DependsOn( t_clear_a ));
+		Task	t_clear_c	= cmd->AddTask( ClearColorImage().SetImage( image_c ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{0.0f, 1.0f, 0.0f, 1.0f} ).DependsOn( t_copy ));
+		Task	t_read_c	= cmd->AddTask( ReadImage().SetImage( image_c, int2(), img_dim ).SetCallback( [&] (const ImageView &view) { CheckColor( view, RGBA32f{0.0f, 1.0f, 0.0f, 1.0f} ); })
+															.DependsOn( t_clear_c ));
+		Task	t_read_b	= cmd->AddTask( ReadImage().SetImage( image_b, int2(), img_dim ).SetCallback( [&] (const ImageView &view) { CheckColor( view, RGBA32f{1.0f, 0.0f, 0.0f, 1.0f} ); })
+															.DependsOn( t_read_c ));
+		FG_UNUSED( t_read_b );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( cb_was_called );
+		CHECK_ERR( data_is_correct );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.transientMemorySize > 0_b );
+		CHECK_ERR( stat.resources.transientMemorySaved > 0_b );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
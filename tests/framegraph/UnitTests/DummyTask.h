@@ -12,6 +12,13 @@ namespace FG
 	//
 	class VFgDummyTask final : public VFrameGraphTask
 	{
+	public:
+		void AddInput (VFgDummyTask *task)
+		{
+			_inputs.push_back( task );
+			++_pendingInputs;
+			task->Attach( this );
+		}
 	};
 
 
@@ -1,7 +1,102 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "framegraph/Shared/EnumUtils.h"
+#include "framegraph/Shared/ImageViewKernels.h"
+#include "framegraph/Shared/EnumToString.h"
 #include "UnitTest_Common.h"
+#include <random>
+#include <chrono>
+
+namespace
+{
+	struct FormatInfo
+	{
+		EPixelFormat	format;
+		EImageAspect	aspect;
+		uint			bytesPerPixel;
+	};
+
+	static const FormatInfo	s_BulkFormats[] = {
+		{ EPixelFormat::RGBA8_UNorm,		EImageAspect::Color,	4 },
+		{ EPixelFormat::sRGB8_A8,			EImageAspect::Color,	4 },
+		{ EPixelFormat::BGRA8_UNorm,		EImageAspect::Color,	4 },
+		{ EPixelFormat::RGBA16F,			EImageAspect::Color,	8 },
+		{ EPixelFormat::RGBA32F,			EImageAspect::Color,	16 },
+		{ EPixelFormat::RGB10_A2_UNorm,		EImageAspect::Color,	4 },
+		{ EPixelFormat::RGB_11_11_10F,		EImageAspect::Color,	4 },
+		{ EPixelFormat::Depth16,			EImageAspect::Depth,	2 },
+		{ EPixelFormat::Depth24,			EImageAspect::Depth,	4 },
+		{ EPixelFormat::Depth32F,			EImageAspect::Depth,	4 },
+		{ EPixelFormat::Depth24_Stencil8,	EImageAspect::Depth,	4 }
+	};
+
+/*
+=================================================
+	GenPixels
+----
+	generates random pixels without inf and nan
+=================================================
+*/
+	static void  GenPixels (const FormatInfo &info, size_t count, INOUT std::mt19937 &gen, OUT Array<uint8_t> &data)
+	{
+		std::uniform_int_distribution<uint>		byte_dist	{ 0, 255 };
+		std::uniform_real_distribution<float>	float_dist	{ -100.0f, 100.0f };
+
+		data.resize( count * info.bytesPerPixel );
+
+		if ( info.format == EPixelFormat::RGBA32F or info.format == EPixelFormat::Depth32F )
+		{
+			for (size_t i = 0; i < data.size(); i += sizeof(float))
+			{
+				const float	f = float_dist( gen );
+				std::memcpy( OUT &data[i], &f, sizeof(f) );
+			}
+			return;
+		}
+
+		for (auto& b : data) { b = uint8_t(byte_dist( gen )); }
+
+		if ( info.format == EPixelFormat::RGBA16F )
+		{
+			for (size_t i = 0; i < data.size(); i += sizeof(uint16_t))
+			{
+				uint16_t	h;
+				std::memcpy( OUT &h, &data[i], sizeof(h) );
+				if ( (h & 0x7C00) == 0x7C00 )	h &= ~0x4000;
+				std::memcpy( OUT &data[i], &h, sizeof(h) );
+			}
+		}
+		else
+		if ( info.format == EPixelFormat::RGB_11_11_10F )
+		{
+			for (size_t i = 0; i < data.size(); i += sizeof(uint))
+			{
+				uint	bits;
+				std::memcpy( OUT &bits, &data[i], sizeof(bits) );
+				if ( (bits & (0x1F << 6))  == (0x1F << 6) )		bits &= ~(0x10u << 6);
+				if ( (bits & (0x1F << 17)) == (0x1F << 17) )	bits &= ~(0x10u << 17);
+				if ( (bits & (0x1Fu << 27)) == (0x1Fu << 27) )	bits &= ~(0x10u << 27);
+				std::memcpy( OUT &data[i], &bits, sizeof(bits) );
+			}
+		}
+	}
+
+/*
+=================================================
+	NearlyEqual
+=================================================
+*/
+	ND_ static bool  NearlyEqual (const RGBA32f &lhs, const RGBA32f &rhs, float absErr, float relErr)
+	{
+		for (uint i = 0; i < 4; ++i)
+		{
+			const float	err = Max( absErr, Abs( rhs[i] ) * relErr );
+			if ( Abs( lhs[i] - rhs[i] ) > err )
+				return false;
+		}
+		return true;
+	}
+}
 
 
 static void PixelFormat_Test1 ()
@@ -14,8 +109,187 @@ static void PixelFormat_Test1 ()
 }
 
 
+static void PixelFormat_Test2 ()
+{
+	// bulk conversion must be equal to per-pixel conversion
+	std::mt19937	gen{ 1234 };
+	const uint2		dim { 37, 5 };
+
+	for (auto& info : s_BulkFormats)
+	{
+		const size_t	row_pitch	= dim.x * info.bytesPerPixel + 12;
+		Array<uint8_t>	data;
+		GenPixels( info, row_pitch * dim.y / info.bytesPerPixel, INOUT gen, OUT data );
+
+		const ArrayView<uint8_t>	parts[] = { data };
+		const ImageView				view	{ parts, uint3{dim, 1}, BytesU{row_pitch}, BytesU{row_pitch * dim.y}, info.format, info.aspect };
+
+		Array<RGBA32f>	rows;
+		TEST( view.LoadRows( 0, dim.y, OUT rows ));
+		TEST( rows.size() == dim.x * dim.y );
+
+		for (uint y = 0; y < dim.y; ++y)
+		for (uint x = 0; x < dim.x; ++x)
+		{
+			RGBA32f	col;
+			view.Load( uint3{x, y, 0}, OUT col );
+			TEST( NearlyEqual( rows[x + y * dim.x], col, 1.0e-6f, 1.0e-6f ));
+		}
+
+		// region
+		const uint2		offset	{ 3, 1 };
+		const uint2		size	{ dim.x - 5, dim.y - 2 };
+		Array<RGBA32f>	region;
+		TEST( view.LoadRows( offset, size, OUT region ));
+
+		for (uint y = 0; y < size.y; ++y)
+		for (uint x = 0; x < size.x; ++x)
+		{
+			TEST( std::memcmp( &region[x + y * size.x], &rows[(x + offset.x) + (y + offset.y) * dim.x], sizeof(RGBA32f) ) == 0 );
+		}
+
+		// SIMD and scalar paths must produce the same result
+		const auto		simd	= GetPixelRowKernels( info.format, info.aspect, true );
+		const auto		scalar	= GetPixelRowKernels( info.format, info.aspect, false );
+		Array<RGBA32f>	row0	( dim.x );
+		Array<RGBA32f>	row1	( dim.x );
+		TEST( simd.load and scalar.load );
+		TEST( simd.bytesPerPixel == info.bytesPerPixel );
+
+		for (uint y = 0; y < dim.y; ++y)
+		{
+			simd.load( view.GetRow( y ).data(), dim.x, OUT row0.data() );
+			scalar.load( view.GetRow( y ).data(), dim.x, OUT row1.data() );
+			TEST( std::memcmp( row0.data(), row1.data(), size_t(ArraySizeOf( row0 ))) == 0 );
+		}
+	}
+}
+
+
+static void PixelFormat_Test3 ()
+{
+	// SIMD and scalar store must produce the same values
+	std::mt19937							gen{ 5678 };
+	std::uniform_real_distribution<float>	dist{ -0.25f, 1.25f };
+	const uint2								dim { 41, 3 };
+
+	for (auto& info : s_BulkFormats)
+	{
+		Array<RGBA32f>	src;
+		for (size_t i = 0; i < dim.x * dim.y; ++i) {
+			src.push_back( RGBA32f{ dist(gen), dist(gen), dist(gen), dist(gen) });
+		}
+
+		const size_t	row_pitch	= dim.x * info.bytesPerPixel + 4;
+		const size_t	data_size	= row_pitch * dim.y;
+		Array<uint8_t>	data0		( data_size, 0 );
+		Array<uint8_t>	data1		( data_size, 0 );
+		const auto		scalar		= GetPixelRowKernels( info.format, info.aspect, false );
+
+		TEST( ImageView::StoreRows( info.format, info.aspect, dim, src, BytesU{row_pitch}, OUT data0.data(), ArraySizeOf(data0) ));
+
+		for (uint y = 0; y < dim.y; ++y) {
+			scalar.store( src.data() + y * dim.x, dim.x, OUT data1.data() + y * row_pitch );
+		}
+
+		Array<RGBA32f>	row0	( dim.x );
+		Array<RGBA32f>	row1	( dim.x );
+
+		for (uint y = 0; y < dim.y; ++y)
+		{
+			scalar.load( data0.data() + y * row_pitch, dim.x, OUT row0.data() );
+			scalar.load( data1.data() + y * row_pitch, dim.x, OUT row1.data() );
+
+			// allow single bit difference for integer formats, FMA may be used on some platforms
+			for (uint x = 0; x < dim.x; ++x) {
+				TEST( NearlyEqual( row0[x], row1[x], 1.0f / 255.0f, 1.0e-6f ));
+			}
+		}
+
+		// round trip
+		if ( info.format == EPixelFormat::RGBA8_UNorm or info.format == EPixelFormat::BGRA8_UNorm or info.format == EPixelFormat::RGBA16F )
+		{
+			const bool	is_float = (info.format == EPixelFormat::RGBA16F);
+
+			for (uint y = 0; y < dim.y; ++y)
+			{
+				scalar.load( data0.data() + y * row_pitch, dim.x, OUT row0.data() );
+
+				for (uint x = 0; x < dim.x; ++x)
+				{
+					RGBA32f	expected = src[x + y * dim.x];
+					if ( not is_float )
+						for (uint i = 0; i < 4; ++i) { expected[i] = Clamp( expected[i], 0.0f, 1.0f ); }
+
+					TEST( NearlyEqual( row0[x], expected, (is_float ? 1.0e-4f : 0.5f / 255.0f + 1.0e-6f), 1.0e-3f ));
+				}
+			}
+		}
+	}
+}
+
+
+static void PixelFormat_Benchmark1 ()
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	std::mt19937	gen{ 42 };
+	const uint2		dim { 1024, 1024 };
+
+	const auto	MPixPerSec = [dim] (Clock_t::duration dt)
+	{
+		const double	sec = std::chrono::duration_cast<std::chrono::duration<double>>( dt ).count();
+		return ToString( double(dim.x) * dim.y / Max( sec, 1.0e-9 ) / 1.0e6, 1 ) + " Mpix/s";
+	};
+
+	for (auto& info : s_BulkFormats)
+	{
+		const size_t	row_pitch	= dim.x * info.bytesPerPixel;
+		Array<uint8_t>	data;
+		GenPixels( info, dim.x * dim.y, INOUT gen, OUT data );
+
+		const ArrayView<uint8_t>	parts[] = { data };
+		const ImageView				view	{ parts, uint3{dim, 1}, BytesU{row_pitch}, BytesU{row_pitch * dim.y}, info.format, info.aspect };
+		Array<RGBA32f>				pixels	( dim.x * dim.y );
+
+		// per-pixel
+		auto	start = Clock_t::now();
+		for (uint y = 0; y < dim.y; ++y)
+		for (uint x = 0; x < dim.x; ++x)
+		{
+			view.Load( uint3{x, y, 0}, OUT pixels[x + y * dim.x] );
+		}
+		const auto	per_pixel = Clock_t::now() - start;
+
+		// scalar rows
+		const auto	scalar = GetPixelRowKernels( info.format, info.aspect, false );
+		start = Clock_t::now();
+		for (uint y = 0; y < dim.y; ++y) {
+			scalar.load( view.GetRow( y ).data(), dim.x, OUT pixels.data() + y * dim.x );
+		}
+		const auto	scalar_rows = Clock_t::now() - start;
+
+		// SIMD rows
+		start = Clock_t::now();
+		TEST( view.LoadRows( 0, dim.y, OUT pixels ));
+		const auto	simd_rows = Clock_t::now() - start;
+
+		// store
+		start = Clock_t::now();
+		TEST( ImageView::StoreRows( info.format, info.aspect, dim, pixels, BytesU{row_pitch}, OUT data.data(), ArraySizeOf(data) ));
+		const auto	store_rows = Clock_t::now() - start;
+
+		FG_LOGI( "PixelFormat "s << ToString( info.format ) << ": Load: " << MPixPerSec( per_pixel ) << ", LoadRows (scalar): " << MPixPerSec( scalar_rows )
+				 << ", LoadRows: " << MPixPerSec( simd_rows ) << ", StoreRows: " << MPixPerSec( store_rows ));
+	}
+}
+
+
 extern void UnitTest_PixelFormat ()
 {
 	PixelFormat_Test1();
+	PixelFormat_Test2();
+	PixelFormat_Test3();
+	PixelFormat_Benchmark1();
 	FG_LOGI( "UnitTest_PixelFormat - passed" );
 }
@@ -5,6 +5,7 @@
 #include "framegraph/Public/FrameGraph.h"
 #include "UnitTest_Common.h"
 #include "DummyTask.h"
+#include "stl/Algorithms/StringUtils.h"
 
 
 namespace FG
@@ -55,6 +56,7 @@ static void VImage_Test1 ()
 	const auto			tasks		= GenDummyTasks( 30 );
 	auto				task_iter	= tasks.begin();
 
+	LinearAllocator<>	allocator;
 	VImage				global_image;
 	VLocalImage			local_image;
 	VLocalImage const*	img			= &local_image;
@@ -64,7 +66,7 @@ static void VImage_Test1 ()
 											 EImageUsage::ColorAttachment | EImageUsage::Transfer | EImageUsage::Storage | EImageUsage::Sampled,
 											 0_layer, 11_mipmap } ));
 
-	TEST( local_image.Create( &global_image ));
+	TEST( local_image.Create( &global_image, allocator ));
 
 	
 	// pass 1
@@ -116,6 +118,7 @@ static void VImage_Test2 ()
 	const auto			tasks		= GenDummyTasks( 30 );
 	auto				task_iter	= tasks.begin();
 	
+	LinearAllocator<>	allocator;
 	VImage				global_image;
 	VLocalImage			local_image;
 	VLocalImage const*	img			= &local_image;
@@ -125,7 +128,7 @@ static void VImage_Test2 ()
 											 EImageUsage::ColorAttachment | EImageUsage::Transfer | EImageUsage::Storage | EImageUsage::Sampled,
 											 8_layer, 11_mipmap } ));
 
-	TEST( local_image.Create( &global_image ));
+	TEST( local_image.Create( &global_image, allocator ));
 
 	// pass 1
 	{
@@ -255,9 +258,80 @@ static void VImage_Test2 ()
 }
 
 
+static void VImage_Benchmark1 ()
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	const uint			pass_count	= 200;
+	const auto			tasks		= GenDummyTasks( pass_count );
+
+	for (uint range_count : {1u, 16u, 2048u})
+	{
+		VBarrierManager		barrier_mngr;
+		LinearAllocator<>	allocator;
+		VImage				global_image;
+		VLocalImage			local_image;
+		VLocalImage const*	img			= &local_image;
+
+		// 256 layers * 8 mipmaps = 2048 subresources
+		TEST( VImageUnitTest::Create( global_image,
+									  ImageDesc{ EImage::Tex2DArray, uint3(64, 64, 0), EPixelFormat::RGBA8_UNorm,
+												 EImageUsage::Transfer | EImageUsage::Sampled,
+												 256_layer, 8_mipmap } ));
+
+		TEST( local_image.Create( &global_image, allocator ));
+
+		const uint	layer_groups	= range_count / img->MipmapLevels();
+		const uint	layers_per_group= layer_groups ? img->ArrayLayers() / layer_groups : 0;
+
+		Clock_t::duration	add_time	{0};
+		Clock_t::duration	commit_time	{0};
+
+		for (uint pass = 0; pass < pass_count; ++pass)
+		{
+			const bool		is_write	= (pass & 1) == 0;
+			const auto		state		= is_write ? EResourceState::TransferDst : EResourceState::ShaderSample | EResourceState::_FragmentShader;
+			const auto		layout		= is_write ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			VTask			task		= tasks[pass].get();
+			auto			start		= Clock_t::now();
+
+			if ( range_count == 1 )
+			{
+				img->AddPendingState( ImageState{ state, layout, ImageRange{ 0_layer, img->ArrayLayers(), 0_mipmap, img->MipmapLevels() },
+												  VK_IMAGE_ASPECT_COLOR_BIT, task });
+			}
+			else
+			for (uint mip = 0; mip < img->MipmapLevels(); ++mip)
+			for (uint group = 0; group < layer_groups; ++group)
+			{
+				img->AddPendingState( ImageState{ state, layout, ImageRange{ ImageLayer{group * layers_per_group}, layers_per_group, MipmapLevel{mip}, 1 },
+												  VK_IMAGE_ASPECT_COLOR_BIT, task });
+			}
+
+			add_time += Clock_t::now() - start;
+			start	  = Clock_t::now();
+
+			img->CommitBarrier( barrier_mngr, null );
+
+			commit_time += Clock_t::now() - start;
+			barrier_mngr.ClearBarriers();
+		}
+
+		TEST( VImageUnitTest::GetRWBarriers( img ).size() == range_count );
+
+		local_image.ResetState( ExeOrderIndex::Final, barrier_mngr, null );
+		local_image.Destroy();
+
+		FG_LOGI( "VLocalImage sub-ranges: "s << ToString( range_count ) << ", passes: " << ToString( pass_count )
+				 << ", AddPendingState: " << ToString( add_time ) << ", CommitBarrier: " << ToString( commit_time ));
+	}
+}
+
+
 extern void UnitTest_VImage ()
 {
 	VImage_Test1();
 	VImage_Test2();
+	VImage_Benchmark1();
 	FG_LOGI( "UnitTest_VImage - passed" );
 }
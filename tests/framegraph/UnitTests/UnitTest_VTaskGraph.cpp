@@ -0,0 +1,243 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VTaskGraph.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "UnitTest_Common.h"
+#include "DummyTask.h"
+
+namespace
+{
+	using TaskGraph_t	= VTaskGraph< VFgDummyTask >;
+	using Tasks_t		= Array< UniquePtr< VFgDummyTask >>;
+	using Clock_t		= std::chrono::high_resolution_clock;
+
+	static constexpr uint	MaxDeps = FG_MaxTaskDependencies;
+
+
+	struct TaskGraphInfo
+	{
+		Tasks_t			tasks;
+		Array<VTask>	entries;
+		size_t			edgeCount	= 0;
+	};
+
+
+	static void  Link (TaskGraphInfo &info, size_t input, size_t output)
+	{
+		info.tasks[output]->AddInput( info.tasks[input].get() );
+		++info.edgeCount;
+	}
+
+	static void  FindEntries (TaskGraphInfo &info)
+	{
+		for (auto& task : info.tasks) {
+			if ( task->Inputs().empty() )
+				info.entries.push_back( task.get() );
+		}
+	}
+
+	// task[i] depends on task[i-1]
+	static TaskGraphInfo  GenChain (size_t count)
+	{
+		TaskGraphInfo	info;
+		info.tasks = GenDummyTasks( count );
+
+		for (size_t i = 1; i < count; ++i) {
+			Link( info, i-1, i );
+		}
+		FindEntries( info );
+		return info;
+	}
+
+	// tree where each node has 'MaxDeps' outputs followed by reversed tree where each node has 'MaxDeps' inputs
+	static TaskGraphInfo  GenFan (size_t count)
+	{
+		TaskGraphInfo	info;
+		const size_t	half = count / 2;
+		info.tasks = GenDummyTasks( half * 2 );
+
+		for (size_t i = 1; i < half; ++i) {
+			Link( info, (i-1) / MaxDeps, i );
+		}
+		for (size_t i = 1; i < half; ++i) {
+			Link( info, half*2 - 1 - i, half*2 - 1 - (i-1) / MaxDeps );
+		}
+
+		// connect leafs of the first tree with leafs of the second tree
+		for (size_t i = 0; i < half; ++i)
+		{
+			if ( info.tasks[i]->Outputs().empty() )
+				Link( info, i, half*2 - 1 - i );
+		}
+		FindEntries( info );
+		return info;
+	}
+
+	// sequence of diamonds: top -> (left, right) -> bottom, bottom is the top of the next diamond
+	static TaskGraphInfo  GenDiamonds (size_t count)
+	{
+		TaskGraphInfo	info;
+		const size_t	diamonds = Max( (count - 1) / 3, size_t(1) );
+		info.tasks = GenDummyTasks( diamonds * 3 + 1 );
+
+		for (size_t i = 0; i < diamonds; ++i)
+		{
+			const size_t	top		= i * 3;
+			const size_t	left	= top + 1;
+			const size_t	right	= top + 2;
+			const size_t	bottom	= top + 3;
+
+			Link( info, top, left );
+			Link( info, top, right );
+			Link( info, left, bottom );
+			Link( info, right, bottom );
+		}
+		FindEntries( info );
+		return info;
+	}
+
+
+	static bool  Traverse (const TaskGraphInfo &info, LinearAllocator<> &alloc, OUT Array<uint> &order)
+	{
+		const size_t	first	= size_t(ExeOrderIndex::First);
+		uint			counter	= 0;
+
+		order.clear();
+		order.resize( info.tasks.size(), UMax );
+
+		const size_t	visited = TaskGraph_t::Traverse( info.entries, info.edgeCount, alloc,
+									[&] (VTask task)
+									{
+										const size_t	idx = size_t(task->ExecutionOrder()) - first;
+										
+										// task must be visited once
+										TEST( order[idx] == UMax );
+										order[idx] = counter++;
+									});
+
+		return visited == info.tasks.size();
+	}
+
+
+	static void  CheckOrder (const TaskGraphInfo &info, const Array<uint> &order)
+	{
+		const size_t	first = size_t(ExeOrderIndex::First);
+
+		for (size_t i = 0; i < info.tasks.size(); ++i)
+		{
+			auto&	task = info.tasks[i];
+
+			TEST( order[i] != UMax );
+			TEST( task->PendingInputs() == 0 );
+
+			// all inputs must be processed before the task
+			for (auto in_node : task->Inputs())
+			{
+				const size_t	in_idx = size_t(in_node->ExecutionOrder()) - first;
+				TEST( order[in_idx] < order[i] );
+			}
+		}
+	}
+}
+
+
+static void TaskGraph_Test1 ()
+{
+	LinearAllocator<>	alloc;
+	Array<uint>			order;
+
+	for (size_t count : {1, 2, 10, 1000})
+	{
+		auto	chain = GenChain( count );
+		TEST( Traverse( chain, alloc, OUT order ));
+		CheckOrder( chain, order );
+
+		// chain must be visited in the same order
+		for (size_t i = 0; i < count; ++i) {
+			TEST( order[i] == i );
+		}
+		alloc.Discard();
+	}
+}
+
+
+static void TaskGraph_Test2 ()
+{
+	LinearAllocator<>	alloc;
+	Array<uint>			order;
+
+	for (size_t count : {2, 10, 1000})
+	{
+		auto	fan = GenFan( count );
+		TEST( Traverse( fan, alloc, OUT order ));
+		CheckOrder( fan, order );
+		alloc.Discard();
+
+		auto	diamonds = GenDiamonds( count );
+		TEST( Traverse( diamonds, alloc, OUT order ));
+		CheckOrder( diamonds, order );
+		alloc.Discard();
+	}
+}
+
+
+static void TaskGraph_Test3 ()
+{
+	LinearAllocator<>	alloc;
+	Array<uint>			order;
+
+	// A -> C, B -> C, A -> D
+	TaskGraphInfo	info;
+	info.tasks = GenDummyTasks( 4 );
+	Link( info, 0, 2 );
+	Link( info, 1, 2 );
+	Link( info, 0, 3 );
+	FindEntries( info );
+
+	TEST( info.entries.size() == 2 );
+	TEST( Traverse( info, alloc, OUT order ));
+	CheckOrder( info, order );
+
+	// tasks are visited in discovery order
+	TEST( order[0] == 0 );
+	TEST( order[1] == 1 );
+	TEST( order[2] == 2 );
+	TEST( order[3] == 3 );
+}
+
+
+static void TaskGraph_Benchmark1 ()
+{
+	LinearAllocator<>	alloc;
+	Array<uint>			order;
+
+	alloc.SetBlockSize( 16_Mb );
+
+	const auto	Measure = [&] (StringView name, const TaskGraphInfo &info)
+	{
+		const auto	start = Clock_t::now();
+		TEST( Traverse( info, alloc, OUT order ));
+		const auto	dt = Clock_t::now() - start;
+
+		alloc.Discard();
+		FG_LOGI( "TaskGraph traverse "s << name << ", tasks: " << ToString( info.tasks.size() ) << ", time: " << ToString( dt ));
+	};
+
+	for (size_t count : {10'000, 100'000})
+	{
+		Measure( "chain", GenChain( count ));
+		Measure( "fan", GenFan( count ));
+		Measure( "diamonds", GenDiamonds( count ));
+	}
+}
+
+
+extern void UnitTest_VTaskGraph ()
+{
+	TaskGraph_Test1();
+	TaskGraph_Test2();
+	TaskGraph_Test3();
+	TaskGraph_Benchmark1();
+
+	FG_LOGI( "UnitTest_VTaskGraph - passed" );
+}
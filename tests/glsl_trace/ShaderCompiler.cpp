@@ -224,3 +224,16 @@ bool ShaderCompiler::GetDebugOutput (VkShaderModule shaderModule, const void *pt
 	return iter->second->ParseShaderTrace( ptr, uint64_t(maxSize), OUT result );
 }
 
+/*
+=================================================
+	GetShaderTrace
+=================================================
+*/
+ShaderTrace const*  ShaderCompiler::GetShaderTrace (VkShaderModule shaderModule) const
+{
+	auto	iter = _debuggableShaders.find( shaderModule );
+	CHECK_ERR( iter != _debuggableShaders.end() );
+
+	return iter->second;
+}
+
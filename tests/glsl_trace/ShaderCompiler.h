@@ -46,6 +46,8 @@ public:
 
 	bool GetDebugOutput (VkShaderModule shaderModule, const void *ptr, BytesU maxSize, OUT Array<FGC::String> &result) const;
 
+	ShaderTrace const*  GetShaderTrace (VkShaderModule shaderModule) const;
+
 
 private:
 	bool _Compile (OUT Array<uint>&			spirvData,
@@ -5,6 +5,7 @@
 #include "stl/Algorithms/StringUtils.h"
 #include "stl/Algorithms/StringParser.h"
 #include "stl/Stream/FileStream.h"
+#include <chrono>
 
 // Warning:
 // Before testing on new GPU set 'UpdateReferences' to 'true', run tests,
@@ -13,6 +14,12 @@
 // All tests must pass.
 static const bool	UpdateReferences = false;
 
+// Set 'BenchmarkParsing' to 'true' to measure parsing of debug output that is scaled up by 'BenchmarkScale'.
+// Tests always check parsing of slightly scaled up output.
+static const bool	BenchmarkParsing = false;
+static const uint	BenchmarkScale	 = 256;
+static const uint	TestScale		 = 4;
+
 /*
 =================================================
 	CreateDebugDescSetLayout
@@ -918,6 +925,124 @@ bool CreateRayTracingScene (VulkanDeviceExt &vulkan, const TestHelpers &helper,
 	return true;
 }
 
+/*
+=================================================
+	ScaleDebugOutput
+----
+	creates debug output with 'scale' copies of each invocation,
+	records of all invocations are interleaved as in the real trace
+=================================================
+*/
+static bool ScaleDebugOutput (const ShaderTrace &trace, const ShaderTrace::InvocationTraces_t &invocations, uint scale, OUT Array<uint> &result)
+{
+	const size_t	header		= size_t(trace.GetDataOffset() / sizeof(uint));
+	size_t			max_records	= 0;
+	Array<uint>		last_pos;
+
+	for (auto& inv : invocations) {
+		max_records = Max( max_records, inv.records.size() );
+	}
+	last_pos.resize( invocations.size() * scale, trace.GetInitialPosition() );
+
+	result.clear();
+	result.resize( header, 0 );
+
+	for (size_t r = 0; r < max_records; ++r)
+	for (size_t i = 0; i < last_pos.size(); ++i)
+	{
+		auto&	inv = invocations[ i % invocations.size() ];
+		if ( r >= inv.records.size() )
+			continue;
+
+		auto&		rec	= inv.records[r];
+		const uint	pos	= uint(result.size() - header);
+
+		result.push_back( last_pos[i] );
+		result.push_back( rec.exprID );
+		result.push_back( rec.type );
+		result.insert( result.end(), inv.values.begin() + rec.valueOffset, inv.values.begin() + rec.valueOffset + rec.valueCount );
+
+		last_pos[i] = pos;
+	}
+
+	CHECK_ERR( result.size() - header <= std::numeric_limits<uint>::max() );
+	result[ size_t(trace.GetPositionOffset() / sizeof(uint)) ] = uint(result.size() - header);
+	return true;
+}
+
+/*
+=================================================
+	CheckScaledDebugTraceOutput
+----
+	parses scaled up debug output, result must be the same as for the original output
+=================================================
+*/
+static bool CheckScaledDebugTraceOutput (const TestHelpers &helper, ArrayView<VkShaderModule> modules, uint scale, bool printTime)
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	for (auto& module : modules)
+	{
+		auto*	trace = helper.compiler.GetShaderTrace( module );
+		CHECK_ERR( trace );
+
+		Array<String>						ref_output;
+		ShaderTrace::InvocationTraces_t		invocations;
+		CHECK_ERR( trace->ParseShaderTrace( helper.readBackPtr, uint64_t(helper.debugOutputSize), OUT ref_output ));
+		CHECK_ERR( trace->ParseShaderTrace( helper.readBackPtr, uint64_t(helper.debugOutputSize), OUT invocations ));
+		CHECK_ERR( ref_output.size() == invocations.size() );
+
+		if ( invocations.empty() )
+			continue;
+
+		Array<uint>		data;
+		CHECK_ERR( ScaleDebugOutput( *trace, invocations, scale, OUT data ));
+
+		Array<String>						output;
+		Array<String>						mt_output;
+		ShaderTrace::InvocationTraces_t		mt_invocations;
+
+		const auto	t0 = Clock_t::now();
+		CHECK_ERR( trace->ParseShaderTrace( data.data(), uint64_t(ArraySizeOf(data)), OUT output, 1 ));
+
+		const auto	t1 = Clock_t::now();
+		CHECK_ERR( trace->ParseShaderTrace( data.data(), uint64_t(ArraySizeOf(data)), OUT mt_output, 0 ));
+
+		const auto	t2 = Clock_t::now();
+		CHECK_ERR( trace->ParseShaderTrace( data.data(), uint64_t(ArraySizeOf(data)), OUT mt_invocations, 0 ));
+
+		const auto	t3 = Clock_t::now();
+
+		CHECK_ERR( output == mt_output );
+		CHECK_ERR( output.size() == ref_output.size() * scale );
+		CHECK_ERR( mt_invocations.size() == invocations.size() * scale );
+
+		for (size_t i = 0; i < output.size(); ++i)
+		{
+			auto&	src = invocations[ i % invocations.size() ];
+			auto&	dst = mt_invocations[i];
+
+			CHECK_ERR( output[i] == ref_output[ i % ref_output.size() ]);
+			CHECK_ERR( dst.values == src.values );
+			CHECK_ERR( dst.records.size() == src.records.size() );
+
+			for (size_t r = 0; r < dst.records.size(); ++r)
+			{
+				CHECK_ERR( dst.records[r].exprID == src.records[r].exprID );
+				CHECK_ERR( dst.records[r].type == src.records[r].type );
+			}
+		}
+
+		if ( printTime )
+		{
+			FG_LOGI( "ParseShaderTrace: "s << ToString( output.size() ) << " invocations, " << ToString( ArraySizeOf(data) )
+					 << ", string: " << ToString( t1 - t0 ) << ", string (MT): " << ToString( t2 - t1 )
+					 << ", structured (MT): " << ToString( t3 - t2 ));
+		}
+	}
+	return true;
+}
+
 /*
 =================================================
 	TestDebugTraceOutput
@@ -959,6 +1084,11 @@ bool TestDebugTraceOutput (const TestHelpers &helper, ArrayView<VkShaderModule>
 	}
 
 	CHECK_ERR( file_data == merged );
+	CHECK_ERR( CheckScaledDebugTraceOutput( helper, modules, TestScale, false ));
+
+	if ( BenchmarkParsing )
+		CHECK_ERR( CheckScaledDebugTraceOutput( helper, modules, BenchmarkScale, true ));
+
 	return true;
 }
 
@@ -0,0 +1,200 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Utils.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "stl/Stream/FileStream.h"
+#include <chrono>
+
+#ifdef FG_STD_FILESYSTEM
+#	include <filesystem>
+	namespace FS = std::filesystem;
+
+static void CreatePipeline (uint variant, OUT GraphicsPipelineDesc &ppln)
+{
+	const String	header = "#define VARIANT "s << ToString( variant ) << "\n";
+
+	ppln = GraphicsPipelineDesc{};
+	ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", header + R"#(
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_GOOGLE_include_directive : require
+#include "cache_test_common.glsl"
+
+layout(location=0) in  vec3	at_Position;
+layout(location=1) in  vec2	at_Texcoord;
+
+layout(location=0) out vec2	v_Texcoord;
+
+layout(push_constant, std140) uniform PC {
+	vec4	offset;
+} pc;
+
+void main() {
+	gl_Position	= vec4( at_Position, 1.0 ) * ub.scale + pc.offset + float(VARIANT);
+	v_Texcoord	= at_Texcoord;
+}
+)#" );
+
+	ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", header + R"#(
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_GOOGLE_include_directive : require
+#include "cache_test_common.glsl"
+
+layout(binding=1) uniform sampler2D  un_ColorTexture;
+
+layout(location=0) in  vec2	v_Texcoord;
+
+layout(location=0) out vec4	out_Color;
+layout(location=1) out uint	out_Index;
+
+void main() {
+	out_Color = texture( un_ColorTexture, v_Texcoord ) * ub.scale;
+	out_Index = uint(VARIANT);
+}
+)#" );
+}
+
+
+static void WriteHeader (const FS::path &path, StringView source)
+{
+	FileWStream		file{ path };
+	TEST( file.IsOpen() );
+	TEST( file.Write( source ));
+}
+
+
+extern void Test_Shader18 (VPipelineCompiler*)
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	const uint		variant_count	= 16;
+	const FS::path	folder			= FS::temp_directory_path() / "fg_shader_cache_test";
+	const FS::path	cache_dir		= folder / "cache";
+
+	FS::remove_all( folder );
+	TEST( FS::create_directories( folder ));
+
+	WriteHeader( folder / "cache_test_common.glsl", R"#(
+layout(binding=0, std140) uniform UB {
+	vec4	scale;
+} ub;
+)#" );
+
+	Array<GraphicsPipelineDesc>	cold_pplns;
+	Clock_t::duration			cold_time;
+	Clock_t::duration			warm_time;
+
+	// cold cache
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+		compiler.AddDirectory( folder.string() );
+		TEST( compiler.SetCacheDirectory( cache_dir.string() ));
+
+		const auto	start = Clock_t::now();
+
+		for (uint i = 0; i < variant_count; ++i)
+		{
+			CreatePipeline( i, OUT cold_pplns.emplace_back() );
+			TEST( compiler.Compile( INOUT cold_pplns.back(), EShaderLangFormat::SPIRV_100 ));
+		}
+		cold_time = Clock_t::now() - start;
+
+		auto	stat = compiler.GetCacheStatistics();
+		TEST( stat.hits == 0 );
+		TEST( stat.misses == variant_count * 2 );
+	}
+
+	// warm cache
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+		compiler.AddDirectory( folder.string() );
+		TEST( compiler.SetCacheDirectory( cache_dir.string() ));
+
+		const auto	start = Clock_t::now();
+
+		for (uint i = 0; i < variant_count; ++i)
+		{
+			GraphicsPipelineDesc	ppln;
+			CreatePipeline( i, OUT ppln );
+			TEST( compiler.Compile( INOUT ppln, EShaderLangFormat::SPIRV_100 ));
+
+			TEST( EqualPipelines( cold_pplns[i], ppln ));
+		}
+		warm_time = Clock_t::now() - start;
+
+		auto	stat = compiler.GetCacheStatistics();
+		TEST( stat.hits == variant_count * 2 );
+		TEST( stat.misses == 0 );
+	}
+
+	// prewarmed cache without disk access
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+		compiler.AddDirectory( folder.string() );
+		TEST( compiler.PrewarmCache( cache_dir.string() ));
+
+		GraphicsPipelineDesc	ppln;
+		CreatePipeline( 0, OUT ppln );
+		TEST( compiler.Compile( INOUT ppln, EShaderLangFormat::SPIRV_100 ));
+
+		TEST( EqualPipelines( cold_pplns[0], ppln ));
+		TEST( compiler.GetCacheStatistics().hits == 2 );
+	}
+
+	// changes in included file must invalidate cache entry
+	{
+		WriteHeader( folder / "cache_test_common.glsl", R"#(
+layout(binding=0, std140) uniform UB {
+	vec4	bias;
+	vec4	scale;
+} ub;
+)#" );
+
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+		compiler.AddDirectory( folder.string() );
+		TEST( compiler.SetCacheDirectory( cache_dir.string() ));
+
+		GraphicsPipelineDesc	ppln;
+		CreatePipeline( 0, OUT ppln );
+		TEST( compiler.Compile( INOUT ppln, EShaderLangFormat::SPIRV_100 ));
+
+		auto	stat = compiler.GetCacheStatistics();
+		TEST( stat.hits == 0 );
+		TEST( stat.misses == 2 );
+
+		auto	ds = FindDescriptorSet( ppln, DescriptorSetID("0") );
+		TEST( ds );
+		TEST( TestUniformBuffer( *ds, UniformID("UB"), 32_b, 0, EShaderStages::Vertex | EShaderStages::Fragment ));
+	}
+
+	// eviction
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+		compiler.AddDirectory( folder.string() );
+		TEST( compiler.SetCacheDirectory( cache_dir.string(), 1_b ));
+
+		TEST( compiler.GetCacheStatistics().evicted > 0 );
+		TEST( FS::is_empty( cache_dir ));
+	}
+
+	FS::remove_all( folder );
+
+	FG_LOGI( "Shader compilation: cold "s << ToString( cold_time ) << ", warm " << ToString( warm_time )
+			 << ", variants: " << ToString( variant_count * 2 ));
+	FG_LOGI( "Test_Shader18 - passed" );
+}
+
+#else
+
+extern void Test_Shader18 (VPipelineCompiler*)
+{
+	FG_LOGI( "Test_Shader18 - skipped, requires std::filesystem" );
+}
+
+#endif	// FG_STD_FILESYSTEM
@@ -0,0 +1,167 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Utils.h"
+#include "stl/Algorithms/StringUtils.h"
+#include <chrono>
+#include <thread>
+
+
+static void CreateGraphicsPipeline (uint variant, OUT GraphicsPipelineDesc &ppln)
+{
+	const String	header = "#define VARIANT "s << ToString( variant ) << "\n";
+
+	ppln = GraphicsPipelineDesc{};
+	ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", header + R"#(
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) in  vec3	at_Position;
+layout(location=1) in  vec2	at_Texcoord;
+layout(location=2) in  vec4	at_Color;
+
+layout(location=0) out vec2	v_Texcoord;
+layout(location=1) out vec4	v_Color;
+
+layout(binding=0, std140) uniform UB {
+	mat4	mvp;
+	vec4	params[VARIANT + 1];
+} ub;
+
+void main() {
+	vec4	pos = vec4( at_Position, 1.0 );
+	for (int i = 0; i <= VARIANT; ++i) {
+		pos += ub.params[i] * float(i);
+	}
+	gl_Position	= ub.mvp * pos;
+	v_Texcoord	= at_Texcoord;
+	v_Color		= at_Color;
+}
+)#" );
+
+	ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", header + R"#(
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(binding=1) uniform sampler2D  un_ColorTexture;
+layout(binding=2) uniform sampler2D  un_NormalTexture;
+
+layout(location=0) in  vec2	v_Texcoord;
+layout(location=1) in  vec4	v_Color;
+
+layout(location=0) out vec4	out_Color;
+
+vec4 Blur (sampler2D tex, vec2 uv)
+{
+	vec4	sum = vec4(0.0);
+	for (int y = -VARIANT; y <= VARIANT; ++y)
+	for (int x = -VARIANT; x <= VARIANT; ++x) {
+		sum += textureOffset( tex, uv, ivec2(x, y) );
+	}
+	return sum / float((2*VARIANT+1) * (2*VARIANT+1));
+}
+
+void main() {
+	vec3	n = normalize( texture( un_NormalTexture, v_Texcoord ).xyz * 2.0 - 1.0 );
+	out_Color = Blur( un_ColorTexture, v_Texcoord ) * v_Color * max( 0.0, dot( n, vec3(0.0, 0.0, 1.0) ));
+}
+)#" );
+}
+
+
+static void CreateComputePipeline (uint variant, OUT ComputePipelineDesc &ppln)
+{
+	const String	header = "#define VARIANT "s << ToString( variant ) << "\n";
+
+	ppln = ComputePipelineDesc{};
+	ppln.AddShader( EShaderLangFormat::VKSL_100, "main", header + R"#(
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding=0, rgba8) writeonly uniform image2D  un_OutImage;
+
+layout(binding=1, std430) readonly buffer SSB {
+	vec4	weights[];
+} ssb;
+
+void main ()
+{
+	vec4	sum = vec4(0.0);
+	for (int i = 0; i <= VARIANT; ++i) {
+		sum += ssb.weights[ i + gl_GlobalInvocationID.x ] * float(i);
+	}
+	imageStore( un_OutImage, ivec2(gl_GlobalInvocationID.xy), sum );
+}
+)#" );
+}
+
+
+extern void Test_Shader19 (VPipelineCompiler*)
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	const uint	variant_count	= 32;
+	const uint	max_threads		= Max( 1u, std::thread::hardware_concurrency() );
+
+	// reference result
+	Array<GraphicsPipelineDesc>	ref_graphics;	ref_graphics.resize( variant_count );
+	Array<ComputePipelineDesc>	ref_compute;	ref_compute.resize( variant_count );
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+
+		for (uint i = 0; i < variant_count; ++i)
+		{
+			CreateGraphicsPipeline( i, OUT ref_graphics[i] );
+			CreateComputePipeline( i, OUT ref_compute[i] );
+
+			TEST( compiler.Compile( INOUT ref_graphics[i], EShaderLangFormat::SPIRV_100 ));
+			TEST( compiler.Compile( INOUT ref_compute[i], EShaderLangFormat::SPIRV_100 ));
+		}
+	}
+
+	Clock_t::duration	single_thread_time;
+
+	for (uint thread_count = 1;; thread_count = Min( thread_count * 2, max_threads ))
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::AutoMapLocations );
+
+		Array<GraphicsPipelineDesc>			graphics;	graphics.resize( variant_count );
+		Array<ComputePipelineDesc>			compute;	compute.resize( variant_count );
+		VPipelineCompiler::PipelineBatch	batch;
+
+		for (uint i = 0; i < variant_count; ++i)
+		{
+			CreateGraphicsPipeline( i, OUT graphics[i] );
+			CreateComputePipeline( i, OUT compute[i] );
+
+			batch.graphics.push_back( &graphics[i] );
+			batch.compute.push_back( &compute[i] );
+		}
+
+		const auto	start = Clock_t::now();
+
+		TEST( compiler.CompileBatch( batch, EShaderLangFormat::SPIRV_100, thread_count ));
+
+		const auto	dt = Clock_t::now() - start;
+
+		if ( thread_count == 1 )
+			single_thread_time = dt;
+
+		// result must not depend on thread count
+		for (uint i = 0; i < variant_count; ++i)
+		{
+			TEST( EqualPipelines( ref_graphics[i], graphics[i] ));
+			TEST( EqualPipelines( ref_compute[i], compute[i] ));
+		}
+
+		FG_LOGI( "Batch compilation of "s << ToString( variant_count * 2 ) << " pipelines, threads: " << ToString( thread_count )
+				 << ", time: " << ToString( dt ) << ", speedup: " << ToString( double(single_thread_time.count()) / Max( 1.0, double(dt.count()) ), 2 ));
+
+		if ( thread_count == max_threads )
+			break;
+	}
+
+	FG_LOGI( "Test_Shader19 - passed" );
+}
@@ -290,3 +290,99 @@ inline bool TestPushConstant (const PipelineDescription &desc, const PushConstan
 			iter->second.size		== uint16_t(size)	and
 			iter->second.stageFlags	== stageFlags;
 }
+
+/*
+=================================================
+	EqualShaders
+----
+	compares SPIRV binaries and specialization constants
+=================================================
+*/
+inline bool EqualShaders (const PipelineDescription::Shader &lhs, const PipelineDescription::Shader &rhs)
+{
+	using SpirvData = PipelineDescription::SharedShaderPtr< Array<uint> >;
+
+	if ( lhs.data.size() != rhs.data.size() or not (lhs.specConstants == rhs.specConstants) )
+		return false;
+
+	for (auto& data : lhs.data)
+	{
+		auto	iter = rhs.data.find( data.first );
+		if ( iter == rhs.data.end() )
+			return false;
+
+		auto*	lhs_spirv = UnionGetIf<SpirvData>( &data.second );
+		auto*	rhs_spirv = UnionGetIf<SpirvData>( &iter->second );
+
+		if ( not (lhs_spirv and rhs_spirv and (*lhs_spirv)->GetData() == (*rhs_spirv)->GetData()) )
+			return false;
+	}
+	return true;
+}
+
+/*
+=================================================
+	EqualLayouts
+=================================================
+*/
+inline bool EqualLayouts (const PipelineDescription::PipelineLayout &lhs, const PipelineDescription::PipelineLayout &rhs)
+{
+	if ( lhs.descriptorSets.size() != rhs.descriptorSets.size() or
+		 lhs.pushConstants.size() != rhs.pushConstants.size() )
+		return false;
+
+	for (size_t i = 0; i < lhs.descriptorSets.size(); ++i)
+	{
+		auto&	lhs_ds = lhs.descriptorSets[i];
+		auto&	rhs_ds = rhs.descriptorSets[i];
+
+		if ( not (lhs_ds.id == rhs_ds.id and lhs_ds.bindingIndex == rhs_ds.bindingIndex and *lhs_ds.uniforms == *rhs_ds.uniforms) )
+			return false;
+	}
+
+	for (auto& pc : lhs.pushConstants)
+	{
+		auto	iter = rhs.pushConstants.find( pc.first );
+		if ( iter == rhs.pushConstants.end() )
+			return false;
+
+		if ( not (pc.second.stageFlags == iter->second.stageFlags and
+				  pc.second.offset == iter->second.offset and
+				  pc.second.size == iter->second.size) )
+			return false;
+	}
+	return true;
+}
+
+/*
+=================================================
+	EqualPipelines
+=================================================
+*/
+inline bool EqualPipelines (const GraphicsPipelineDesc &lhs, const GraphicsPipelineDesc &rhs)
+{
+	if ( lhs._shaders.size() != rhs._shaders.size() )
+		return false;
+
+	for (auto& sh : lhs._shaders)
+	{
+		auto	iter = rhs._shaders.find( sh.first );
+		if ( iter == rhs._shaders.end() or not EqualShaders( sh.second, iter->second ))
+			return false;
+	}
+
+	return	EqualLayouts( lhs._pipelineLayout, rhs._pipelineLayout )	and
+			lhs._vertexAttribs		== rhs._vertexAttribs				and
+			lhs._fragmentOutput		== rhs._fragmentOutput				and
+			lhs._supportedTopology	== rhs._supportedTopology			and
+			lhs._patchControlPoints	== rhs._patchControlPoints			and
+			lhs._earlyFragmentTests	== rhs._earlyFragmentTests;
+}
+
+inline bool EqualPipelines (const ComputePipelineDesc &lhs, const ComputePipelineDesc &rhs)
+{
+	return	EqualShaders( lhs._shader, rhs._shader )					and
+			EqualLayouts( lhs._pipelineLayout, rhs._pipelineLayout )	and
+			All( lhs._defaultLocalGroupSize == rhs._defaultLocalGroupSize )	and
+			All( lhs._localSizeSpec == rhs._localSizeSpec );
+}
@@ -19,6 +19,8 @@ extern void Test_Shader14 (VPipelineCompiler* compiler);
 extern void Test_Shader15 (VPipelineCompiler* compiler);
 extern void Test_Shader16 (VPipelineCompiler* compiler);
 extern void Test_Shader17 (VPipelineCompiler* compiler);
+extern void Test_Shader18 (VPipelineCompiler* compiler);
+extern void Test_Shader19 (VPipelineCompiler* compiler);
 
 
 int main ()
@@ -43,6 +45,8 @@ int main ()
 	Test_Shader15( &compiler );
 	Test_Shader16( &compiler );
 	Test_Shader17( &compiler );
+	Test_Shader18( &compiler );
+	Test_Shader19( &compiler );
 
 	FG_LOGI( "Tests.PipelineCompiler finished" );
 	return 0;
@@ -0,0 +1,217 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Log/AsyncLogger.h"
+#include "UnitTest_Common.h"
+#include <mutex>
+#include <thread>
+
+
+static void AsyncLogger_Test1 ()
+{
+	// messages from each thread must be in order
+	std::mutex		guard;
+	Array<String>	messages;
+
+	AsyncLogger::Config	cfg;
+	cfg.bufferSize	= 1_Mb;
+	cfg.output		= [&] (StringView msg, StringView, int) { std::unique_lock lock{guard};  messages.push_back( String{msg} ); };
+	TEST( AsyncLogger::Start( cfg ));
+
+	static constexpr uint	thread_count	= 4;
+	static constexpr uint	msg_count		= 1000;
+	Array<std::thread>		threads;
+
+	for (uint t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back( [t] ()
+		{
+			for (uint i = 0; i < msg_count; ++i)
+			{
+				if ( i & 1 )
+					FG_LOGI_ASYNC( "{}:{}", t, i );
+				else
+					FG_LOGI( ToString( t ) << ':' << ToString( i ));
+			}
+		});
+	}
+	for (auto& t : threads) { t.join(); }
+
+	AsyncLogger::Flush();
+	AsyncLogger::Stop();
+
+	TEST( AsyncLogger::DroppedCount() == 0 );
+	TEST( messages.size() == thread_count * msg_count );
+
+	uint	next [thread_count] = {};
+	for (auto& msg : messages)
+	{
+		const size_t	pos = msg.find( ':' );
+		TEST( pos != String::npos );
+
+		const uint	t = uint(std::stoul( msg.substr( 0, pos )));
+		const uint	i = uint(std::stoul( msg.substr( pos+1 )));
+		TEST( t < thread_count );
+		TEST( i == next[t] );
+		++next[t];
+	}
+}
+
+
+static void AsyncLogger_Test2 ()
+{
+	// messages are dropped while drain thread is blocked
+	Atomic<uint>	received	{0};
+	Atomic<bool>	blocked		{false};
+	Atomic<bool>	unblock		{false};
+
+	AsyncLogger::Config	cfg;
+	cfg.bufferSize	= 4_Kb;
+	cfg.output		= [&] (StringView msg, StringView, int)
+					{
+						if ( StartsWith( msg, "AsyncLogger:" ))
+							return;
+
+						received.fetch_add( 1 );
+						blocked.store( true );
+						for (; not unblock.load();) { std::this_thread::yield(); }
+					};
+	TEST( AsyncLogger::Start( cfg ));
+
+	FG_LOGI_ASYNC( "first" );
+	for (; not blocked.load();) { std::this_thread::yield(); }
+
+	static constexpr uint	msg_count = 1000;
+	for (uint i = 0; i < msg_count; ++i) {
+		FG_LOGI_ASYNC( "message {}, value {}", i, float(i) * 0.5f );
+	}
+	unblock.store( true );
+
+	AsyncLogger::Stop();
+
+	TEST( AsyncLogger::DroppedCount() > 0 );
+	TEST( received.load() + AsyncLogger::DroppedCount() == msg_count + 1 );
+}
+
+
+namespace
+{
+	struct NoDefaultCtor
+	{
+		int		value;
+		explicit NoDefaultCtor (int v) : value{v} {}
+	};
+
+	ND_ String  ToString (const NoDefaultCtor &x)
+	{
+		return "["s << FGC::ToString( x.value ) << "]";
+	}
+}
+
+static void AsyncLogger_Test3 ()
+{
+	// lazy formatting
+	String	result;
+
+	AsyncLogger::Config	cfg;
+	cfg.output = [&result] (StringView msg, StringView, int) { result = msg; };
+	TEST( AsyncLogger::Start( cfg ));
+
+	FG_LOGI_ASYNC( "a={}, b={}, c={}", 1, true, uint2{2, 3} );
+	AsyncLogger::Flush();
+	TEST( result == "a=1, b=true, c=( 2, 3 )" );
+
+	FG_LOGI_ASYNC( "d={}", NoDefaultCtor{4} );
+	AsyncLogger::Stop();
+
+	TEST( result == "d=[4]" );
+}
+
+
+static void AsyncLogger_Benchmark1 ()
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	static constexpr uint	msg_count	= 100'000;
+	Atomic<uint64_t>		received	{0};
+
+	struct Result
+	{
+		double		producerRate;	// enqueued and dropped messages
+		double		deliveredRate;	// messages written to output, measured until drain thread is stopped
+		uint64_t	delivered;
+		uint64_t	dropped;
+	};
+
+	const auto	Benchmark = [&received] (uint threadCount, bool lazy)
+	{
+		received.store( 0 );
+
+		AsyncLogger::Config	cfg;
+		cfg.bufferSize	= 1_Mb;
+		cfg.output		= [&received] (StringView msg, StringView, int)
+						{
+							if ( not StartsWith( msg, "AsyncLogger:" ))
+								received.fetch_add( 1, memory_order_relaxed );
+						};
+		TEST( AsyncLogger::Start( cfg ));
+
+		Array<std::thread>	threads;
+		const auto			start	= Clock_t::now();
+
+		for (uint t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back( [lazy] ()
+			{
+				for (uint i = 0; i < msg_count; ++i)
+				{
+					if ( lazy )
+						FG_LOGI_ASYNC( "message {}, value {}", i, float(i) * 0.5f );
+					else
+						FG_LOGI( "preformatted message text" );
+				}
+			});
+		}
+		for (auto& t : threads) { t.join(); }
+
+		const auto		produced	= Clock_t::now();
+
+		AsyncLogger::Stop();
+
+		const auto		ToSec		= [start] (Clock_t::time_point t) { return Max( std::chrono::duration_cast<std::chrono::duration<double>>( t - start ).count(), 1.0e-9 ); };
+		const double	total		= double(msg_count) * threadCount;
+
+		Result	res;
+		res.delivered		= received.load();
+		res.dropped			= AsyncLogger::DroppedCount();
+		res.producerRate	= total / ToSec( produced ) / 1.0e6;
+		res.deliveredRate	= double(res.delivered) / ToSec( Clock_t::now() ) / 1.0e6;
+
+		TEST( res.delivered + res.dropped == uint64_t(total) );
+		return res;
+	};
+
+	const auto	Print = [] (INOUT String &str, StringView name, const Result &res)
+	{
+		str << ", " << name << ": " << ToString( res.producerRate, 2 ) << " / " << ToString( res.deliveredRate, 2 )
+			<< " (dropped " << ToString( res.dropped ) << ")";
+	};
+
+	String	str = "AsyncLogger benchmark (produced / delivered, million messages per second):";
+	for (uint threads : {1u, 2u, 4u, 8u, 16u})
+	{
+		str << "\n  threads: " << ToString( threads );
+		Print( INOUT str, "text", Benchmark( threads, false ));
+		Print( INOUT str, "lazy", Benchmark( threads, true ));
+	}
+	FG_LOGI( str );
+}
+
+
+extern void UnitTest_AsyncLogger ()
+{
+	AsyncLogger_Test1();
+	AsyncLogger_Test2();
+	AsyncLogger_Test3();
+	AsyncLogger_Benchmark1();
+	FG_LOGI( "UnitTest_AsyncLogger - passed" );
+}
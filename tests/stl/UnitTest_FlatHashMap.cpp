@@ -0,0 +1,153 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Containers/FlatHashMap.h"
+#include "stl/Memory/LinearAllocator.h"
+#include "UnitTest_Common.h"
+#include <chrono>
+
+
+static void FlatHashMap_Test1 ()
+{
+	FlatHashMap< uint64_t, uint >	map;
+
+	for (uint i = 0; i < 100; ++i) {
+		TEST( map.insert({ i, i }).second );
+	}
+	TEST( map.size() == 100 );
+	TEST( not map.insert({ 5, 0 }).second );
+
+	auto	iter = map.find( 5 );	TEST( iter != map.end() );	TEST( iter->first == 5 );	TEST( iter->second == 5 );
+	iter = map.find( 99 );			TEST( iter != map.end() );	TEST( iter->second == 99 );
+	iter = map.find( 100 );			TEST( iter == map.end() );
+
+	map.insert({ 7, 0 }).first->second += 10;
+	TEST( map.find( 7 )->second == 17 );
+
+	size_t	count = 0;
+	for (auto[key, value] : map)
+	{
+		TEST( key < 100 );
+		++count;
+	}
+	TEST( count == 100 );
+}
+
+
+static void FlatHashMap_Test2 ()
+{
+	FlatHashMap< uint64_t, uint >	map;
+
+	map.reserve( 1000 );
+	const size_t	cap = map.capacity();
+	TEST( cap * 3 >= 1000 * 4 );
+
+	for (uint i = 0; i < 1000; ++i) {
+		map.insert({ uint64_t(i) << 32, i });
+	}
+	TEST( map.capacity() == cap );
+
+	// clear must keep memory
+	map.clear();
+	TEST( map.empty() );
+	TEST( map.capacity() == cap );
+	TEST( map.begin() == map.end() );
+	TEST( map.count( 1ull << 32 ) == 0 );
+
+	map.insert({ 1ull << 32, 1 });
+	TEST( map.size() == 1 );
+	TEST( map.count( 1ull << 32 ) == 1 );
+
+	map.release();
+	TEST( map.capacity() == 0 );
+	TEST( map.find( 1ull << 32 ) == map.end() );
+}
+
+
+static void FlatHashMap_Test3 ()
+{
+	using Allocator_t = UntypedLinearAllocator<>;
+
+	LinearAllocator<>	alloc;
+	alloc.SetBlockSize( 4_Kb );
+
+	FlatHashMap< uint64_t, uint, Allocator_t >	map{ alloc };
+
+	for (uint j = 0; j < 3; ++j)
+	{
+		for (uint i = 0; i < 10'000; ++i) {
+			map.insert({ i, i });
+		}
+		TEST( map.size() == 10'000 );
+
+		for (uint i = 0; i < 10'000; i += 7) {
+			TEST( map.find( i )->second == i );
+		}
+
+		map.release();
+		alloc.Discard();
+	}
+}
+
+
+static void FlatHashMap_Benchmark1 ()
+{
+	using Clock_t	= std::chrono::high_resolution_clock;
+	using Key_t		= uint64_t;
+
+	// same layout as resource ID in command batch: index, instance, type
+	const auto	MakeKey = [] (size_t i) -> Key_t
+	{
+		return Key_t(i & 0xFFFF) | (Key_t((i >> 16) + 1) << 16) | (Key_t(i % 17) << 48);
+	};
+
+	const auto	Measure = [&MakeKey] (auto &map, size_t count, StringView name)
+	{
+		const auto	start = Clock_t::now();
+		size_t		sum   = 0;
+
+		// first acquire inserts resource, then resource is found 3 times
+		for (uint j = 0; j < 4; ++j)
+		for (size_t i = 0; i < count; ++i)
+		{
+			sum += map.insert({ MakeKey( i ), 1 }).second;
+		}
+
+		const auto	dt = Clock_t::now() - start;
+
+		TEST( sum == count );
+		TEST( map.size() == count );
+		FG_LOGI( "Acquire "s << name << ", resources: " << ToString( count ) << ", time: " << ToString( dt ));
+	};
+
+	LinearAllocator<>	alloc;
+	alloc.SetBlockSize( 1_Mb );
+
+	for (size_t count : {1'000, 10'000, 100'000})
+	{
+		{
+			std::unordered_map< Key_t, uint >	map;
+			Measure( map, count, "unordered_map" );
+		}
+		{
+			FlatHashMap< Key_t, uint, UntypedLinearAllocator<> >	map{ alloc };
+			Measure( map, count, "FlatHashMap" );
+		}
+		{
+			FlatHashMap< Key_t, uint, UntypedLinearAllocator<> >	map{ alloc };
+			map.reserve( count );
+			Measure( map, count, "FlatHashMap (reserved)" );
+		}
+		alloc.Discard();
+	}
+}
+
+
+extern void UnitTest_FlatHashMap ()
+{
+	FlatHashMap_Test1();
+	FlatHashMap_Test2();
+	FlatHashMap_Test3();
+	FlatHashMap_Benchmark1();
+
+	FG_LOGI( "UnitTest_FlatHashMap - passed" );
+}
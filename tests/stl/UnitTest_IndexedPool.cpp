@@ -2,8 +2,13 @@
 
 #include "stl/Containers/ChunkedIndexedPool.h"
 #include "stl/Containers/CachedIndexedPool.h"
+#include "stl/ThreadSafe/LfCachedIndexedPool.h"
+#include "stl/Containers/SparseIndexMap.h"
 #include "stl/CompileTime/Math.h"
 #include "UnitTest_Common.h"
+#include <chrono>
+#include <thread>
+#include <shared_mutex>
 
 
 static void ChunkedIndexedPool_Test1 ()
@@ -84,12 +89,211 @@ static void CachedIndexedPool_Test1 ()
 }
 
 
+static void LfCachedIndexedPool_Test1 ()
+{
+	LfCachedIndexedPool<uint, uint, 16, 16>	pool;
+
+	uint	idx1, idx2;
+
+	TEST( pool.Assign( OUT idx1 ));
+	TEST( pool.Assign( OUT idx2 ));
+
+	TEST( pool.Insert( idx1, 2 ).second );
+	TEST( not pool.Insert( idx2, 2 ).second );
+	TEST( pool.Find( &pool[idx2] ) == idx1 );
+
+	TEST( not pool.RemoveFromCache( idx2 ));
+	TEST( pool.RemoveFromCache( idx1 ));
+	TEST( pool.Find( &pool[idx2] ) == UMax );
+	pool.Unassign( idx2 );
+	pool.Unassign( idx1 );
+}
+
+
+static void LfCachedIndexedPool_Test2 ()
+{
+	// fill whole pool, values with same hash are in the same probe sequence
+	constexpr uint							count = 16 * 16;
+	LfCachedIndexedPool<uint, uint, 16, 16>	pool;
+	const BytesU							initial_size = pool.DynamicSize();
+
+	for (uint i = 0; i < count; ++i)
+	{
+		uint	idx;
+		TEST( pool.Assign( OUT idx ));
+		TEST( pool.Insert( idx, (i & 1 ? i * 1024 : i) ).second );
+	}
+
+	// cache index grows with the number of values
+	TEST( pool.DynamicSize() > initial_size );
+
+	for (uint i = 0; i < count; ++i)
+	{
+		const uint	value = (i & 1 ? i * 1024 : i);
+		TEST( pool.Find( &value ) == i );
+	}
+
+	// remove every third value, other values must be reachable after backward shift
+	for (uint i = 0; i < count; i += 3) {
+		TEST( pool.RemoveFromCache( i ));
+	}
+
+	for (uint i = 0; i < count; ++i)
+	{
+		const uint	value = (i & 1 ? i * 1024 : i);
+		TEST( pool.Find( &value ) == (i % 3 ? i : UMax) );
+	}
+
+	for (uint i = 0; i < count; ++i)
+	{
+		if ( i % 3 )
+			TEST( pool.RemoveFromCache( i ));
+		pool.Unassign( i );
+	}
+	TEST( pool.empty() );
+}
+
+
+static void LfCachedIndexedPool_Benchmark1 ()
+{
+	using Clock_t	= std::chrono::high_resolution_clock;
+	using Value_t	= uint64_t;
+
+	// same as 'VResourceManager::CachedPoolTmpl'
+	constexpr uint	ChunkSize	= 1u << 9;
+	constexpr uint	MaxChunks	= 8;
+	constexpr uint	StableCount	= ChunkSize * 2;
+	constexpr uint	LookupCount	= 100'000;
+
+	const auto	Measure = [] (auto &pool, uint readerCount, StringView name)
+	{
+		uint	indices [StableCount];
+
+		for (uint i = 0; i < StableCount; ++i)
+		{
+			TEST( pool.Assign( OUT indices[i] ));
+			TEST( pool.Insert( indices[i], Value_t(i) * 7919 ).second );
+		}
+
+		std::atomic<bool>	stop		{false};
+		std::atomic<uint>	misses		{0};
+		Array<std::thread>	readers;
+
+		// writer adds and removes values which are never searched by readers
+		std::thread		writer{ [&pool, &stop] ()
+		{
+			uint	temp [ChunkSize];
+			for (uint j = 0; not stop.load( memory_order_relaxed ); ++j)
+			{
+				for (uint i = 0; i < CountOf(temp); ++i)
+				{
+					TEST( pool.Assign( OUT temp[i] ));
+					TEST( pool.Insert( temp[i], ~Value_t(i + j * ChunkSize) ).second );
+				}
+				for (uint i = 0; i < CountOf(temp); ++i)
+				{
+					pool.RemoveFromCache( temp[i] );
+					pool.Unassign( temp[i] );
+				}
+			}
+		}};
+
+		const auto	start = Clock_t::now();
+
+		for (uint t = 0; t < readerCount; ++t)
+		{
+			readers.emplace_back( [&pool, &misses, t] ()
+			{
+				uint	miss = 0;
+				for (uint i = 0; i < LookupCount; ++i)
+				{
+					const Value_t	value	= Value_t((i + t * 131) % StableCount) * 7919;
+					const uint		index	= pool.Find( &value );
+
+					if ( index == UMax )	++miss;
+					else					TEST( pool[index] == value );
+				}
+				misses.fetch_add( miss, memory_order_relaxed );
+			});
+		}
+
+		for (auto& t : readers) { t.join(); }
+
+		const auto	dt = Clock_t::now() - start;
+
+		stop.store( true, memory_order_relaxed );
+		writer.join();
+
+		for (uint i = 0; i < StableCount; ++i)
+		{
+			TEST( pool.RemoveFromCache( indices[i] ));
+			pool.Unassign( indices[i] );
+		}
+
+		FG_LOGI( "Find in "s << name << ", readers: " << ToString( readerCount ) << ", lookups: " << ToString( readerCount * LookupCount )
+				 << ", time: " << ToString( dt ) << ", misses: " << ToString( misses.load() ));
+	};
+
+	for (uint readers : {1, 2, 4, 8, 16})
+	{
+		{
+			CachedIndexedPool< Value_t, uint, ChunkSize, MaxChunks, UntypedAlignedAllocator, Mutex, std::shared_mutex, AtomicPtr >	pool;
+			Measure( pool, readers, "CachedIndexedPool" );
+		}
+		{
+			LfCachedIndexedPool< Value_t, uint, ChunkSize, MaxChunks, UntypedAlignedAllocator, Mutex, Mutex, AtomicPtr >	pool;
+			Measure( pool, readers, "LfCachedIndexedPool" );
+		}
+	}
+}
+
+
+static void SparseIndexMap_Test1 ()
+{
+	SparseIndexMap< uint16_t, uint16_t, 1u << 16, 256 >	map;
+	bool												inserted;
+
+	TEST( map.Find( 10 ) == null );
+	TEST( map.DynamicSize() == BytesU{sizeof(map)} );
+
+	TEST( map.Emplace( 10, 1, OUT inserted ) == 1 );		TEST( inserted );
+	TEST( map.Emplace( 40000, 2, OUT inserted ) == 2 );	TEST( inserted );
+	TEST( map.Emplace( 10, 3, OUT inserted ) == 1 );		TEST( not inserted );
+
+	TEST( map.Find( 10 ) and *map.Find( 10 ) == 1 );
+	TEST( map.Find( 40000 ) and *map.Find( 40000 ) == 2 );
+	TEST( map.Find( 11 ) == null );
+
+	// only two pages are allocated
+	const BytesU	size = map.DynamicSize();
+	TEST( size < BytesU{sizeof(map)} + 2 * 256 * 8 + 1 );
+
+	map.Erase( 40000 );
+	TEST( map.Find( 40000 ) == null );
+
+	// clear does not free pages
+	map.Clear();
+	TEST( map.Find( 10 ) == null );
+	TEST( map.DynamicSize() == size );
+
+	TEST( map.Emplace( 10, 4, OUT inserted ) == 4 );		TEST( inserted );
+	TEST( *map.Find( 10 ) == 4 );
+
+	map.Release();
+	TEST( map.Find( 10 ) == null );
+}
+
+
 extern void UnitTest_IndexedPool ()
 {
 	ChunkedIndexedPool_Test1();
 	ChunkedIndexedPool_Test2();
 	ChunkedIndexedPool_Test3();
 	CachedIndexedPool_Test1();
+	LfCachedIndexedPool_Test1();
+	LfCachedIndexedPool_Test2();
+	LfCachedIndexedPool_Benchmark1();
+	SparseIndexMap_Test1();
 
 	FG_LOGI( "UnitTest_IndexedPool - passed" );
 }
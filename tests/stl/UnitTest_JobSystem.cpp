@@ -0,0 +1,235 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/JobSystem.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "UnitTest_Common.h"
+#include <chrono>
+
+
+static void LfWorkStealingDeque_Test1 ()
+{
+	LfWorkStealingDeque<uint, 4>	deque;
+	uint							value;
+
+	TEST( deque.empty() );
+	TEST( not deque.Pop( OUT value ));
+	TEST( not deque.Steal( OUT value ));
+
+	TEST( deque.Push( 1 ));
+	TEST( deque.Push( 2 ));
+	TEST( deque.Push( 3 ));
+	TEST( deque.Push( 4 ));
+	TEST( not deque.Push( 5 ));
+	TEST( deque.size() == 4 );
+
+	TEST( deque.Steal( OUT value ) and value == 1 );
+	TEST( deque.Pop( OUT value ) and value == 4 );
+	TEST( deque.Push( 5 ));
+	TEST( deque.Pop( OUT value ) and value == 5 );
+	TEST( deque.Steal( OUT value ) and value == 2 );
+	TEST( deque.Pop( OUT value ) and value == 3 );
+	TEST( deque.empty() );
+	TEST( not deque.Pop( OUT value ));
+}
+
+
+static void LfWorkStealingDeque_Test2 ()
+{
+	constexpr uint					thief_count	= 3;
+	constexpr uint					value_count	= 100'000;
+	LfWorkStealingDeque<uint, 256>	deque;
+	Array<std::thread>				thieves;
+	Array<Atomic<uint>>				received	( value_count );
+	Atomic<bool>					done		{false};
+
+	for (auto& r : received) { r.store( 0, memory_order_relaxed ); }
+
+	for (uint t = 0; t < thief_count; ++t)
+	{
+		thieves.emplace_back( [&] ()
+		{
+			for (uint value; not done.load( memory_order_acquire );)
+			{
+				if ( deque.Steal( OUT value ))
+					received[ value ].fetch_add( 1, memory_order_relaxed );
+			}
+		});
+	}
+
+	// owner
+	for (uint i = 0; i < value_count;)
+	{
+		if ( deque.Push( i ))
+			++i;
+
+		uint	value;
+		if ( (i & 3) == 0 and deque.Pop( OUT value ))
+			received[ value ].fetch_add( 1, memory_order_relaxed );
+	}
+
+	for (uint value; not deque.empty();)
+	{
+		if ( deque.Pop( OUT value ))
+			received[ value ].fetch_add( 1, memory_order_relaxed );
+	}
+
+	done.store( true, memory_order_release );
+	for (auto& t : thieves) { t.join(); }
+
+	// each value must be received exactly once
+	for (auto& r : received) {
+		TEST( r.load( memory_order_relaxed ) == 1 );
+	}
+}
+
+
+static void JobSystem_Test1 ()
+{
+	JobSystem	js;
+	JobSystem::Config	cfg;
+	cfg.workerCount = 3;
+	TEST( js.Initialize( cfg ));
+	TEST( js.WorkerCount() == 3 );
+	TEST( not js.IsWorkerThread() );
+
+	// counters and dependencies
+	Atomic<uint>	stage1		{0};
+	Atomic<uint>	stage2		{0};
+	Atomic<bool>	failed		{false};
+	JobCounter		counter1;
+	JobCounter		counter2;
+
+	for (uint i = 0; i < 100; ++i)
+	{
+		js.Run( [&] () { stage1.fetch_add( 1, memory_order_relaxed ); }, &counter1 );
+	}
+
+	for (uint i = 0; i < 100; ++i)
+	{
+		js.Run( [&] ()
+				{
+					if ( stage1.load( memory_order_relaxed ) != 100 )
+						failed.store( true, memory_order_relaxed );
+
+					stage2.fetch_add( 1, memory_order_relaxed );
+				},
+				counter1, &counter2 );
+	}
+
+	js.Wait( counter2 );
+	TEST( counter1.IsComplete() );
+	TEST( counter2.IsComplete() );
+	TEST( stage1.load() == 100 );
+	TEST( stage2.load() == 100 );
+	TEST( not failed.load() );
+
+	// nested jobs
+	Atomic<uint>	nested {0};
+	JobCounter		counter3;
+
+	for (uint i = 0; i < 10; ++i)
+	{
+		js.Run( [&] ()
+				{
+					JobCounter	local;
+					for (uint j = 0; j < 10; ++j) {
+						js.Run( [&] () { nested.fetch_add( 1, memory_order_relaxed ); }, &local );
+					}
+					js.Wait( local );
+				},
+				&counter3 );
+	}
+
+	js.Wait( counter3 );
+	TEST( nested.load() == 100 );
+
+	js.Deinitialize();
+}
+
+
+static void JobSystem_Test2 ()
+{
+	JobSystem			js;
+	Array<std::thread>	app_threads;
+	JobSystem::Config	cfg;
+
+	// external thread pool
+	cfg.workerCount		= 2;
+	cfg.threadStarter	= [&app_threads] (uint, JobSystem::WorkerLoop_t &&loop) { app_threads.emplace_back( std::move(loop) ); };
+
+	TEST( js.Initialize( cfg ));
+	TEST( app_threads.size() == 2 );
+
+	Array<uint>	items;
+	for (uint i = 0; i < 10'000; ++i) {
+		items.push_back( i );
+	}
+
+	Array<uint>	result;		result.resize( items.size(), 0 );
+
+	js.ParallelFor( ArrayView<uint>{items}, [&result] (uint value, size_t index) { result[index] = value * 2 + 1; });
+
+	for (size_t i = 0; i < items.size(); ++i) {
+		TEST( result[i] == items[i] * 2 + 1 );
+	}
+
+	js.Deinitialize();
+	for (auto& t : app_threads) { t.join(); }
+}
+
+
+static void JobSystem_Test3 ()
+{
+	using TimePoint_t = std::chrono::high_resolution_clock::time_point;
+
+	// fine grained: many small jobs, coarse grained: few heavy jobs
+	const auto	Benchmark = [] (uint workerCount, uint jobCount, uint iterations)
+	{
+		JobSystem			js;
+		JobSystem::Config	cfg;
+		cfg.workerCount = workerCount;
+		TEST( js.Initialize( cfg ));
+
+		Atomic<uint64_t>	sum		{0};
+		JobCounter			counter;
+		const TimePoint_t	start	= std::chrono::high_resolution_clock::now();
+
+		for (uint i = 0; i < jobCount; ++i)
+		{
+			js.Run( [&sum, iterations, i] ()
+					{
+						uint64_t	x = i;
+						for (uint j = 0; j < iterations; ++j) {
+							x = x * 6364136223846793005ull + 1442695040888963407ull;
+						}
+						sum.fetch_add( x & 1, memory_order_relaxed );
+					},
+					&counter );
+		}
+		js.Wait( counter );
+
+		const auto	dt = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::high_resolution_clock::now() - start );
+		js.Deinitialize();
+		return dt;
+	};
+
+	String	str = "JobSystem benchmark:";
+	for (uint workers : {1u, 2u, 4u, 8u})
+	{
+		str << "\n  workers: " << ToString( workers )
+			<< ", fine: " << ToString( Benchmark( workers, 20'000, 100 ))
+			<< ", coarse: " << ToString( Benchmark( workers, 64, 200'000 ));
+	}
+	FG_LOGI( str );
+}
+
+
+extern void UnitTest_JobSystem ()
+{
+	LfWorkStealingDeque_Test1();
+	LfWorkStealingDeque_Test2();
+	JobSystem_Test1();
+	JobSystem_Test2();
+	JobSystem_Test3();
+	FG_LOGI( "UnitTest_JobSystem - passed" );
+}
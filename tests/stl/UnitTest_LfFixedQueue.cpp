@@ -0,0 +1,100 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/LfFixedQueue.h"
+#include "UnitTest_Common.h"
+#include <thread>
+
+
+static void LfFixedQueue_Test1 ()
+{
+	LfFixedQueue<int, 4>	queue;
+	int						value;
+
+	TEST( queue.empty() );
+	TEST( not queue.Pop( OUT value ));
+
+	TEST( queue.Push( 1 ));
+	TEST( queue.Push( 2 ));
+	TEST( queue.Push( 3 ));
+	TEST( queue.Push( 4 ));
+	TEST( not queue.Push( 5 ));
+
+	TEST( queue.Pop( OUT value ) and value == 1 );
+	TEST( queue.Push( 5 ));
+
+	TEST( queue.Pop( OUT value ) and value == 2 );
+	TEST( queue.Pop( OUT value ) and value == 3 );
+	TEST( queue.Pop( OUT value ) and value == 4 );
+	TEST( queue.Pop( OUT value ) and value == 5 );
+	TEST( queue.empty() );
+}
+
+
+static void LfFixedQueue_Test2 ()
+{
+	using T = DebugInstanceCounter< int, 2 >;
+
+	T::ClearStatistic();
+	{
+		LfFixedQueue<T, 8>	queue;
+
+		TEST( queue.Push( T{1} ));
+		TEST( queue.Push( T{2} ));
+
+		T	value;
+		TEST( queue.Pop( OUT value ));
+	}
+	TEST( T::CheckStatistic() );
+}
+
+
+static void LfFixedQueue_Test3 ()
+{
+	constexpr uint				producer_count	= 4;
+	constexpr uint				value_count		= 10'000;
+	LfFixedQueue<uint, 64>		queue;
+	Array<std::thread>			producers;
+	Array<uint>					last_values;	last_values.resize( producer_count, 0 );
+
+	for (uint t = 0; t < producer_count; ++t)
+	{
+		producers.emplace_back( [&queue, t] ()
+		{
+			for (uint i = 1; i <= value_count;)
+			{
+				if ( queue.Push( (t << 24) | i ))
+					++i;
+				else
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	// values from each producer must be in the same order
+	for (uint received = 0; received < producer_count * value_count;)
+	{
+		uint	value;
+		if ( not queue.Pop( OUT value ))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		uint&	last = last_values[ value >> 24 ];
+		TEST( (value & 0xFFFFFF) == last + 1 );
+		last = (value & 0xFFFFFF);
+		++received;
+	}
+
+	for (auto& t : producers) { t.join(); }
+	TEST( queue.empty() );
+}
+
+
+extern void UnitTest_LfFixedQueue ()
+{
+	LfFixedQueue_Test1();
+	LfFixedQueue_Test2();
+	LfFixedQueue_Test3();
+	FG_LOGI( "UnitTest_LfFixedQueue - passed" );
+}
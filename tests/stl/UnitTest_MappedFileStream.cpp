@@ -0,0 +1,65 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Stream/MappedFileStream.h"
+#include "UnitTest_Common.h"
+
+
+static void MappedFileStream_Test1 ()
+{
+	const char		fname[] = "mapped_file_test.bin";
+	Array<uint8_t>	data;
+
+	for (uint i = 0; i < 10'000; ++i) {
+		data.push_back( uint8_t(i * 7 + (i >> 8)) );
+	}
+	{
+		FileWStream	wfile{ fname };
+		TEST( wfile.IsOpen() );
+		TEST( wfile.Write( data ));
+	}
+	{
+		MappedFileRStream	rfile{ fname };
+		TEST( rfile.IsOpen() );
+		TEST( rfile.IsMapped() );
+		TEST( rfile.Size() == ArraySizeOf(data) );
+
+		// read
+		Array<uint8_t>	buf;
+		TEST( rfile.Read( 100, OUT buf ));
+		TEST( ArrayView<uint8_t>{buf} == ArrayView<uint8_t>{data}.section( 0, 100 ));
+		TEST( rfile.Position() == 100_b );
+
+		TEST( rfile.SeekSet( 9'950_b ));
+		TEST( rfile.Read2( OUT buf.data(), 100_b ) == 50_b );
+		TEST( ArrayView<uint8_t>{buf}.section( 0, 50 ) == ArrayView<uint8_t>{data}.section( 9'950, 50 ));
+		TEST( rfile.RemainingSize() == 0_b );
+
+		// zero-copy view
+		rfile.WillNeed( 1'000_b, 4'000_b );
+		auto	view = rfile.GetView( 1'000_b, 4'000_b );
+		TEST( view.size() == 4'000 );
+		TEST( view == ArrayView<uint8_t>{data}.section( 1'000, 4'000 ));
+
+		view = rfile.GetView( 9'000_b, 5'000_b );
+		TEST( view == ArrayView<uint8_t>{data}.section( 9'000, 1'000 ));
+	}
+	{
+		FileWStream	wfile{ fname };
+		TEST( wfile.IsOpen() );
+	}
+	{
+		// empty file can't be mapped, but stream is valid
+		MappedFileRStream	rfile{ fname };
+		TEST( rfile.IsOpen() );
+		TEST( rfile.Size() == 0_b );
+		TEST( rfile.GetView( 0_b, 10_b ).empty() );
+	}
+	std::remove( fname );
+}
+
+
+extern void UnitTest_MappedFileStream ()
+{
+	MappedFileStream_Test1();
+	FG_LOGI( "UnitTest_MappedFileStream - passed" );
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Log/TraceRecorder.h"
+#include "UnitTest_Common.h"
+#include <thread>
+
+#ifdef FG_ENABLE_CPU_TRACE
+
+static void TraceRecorder_Test1 ()
+{
+	TraceRecorder::Start();
+	{
+		FG_TRACE_SCOPE( "Main", "test" );
+
+		std::thread	thread{ [] () {
+				FG_TRACE_SCOPE( "Worker \"1\"", "test" );
+			}};
+		thread.join();
+
+		TraceRecorder::AddEvent( TraceRecorder::ETrack::GPU, 2, "Batch", "gpu", 1000, 3500 );
+	}
+	TraceRecorder::Stop();
+
+	// events are not recorded after 'Stop'
+	{
+		FG_TRACE_SCOPE( "Ignored", "test" );
+	}
+
+	String	json;
+	TEST( TraceRecorder::ToChromeTrace( OUT json ));
+
+	TEST( HasSubString( json, "{\"name\":\"Main\",\"cat\":\"test\",\"ph\":\"X\",\"pid\":0" ));
+	TEST( HasSubString( json, "\"name\":\"Worker \\\"1\\\"\"" ));
+	TEST( HasSubString( json, "{\"name\":\"Batch\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":1.000,\"dur\":2.500}" ));
+	TEST( not HasSubString( json, "Ignored" ));
+}
+
+#endif	// FG_ENABLE_CPU_TRACE
+
+
+extern void UnitTest_TraceRecorder ()
+{
+#ifdef FG_ENABLE_CPU_TRACE
+	TraceRecorder_Test1();
+	
+	FG_LOGI( "UnitTest_TraceRecorder - passed" );
+#endif
+}
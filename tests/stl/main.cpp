@@ -14,6 +14,7 @@ extern void UnitTest_ToString ();
 extern void UnitTest_LfDoubleBuffer ();
 extern void UnitTest_BitTree ();
 extern void UnitTest_LfFixedStack ();
+extern void UnitTest_LfFixedQueue ();
 extern void UnitTest_StructView ();
 extern void UnitTest_Array ();
 extern void UnitTest_StringParser ();
@@ -22,6 +23,11 @@ extern void UnitTest_LfIndexedPool ();
 extern void UnitTest_Rectangle ();
 extern void UnitTest_NtStringView ();
 extern void UnitTest_TypeList ();
+extern void UnitTest_FlatHashMap ();
+extern void UnitTest_TraceRecorder ();
+extern void UnitTest_JobSystem ();
+extern void UnitTest_MappedFileStream ();
+extern void UnitTest_AsyncLogger ();
 
 
 int main ()
@@ -37,6 +43,7 @@ int main ()
 	UnitTest_LinearAllocator();
 	UnitTest_LfDoubleBuffer();
 	UnitTest_LfFixedStack();
+	UnitTest_LfFixedQueue();
 	UnitTest_BitTree();
 	UnitTest_StructView();
 	UnitTest_Array();
@@ -46,6 +53,11 @@ int main ()
 	UnitTest_Rectangle();
 	UnitTest_NtStringView();
 	UnitTest_TypeList();
+	UnitTest_FlatHashMap();
+	UnitTest_TraceRecorder();
+	UnitTest_JobSystem();
+	UnitTest_MappedFileStream();
+	UnitTest_AsyncLogger();
 
 	FG_LOGI( "Tests.STL finished" );
 	return 0;